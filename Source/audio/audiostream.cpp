@@ -134,6 +134,15 @@ int LoopingAudioStream::readBuffer(int16 *buffer, const int numSamples) {
 	return samplesRead;
 }
 
+int LoopingAudioStream::peekBuffer(const int16 *&buffer) {
+	if (_loops && _completeIterations == _loops)
+		return 0;
+
+	// When the parent has no more samples, readBuffer takes care of
+	// rewinding it.
+	return _parent->peekBuffer(buffer);
+}
+
 bool LoopingAudioStream::endOfData() const {
 	return (_loops != 0 && _completeIterations == _loops) || _parent->endOfData();
 }
@@ -221,6 +230,23 @@ int SubLoopingAudioStream::readBuffer(int16 *buffer, const int numSamples) {
 	}
 }
 
+int SubLoopingAudioStream::peekBuffer(const int16 *&buffer) {
+	if (_done)
+		return 0;
+
+	// At the loop end, readBuffer takes care of seeking back
+	const int framesLeft = _loopEnd.frameDiff(_pos);
+	if (framesLeft <= 0)
+		return 0;
+
+	return MIN(framesLeft, _parent->peekBuffer(buffer));
+}
+
+void SubLoopingAudioStream::consumeBuffer(int numSamples) {
+	_parent->consumeBuffer(numSamples);
+	_pos = _pos.addFrames(numSamples);
+}
+
 bool SubLoopingAudioStream::endOfData() const {
 	// We're out of data if this stream is finished or the parent
 	// has run out of data for now.
@@ -330,6 +356,8 @@ public:
 
 	// Implement the AudioStream API
 	virtual int readBuffer(int16 *buffer, const int numSamples);
+	virtual int peekBuffer(const int16 *&buffer);
+	virtual void consumeBuffer(int numSamples);
 	virtual bool isStereo() const { return _stereo; }
 	virtual int getRate() const { return _rate; }
 
@@ -398,6 +426,23 @@ int QueuingAudioStreamImpl::readBuffer(int16 *buffer, const int numSamples) {
 	return samplesDecoded;
 }
 
+int QueuingAudioStreamImpl::peekBuffer(const int16 *&buffer) {
+	Common::StackLock lock(_mutex);
+
+	// Finished streams are removed by readBuffer
+	if (_queue.empty())
+		return 0;
+
+	return _queue.front()._stream->peekBuffer(buffer);
+}
+
+void QueuingAudioStreamImpl::consumeBuffer(int numSamples) {
+	Common::StackLock lock(_mutex);
+
+	if (!_queue.empty())
+		_queue.front()._stream->consumeBuffer(numSamples);
+}
+
 QueuingAudioStream *makeQueuingAudioStream(int rate, bool stereo) {
 	return new QueuingAudioStreamImpl(rate, stereo);
 }
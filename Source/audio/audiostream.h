@@ -59,6 +59,32 @@ public:
 	 */
 	virtual int readBuffer(int16 *buffer, const int numSamples) = 0;
 
+	/**
+	 * Gives direct access to the samples readBuffer() would return next,
+	 * for streams which keep them in an internal buffer anyway. This allows
+	 * consumers like the rate converters to use the samples in place
+	 * instead of copying them into a buffer of their own.
+	 *
+	 * The samples returned have to be marked as used by consumeBuffer().
+	 * The pointer stays valid until a non-const method of the stream other
+	 * than consumeBuffer() is called. For stereo streams the number of
+	 * samples returned is always even.
+	 *
+	 * @param buffer set to the first available sample
+	 * @return number of samples available. 0 means that the samples are
+	 *         not accessible directly at the moment, and readBuffer() has
+	 *         to be used (which also takes care of reporting the end of data).
+	 */
+	virtual int peekBuffer(const int16 *&buffer) { return 0; }
+
+	/**
+	 * Marks samples returned by the last peekBuffer() call as used.
+	 *
+	 * @param numSamples number of samples used, at most as many as the last
+	 *                   peekBuffer() call returned
+	 */
+	virtual void consumeBuffer(int numSamples) {}
+
 	/** Is this a stereo stream? */
 	virtual bool isStereo() const = 0;
 
@@ -121,6 +147,8 @@ public:
 	LoopingAudioStream(RewindableAudioStream *stream, uint loops, DisposeAfterUse::Flag disposeAfterUse = DisposeAfterUse::YES);
 
 	int readBuffer(int16 *buffer, const int numSamples);
+	int peekBuffer(const int16 *&buffer);
+	void consumeBuffer(int numSamples) { _parent->consumeBuffer(numSamples); }
 	bool endOfData() const;
 	bool endOfStream() const;
 
@@ -250,6 +278,8 @@ public:
 	                      DisposeAfterUse::Flag disposeAfterUse = DisposeAfterUse::YES);
 
 	int readBuffer(int16 *buffer, const int numSamples);
+	int peekBuffer(const int16 *&buffer);
+	void consumeBuffer(int numSamples);
 	bool endOfData() const;
 	bool endOfStream() const;
 
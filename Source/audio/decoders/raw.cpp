@@ -50,23 +50,36 @@ template<bool is16Bit, bool isUnsigned, bool isLE>
 class RawStream : public SeekableAudioStream {
 public:
 	RawStream(int rate, bool stereo, DisposeAfterUse::Flag disposeStream, Common::SeekableReadStream *stream)
-		: _rate(rate), _isStereo(stereo), _playtime(0, rate), _stream(stream, disposeStream), _endOfData(false), _buffer(0) {
+		: _rate(rate), _isStereo(stereo), _playtime(0, rate), _stream(stream, disposeStream), _endOfData(false), _buffer(0),
+		  _peekBuffer(0), _peekPos(0), _peekLen(0) {
 		// Setup our buffer for readBuffer
 		_buffer = new byte[kSampleBufferLength * (is16Bit ? 2 : 1)];
 		assert(_buffer);
 
+		// Samples already in the native format can be handed out from
+		// the read buffer directly
+		if (isNativeFormat())
+			_peekBuffer = (int16 *)_buffer;
+
 		// Calculate the total playtime of the stream
 		_playtime = Timestamp(0, _stream->size() / (_isStereo ? 2 : 1) / (is16Bit ? 2 : 1), rate);
 	}
 
 	~RawStream() {
+		if (!isNativeFormat())
+			delete[] _peekBuffer;
 		delete[] _buffer;
 	}
 
 	int readBuffer(int16 *buffer, const int numSamples);
+	int peekBuffer(const int16 *&buffer);
+	void consumeBuffer(int numSamples) {
+		assert(_peekPos + numSamples <= _peekLen);
+		_peekPos += numSamples;
+	}
 
 	bool isStereo() const  { return _isStereo; }
-	bool endOfData() const { return _endOfData; }
+	bool endOfData() const { return _endOfData && _peekPos == _peekLen; }
 
 	int getRate() const         { return _rate; }
 	Timestamp getLength() const { return _playtime; }
@@ -90,6 +103,22 @@ private:
 		kSampleBufferLength = 2048
 	};
 
+	int16 *_peekBuffer;                                        ///< Decoded samples handed out by peekBuffer
+	int _peekPos;                                              ///< Position of the first unconsumed sample in _peekBuffer
+	int _peekLen;                                              ///< Number of valid samples in _peekBuffer
+
+	/**
+	 * Whether the raw data is in the format of the samples returned, i.e.
+	 * signed 16 bit in native endianness.
+	 */
+	static bool isNativeFormat() {
+#ifdef SCUMM_LITTLE_ENDIAN
+		return is16Bit && !isUnsigned && isLE;
+#else
+		return is16Bit && !isUnsigned && !isLE;
+#endif
+	}
+
 	/**
 	 * Fill the temporary sample buffer used in readBuffer.
 	 *
@@ -103,6 +132,20 @@ template<bool is16Bit, bool isUnsigned, bool isLE>
 int RawStream<is16Bit, isUnsigned, isLE>::readBuffer(int16 *buffer, const int numSamples) {
 	int samplesLeft = numSamples;
 
+	// Samples decoded by peekBuffer, which have not been consumed yet,
+	// have to be returned first
+	if (_peekPos < _peekLen) {
+		const int len = MIN(samplesLeft, _peekLen - _peekPos);
+		memcpy(buffer, _peekBuffer + _peekPos, len * sizeof(int16));
+		_peekPos += len;
+		buffer += len;
+		samplesLeft -= len;
+
+		if (_peekPos < _peekLen)
+			return numSamples;
+	}
+	_peekPos = _peekLen = 0;
+
 	while (samplesLeft > 0) {
 		// Try to read up to "samplesLeft" samples.
 		int len = fillBuffer(samplesLeft);
@@ -126,6 +169,39 @@ int RawStream<is16Bit, isUnsigned, isLE>::readBuffer(int16 *buffer, const int nu
 	return numSamples - samplesLeft;
 }
 
+template<bool is16Bit, bool isUnsigned, bool isLE>
+int RawStream<is16Bit, isUnsigned, isLE>::peekBuffer(const int16 *&buffer) {
+	if (_peekPos == _peekLen) {
+		_peekPos = _peekLen = 0;
+
+		int len = fillBuffer(kSampleBufferLength);
+		// Hand out whole sample pairs only
+		if (_isStereo && (len & 1)) {
+			_stream->seek(is16Bit ? -2 : -1, SEEK_CUR);
+			_endOfData = false;
+			--len;
+		}
+		if (!len)
+			return 0;
+
+		if (!isNativeFormat()) {
+			if (!_peekBuffer)
+				_peekBuffer = new int16[kSampleBufferLength];
+
+			const byte *src = _buffer;
+			for (int i = 0; i < len; ++i) {
+				_peekBuffer[i] = READ_ENDIAN_SAMPLE(is16Bit, isUnsigned, src, isLE);
+				src += (is16Bit ? 2 : 1);
+			}
+		}
+
+		_peekLen = len;
+	}
+
+	buffer = _peekBuffer + _peekPos;
+	return _peekLen - _peekPos;
+}
+
 template<bool is16Bit, bool isUnsigned, bool isLE>
 int RawStream<is16Bit, isUnsigned, isLE>::fillBuffer(int maxSamples) {
 	int bufferedSamples = 0;
@@ -162,6 +238,7 @@ int RawStream<is16Bit, isUnsigned, isLE>::fillBuffer(int maxSamples) {
 template<bool is16Bit, bool isUnsigned, bool isLE>
 bool RawStream<is16Bit, isUnsigned, isLE>::seek(const Timestamp &where) {
 	_endOfData = true;
+	_peekPos = _peekLen = 0;
 
 	if (where > _playtime)
 		return false;
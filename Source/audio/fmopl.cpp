@@ -27,6 +27,7 @@
 #include "audio/softsynth/opl/mame.h"
 #include "audio/softsynth/opl/nuked.h"
 
+#include "common/atomic.h"
 #include "common/config-manager.h"
 #include "common/system.h"
 #include "common/textconsole.h"
@@ -293,7 +294,9 @@ EmulatedOPL::EmulatedOPL() :
 	_nextTick(0),
 	_samplesPerTick(0),
 	_baseFreq(0),
-	_handle(new Audio::SoundHandle()) {
+	_handle(new Audio::SoundHandle()),
+	_renderAhead(false),
+	_ringTarget(0) {
 }
 
 EmulatedOPL::~EmulatedOPL() {
@@ -306,7 +309,57 @@ EmulatedOPL::~EmulatedOPL() {
 	delete _handle;
 }
 
+void EmulatedOPL::write(int a, int v) {
+	if (_renderAhead)
+		queueWrite(a, v, false);
+	else
+		writeImpl(a, v);
+}
+
+byte EmulatedOPL::read(int a) {
+	if (!_renderAhead)
+		return readImpl(a);
+
+	// Reads have to see the effect of all writes made so far
+	Common::StackLock lock(_renderMutex);
+	flushWrites();
+	return readImpl(a);
+}
+
+void EmulatedOPL::writeReg(int r, int v) {
+	if (_renderAhead)
+		queueWrite(r, v, true);
+	else
+		writeRegImpl(r, v);
+}
+
 int EmulatedOPL::readBuffer(int16 *buffer, const int numSamples) {
+	if (!_renderAhead) {
+		render(buffer, numSamples);
+		return numSamples;
+	}
+
+	uint32 len = 0;
+#ifdef SCUMMVM_HAS_ATOMICS
+	// Usually the renderer is ahead and the samples can be taken from the
+	// ring buffer without locking
+	len = _ring.read(buffer, numSamples);
+	if (len == (uint32)numSamples)
+		return numSamples;
+#endif
+
+	Common::StackLock lock(_renderMutex);
+
+	// The renderer might have caught up while waiting for the lock. All
+	// samples left in the ring buffer precede the ones rendered here.
+	len += _ring.read(buffer + len, numSamples - len);
+	if (len < (uint32)numSamples)
+		render(buffer + len, numSamples - len);
+
+	return numSamples;
+}
+
+void EmulatedOPL::render(int16 *buffer, int numSamples) {
 	const int stereoFactor = isStereo() ? 2 : 1;
 	int len = numSamples / stereoFactor;
 	int step;
@@ -316,6 +369,9 @@ int EmulatedOPL::readBuffer(int16 *buffer, const int numSamples) {
 		if (step > (_nextTick >> FIXP_SHIFT))
 			step = (_nextTick >> FIXP_SHIFT);
 
+		if (_renderAhead)
+			flushWrites();
+
 		generateSamples(buffer, step * stereoFactor);
 
 		_nextTick -= step << FIXP_SHIFT;
@@ -329,8 +385,56 @@ int EmulatedOPL::readBuffer(int16 *buffer, const int numSamples) {
 		buffer += step * stereoFactor;
 		len -= step;
 	} while (len);
+}
 
-	return numSamples;
+void EmulatedOPL::queueWrite(uint16 address, uint8 value, bool isReg) {
+	PendingWrite write;
+	write.address = address;
+	write.value = value;
+	write.isReg = isReg;
+
+	Common::StackLock lock(_writeMutex);
+	_pendingWrites.push_back(write);
+}
+
+void EmulatedOPL::flushWrites() {
+	// Writes are taken out of the queue in one go, so that writers are not
+	// blocked while the emulator processes them
+	{
+		Common::StackLock lock(_writeMutex);
+		if (_pendingWrites.empty())
+			return;
+		_appliedWrites.push_back(_pendingWrites);
+		_pendingWrites.resize(0);
+	}
+
+	for (uint i = 0; i < _appliedWrites.size(); ++i) {
+		const PendingWrite &write = _appliedWrites[i];
+		if (write.isReg)
+			writeRegImpl(write.address, write.value);
+		else
+			writeImpl(write.address, write.value);
+	}
+	_appliedWrites.resize(0);
+}
+
+void EmulatedOPL::fillRing() {
+	const uint32 chunkSize = kRenderChunkSize * (isStereo() ? 2 : 1);
+
+	// Chunks never wrap around, as the ring size is a multiple of the chunk
+	// size. The lock is taken for each chunk, so that read() and the mixer
+	// do not have to wait for the whole ring to be refilled. The chunk is
+	// published before unlocking, as the mixer renders any samples missing
+	// in the ring itself, which have to follow those in the ring.
+	while (_ring.getBuffered() < _ringTarget) {
+		Common::StackLock lock(_renderMutex);
+		render(_ring.beginWrite(chunkSize), chunkSize);
+		_ring.endWrite(chunkSize);
+	}
+}
+
+void EmulatedOPL::renderAheadProc(void *refCon) {
+	static_cast<EmulatedOPL *>(refCon)->fillRing();
 }
 
 int EmulatedOPL::getRate() const {
@@ -339,11 +443,36 @@ int EmulatedOPL::getRate() const {
 
 void EmulatedOPL::startCallbacks(int timerFrequency) {
 	setCallbackFrequency(timerFrequency);
+
+	const int renderAheadMs = ConfMan.getInt("opl_render_ahead");
+	if (renderAheadMs > 0) {
+		const uint32 chunkSize = kRenderChunkSize * (isStereo() ? 2 : 1);
+		_ringTarget = MAX<uint32>(getRate() * renderAheadMs / 1000 * (isStereo() ? 2 : 1), chunkSize);
+		_ringTarget = (_ringTarget + chunkSize - 1) / chunkSize * chunkSize;
+		// Room for a chunk rendered while the ring is almost at its target
+		_ring.allocate(_ringTarget + chunkSize);
+		_renderAhead = true;
+	}
+
 	g_system->getMixer()->playStream(Audio::Mixer::kPlainSoundType, _handle, this, -1, Audio::Mixer::kMaxChannelVolume, 0, DisposeAfterUse::NO, true);
+
+	if (_renderAhead)
+		g_system->getTimerManager()->installTimerProc(renderAheadProc, kRenderAheadInterval, this, "EmulatedOPL");
 }
 
 void EmulatedOPL::stopCallbacks() {
+	if (_renderAhead)
+		g_system->getTimerManager()->removeTimerProc(renderAheadProc);
+
 	g_system->getMixer()->stopHandle(*_handle);
+
+	if (_renderAhead) {
+		// Neither the renderer nor the mixer can access the emulator anymore,
+		// so the remaining writes can be applied directly
+		flushWrites();
+		_renderAhead = false;
+		_ring.free();
+	}
 }
 
 void EmulatedOPL::setCallbackFrequency(int timerFrequency) {
@@ -24,8 +24,11 @@
 #define AUDIO_FMOPL_H
 
 #include "audio/audiostream.h"
+#include "audio/ringbuffer.h"
 
+#include "common/array.h"
 #include "common/func.h"
+#include "common/mutex.h"
 #include "common/ptr.h"
 #include "common/scummsys.h"
 
@@ -236,6 +239,13 @@ private:
  *
  * This will send callbacks based on the number of samples
  * decoded in readBuffer().
+ *
+ * Optionally the output can be rendered ahead of time from a timer proc,
+ * which usually runs in a thread of its own, into a ring buffer. This takes
+ * the cost of the emulation out of the mixer thread. The length of the
+ * buffer is set by the "opl_render_ahead" config key in milliseconds, 0
+ * disables rendering ahead. In this mode register writes are queued and
+ * applied by the renderer between two generateSamples calls.
  */
 class EmulatedOPL : public OPL, protected Audio::AudioStream {
 public:
@@ -243,6 +253,9 @@ public:
 	virtual ~EmulatedOPL();
 
 	// OPL API
+	void write(int a, int v);
+	byte read(int a);
+	void writeReg(int r, int v);
 	void setCallbackFrequency(int timerFrequency);
 
 	// AudioStream API
@@ -255,6 +268,27 @@ protected:
 	void startCallbacks(int timerFrequency);
 	void stopCallbacks();
 
+	/**
+	 * Write a byte to the given I/O port of the emulator.
+	 *
+	 * @see OPL::write
+	 */
+	virtual void writeImpl(int a, int v) = 0;
+
+	/**
+	 * Read a byte from the given I/O port of the emulator.
+	 *
+	 * @see OPL::read
+	 */
+	virtual byte readImpl(int a) = 0;
+
+	/**
+	 * Write directly to a register of the emulator.
+	 *
+	 * @see OPL::writeReg
+	 */
+	virtual void writeRegImpl(int r, int v) = 0;
+
 	/**
 	 * Read up to 'length' samples.
 	 *
@@ -278,6 +312,40 @@ private:
 	int _samplesPerTick;
 
 	Audio::SoundHandle *_handle;
+
+	/**
+	 * Generate samples and invoke the callback at the right positions.
+	 */
+	void render(int16 *buffer, int numSamples);
+
+	// Render ahead support
+	struct PendingWrite {
+		uint16 address;
+		uint8 value;
+		bool isReg;
+	};
+
+	enum {
+		/** Interval in which the ring buffer is refilled, in microseconds */
+		kRenderAheadInterval = 10000,
+		/** Maximal number of sample frames rendered at once */
+		kRenderChunkSize = 256
+	};
+
+	bool _renderAhead;
+	Common::Mutex _renderMutex;                      ///< Held while the emulator is used
+	Common::Mutex _writeMutex;                       ///< Protects _pendingWrites
+	Common::Array<PendingWrite> _pendingWrites;      ///< Writes not yet passed to the emulator
+	Common::Array<PendingWrite> _appliedWrites;      ///< Writes being passed to the emulator
+
+	Audio::SampleRingBuffer _ring;
+	uint32 _ringTarget;                              ///< Number of samples to render ahead
+
+	void queueWrite(uint16 address, uint8 value, bool isReg);
+	void flushWrites();
+	void fillRing();
+
+	static void renderAheadProc(void *refCon);
 };
 
 } // End of namespace OPL
@@ -22,6 +22,9 @@
 
 #include "gui/EventRecorder.h"
 
+#include "common/array.h"
+#include "common/atomic.h"
+#include "common/config-manager.h"
 #include "common/util.h"
 #include "common/system.h"
 #include "common/textconsole.h"
@@ -44,24 +47,24 @@ namespace Audio {
  */
 class Channel {
 public:
-	Channel(Mixer *mixer, Mixer::SoundType type, AudioStream *stream, DisposeAfterUse::Flag autofreeStream, bool reverseStereo, int id, bool permanent);
+	Channel(Mixer *mixer, Mixer::SoundType type, AudioStream *stream, DisposeAfterUse::Flag autofreeStream, bool reverseStereo, int id, bool permanent, ResamplerQuality quality);
 	~Channel();
 
 	/**
 	 * Mixes the channel's samples into the given buffer.
 	 *
-	 * @param data buffer where to mix the data
+	 * @param data buffer where to mix the data (see RateConverter::flowAccumulate)
 	 * @param len  number of sample *pairs*. So a value of
 	 *             10 means that the buffer contains twice 10 sample, each
-	 *             16 bits, for a total of 40 bytes.
+	 *             32 bits, for a total of 80 bytes.
 	 * @return number of sample pairs processed (which can still be silence!)
 	 */
-	int mix(int16 *data, uint len);
+	int mix(int32 *data, uint len);
 
 	/**
 	 * Queries whether the channel is still playing or not.
 	 */
-	bool isFinished() const { return _stream->endOfStream(); }
+	bool isFinished() const { return _stream->endOfStream() && !_converter->hasPendingOutput(); }
 
 	/**
 	 * Queries whether the channel is a permanent channel.
@@ -169,23 +172,117 @@ private:
 	Common::DisposablePtr<AudioStream> _stream;
 };
 
+#pragma mark -
+#pragma mark --- Command queue ---
+#pragma mark -
+
+// The command queue is a single producer, single consumer ring buffer.
+// Producers are serialized by _queueMutex, the consumer is whoever holds
+// _mutex (usually the audio thread in mixCallback). Where the compiler
+// offers atomic loads and stores, the consumer does not need any other lock.
+
+void MixerImpl::queueCommand(byte type, uint32 handle, int value) {
+	// Must be called with _queueMutex held
+#ifdef SCUMMVM_HAS_ATOMICS
+	while (_commandHead - Common::loadAcquire(&_commandTail) == kCommandQueueSize) {
+#else
+	while (_commandHead - _commandTail == kCommandQueueSize) {
+#endif
+		// The audio thread is not keeping up (or not running at all), so
+		// apply the pending commands from this thread instead. Note that
+		// _queueMutex must not be held while acquiring _mutex.
+		_queueMutex.unlock();
+		{
+			Common::StackLock lock(_mutex);
+			processCommands();
+		}
+		_queueMutex.lock();
+	}
+
+	Command &cmd = _commands[_commandHead & (kCommandQueueSize - 1)];
+	cmd.type = type;
+	cmd.handle = handle;
+	cmd.value = value;
+
+#ifdef SCUMMVM_HAS_ATOMICS
+	Common::storeRelease(&_commandHead, _commandHead + 1);
+#else
+	_commandHead++;
+#endif
+}
+
+void MixerImpl::processCommands() {
+	// Must be called with _mutex held
+#ifdef SCUMMVM_HAS_ATOMICS
+	const uint32 head = Common::loadAcquire(&_commandHead);
+#else
+	Common::StackLock lock(_queueMutex);
+	const uint32 head = _commandHead;
+#endif
+	uint32 tail = _commandTail;
+
+	for (; tail != head; ++tail) {
+		const Command &cmd = _commands[tail & (kCommandQueueSize - 1)];
+
+		if (cmd.type == Command::kSoundTypeChanged) {
+			for (uint i = 0; i != _numChannels; ++i) {
+				if (_channels[i] && _channels[i]->getType() == cmd.value)
+					_channels[i]->notifyGlobalVolChange();
+			}
+			continue;
+		}
+
+		SoundHandle handle;
+		handle._val = cmd.handle;
+		const int index = findChannel(handle);
+		if (index == -1)
+			continue;
+
+		if (cmd.type == Command::kSetVolume)
+			_channels[index]->setVolume(cmd.value);
+		else
+			_channels[index]->setBalance(cmd.value);
+	}
+
+#ifdef SCUMMVM_HAS_ATOMICS
+	Common::storeRelease(&_commandTail, tail);
+#else
+	_commandTail = tail;
+#endif
+}
+
 #pragma mark -
 #pragma mark --- Mixer ---
 #pragma mark -
 
 // TODO: parameter "system" is unused
-MixerImpl::MixerImpl(OSystem *system, uint sampleRate)
-	: _mutex(), _sampleRate(sampleRate), _mixerReady(false), _handleSeed(0), _soundTypeSettings() {
+MixerImpl::MixerImpl(OSystem *system, uint sampleRate, uint numChannels)
+	: _mutex(), _queueMutex(), _sampleRate(sampleRate), _numChannels(numChannels), _resamplerQuality(kResamplerLinear), _mixerReady(false), _handleSeed(0), _soundTypeSettings(),
+	  _commandHead(0), _commandTail(0), _mixBuffer(0), _mixBufferSize(0) {
 
 	assert(sampleRate > 0);
+	assert(numChannels > 0);
 
-	for (int i = 0; i != NUM_CHANNELS; i++)
+	if (ConfMan.get("resampler") == "sinc")
+		_resamplerQuality = kResamplerSinc;
+
+	_channels = new Channel *[_numChannels];
+	_channelParams = new ChannelParams[_numChannels];
+	for (uint i = 0; i != _numChannels; i++) {
 		_channels[i] = 0;
+		_channelParams[i].handle = 0xFFFFFFFF;
+		_channelParams[i].volume = 0;
+		_channelParams[i].balance = 0;
+	}
 }
 
 MixerImpl::~MixerImpl() {
-	for (int i = 0; i != NUM_CHANNELS; i++)
+	for (uint i = 0; i != _numChannels; i++)
 		delete _channels[i];
+
+	delete[] _channels;
+	delete[] _channelParams;
+	free(_mixBuffer);
 }
 
 void MixerImpl::setReady(bool ready) {
@@ -196,9 +293,17 @@ uint MixerImpl::getOutputRate() const {
 	return _sampleRate;
 }
 
-void MixerImpl::insertChannel(SoundHandle *handle, Channel *chan) {
+int MixerImpl::findChannel(SoundHandle handle) const {
+	const int index = handle._val % _numChannels;
+	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
+		return -1;
+	return index;
+}
+
+bool MixerImpl::insertChannel(SoundHandle *handle, Channel *chan) {
+	// Must be called with _mutex held
 	int index = -1;
-	for (int i = 0; i != NUM_CHANNELS; i++) {
+	for (uint i = 0; i != _numChannels; i++) {
 		if (_channels[i] == 0) {
 			index = i;
 			break;
@@ -206,19 +311,52 @@ void MixerImpl::insertChannel(SoundHandle *handle, Channel *chan) {
 	}
 	if (index == -1) {
 		warning("MixerImpl::out of mixer slots");
-		delete chan;
-		return;
+		return false;
 	}
 
-	_channels[index] = chan;
-
 	SoundHandle chanHandle;
-	chanHandle._val = index + (_handleSeed * NUM_CHANNELS);
+	chanHandle._val = index + (_handleSeed * _numChannels);
 
 	chan->setHandle(chanHandle);
 	_handleSeed++;
 	if (handle)
 		*handle = chanHandle;
+
+	{
+		Common::StackLock lock(_queueMutex);
+		_channelParams[index].handle = chanHandle._val;
+		_channelParams[index].volume = chan->getVolume();
+		_channelParams[index].balance = chan->getBalance();
+	}
+
+	_channels[index] = chan;
+	return true;
+}
+
+void MixerImpl::freeChannelSlot(uint index) {
+	// Must be called with _mutex held
+	_channels[index] = 0;
+
+	// Invalidating the handle is enough, the volume and balance of a slot
+	// are only reported for a matching handle and reset by insertChannel.
+#ifdef SCUMMVM_HAS_ATOMICS
+	Common::storeRelease(&_channelParams[index].handle, 0xFFFFFFFF);
+#else
+	Common::StackLock lock(_queueMutex);
+	_channelParams[index].handle = 0xFFFFFFFF;
+#endif
+}
+
+MixerImpl::ChannelParams *MixerImpl::findChannelParams(SoundHandle handle) {
+	// Must be called with _queueMutex held
+	ChannelParams &params = _channelParams[handle._val % _numChannels];
+#ifdef SCUMMVM_HAS_ATOMICS
+	if (Common::loadAcquire(&params.handle) != handle._val)
+#else
+	if (params.handle != handle._val)
+#endif
+		return 0;
+	return &params;
 }
 
 void MixerImpl::playStream(
@@ -229,8 +367,6 @@ void MixerImpl::playStream(
 			DisposeAfterUse::Flag autofreeStream,
 			bool permanent,
 			bool reverseStereo) {
-	Common::StackLock lock(_mutex);
-
 	if (stream == 0) {
 		warning("stream is 0");
 		return;
@@ -239,31 +375,42 @@ void MixerImpl::playStream(
 
 	assert(_mixerReady);
 
-	// Prevent duplicate sounds
-	if (id != -1) {
-		for (int i = 0; i != NUM_CHANNELS; i++)
-			if (_channels[i] != 0 && _channels[i]->getId() == id) {
-				// Delete the stream if were asked to auto-dispose it.
-				// Note: This could cause trouble if the client code does not
-				// yet expect the stream to be gone. The primary example to
-				// keep in mind here is QueuingAudioStream.
-				// Thus, as a quick rule of thumb, you should never, ever,
-				// try to play QueuingAudioStreams with a sound id.
-				if (autofreeStream == DisposeAfterUse::YES)
-					delete stream;
-				return;
-			}
-	}
-
 #ifdef AUDIO_REVERSE_STEREO
 	reverseStereo = !reverseStereo;
 #endif
 
-	// Create the channel
-	Channel *chan = new Channel(this, type, stream, autofreeStream, reverseStereo, id, permanent);
+	// Create the channel before taking the lock, setting up the rate
+	// converter involves memory allocations.
+	Channel *chan = new Channel(this, type, stream, autofreeStream, reverseStereo, id, permanent, _resamplerQuality);
 	chan->setVolume(volume);
 	chan->setBalance(balance);
-	insertChannel(handle, chan);
+
+	bool inserted = false;
+	{
+		Common::StackLock lock(_mutex);
+
+		// Prevent duplicate sounds
+		bool duplicate = false;
+		if (id != -1) {
+			for (uint i = 0; i != _numChannels; i++)
+				if (_channels[i] != 0 && _channels[i]->getId() == id) {
+					duplicate = true;
+					break;
+				}
+		}
+
+		if (!duplicate)
+			inserted = insertChannel(handle, chan);
+	}
+
+	// Deleting the channel deletes the stream if were asked to auto-dispose it.
+	// Note: This could cause trouble if the client code does not
+	// yet expect the stream to be gone. The primary example to
+	// keep in mind here is QueuingAudioStream.
+	// Thus, as a quick rule of thumb, you should never, ever,
+	// try to play QueuingAudioStreams with a sound id.
+	if (!inserted)
+		delete chan;
 }
 
 int MixerImpl::mixCallback(byte *samples, uint len) {
@@ -279,67 +426,98 @@ int MixerImpl::mixCallback(byte *samples, uint len) {
 	// Since the mixer callback has been called, the mixer must be ready...
 	_mixerReady = true;
 
+	processCommands();
+
+	// All channels are summed up into a 32-bit buffer first, which is
+	// then clamped to 16-bit in one go.
+	if (_mixBufferSize < 2 * len) {
+		free(_mixBuffer);
+		_mixBufferSize = 2 * len;
+		_mixBuffer = (int32 *)malloc(_mixBufferSize * sizeof(int32));
+		if (!_mixBuffer)
+			error("[MixerImpl::mixCallback] Cannot allocate memory for mix buffer");
+	}
+
 	//  zero the buf
-	memset(buf, 0, 2 * len * sizeof(int16));
+	memset(_mixBuffer, 0, 2 * len * sizeof(int32));
 
 	// mix all channels
 	int res = 0, tmp;
-	for (int i = 0; i != NUM_CHANNELS; i++)
+	for (uint i = 0; i != _numChannels; i++)
 		if (_channels[i]) {
 			if (_channels[i]->isFinished()) {
 				delete _channels[i];
-				_channels[i] = 0;
+				freeChannelSlot(i);
 			} else if (!_channels[i]->isPaused()) {
-				tmp = _channels[i]->mix(buf, len);
+				tmp = _channels[i]->mix(_mixBuffer, len);
 
 				if (tmp > res)
 					res = tmp;
 			}
 		}
 
+	clampMixBuffer(_mixBuffer, buf, 2 * len);
+
 	return res;
 }
 
 void MixerImpl::stopAll() {
-	Common::StackLock lock(_mutex);
-	for (int i = 0; i != NUM_CHANNELS; i++) {
-		if (_channels[i] != 0 && !_channels[i]->isPermanent()) {
-			delete _channels[i];
-			_channels[i] = 0;
+	Common::Array<Channel *> stopped;
+	{
+		Common::StackLock lock(_mutex);
+		for (uint i = 0; i != _numChannels; i++) {
+			if (_channels[i] != 0 && !_channels[i]->isPermanent()) {
+				stopped.push_back(_channels[i]);
+				freeChannelSlot(i);
+			}
 		}
 	}
+
+	// The channels are no longer visible to the audio thread, so their
+	// (possibly expensive) destruction can happen without holding the lock.
+	for (uint i = 0; i < stopped.size(); i++)
+		delete stopped[i];
 }
 
 void MixerImpl::stopID(int id) {
-	Common::StackLock lock(_mutex);
-	for (int i = 0; i != NUM_CHANNELS; i++) {
-		if (_channels[i] != 0 && _channels[i]->getId() == id) {
-			delete _channels[i];
-			_channels[i] = 0;
+	Common::Array<Channel *> stopped;
+	{
+		Common::StackLock lock(_mutex);
+		for (uint i = 0; i != _numChannels; i++) {
+			if (_channels[i] != 0 && _channels[i]->getId() == id) {
+				stopped.push_back(_channels[i]);
+				freeChannelSlot(i);
+			}
 		}
 	}
+
+	for (uint i = 0; i < stopped.size(); i++)
+		delete stopped[i];
 }
 
 void MixerImpl::stopHandle(SoundHandle handle) {
-	Common::StackLock lock(_mutex);
+	Channel *stopped;
+	{
+		Common::StackLock lock(_mutex);
 
-	// Simply ignore stop requests for handles of sounds that already terminated
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
-		return;
+		// Simply ignore stop requests for handles of sounds that already terminated
+		const int index = findChannel(handle);
+		if (index == -1)
+			return;
 
-	delete _channels[index];
-	_channels[index] = 0;
+		stopped = _channels[index];
+		freeChannelSlot(index);
+	}
+
+	delete stopped;
 }
 
 void MixerImpl::muteSoundType(SoundType type, bool mute) {
 	assert(0 <= (int)type && (int)type < ARRAYSIZE(_soundTypeSettings));
 	_soundTypeSettings[type].mute = mute;
 
-	for (int i = 0; i != NUM_CHANNELS; ++i) {
-		if (_channels[i] && _channels[i]->getType() == type)
-			_channels[i]->notifyGlobalVolChange();
-	}
+	Common::StackLock lock(_queueMutex);
+	queueCommand(Command::kSoundTypeChanged, 0, type);
 }
 
 bool MixerImpl::isSoundTypeMuted(SoundType type) const {
@@ -348,39 +526,41 @@ bool MixerImpl::isSoundTypeMuted(SoundType type) const {
 }
 
 void MixerImpl::setChannelVolume(SoundHandle handle, byte volume) {
-	Common::StackLock lock(_mutex);
+	Common::StackLock lock(_queueMutex);
 
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
+	ChannelParams *params = findChannelParams(handle);
+	if (!params)
 		return;
 
-	_channels[index]->setVolume(volume);
+	params->volume = volume;
+	queueCommand(Command::kSetVolume, handle._val, volume);
 }
 
 byte MixerImpl::getChannelVolume(SoundHandle handle) {
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
-		return 0;
+	// Report the most recently requested volume, even if the audio thread
+	// has not picked it up yet.
+	Common::StackLock lock(_queueMutex);
 
-	return _channels[index]->getVolume();
+	const ChannelParams *params = findChannelParams(handle);
+	return params ? params->volume : 0;
 }
 
 void MixerImpl::setChannelBalance(SoundHandle handle, int8 balance) {
-	Common::StackLock lock(_mutex);
+	Common::StackLock lock(_queueMutex);
 
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
+	ChannelParams *params = findChannelParams(handle);
+	if (!params)
 		return;
 
-	_channels[index]->setBalance(balance);
+	params->balance = balance;
+	queueCommand(Command::kSetBalance, handle._val, balance);
 }
 
 int8 MixerImpl::getChannelBalance(SoundHandle handle) {
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
-		return 0;
+	Common::StackLock lock(_queueMutex);
 
-	return _channels[index]->getBalance();
+	const ChannelParams *params = findChannelParams(handle);
+	return params ? params->balance : 0;
 }
 
 uint32 MixerImpl::getSoundElapsedTime(SoundHandle handle) {
@@ -390,8 +570,8 @@ uint32 MixerImpl::getSoundElapsedTime(SoundHandle handle) {
 Timestamp MixerImpl::getElapsedTime(SoundHandle handle) {
 	Common::StackLock lock(_mutex);
 
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
+	const int index = findChannel(handle);
+	if (index == -1)
 		return Timestamp(0, _sampleRate);
 
 	return _channels[index]->getElapsedTime();
@@ -399,7 +579,7 @@ Timestamp MixerImpl::getElapsedTime(SoundHandle handle) {
 
 void MixerImpl::pauseAll(bool paused) {
 	Common::StackLock lock(_mutex);
-	for (int i = 0; i != NUM_CHANNELS; i++) {
+	for (uint i = 0; i != _numChannels; i++) {
 		if (_channels[i] != 0) {
 			_channels[i]->pause(paused);
 		}
@@ -408,7 +588,7 @@ void MixerImpl::pauseAll(bool paused) {
 
 void MixerImpl::pauseID(int id, bool paused) {
 	Common::StackLock lock(_mutex);
-	for (int i = 0; i != NUM_CHANNELS; i++) {
+	for (uint i = 0; i != _numChannels; i++) {
 		if (_channels[i] != 0 && _channels[i]->getId() == id) {
 			_channels[i]->pause(paused);
 			return;
@@ -420,8 +600,8 @@ void MixerImpl::pauseHandle(SoundHandle handle, bool paused) {
 	Common::StackLock lock(_mutex);
 
 	// Simply ignore (un)pause requests for sounds that already terminated
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
+	const int index = findChannel(handle);
+	if (index == -1)
 		return;
 
 	_channels[index]->pause(paused);
@@ -434,7 +614,7 @@ bool MixerImpl::isSoundIDActive(int id) {
 	g_eventRec.updateSubsystems();
 #endif
 
-	for (int i = 0; i != NUM_CHANNELS; i++)
+	for (uint i = 0; i != _numChannels; i++)
 		if (_channels[i] && _channels[i]->getId() == id)
 			return true;
 	return false;
@@ -442,8 +622,8 @@ bool MixerImpl::isSoundIDActive(int id) {
 
 int MixerImpl::getSoundID(SoundHandle handle) {
 	Common::StackLock lock(_mutex);
-	const int index = handle._val % NUM_CHANNELS;
-	if (_channels[index] && _channels[index]->getHandle()._val == handle._val)
+	const int index = findChannel(handle);
+	if (index != -1)
 		return _channels[index]->getId();
 	return 0;
 }
@@ -455,13 +635,12 @@ bool MixerImpl::isSoundHandleActive(SoundHandle handle) {
 	g_eventRec.updateSubsystems();
 #endif
 
-	const int index = handle._val % NUM_CHANNELS;
-	return _channels[index] && _channels[index]->getHandle()._val == handle._val;
+	return findChannel(handle) != -1;
 }
 
 bool MixerImpl::hasActiveChannelOfType(SoundType type) {
 	Common::StackLock lock(_mutex);
-	for (int i = 0; i != NUM_CHANNELS; i++)
+	for (uint i = 0; i != _numChannels; i++)
 		if (_channels[i] && _channels[i]->getType() == type)
 			return true;
 	return false;
@@ -476,13 +655,10 @@ void MixerImpl::setVolumeForSoundType(SoundType type, int volume) {
 	// TODO: Maybe we should do logarithmic (not linear) volume
 	// scaling? See also Player_V2::setMasterVolume
 
-	Common::StackLock lock(_mutex);
 	_soundTypeSettings[type].volume = volume;
 
-	for (int i = 0; i != NUM_CHANNELS; ++i) {
-		if (_channels[i] && _channels[i]->getType() == type)
-			_channels[i]->notifyGlobalVolChange();
-	}
+	Common::StackLock lock(_queueMutex);
+	queueCommand(Command::kSoundTypeChanged, 0, type);
 }
 
 int MixerImpl::getVolumeForSoundType(SoundType type) const {
@@ -497,7 +673,7 @@ int MixerImpl::getVolumeForSoundType(SoundType type) const {
 #pragma mark -
 
 Channel::Channel(Mixer *mixer, Mixer::SoundType type, AudioStream *stream,
-                 DisposeAfterUse::Flag autofreeStream, bool reverseStereo, int id, bool permanent)
+                 DisposeAfterUse::Flag autofreeStream, bool reverseStereo, int id, bool permanent, ResamplerQuality quality)
     : _type(type), _mixer(mixer), _id(id), _permanent(permanent), _volume(Mixer::kMaxChannelVolume),
       _balance(0), _pauseLevel(0), _samplesConsumed(0), _samplesDecoded(0), _mixerTimeStamp(0),
       _pauseStartTime(0), _pauseTime(0), _converter(0), _volL(0), _volR(0),
@@ -506,7 +682,7 @@ Channel::Channel(Mixer *mixer, Mixer::SoundType type, AudioStream *stream,
 	assert(stream);
 
 	// Get a rate converter instance
-	_converter = makeRateConverter(_stream->getRate(), mixer->getOutputRate(), _stream->isStereo(), reverseStereo);
+	_converter = makeRateConverter(_stream->getRate(), mixer->getOutputRate(), _stream->isStereo(), reverseStereo, quality);
 }
 
 Channel::~Channel() {
@@ -604,18 +780,18 @@ Timestamp Channel::getElapsedTime() {
 	return ts;
 }
 
-int Channel::mix(int16 *data, uint len) {
+int Channel::mix(int32 *data, uint len) {
 	assert(_stream);
 
 	int res = 0;
-	if (_stream->endOfData()) {
+	if (_stream->endOfData() && !_converter->hasPendingOutput()) {
 		// TODO: call drain method
 	} else {
 		assert(_converter);
 		_samplesConsumed = _samplesDecoded;
 		_mixerTimeStamp = g_system->getMillis(true);
 		_pauseTime = 0;
-		res = _converter->flow(*_stream, data, len, _volL, _volR);
+		res = _converter->flowAccumulate(*_stream, data, len, _volL, _volR);
 		_samplesDecoded += res;
 	}
 
@@ -26,6 +26,7 @@
 #include "common/scummsys.h"
 #include "common/mutex.h"
 #include "audio/mixer.h"
+#include "audio/rate.h"
 
 namespace Audio {
 
@@ -49,14 +50,58 @@ namespace Audio {
  * @see OSystem::getMixer()
  */
 class MixerImpl : public Mixer {
+public:
+	enum {
+		/** Number of channels used when the backend does not ask for a specific amount. */
+		kDefaultChannelCount = 64
+	};
+
 private:
+	/**
+	 * A channel parameter change requested by the engine. These are queued
+	 * and applied by the audio thread at the start of the next mixCallback,
+	 * so that frequent calls like volume fades never wait for the mixer.
+	 */
+	struct Command {
+		enum Type {
+			kSetVolume,
+			kSetBalance,
+			kSoundTypeChanged
+		};
+
+		byte type;
+		int value;
+		uint32 handle;
+	};
+
 	enum {
-		NUM_CHANNELS = 16
+		/** Size of the command ring buffer. Must be a power of two. */
+		kCommandQueueSize = 256
+	};
+
+	/**
+	 * Volume and balance of a channel as last requested by the engine.
+	 * This is what getChannelVolume/getChannelBalance report, regardless of
+	 * whether the audio thread has applied the change yet.
+	 */
+	struct ChannelParams {
+		volatile uint32 handle;	///< Reset by the audio thread, see freeChannelSlot
+		byte volume;
+		int8 balance;
 	};
 
+	/** Guards the channel table. Only held for short periods of time. */
 	Common::Mutex _mutex;
 
+	/**
+	 * Serializes producers of the command queue and guards _channelParams,
+	 * except for freeing a slot (see freeChannelSlot).
+	 */
+	Common::Mutex _queueMutex;
+
 	const uint _sampleRate;
+	const uint _numChannels;
+	ResamplerQuality _resamplerQuality;
 	bool _mixerReady;
 	uint32 _handleSeed;
 
@@ -68,12 +113,24 @@ private:
 	};
 
 	SoundTypeSettings _soundTypeSettings[4];
-	Channel *_channels[NUM_CHANNELS];
+	Channel **_channels;
+	ChannelParams *_channelParams;
 
+	Command _commands[kCommandQueueSize];
+	volatile uint32 _commandHead;	///< Next slot to write, only advanced by producers
+	volatile uint32 _commandTail;	///< Next slot to read, only advanced by the audio thread
+
+	int32 *_mixBuffer;
+	uint _mixBufferSize;
+
+	void queueCommand(byte type, uint32 handle, int value);
+	void processCommands();
+	int findChannel(SoundHandle handle) const;
+	ChannelParams *findChannelParams(SoundHandle handle);
 
 public:
 
-	MixerImpl(OSystem *system, uint sampleRate);
+	MixerImpl(OSystem *system, uint sampleRate, uint numChannels = kDefaultChannelCount);
 	~MixerImpl();
 
 	virtual bool isReady() const { return _mixerReady; }
@@ -119,7 +176,16 @@ public:
 	virtual uint getOutputRate() const;
 
 protected:
-	void insertChannel(SoundHandle *handle, Channel *chan);
+	bool insertChannel(SoundHandle *handle, Channel *chan);
+
+	/**
+	 * Mark a channel slot as free, so that the handle of the channel which
+	 * used it no longer reports a volume or balance.
+	 * Must be called with _mutex held. Where SCUMMVM_HAS_ATOMICS is defined
+	 * _queueMutex is not taken, as the audio thread frees the slots of
+	 * finished channels.
+	 */
+	void freeChannelSlot(uint index);
 
 public:
 	/**
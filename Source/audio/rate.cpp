@@ -31,7 +31,9 @@
 #include "audio/audiostream.h"
 #include "audio/rate.h"
 #include "audio/mixer.h"
+#include "common/algorithm.h"
 #include "common/frac.h"
+#include "common/math.h"
 #include "common/textconsole.h"
 #include "common/util.h"
 
@@ -57,6 +59,48 @@ enum {
 	FRAC_HALF_LOW = (1L << (FRAC_BITS_LOW-1))
 };
 
+/**
+ * Mixes a sample into the output buffer. 16-bit buffers are clamped on
+ * every addition, 32-bit accumulation buffers are clamped once at the end
+ * (see clampMixBuffer).
+ */
+static inline void mixSample(st_sample_t &a, int b) {
+	clampedAdd(a, b);
+}
+
+static inline void mixSample(int32 &a, int b) {
+	a += b;
+}
+
+/**
+ * Gets the next block of input samples. If the stream supports it, its
+ * samples are used in place (see AudioStream::peekBuffer), otherwise they
+ * are read into the given buffer.
+ *
+ * Samples used in place are only marked as consumed on the next call, so
+ * that the stream does not report its end while the converter still
+ * holds unprocessed samples.
+ *
+ * @param ptr    set to the first sample of the block
+ * @param peeked number of samples pending to be consumed, updated
+ * @return number of samples in the block
+ */
+static inline int nextInputBlock(AudioStream &input, const st_sample_t *&ptr, st_sample_t *buf, int bufSize, int &peeked) {
+	if (peeked) {
+		input.consumeBuffer(peeked);
+		peeked = 0;
+	}
+
+	const int len = input.peekBuffer(ptr);
+	if (len > 0) {
+		peeked = len;
+		return len;
+	}
+
+	ptr = buf;
+	return input.readBuffer(buf, bufSize);
+}
+
 /**
  * Audio rate converter based on simple resampling. Used when no
  * interpolation is required.
@@ -69,6 +113,8 @@ protected:
 	st_sample_t inBuf[INTERMEDIATE_BUFFER_SIZE];
 	const st_sample_t *inPtr;
 	int inLen;
+	/** number of samples used in place, still to be consumed */
+	int inPeeked;
 
 	/** position of how far output is ahead of input */
 	/** Holds what would have been opos-ipos */
@@ -77,9 +123,17 @@ protected:
 	/** fractional position increment in the output stream */
 	long opos_inc;
 
+	template<typename Sample>
+	int doFlow(AudioStream &input, Sample *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r);
+
 public:
 	SimpleRateConverter(st_rate_t inrate, st_rate_t outrate);
-	int flow(AudioStream &input, st_sample_t *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r);
+	int flow(AudioStream &input, st_sample_t *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r) {
+		return doFlow(input, obuf, osamp, vol_l, vol_r);
+	}
+	int flowAccumulate(AudioStream &input, int32 *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r) {
+		return doFlow(input, obuf, osamp, vol_l, vol_r);
+	}
 	int drain(st_sample_t *obuf, st_size_t osamp, st_volume_t vol) {
 		return ST_SUCCESS;
 	}
@@ -105,6 +159,7 @@ SimpleRateConverter<stereo, reverseStereo>::SimpleRateConverter(st_rate_t inrate
 	opos_inc = inrate / outrate;
 
 	inLen = 0;
+	inPeeked = 0;
 }
 
 /*
@@ -112,8 +167,9 @@ SimpleRateConverter<stereo, reverseStereo>::SimpleRateConverter(st_rate_t inrate
  * Return number of sample pairs processed.
  */
 template<bool stereo, bool reverseStereo>
-int SimpleRateConverter<stereo, reverseStereo>::flow(AudioStream &input, st_sample_t *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r) {
-	st_sample_t *ostart, *oend;
+template<typename Sample>
+int SimpleRateConverter<stereo, reverseStereo>::doFlow(AudioStream &input, Sample *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r) {
+	Sample *ostart, *oend;
 
 	ostart = obuf;
 	oend = obuf + osamp * 2;
@@ -124,8 +180,7 @@ int SimpleRateConverter<stereo, reverseStereo>::flow(AudioStream &input, st_samp
 		do {
 			// Check if we have to refill the buffer
 			if (inLen == 0) {
-				inPtr = inBuf;
-				inLen = input.readBuffer(inBuf, ARRAYSIZE(inBuf));
+				inLen = nextInputBlock(input, inPtr, inBuf, ARRAYSIZE(inBuf), inPeeked);
 				if (inLen <= 0)
 					return (obuf - ostart) / 2;
 			}
@@ -144,10 +199,10 @@ int SimpleRateConverter<stereo, reverseStereo>::flow(AudioStream &input, st_samp
 		opos += opos_inc;
 
 		// output left channel
-		clampedAdd(obuf[reverseStereo    ], (out0 * (int)vol_l) / Audio::Mixer::kMaxMixerVolume);
+		mixSample(obuf[reverseStereo    ], (out0 * (int)vol_l) / Audio::Mixer::kMaxMixerVolume);
 
 		// output right channel
-		clampedAdd(obuf[reverseStereo ^ 1], (out1 * (int)vol_r) / Audio::Mixer::kMaxMixerVolume);
+		mixSample(obuf[reverseStereo ^ 1], (out1 * (int)vol_r) / Audio::Mixer::kMaxMixerVolume);
 
 		obuf += 2;
 	}
@@ -171,6 +226,8 @@ protected:
 	st_sample_t inBuf[INTERMEDIATE_BUFFER_SIZE];
 	const st_sample_t *inPtr;
 	int inLen;
+	/** number of samples used in place, still to be consumed */
+	int inPeeked;
 
 	/** fractional position of the output stream in input stream unit */
 	frac_t opos;
@@ -183,9 +240,17 @@ protected:
 	/** current sample(s) in the input stream (left/right channel) */
 	st_sample_t icur0, icur1;
 
+	template<typename Sample>
+	int doFlow(AudioStream &input, Sample *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r);
+
 public:
 	LinearRateConverter(st_rate_t inrate, st_rate_t outrate);
-	int flow(AudioStream &input, st_sample_t *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r);
+	int flow(AudioStream &input, st_sample_t *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r) {
+		return doFlow(input, obuf, osamp, vol_l, vol_r);
+	}
+	int flowAccumulate(AudioStream &input, int32 *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r) {
+		return doFlow(input, obuf, osamp, vol_l, vol_r);
+	}
 	int drain(st_sample_t *obuf, st_size_t osamp, st_volume_t vol) {
 		return ST_SUCCESS;
 	}
@@ -214,6 +279,7 @@ LinearRateConverter<stereo, reverseStereo>::LinearRateConverter(st_rate_t inrate
 	icur0 = icur1 = 0;
 
 	inLen = 0;
+	inPeeked = 0;
 }
 
 /*
@@ -221,8 +287,9 @@ LinearRateConverter<stereo, reverseStereo>::LinearRateConverter(st_rate_t inrate
  * Return number of sample pairs processed.
  */
 template<bool stereo, bool reverseStereo>
-int LinearRateConverter<stereo, reverseStereo>::flow(AudioStream &input, st_sample_t *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r) {
-	st_sample_t *ostart, *oend;
+template<typename Sample>
+int LinearRateConverter<stereo, reverseStereo>::doFlow(AudioStream &input, Sample *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r) {
+	Sample *ostart, *oend;
 
 	ostart = obuf;
 	oend = obuf + osamp * 2;
@@ -233,8 +300,7 @@ int LinearRateConverter<stereo, reverseStereo>::flow(AudioStream &input, st_samp
 		while ((frac_t)FRAC_ONE_LOW <= opos) {
 			// Check if we have to refill the buffer
 			if (inLen == 0) {
-				inPtr = inBuf;
-				inLen = input.readBuffer(inBuf, ARRAYSIZE(inBuf));
+				inLen = nextInputBlock(input, inPtr, inBuf, ARRAYSIZE(inBuf), inPeeked);
 				if (inLen <= 0)
 					return (obuf - ostart) / 2;
 			}
@@ -259,10 +325,10 @@ int LinearRateConverter<stereo, reverseStereo>::flow(AudioStream &input, st_samp
 						  out0);
 
 			// output left channel
-			clampedAdd(obuf[reverseStereo    ], (out0 * (int)vol_l) / Audio::Mixer::kMaxMixerVolume);
+			mixSample(obuf[reverseStereo    ], (out0 * (int)vol_l) / Audio::Mixer::kMaxMixerVolume);
 
 			// output right channel
-			clampedAdd(obuf[reverseStereo ^ 1], (out1 * (int)vol_r) / Audio::Mixer::kMaxMixerVolume);
+			mixSample(obuf[reverseStereo ^ 1], (out1 * (int)vol_r) / Audio::Mixer::kMaxMixerVolume);
 
 			obuf += 2;
 
@@ -291,59 +357,413 @@ public:
 	}
 
 	virtual int flow(AudioStream &input, st_sample_t *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r) {
+		return doFlow(input, obuf, osamp, vol_l, vol_r);
+	}
+
+	virtual int flowAccumulate(AudioStream &input, int32 *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r) {
+		return doFlow(input, obuf, osamp, vol_l, vol_r);
+	}
+
+	virtual int drain(st_sample_t *obuf, st_size_t osamp, st_volume_t vol) {
+		return ST_SUCCESS;
+	}
+
+private:
+	template<typename Sample>
+	int doFlow(AudioStream &input, Sample *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r) {
 		assert(input.isStereo() == stereo);
 
-		st_sample_t *ptr;
-		st_size_t len;
+		const st_sample_t *ptr;
+		int len;
 
-		st_sample_t *ostart = obuf;
+		Sample *ostart = obuf;
 
 		if (stereo)
 			osamp *= 2;
 
-		// Reallocate temp buffer, if necessary
-		if (osamp > _bufferSize) {
-			free(_buffer);
-			_buffer = (st_sample_t *)malloc(osamp * 2);
-			_bufferSize = osamp;
-		}
+		while (osamp > 0) {
+			// Use the samples of the stream in place, if possible
+			len = input.peekBuffer(ptr);
+			const bool peeked = (len > 0);
+
+			if (peeked) {
+				len = MIN<int>(len, osamp);
+			} else {
+				// Reallocate temp buffer, if necessary
+				if (osamp > _bufferSize) {
+					free(_buffer);
+					_buffer = (st_sample_t *)malloc(osamp * 2);
+					_bufferSize = osamp;
+				}
+
+				if (!_buffer)
+					error("[CopyRateConverter::flow] Cannot allocate memory for temp buffer");
+
+				// Read up to 'osamp' samples into our temporary buffer
+				len = input.readBuffer(_buffer, osamp);
+				if (len <= 0)
+					break;
+				ptr = _buffer;
+			}
 
-		if (!_buffer)
-			error("[CopyRateConverter::flow] Cannot allocate memory for temp buffer");
+			osamp -= len;
 
-		// Read up to 'osamp' samples into our temporary buffer
-		len = input.readBuffer(_buffer, osamp);
+			// Mix the data into the output buffer
+			for (int i = len; i > 0; i -= (stereo ? 2 : 1)) {
+				st_sample_t out0, out1;
+				out0 = *ptr++;
+				out1 = (stereo ? *ptr++ : out0);
 
-		// Mix the data into the output buffer
-		ptr = _buffer;
-		for (; len > 0; len -= (stereo ? 2 : 1)) {
-			st_sample_t out0, out1;
-			out0 = *ptr++;
-			out1 = (stereo ? *ptr++ : out0);
+				// output left channel
+				mixSample(obuf[reverseStereo    ], (out0 * (int)vol_l) / Audio::Mixer::kMaxMixerVolume);
 
-			// output left channel
-			clampedAdd(obuf[reverseStereo    ], (out0 * (int)vol_l) / Audio::Mixer::kMaxMixerVolume);
+				// output right channel
+				mixSample(obuf[reverseStereo ^ 1], (out1 * (int)vol_r) / Audio::Mixer::kMaxMixerVolume);
 
-			// output right channel
-			clampedAdd(obuf[reverseStereo ^ 1], (out1 * (int)vol_r) / Audio::Mixer::kMaxMixerVolume);
+				obuf += 2;
+			}
 
-			obuf += 2;
+			if (peeked)
+				input.consumeBuffer(len);
+			else
+				break;
 		}
 		return (obuf - ostart) / 2;
 	}
+};
 
-	virtual int drain(st_sample_t *obuf, st_size_t osamp, st_volume_t vol) {
+
+#pragma mark -
+
+/**
+ * Computes the dot product of two int16 vectors. The length must be a
+ * multiple of 8.
+ */
+static inline int dotProduct(const int16 *a, const int16 *b, uint len) {
+#if defined(AUDIO_MIX_SSE2)
+	__m128i acc = _mm_setzero_si128();
+	for (uint i = 0; i < len; i += 8)
+		acc = _mm_add_epi32(acc, _mm_madd_epi16(_mm_loadu_si128((const __m128i *)(a + i)), _mm_loadu_si128((const __m128i *)(b + i))));
+	acc = _mm_add_epi32(acc, _mm_shuffle_epi32(acc, _MM_SHUFFLE(1, 0, 3, 2)));
+	acc = _mm_add_epi32(acc, _mm_shuffle_epi32(acc, _MM_SHUFFLE(2, 3, 0, 1)));
+	return _mm_cvtsi128_si32(acc);
+#elif defined(AUDIO_MIX_NEON)
+	int32x4_t acc = vdupq_n_s32(0);
+	for (uint i = 0; i < len; i += 4)
+		acc = vmlal_s16(acc, vld1_s16(a + i), vld1_s16(b + i));
+	int32x2_t sum = vadd_s32(vget_low_s32(acc), vget_high_s32(acc));
+	return vget_lane_s32(vpadd_s32(sum, sum), 0);
+#else
+	int acc = 0;
+	for (uint i = 0; i < len; ++i)
+		acc += a[i] * b[i];
+	return acc;
+#endif
+}
+
+/**
+ * Zeroth order modified Bessel function of the first kind, used for the
+ * Kaiser window.
+ */
+static double besselI0(double x) {
+	double sum = 1.0, term = 1.0;
+	const double halfX = x / 2.0;
+
+	for (int k = 1; k < 50 && term > sum * 1e-12; ++k) {
+		term *= (halfX / k) * (halfX / k);
+		sum += term;
+	}
+
+	return sum;
+}
+
+/**
+ * Band-limited audio rate converter based on a polyphase windowed sinc
+ * filter.
+ *
+ * The ratio between the rates is reduced to L/M (output/input). When L is
+ * at most kMaxPhases, as for 44100 <-> 48000 Hz (L = 160 or 147) or rates
+ * which are multiples of each other, a set of filter taps is kept for every
+ * phase, so the conversion is exact. Otherwise, e.g. for 22050 -> 48000 Hz
+ * (L = 320) or 11025 -> 48000 Hz (L = 640), the phase is truncated to one
+ * of kMaxPhases equally spaced precomputed ones.
+ *
+ * Input is read in blocks and deinterleaved into one history buffer per
+ * channel, so that every output sample is a dot product of contiguous
+ * samples and filter taps. At the end of the stream the history is padded
+ * with silence, so the output covers the input up to its last sample.
+ */
+template<bool stereo, bool reverseStereo>
+class SincRateConverter : public RateConverter {
+protected:
+	enum {
+		kMaxPhases = 256,
+		kZeroCrossings = 8,
+		kCoeffBits = 14,
+		kBlockSize = INTERMEDIATE_BUFFER_SIZE
+	};
+
+	st_sample_t inBuf[kBlockSize * (stereo ? 2 : 1)];
+
+	/** number of filter taps per phase, a multiple of 8 */
+	uint taps;
+	/** number of phases in the filter bank */
+	uint numPhases;
+	/** filter bank, numPhases * taps coefficients */
+	int16 *coeffs;
+
+	/** output and input step of the reduced ratio (L/M) */
+	uint32 outStep, inStep;
+	/** current phase, always < outStep */
+	uint32 phase;
+
+	/** deinterleaved input samples (left/right channel) */
+	int16 *history[2];
+	/** size of each history buffer */
+	uint capacity;
+	/** index of the first sample used for the next output sample */
+	uint pos;
+	/** number of valid samples in the history buffers */
+	uint len;
+	/** whether the end of the stream has been padded with silence */
+	bool flushed;
+
+	bool refill(AudioStream &input);
+
+	template<typename Sample>
+	int doFlow(AudioStream &input, Sample *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r);
+
+public:
+	SincRateConverter(st_rate_t inrate, st_rate_t outrate);
+	~SincRateConverter();
+
+	int flow(AudioStream &input, st_sample_t *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r) {
+		return doFlow(input, obuf, osamp, vol_l, vol_r);
+	}
+	int flowAccumulate(AudioStream &input, int32 *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r) {
+		return doFlow(input, obuf, osamp, vol_l, vol_r);
+	}
+	int drain(st_sample_t *obuf, st_size_t osamp, st_volume_t vol) {
 		return ST_SUCCESS;
 	}
+	bool hasPendingOutput() const {
+		return !flushed || pos + taps <= len;
+	}
 };
 
+/*
+ * Prepare processing.
+ */
+template<bool stereo, bool reverseStereo>
+SincRateConverter<stereo, reverseStereo>::SincRateConverter(st_rate_t inrate, st_rate_t outrate) {
+	const st_rate_t div = Common::gcd(inrate, outrate);
+	outStep = outrate / div;
+	inStep = inrate / div;
+	phase = 0;
+
+	numPhases = MIN<uint>(outStep, kMaxPhases);
+
+	// When downsampling, the cutoff has to be lowered to the output Nyquist
+	// frequency, which requires a proportionally longer filter. Keep some
+	// room for the transition band in either case.
+	const double cutoff = 0.9 * MIN(1.0, (double)outrate / inrate);
+	const uint halfTaps = (uint)ceil(kZeroCrossings / cutoff);
+	taps = (2 * halfTaps + 7) & ~7;
+
+	const double halfWidth = taps / 2;
+	const double beta = 8.0;
+	const double windowScale = 1.0 / besselI0(beta);
+
+	coeffs = new int16[numPhases * taps];
+	double *filter = new double[taps];
+	for (uint p = 0; p < numPhases; ++p) {
+		// The output sample lies between the taps taps/2-1 and taps/2,
+		// at this fractional offset
+		const double frac = (double)p / numPhases;
+
+		double sum = 0.0;
+		for (uint k = 0; k < taps; ++k) {
+			const double d = k - (halfWidth - 1) - frac;
+			const double r = d / halfWidth;
+			if (r <= -1.0 || r >= 1.0) {
+				filter[k] = 0.0;
+				continue;
+			}
+
+			const double x = M_PI * cutoff * d;
+			const double sinc = (d == 0.0) ? 1.0 : sin(x) / x;
+			filter[k] = cutoff * sinc * besselI0(beta * sqrt(1.0 - r * r)) * windowScale;
+			sum += filter[k];
+		}
+
+		// Normalize each phase to unity gain, and put the rounding error
+		// into the center tap so DC passes through unchanged
+		int16 *c = coeffs + p * taps;
+		int total = 0;
+		for (uint k = 0; k < taps; ++k) {
+			c[k] = (int16)floor(filter[k] / sum * (1 << kCoeffBits) + 0.5);
+			total += c[k];
+		}
+		c[taps / 2 - 1 + (frac >= 0.5 ? 1 : 0)] += (1 << kCoeffBits) - total;
+	}
+	delete[] filter;
+
+	capacity = taps + kBlockSize;
+	history[0] = new int16[capacity * (stereo ? 2 : 1)];
+	history[1] = stereo ? history[0] + capacity : history[0];
+
+	// Start with silence before the first sample, so that the first output
+	// sample corresponds to the first input sample.
+	pos = 0;
+	len = taps / 2 - 1;
+	flushed = false;
+	memset(history[0], 0, capacity * (stereo ? 2 : 1) * sizeof(int16));
+}
+
+template<bool stereo, bool reverseStereo>
+SincRateConverter<stereo, reverseStereo>::~SincRateConverter() {
+	delete[] coeffs;
+	delete[] history[0];
+}
+
+/*
+ * Drop the samples which are no longer needed and read a new block of
+ * input. Returns false if no input was available.
+ */
+template<bool stereo, bool reverseStereo>
+bool SincRateConverter<stereo, reverseStereo>::refill(AudioStream &input) {
+	if (pos >= len) {
+		// When downsampling, the filter may advance past input which has
+		// not been read yet. Skip it.
+		pos -= len;
+		len = 0;
+		while (pos > 0) {
+			const st_sample_t *in;
+			const int maxSamples = MIN<uint>(pos, kBlockSize) * (stereo ? 2 : 1);
+			int skipped = input.peekBuffer(in);
+			if (skipped > 0) {
+				skipped = MIN(skipped, maxSamples);
+				input.consumeBuffer(skipped);
+			} else {
+				skipped = input.readBuffer(inBuf, maxSamples);
+				if (skipped <= 0)
+					return false;
+			}
+			pos -= skipped / (stereo ? 2 : 1);
+		}
+	} else if (pos > 0) {
+		len -= pos;
+		memmove(history[0], history[0] + pos, len * sizeof(int16));
+		if (stereo)
+			memmove(history[1], history[1] + pos, len * sizeof(int16));
+		pos = 0;
+	}
+
+	const int maxSamples = MIN<uint>(kBlockSize, capacity - len) * (stereo ? 2 : 1);
+
+	// Deinterleave straight from the stream's buffer, if possible
+	const st_sample_t *in;
+	int read = input.peekBuffer(in);
+	const bool peeked = (read > 0);
+	if (peeked) {
+		read = MIN(read, maxSamples);
+	} else {
+		read = input.readBuffer(inBuf, maxSamples);
+		if (read <= 0)
+			return false;
+		in = inBuf;
+	}
+
+	const int frames = read / (stereo ? 2 : 1);
+	int16 *left = history[0] + len;
+	if (stereo) {
+		int16 *right = history[1] + len;
+		for (int i = 0; i < frames; ++i) {
+			*left++ = *in++;
+			*right++ = *in++;
+		}
+	} else {
+		memcpy(left, in, frames * sizeof(int16));
+	}
+	len += frames;
+
+	if (peeked)
+		input.consumeBuffer(read);
+
+	return true;
+}
+
+/*
+ * Processed signed long samples from ibuf to obuf.
+ * Return number of sample pairs processed.
+ */
+template<bool stereo, bool reverseStereo>
+template<typename Sample>
+int SincRateConverter<stereo, reverseStereo>::doFlow(AudioStream &input, Sample *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r) {
+	Sample *ostart, *oend;
+
+	ostart = obuf;
+	oend = obuf + osamp * 2;
+
+	while (obuf < oend) {
+		// Make sure the whole filter window is available
+		if (pos + taps > len) {
+			if (refill(input))
+				continue;
+			if (flushed || !input.endOfStream())
+				break;
+
+			// The stream has ended. Pad it with silence for the second half
+			// of the filter, to output the samples up to its last one.
+			// refill() dropped the used samples, so there is enough room.
+			if (pos < len) {
+				assert(len + taps / 2 <= capacity);
+				memset(history[0] + len, 0, taps / 2 * sizeof(int16));
+				if (stereo)
+					memset(history[1] + len, 0, taps / 2 * sizeof(int16));
+				len += taps / 2;
+			}
+			flushed = true;
+			continue;
+		}
+
+		const int16 *c = coeffs + ((phase * numPhases) / outStep) * taps;
+
+		int out0 = (dotProduct(history[0] + pos, c, taps) + (1 << (kCoeffBits - 1))) >> kCoeffBits;
+		out0 = CLIP<int>(out0, ST_SAMPLE_MIN, ST_SAMPLE_MAX);
+		int out1 = out0;
+		if (stereo) {
+			out1 = (dotProduct(history[1] + pos, c, taps) + (1 << (kCoeffBits - 1))) >> kCoeffBits;
+			out1 = CLIP<int>(out1, ST_SAMPLE_MIN, ST_SAMPLE_MAX);
+		}
+
+		// output left channel
+		mixSample(obuf[reverseStereo    ], (out0 * (int)vol_l) / Audio::Mixer::kMaxMixerVolume);
+
+		// output right channel
+		mixSample(obuf[reverseStereo ^ 1], (out1 * (int)vol_r) / Audio::Mixer::kMaxMixerVolume);
+
+		obuf += 2;
+
+		// Increment output position
+		phase += inStep;
+		if (phase >= outStep) {
+			pos += phase / outStep;
+			phase %= outStep;
+		}
+	}
+	return (obuf - ostart) / 2;
+}
+
 
 #pragma mark -
 
 template<bool stereo, bool reverseStereo>
-RateConverter *makeRateConverter(st_rate_t inrate, st_rate_t outrate) {
+RateConverter *makeRateConverter(st_rate_t inrate, st_rate_t outrate, ResamplerQuality quality) {
 	if (inrate != outrate) {
-		if ((inrate % outrate) == 0 && (inrate < 65536)) {
+		if (quality == kResamplerSinc) {
+			return new SincRateConverter<stereo, reverseStereo>(inrate, outrate);
+		} else if ((inrate % outrate) == 0 && (inrate < 65536)) {
 			return new SimpleRateConverter<stereo, reverseStereo>(inrate, outrate);
 		} else {
 			return new LinearRateConverter<stereo, reverseStereo>(inrate, outrate);
@@ -356,14 +776,14 @@ RateConverter *makeRateConverter(st_rate_t inrate, st_rate_t outrate) {
 /**
  * Create and return a RateConverter object for the specified input and output rates.
  */
-RateConverter *makeRateConverter(st_rate_t inrate, st_rate_t outrate, bool stereo, bool reverseStereo) {
+RateConverter *makeRateConverter(st_rate_t inrate, st_rate_t outrate, bool stereo, bool reverseStereo, ResamplerQuality quality) {
 	if (stereo) {
 		if (reverseStereo)
-			return makeRateConverter<true, true>(inrate, outrate);
+			return makeRateConverter<true, true>(inrate, outrate, quality);
 		else
-			return makeRateConverter<true, false>(inrate, outrate);
+			return makeRateConverter<true, false>(inrate, outrate, quality);
 	} else
-		return makeRateConverter<false, false>(inrate, outrate);
+		return makeRateConverter<false, false>(inrate, outrate, quality);
 }
 
 } // End of namespace Audio
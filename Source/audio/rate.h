@@ -24,6 +24,15 @@
 #define AUDIO_RATE_H
 
 #include "common/scummsys.h"
+#include "common/util.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define AUDIO_MIX_SSE2
+#include <emmintrin.h>
+#elif defined(__ARM_NEON__) || defined(__ARM_NEON)
+#define AUDIO_MIX_NEON
+#include <arm_neon.h>
+#endif
 
 namespace Audio {
 
@@ -65,6 +74,60 @@ static inline void clampedAdd(int16& a, int b) {
 #endif
 }
 
+/**
+ * Saturate a buffer of 32-bit mixing sums (as filled by
+ * RateConverter::flowAccumulate) into 16-bit output samples.
+ *
+ * This replaces a clampedAdd per channel and sample by a single clamping
+ * pass over the final mix, which uses SSE2 or NEON when available.
+ *
+ * @param src   accumulated samples
+ * @param dst   output samples
+ * @param count number of samples (not sample pairs) to convert
+ */
+static inline void clampMixBuffer(const int32 *src, st_sample_t *dst, uint count) {
+#if defined(AUDIO_MIX_SSE2)
+#ifdef OUTPUT_UNSIGNED_AUDIO
+	const __m128i signFlip = _mm_set1_epi16((short)0x8000);
+#endif
+	for (; count >= 8; count -= 8, src += 8, dst += 8) {
+		__m128i lo = _mm_loadu_si128((const __m128i *)src);
+		__m128i hi = _mm_loadu_si128((const __m128i *)(src + 4));
+		__m128i out = _mm_packs_epi32(lo, hi);
+#ifdef OUTPUT_UNSIGNED_AUDIO
+		out = _mm_xor_si128(out, signFlip);
+#endif
+		_mm_storeu_si128((__m128i *)dst, out);
+	}
+#elif defined(AUDIO_MIX_NEON)
+#ifdef OUTPUT_UNSIGNED_AUDIO
+	const int16x8_t signFlip = vdupq_n_s16((int16)0x8000);
+#endif
+	for (; count >= 8; count -= 8, src += 8, dst += 8) {
+		int16x8_t out = vcombine_s16(vqmovn_s32(vld1q_s32(src)), vqmovn_s32(vld1q_s32(src + 4)));
+#ifdef OUTPUT_UNSIGNED_AUDIO
+		out = veorq_s16(out, signFlip);
+#endif
+		vst1q_s16(dst, out);
+	}
+#endif
+
+	for (; count > 0; --count) {
+		int val = *src++;
+
+		if (val > ST_SAMPLE_MAX)
+			val = ST_SAMPLE_MAX;
+		else if (val < ST_SAMPLE_MIN)
+			val = ST_SAMPLE_MIN;
+
+#ifdef OUTPUT_UNSIGNED_AUDIO
+		*dst++ = ((int16)val) ^ 0x8000;
+#else
+		*dst++ = val;
+#endif
+	}
+}
+
 class RateConverter {
 public:
 	RateConverter() {}
@@ -75,10 +138,58 @@ public:
 	 */
 	virtual int flow(AudioStream &input, st_sample_t *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r) = 0;
 
+	/**
+	 * Like flow(), but adds the samples into a 32-bit buffer without
+	 * clamping them. Use clampMixBuffer() to produce the final output.
+	 *
+	 * The default implementation goes through flow() using a temporary
+	 * buffer; converters should override it with a direct version.
+	 *
+	 * @return Number of sample pairs written into the buffer.
+	 */
+	virtual int flowAccumulate(AudioStream &input, int32 *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r) {
+		st_sample_t tmp[512];
+		int total = 0;
+
+		while (osamp > 0) {
+			const st_size_t chunk = MIN<st_size_t>(osamp, ARRAYSIZE(tmp) / 2);
+			memset(tmp, 0, chunk * 2 * sizeof(st_sample_t));
+
+			const int res = flow(input, tmp, chunk, vol_l, vol_r);
+			for (int i = 0; i < res * 2; ++i)
+				*obuf++ += tmp[i];
+
+			total += res;
+			if (res < (int)chunk)
+				break;
+			osamp -= chunk;
+		}
+
+		return total;
+	}
+
 	virtual int drain(st_sample_t *obuf, st_size_t osamp, st_volume_t vol) = 0;
+
+	/**
+	 * Check whether the converter holds input which it has not output yet,
+	 * e.g. in a filter history. Such a converter has to be flowed after
+	 * the end of its stream, until this returns false.
+	 */
+	virtual bool hasPendingOutput() const { return false; }
+};
+
+/**
+ * Interpolation used by rate converters when the input and output rates
+ * differ.
+ */
+enum ResamplerQuality {
+	/** Nearest neighbor or linear interpolation. Fast, but prone to aliasing. */
+	kResamplerLinear,
+	/** Band-limited interpolation using a windowed sinc filter. */
+	kResamplerSinc
 };
 
-RateConverter *makeRateConverter(st_rate_t inrate, st_rate_t outrate, bool stereo, bool reverseStereo = false);
+RateConverter *makeRateConverter(st_rate_t inrate, st_rate_t outrate, bool stereo, bool reverseStereo = false, ResamplerQuality quality = kResamplerLinear);
 
 } // End of namespace Audio
 
@@ -0,0 +1,104 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "common/atomic.h"
+#include "common/util.h"
+
+#include "audio/ringbuffer.h"
+
+namespace Audio {
+
+SampleRingBuffer::SampleRingBuffer()
+	: _data(nullptr), _size(0), _readPos(0), _writePos(0) {
+}
+
+SampleRingBuffer::~SampleRingBuffer() {
+	free();
+}
+
+void SampleRingBuffer::allocate(uint32 minSize) {
+	free();
+
+	_size = 1;
+	while (_size < minSize)
+		_size <<= 1;
+	_data = new int16[_size];
+}
+
+void SampleRingBuffer::free() {
+	delete[] _data;
+	_data = nullptr;
+	_size = 0;
+	_readPos = _writePos = 0;
+}
+
+uint32 SampleRingBuffer::getBuffered() const {
+#ifdef SCUMMVM_HAS_ATOMICS
+	return _writePos - Common::loadAcquire(&_readPos);
+#else
+	return _writePos - _readPos;
+#endif
+}
+
+int16 *SampleRingBuffer::beginWrite(uint32 numSamples) {
+	const uint32 offset = _writePos & (_size - 1);
+	assert(offset + numSamples <= _size);
+	assert(getBuffered() + numSamples <= _size);
+	return _data + offset;
+}
+
+void SampleRingBuffer::endWrite(uint32 numSamples) {
+#ifdef SCUMMVM_HAS_ATOMICS
+	Common::storeRelease(&_writePos, _writePos + numSamples);
+#else
+	_writePos += numSamples;
+#endif
+}
+
+uint32 SampleRingBuffer::read(int16 *data, uint32 numSamples) {
+	uint32 readPos = _readPos;
+#ifdef SCUMMVM_HAS_ATOMICS
+	const uint32 available = Common::loadAcquire(&_writePos) - readPos;
+#else
+	const uint32 available = _writePos - readPos;
+#endif
+	numSamples = MIN(numSamples, available);
+
+	uint32 len = numSamples;
+	while (len > 0) {
+		const uint32 offset = readPos & (_size - 1);
+		const uint32 chunk = MIN(len, _size - offset);
+		memcpy(data, _data + offset, chunk * sizeof(int16));
+		data += chunk;
+		readPos += chunk;
+		len -= chunk;
+	}
+
+#ifdef SCUMMVM_HAS_ATOMICS
+	Common::storeRelease(&_readPos, readPos);
+#else
+	_readPos = readPos;
+#endif
+	return numSamples;
+}
+
+} // End of namespace Audio
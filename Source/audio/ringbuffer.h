@@ -0,0 +1,100 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef AUDIO_RINGBUFFER_H
+#define AUDIO_RINGBUFFER_H
+
+#include "common/scummsys.h"
+
+namespace Audio {
+
+/**
+ * A ring buffer of samples shared by one producer and one consumer.
+ *
+ * The producer renders samples in place into the buffer between beginWrite
+ * and endWrite, the consumer takes them out with read. Both positions count
+ * samples and only ever increase, the buffer size is a power of two.
+ *
+ * Where SCUMMVM_HAS_ATOMICS is defined (see common/atomic.h), the producer
+ * and the consumer may run in different threads without locking. Otherwise
+ * the caller has to serialize all accesses.
+ */
+class SampleRingBuffer {
+public:
+	SampleRingBuffer();
+	~SampleRingBuffer();
+
+	/**
+	 * Allocate the buffer, discarding any samples buffered.
+	 *
+	 * @param minSize  minimal number of samples to hold, rounded up to a
+	 *                 power of two
+	 */
+	void allocate(uint32 minSize);
+
+	/** Free the buffer. */
+	void free();
+
+	/** Number of samples the buffer can hold. */
+	uint32 size() const { return _size; }
+
+	/** Number of samples buffered, as seen by the producer. */
+	uint32 getBuffered() const;
+
+	/**
+	 * Get the space for writing the next samples. The samples must not wrap
+	 * around the end of the buffer nor exceed its free space, which holds
+	 * when writing chunks of a constant size dividing the buffer size.
+	 *
+	 * @param numSamples  number of samples to write
+	 * @return pointer to write the samples to
+	 */
+	int16 *beginWrite(uint32 numSamples);
+
+	/**
+	 * Make samples written at the pointer returned by beginWrite available
+	 * to the consumer.
+	 *
+	 * @param numSamples  number of samples written
+	 */
+	void endWrite(uint32 numSamples);
+
+	/**
+	 * Take samples out of the buffer.
+	 *
+	 * @param data        buffer to copy the samples to
+	 * @param numSamples  maximum number of samples to copy
+	 * @return number of samples copied, less than numSamples if the buffer
+	 *         runs empty
+	 */
+	uint32 read(int16 *data, uint32 numSamples);
+
+private:
+	int16 *_data;
+	uint32 _size;
+	volatile uint32 _readPos;
+	volatile uint32 _writePos;
+};
+
+} // End of namespace Audio
+
+#endif
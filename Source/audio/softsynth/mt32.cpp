@@ -28,6 +28,7 @@
 #include "audio/softsynth/emumidi.h"
 #include "audio/musicplugin.h"
 #include "audio/mpu401.h"
+#include "audio/ringbuffer.h"
 
 #include "common/config-manager.h"
 #include "common/debug.h"
@@ -37,9 +38,11 @@
 #include "common/system.h"
 #include "common/util.h"
 #include "common/archive.h"
+#include "common/atomic.h"
 #include "common/textconsole.h"
 #include "common/translation.h"
 #include "common/osd_message_queue.h"
+#include "common/timer.h"
 
 #include "graphics/fontman.h"
 #include "graphics/surface.h"
@@ -113,6 +116,24 @@ private:
 
 	int _outputRate;
 
+	// Render ahead support. The ring buffer is filled by a timer proc and
+	// drained by readBuffer.
+	enum {
+		/** Interval in which the ring buffer is refilled, in microseconds */
+		kRenderAheadInterval = 10000,
+		/** Number of samples rendered at once, a power of two */
+		kRenderChunkSize = 512
+	};
+
+	bool _renderAhead;
+	Common::Mutex _renderMutex;         ///< Held while samples are generated
+	Audio::SampleRingBuffer _ring;
+	uint32 _ringTarget;                 ///< Number of samples to render ahead
+	uint32 _underruns;                  ///< Number of readBuffer calls the renderer did not keep up with
+
+	void fillRing();
+	static void renderAheadProc(void *refCon);
+
 protected:
 	void generateSamples(int16 *buf, int len);
 
@@ -131,6 +152,7 @@ public:
 	MidiChannel *getPercussionChannel();
 
 	// AudioStream API
+	int readBuffer(int16 *data, const int numSamples);
 	bool isStereo() const { return true; }
 	int getRate() const { return _outputRate; }
 };
@@ -150,6 +172,9 @@ MidiDriver_MT32::MidiDriver_MT32(Audio::Mixer *mixer) : MidiDriver_Emulated(mixe
 	_outputRate = 0;
 	_controlData = nullptr;
 	_pcmData = nullptr;
+	_renderAhead = false;
+	_ringTarget = 0;
+	_underruns = 0;
 }
 
 MidiDriver_MT32::~MidiDriver_MT32() {
@@ -221,8 +246,22 @@ int MidiDriver_MT32::open() {
 
 	MidiDriver_Emulated::open();
 
+	// Optionally render ahead from a timer proc, which takes the synthesis
+	// out of the audio callback at the cost of the given latency
+	const int renderAheadMs = ConfMan.getInt("mt32_render_ahead");
+	if (renderAheadMs > 0) {
+		_ringTarget = MAX<uint32>(_outputRate * renderAheadMs / 1000 * 2, kRenderChunkSize);
+		_ringTarget = (_ringTarget + kRenderChunkSize - 1) & ~(kRenderChunkSize - 1);
+		_ring.allocate(_ringTarget * 2);
+		_underruns = 0;
+		_renderAhead = true;
+	}
+
 	_mixer->playStream(Audio::Mixer::kPlainSoundType, &_mixerSoundHandle, this, -1, Audio::Mixer::kMaxChannelVolume, 0, DisposeAfterUse::NO, true);
 
+	if (_renderAhead)
+		g_system->getTimerManager()->installTimerProc(renderAheadProc, kRenderAheadInterval, this, "MT32RenderAhead");
+
 	return 0;
 }
 
@@ -268,9 +307,18 @@ void MidiDriver_MT32::close() {
 
 	// Detach the player callback handler
 	setTimerCallback(NULL, NULL);
-	// Detach the mixer callback handler
+	// Detach the render ahead and mixer callback handlers
+	if (_renderAhead) {
+		g_system->getTimerManager()->removeTimerProc(renderAheadProc);
+		debug(1, "MT-32 renderer: %u underruns", _underruns);
+	}
 	_mixer->stopHandle(_mixerSoundHandle);
 
+	if (_renderAhead) {
+		_renderAhead = false;
+		_ring.free();
+	}
+
 	Common::StackLock lock(_mutex);
 	_service.closeSynth();
 	_service.freeContext();
@@ -285,6 +333,48 @@ void MidiDriver_MT32::generateSamples(int16 *data, int len) {
 	_service.renderBit16s(data, len);
 }
 
+int MidiDriver_MT32::readBuffer(int16 *data, const int numSamples) {
+	if (!_renderAhead)
+		return MidiDriver_Emulated::readBuffer(data, numSamples);
+
+	uint32 len = 0;
+#ifdef SCUMMVM_HAS_ATOMICS
+	// Usually the renderer is ahead and the samples can be taken from the
+	// ring buffer without locking
+	len = _ring.read(data, numSamples);
+	if (len == (uint32)numSamples)
+		return numSamples;
+#endif
+
+	Common::StackLock lock(_renderMutex);
+
+	// The renderer might have caught up while waiting for the lock. All
+	// samples left in the ring buffer precede the ones generated here.
+	len += _ring.read(data + len, numSamples - len);
+	if (len < (uint32)numSamples) {
+		++_underruns;
+		MidiDriver_Emulated::readBuffer(data + len, numSamples - len);
+	}
+
+	return numSamples;
+}
+
+void MidiDriver_MT32::fillRing() {
+	Common::StackLock lock(_renderMutex);
+
+	// Chunks never wrap around, as the ring size is a multiple of the chunk
+	// size. The MIDI player callbacks are invoked from here at the right
+	// positions.
+	while (_ring.getBuffered() < _ringTarget) {
+		MidiDriver_Emulated::readBuffer(_ring.beginWrite(kRenderChunkSize), kRenderChunkSize);
+		_ring.endWrite(kRenderChunkSize);
+	}
+}
+
+void MidiDriver_MT32::renderAheadProc(void *refCon) {
+	static_cast<MidiDriver_MT32 *>(refCon)->fillRing();
+}
+
 uint32 MidiDriver_MT32::property(int prop, uint32 param) {
 	switch (prop) {
 	case PROP_CHANNEL_MASK:
@@ -184,7 +184,7 @@ void OPL::reset() {
 	init();
 }
 
-void OPL::write(int port, int val) {
+void OPL::writeImpl(int port, int val) {
 	if (port&1) {
 		switch (_type) {
 		case Config::kOpl2:
@@ -228,7 +228,7 @@ void OPL::write(int port, int val) {
 	}
 }
 
-byte OPL::read(int port) {
+byte OPL::readImpl(int port) {
 	switch (_type) {
 	case Config::kOpl2:
 		if (!(port & 1))
@@ -249,7 +249,7 @@ byte OPL::read(int port) {
 	return 0;
 }
 
-void OPL::writeReg(int r, int v) {
+void OPL::writeRegImpl(int r, int v) {
 	int tempReg = 0;
 	switch (_type) {
 	case Config::kOpl2:
@@ -265,21 +265,21 @@ void OPL::writeReg(int r, int v) {
 		if (_type == Config::kOpl3 && r >= 0x100) {
 			// We need to set the register we want to write to via port 0x222,
 			// since we want to write to the secondary register set.
-			write(0x222, r);
+			writeImpl(0x222, r);
 			// Do the real writing to the register
-			write(0x223, v);
+			writeImpl(0x223, v);
 		} else {
 			// We need to set the register we want to write to via port 0x388
-			write(0x388, r);
+			writeImpl(0x388, r);
 			// Do the real writing to the register
-			write(0x389, v);
+			writeImpl(0x389, v);
 		}
 
 		// Restore the old register
 		if (_type == Config::kOpl3 && tempReg >= 0x100) {
-			write(0x222, tempReg & ~0x100);
+			writeImpl(0x222, tempReg & ~0x100);
 		} else {
-			write(0x388, tempReg);
+			writeImpl(0x388, tempReg);
 		}
 		break;
 	};
@@ -90,14 +90,13 @@ public:
 	bool init();
 	void reset();
 
-	void write(int a, int v);
-	byte read(int a);
-
-	void writeReg(int r, int v);
-
 	bool isStereo() const { return _type != Config::kOpl2; }
 
 protected:
+	void writeImpl(int a, int v);
+	byte readImpl(int a);
+	void writeRegImpl(int r, int v);
+
 	void generateSamples(int16 *buffer, int length);
 };
 
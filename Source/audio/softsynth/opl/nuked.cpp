@@ -1405,7 +1405,7 @@ void OPL::reset() {
 	OPL3_Reset(&chip, _rate);
 }
 
-void OPL::write(int port, int val) {
+void OPL::writeImpl(int port, int val) {
 	if (port & 1) {
 		switch (_type) {
 		case Config::kOpl2:
@@ -1449,7 +1449,7 @@ void OPL::write(int port, int val) {
 }
 
 
-void OPL::writeReg(int r, int v) {
+void OPL::writeRegImpl(int r, int v) {
 	OPL3_WriteRegBuffered(&chip, (Bit16u)r, (Bit8u)v);
 }
 
@@ -1473,7 +1473,7 @@ void OPL::dualWrite(uint8 index, uint8 reg, uint8 val) {
 	OPL3_WriteRegBuffered(&chip, (Bit16u)fullReg, (Bit8u)val);
 }
 
-byte OPL::read(int port) {
+byte OPL::readImpl(int port) {
 	return 0;
 }
 
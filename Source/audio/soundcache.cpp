@@ -0,0 +1,291 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "common/textconsole.h"
+#include "common/util.h"
+
+#include "audio/audiostream.h"
+#include "audio/soundcache.h"
+
+namespace Common {
+DECLARE_SINGLETON(Audio::SoundCache);
+}
+
+namespace Audio {
+
+/**
+ * A stream playing a sound stored in the sound cache. The sound is kept alive
+ * as long as the stream exists.
+ */
+class CachedSoundStream : public SeekableAudioStream {
+public:
+	CachedSoundStream(SoundCache *cache, SoundCache::Entry *entry)
+		: _cache(cache), _entry(entry), _pos(0) {}
+
+	~CachedSoundStream() {
+		_cache->release(_entry);
+	}
+
+	int readBuffer(int16 *buffer, const int numSamples) {
+		const int len = MIN<int>(numSamples, _entry->numSamples - _pos);
+		memcpy(buffer, _entry->data + _pos, len * sizeof(int16));
+		_pos += len;
+		return len;
+	}
+
+	int peekBuffer(const int16 *&buffer) {
+		buffer = _entry->data + _pos;
+		return _entry->numSamples - _pos;
+	}
+
+	void consumeBuffer(int numSamples) {
+		assert(_pos + numSamples <= _entry->numSamples);
+		_pos += numSamples;
+	}
+
+	bool isStereo() const  { return _entry->stereo; }
+	bool endOfData() const { return _pos >= _entry->numSamples; }
+	int getRate() const    { return _entry->rate; }
+
+	Timestamp getLength() const {
+		return Timestamp(0, _entry->numSamples / (_entry->stereo ? 2 : 1), _entry->rate);
+	}
+
+	bool seek(const Timestamp &where) {
+		const uint32 seekSample = convertTimeToStreamPos(where, getRate(), isStereo()).totalNumberOfFrames();
+		if (seekSample > _entry->numSamples)
+			return false;
+
+		_pos = seekSample;
+		return true;
+	}
+
+private:
+	SoundCache *const _cache;
+	SoundCache::Entry *const _entry;
+	uint32 _pos;
+};
+
+SoundCache::SoundCache()
+	: _memoryUsed(0), _memoryLimit(kDefaultMemoryLimit), _hits(0), _misses(0), _evictions(0) {
+}
+
+SoundCache::~SoundCache() {
+	// All streams should be gone by now, any stream still alive would access
+	// the singleton after its destruction
+	for (EntryList::iterator i = _lruList.begin(); i != _lruList.end(); ++i) {
+		if ((*i)->refCount)
+			warning("SoundCache: Sound '%s' is still in use", (*i)->key.c_str());
+		else
+			freeEntry(*i);
+	}
+}
+
+Common::String SoundCache::makeKey(const Common::String &name, uint32 offset, const Common::String &params) {
+	return Common::String::format("%s:%u:%s", name.c_str(), offset, params.c_str());
+}
+
+SeekableAudioStream *SoundCache::get(const Common::String &key) {
+	Common::StackLock lock(_mutex);
+
+	EntryMap::iterator i = _entries.find(key);
+	if (i == _entries.end()) {
+		++_misses;
+		return 0;
+	}
+
+	++_hits;
+
+	// Move the entry to the front of the LRU list
+	Entry *entry = i->_value;
+	_lruList.erase(entry->lruPos);
+	_lruList.push_front(entry);
+	entry->lruPos = _lruList.begin();
+
+	return createStream(entry);
+}
+
+SeekableAudioStream *SoundCache::put(const Common::String &key, SeekableAudioStream *stream) {
+	if (!stream)
+		return 0;
+
+	// Sounds taking up more than a quarter of the budget would push out too
+	// many other sounds, they are not worth caching
+	uint32 maxSize;
+	{
+		Common::StackLock lock(_mutex);
+		maxSize = _memoryLimit / 4;
+	}
+
+	// Without a known length there is no way to tell whether the sound fits
+	// before decoding all of it, such sounds are played directly instead
+	const uint32 maxSamples = maxSize / sizeof(int16);
+	const Timestamp length = stream->getLength();
+	if (length.totalNumberOfFrames() <= 0 || (uint64)length.convertToFramerate(stream->getRate()).totalNumberOfFrames() * (stream->isStereo() ? 2 : 1) > maxSamples)
+		return stream;
+
+	// Decode the whole sound. The length reported by some decoders is only an
+	// estimate, so the buffer is grown as needed.
+	uint32 capacity = 0;
+	uint32 numSamples = 0;
+	int16 *data = 0;
+	bool tooLarge = false;
+
+	while (!stream->endOfData()) {
+		if (numSamples == capacity) {
+			if (capacity >= maxSamples) {
+				tooLarge = true;
+				break;
+			}
+
+			capacity = MIN<uint32>(MAX<uint32>(capacity * 2, 4096), maxSamples);
+			int16 *newData = (int16 *)realloc(data, capacity * sizeof(int16));
+			if (!newData) {
+				tooLarge = true;
+				break;
+			}
+			data = newData;
+		}
+
+		const int len = stream->readBuffer(data + numSamples, capacity - numSamples);
+		if (len <= 0)
+			break;
+		numSamples += len;
+	}
+
+	if (tooLarge) {
+		free(data);
+		stream->rewind();
+		return stream;
+	}
+
+	Entry *entry = new Entry();
+	entry->key = key;
+	entry->data = data;
+	entry->numSamples = numSamples;
+	entry->rate = stream->getRate();
+	entry->stereo = stream->isStereo();
+	entry->refCount = 0;
+	entry->cached = false;
+	delete stream;
+
+	Common::StackLock lock(_mutex);
+
+	// Another thread might have added the same sound in the meantime, in
+	// which case the old entry is replaced
+	EntryMap::iterator i = _entries.find(key);
+	if (i != _entries.end())
+		remove(i->_value);
+
+	// In case all memory is taken up by sounds currently playing the new sound
+	// is not cached, it only lives as long as the returned stream
+	if (makeRoom(entry->size())) {
+		entry->cached = true;
+		_lruList.push_front(entry);
+		entry->lruPos = _lruList.begin();
+		_entries[key] = entry;
+		_memoryUsed += entry->size();
+	}
+
+	return createStream(entry);
+}
+
+void SoundCache::clear() {
+	Common::StackLock lock(_mutex);
+
+	while (!_lruList.empty())
+		remove(_lruList.front());
+}
+
+void SoundCache::setMemoryLimit(uint32 limit) {
+	Common::StackLock lock(_mutex);
+
+	_memoryLimit = limit;
+	makeRoom(0);
+}
+
+SoundCache::Stats SoundCache::getStats() const {
+	Common::StackLock lock(_mutex);
+
+	Stats stats;
+	stats.hits = _hits;
+	stats.misses = _misses;
+	stats.evictions = _evictions;
+	stats.entries = _entries.size();
+	stats.memoryUsed = _memoryUsed;
+	stats.memoryLimit = _memoryLimit;
+	return stats;
+}
+
+void SoundCache::resetStats() {
+	Common::StackLock lock(_mutex);
+
+	_hits = _misses = _evictions = 0;
+}
+
+CachedSoundStream *SoundCache::createStream(Entry *entry) {
+	++entry->refCount;
+	return new CachedSoundStream(this, entry);
+}
+
+void SoundCache::release(Entry *entry) {
+	Common::StackLock lock(_mutex);
+
+	assert(entry->refCount > 0);
+	if (--entry->refCount == 0 && !entry->cached)
+		freeEntry(entry);
+}
+
+bool SoundCache::makeRoom(uint32 size) {
+	// Evict the least recently used sounds, skipping those currently playing
+	EntryList::iterator i = _lruList.reverse_begin();
+	while (_memoryUsed + size > _memoryLimit && i != _lruList.end()) {
+		Entry *entry = *i;
+		--i;
+
+		if (!entry->refCount) {
+			remove(entry);
+			++_evictions;
+		}
+	}
+
+	return _memoryUsed + size <= _memoryLimit;
+}
+
+void SoundCache::remove(Entry *entry) {
+	assert(entry->cached);
+
+	_entries.erase(entry->key);
+	_lruList.erase(entry->lruPos);
+	_memoryUsed -= entry->size();
+	entry->cached = false;
+
+	if (!entry->refCount)
+		freeEntry(entry);
+}
+
+void SoundCache::freeEntry(Entry *entry) {
+	free(entry->data);
+	delete entry;
+}
+
+} // End of namespace Audio
@@ -0,0 +1,181 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef AUDIO_SOUNDCACHE_H
+#define AUDIO_SOUNDCACHE_H
+
+#include "common/scummsys.h"
+#include "common/hashmap.h"
+#include "common/hash-str.h"
+#include "common/list.h"
+#include "common/mutex.h"
+#include "common/singleton.h"
+#include "common/str.h"
+
+namespace Audio {
+
+class SeekableAudioStream;
+class CachedSoundStream;
+
+/**
+ * A process wide cache of decoded sounds.
+ *
+ * Engines tend to play the same short sound effects over and over again,
+ * decoding them from scratch every time. The sound cache keeps the decoded
+ * PCM data of such sounds around, so that playing a sound again only
+ * requires creating a stream reading from memory.
+ *
+ * Sounds are identified by a key, which should describe the source of the
+ * data and the way it is decoded, see makeKey. The memory used by the cache
+ * is bounded; the least recently used sounds, which are not being played
+ * anymore, are evicted first.
+ *
+ * Usage:
+ * @code
+ * const Common::String key = Audio::SoundCache::makeKey(fileName, offset, "adpcm");
+ * Audio::SeekableAudioStream *stream = g_soundCache.get(key);
+ * if (!stream)
+ *     stream = g_soundCache.put(key, decodeSound(fileName, offset));
+ * @endcode
+ */
+class SoundCache : public Common::Singleton<SoundCache> {
+	friend class Common::Singleton<SingletonBaseType>;
+	friend class CachedSoundStream;
+public:
+	enum {
+		/** The default memory budget of the cache in bytes. */
+		kDefaultMemoryLimit = 8 * 1024 * 1024
+	};
+
+	struct Stats {
+		uint32 hits;        ///< Number of lookups which found a cached sound
+		uint32 misses;      ///< Number of lookups which did not find a cached sound
+		uint32 evictions;   ///< Number of sounds removed to stay in the budget
+		uint32 entries;     ///< Number of sounds currently cached
+		uint32 memoryUsed;  ///< Memory used by cached sounds in bytes
+		uint32 memoryLimit; ///< Memory budget of the cache in bytes
+	};
+
+	/**
+	 * Create a key describing a sound.
+	 *
+	 * @param name    name of the file or archive member the sound is read from
+	 * @param offset  offset of the sound inside of the file
+	 * @param params  codec and any parameters affecting the decoded data
+	 * @return the key to use for get and put
+	 */
+	static Common::String makeKey(const Common::String &name, uint32 offset, const Common::String &params);
+
+	/**
+	 * Look up a sound in the cache.
+	 *
+	 * @param key  key of the sound
+	 * @return a new stream playing the cached sound, or 0 if the sound is
+	 *         not cached
+	 */
+	SeekableAudioStream *get(const Common::String &key);
+
+	/**
+	 * Decode a sound and add it to the cache.
+	 *
+	 * The given stream is decoded completely and deleted afterwards. Sounds
+	 * of unknown length or which would take up too much of the memory budget
+	 * are not cached, in this case the given stream is returned as is.
+	 *
+	 * The sound is decoded on the calling thread before this returns, so
+	 * the first playback of a sound costs its full decoding time, just like
+	 * without the cache. Decoding in the background would require a way to
+	 * start playing a sound before its decoding has finished.
+	 *
+	 * @param key     key of the sound
+	 * @param stream  stream to decode, may be 0
+	 * @return a stream playing the sound, or 0 if stream was 0
+	 */
+	SeekableAudioStream *put(const Common::String &key, SeekableAudioStream *stream);
+
+	/**
+	 * Remove all sounds from the cache. Sounds which are still being played
+	 * are freed as soon as their streams are deleted.
+	 */
+	void clear();
+
+	/**
+	 * Set the memory budget of the cache, evicting sounds if necessary.
+	 *
+	 * @param limit  budget in bytes
+	 */
+	void setMemoryLimit(uint32 limit);
+
+	/**
+	 * Query the statistics of the cache.
+	 */
+	Stats getStats() const;
+
+	/**
+	 * Reset the hit, miss and eviction counters.
+	 */
+	void resetStats();
+
+private:
+	SoundCache();
+	~SoundCache();
+
+	struct Entry;
+	typedef Common::List<Entry *> EntryList;
+	typedef Common::HashMap<Common::String, Entry *> EntryMap;
+
+	struct Entry {
+		Common::String key;
+		int16 *data;
+		uint32 numSamples;
+		int rate;
+		bool stereo;
+		uint refCount;               ///< Number of streams playing this entry
+		bool cached;                 ///< Whether the entry is owned by the cache
+		EntryList::iterator lruPos;  ///< Position in _lruList if cached
+
+		uint32 size() const { return numSamples * sizeof(int16); }
+	};
+
+	Common::Mutex _mutex;
+	EntryMap _entries;
+	EntryList _lruList;              ///< Cached entries, most recently used first
+	uint32 _memoryUsed;
+	uint32 _memoryLimit;
+
+	uint32 _hits;
+	uint32 _misses;
+	uint32 _evictions;
+
+	CachedSoundStream *createStream(Entry *entry);
+	void release(Entry *entry);
+	bool makeRoom(uint32 size);
+	void remove(Entry *entry);
+	static void freeEntry(Entry *entry);
+};
+
+} // End of namespace Audio
+
+/** Shortcut for accessing the sound cache. */
+#define g_soundCache (::Audio::SoundCache::instance())
+
+#endif
@@ -30,6 +30,8 @@
 #include "backends/audiocd/default/default-audiocd.h"
 #endif
 
+#include "backends/jobs/default/default-jobs.h"
+
 
 #include "gui/message.h"
 
@@ -52,6 +54,11 @@ void BaseBackend::initBackend() {
 		_audiocdManager = new DefaultAudioCDManager();
 #endif
 
+	// Init job manager, running all jobs synchronously unless the backend
+	// provides worker threads
+	if (!_jobManager)
+		_jobManager = new DefaultJobManager();
+
 	OSystem::initBackend();
 }
 
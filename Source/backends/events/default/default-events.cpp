@@ -26,6 +26,7 @@
 
 #include "common/system.h"
 #include "common/config-manager.h"
+#include "common/jobs.h"
 #include "common/translation.h"
 #include "backends/events/default/default-events.h"
 #include "backends/keymapper/keymapper.h"
@@ -85,6 +86,11 @@ void DefaultEventManager::init() {
 }
 
 bool DefaultEventManager::pollEvent(Common::Event &event) {
+	// Deliver the results of finished jobs on the main thread
+	Common::JobManager *jobManager = g_system->getJobManager();
+	if (jobManager)
+		jobManager->processCompletions();
+
 	_dispatcher.dispatch();
 
 	if (_shouldGenerateKeyRepeatEvents) {
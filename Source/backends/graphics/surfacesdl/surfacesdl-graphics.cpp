@@ -28,6 +28,7 @@
 #include "backends/events/sdl/sdl-events.h"
 #include "backends/platform/sdl/sdl.h"
 #include "common/config-manager.h"
+#include "common/jobs.h"
 #include "common/mutex.h"
 #include "common/textconsole.h"
 #include "common/translation.h"
@@ -186,6 +187,8 @@ SurfaceSdlGraphicsManager::SurfaceSdlGraphicsManager(SdlEventSource *sdlEventSou
 #ifdef USE_OSD
 	_osdMessageSurface(nullptr), _osdMessageAlpha(SDL_ALPHA_TRANSPARENT), _osdMessageFadeStartTime(0),
 	_osdIconSurface(nullptr),
+	_osdStatsEnabled(false), _osdStatsSurface(nullptr), _osdStatsStartTime(0), _osdStatsFrames(0),
+	_osdStatsScalerTime(0), _osdStatsMaxScalerTime(0), _osdStatsUpdateTime(0), _osdStatsMaxUpdateTime(0),
 #endif
 #if SDL_VERSION_ATLEAST(2, 0, 0)
 	_renderer(nullptr), _screenTexture(nullptr),
@@ -1314,6 +1317,11 @@ void SurfaceSdlGraphicsManager::unloadGFXMode() {
 		SDL_FreeSurface(_osdIconSurface);
 		_osdIconSurface = NULL;
 	}
+
+	if (_osdStatsSurface) {
+		SDL_FreeSurface(_osdStatsSurface);
+		_osdStatsSurface = NULL;
+	}
 #endif
 	DestroyScalers();
 
@@ -1400,13 +1408,92 @@ void SurfaceSdlGraphicsManager::updateShader() {
 	// hardware-based up-scaling (sharp-bilinear-simple, etc.)
 }
 
+/**
+ * The number of lines scaled by one job. Multiple of 4, so that the slices
+ * keep the pattern of the DotMatrix scaler.
+ */
+static const int kScalerSliceLines = 16;
+
+struct ScalerSlices {
+	ScalerProc *scalerProc;
+	int scale;
+	const byte *src;
+	uint32 srcPitch;
+	byte *dst;
+	uint32 dstPitch;
+	int width, height;
+	uint count;
+};
+
+static void scaleSlicesProc(void *refCon, uint begin, uint end) {
+	const ScalerSlices *slices = (const ScalerSlices *)refCon;
+
+	for (uint i = begin; i < end; ++i) {
+		// The last slice takes the remaining lines
+		const int y = i * kScalerSliceLines;
+		const int h = (i == slices->count - 1) ? slices->height - y : kScalerSliceLines;
+
+		slices->scalerProc(slices->src + y * slices->srcPitch, slices->srcPitch,
+			slices->dst + y * slices->scale * slices->dstPitch, slices->dstPitch, slices->width, h);
+	}
+}
+
+static bool canScaleInParallel(ScalerProc *scalerProc) {
+#if defined(USE_HQ_SCALERS) && defined(USE_NASM)
+	// The assembly versions of the HQ scalers keep their state in global
+	// variables
+	if (scalerProc == HQ2x || scalerProc == HQ3x)
+		return false;
+#endif
+	return true;
+}
+
+void SurfaceSdlGraphicsManager::scaleRect(ScalerProc *scalerProc, int scale, const byte *src, uint32 srcPitch, byte *dst, uint32 dstPitch, int width, int height) {
+	Common::JobManager *jobManager = g_system->getJobManager();
+
+	// Small rects, like the ones of the mouse cursor, are not worth it
+	if (jobManager->getWorkerCount() == 0 || height < 2 * kScalerSliceLines || !canScaleInParallel(scalerProc)) {
+		scalerProc(src, srcPitch, dst, dstPitch, width, height);
+		return;
+	}
+
+	ScalerSlices slices;
+	slices.scalerProc = scalerProc;
+	slices.scale = scale;
+	slices.src = src;
+	slices.srcPitch = srcPitch;
+	slices.dst = dst;
+	slices.dstPitch = dstPitch;
+	slices.width = width;
+	slices.height = height;
+	slices.count = height / kScalerSliceLines;
+
+	jobManager->parallelFor(0, slices.count, 1, scaleSlicesProc, &slices, "Scaler");
+}
+
+#ifdef USE_OSD
+/** A timestamp in microseconds, for the scaler statistics. */
+static uint32 getMicroseconds() {
+#if SDL_VERSION_ATLEAST(2, 0, 0)
+	const uint64 counter = SDL_GetPerformanceCounter();
+	const uint64 frequency = SDL_GetPerformanceFrequency();
+	return (uint32)(counter / frequency * 1000000 + counter % frequency * 1000000 / frequency);
+#else
+	return SDL_GetTicks() * 1000;
+#endif
+}
+#endif
+
 void SurfaceSdlGraphicsManager::internUpdateScreen() {
 	SDL_Surface *srcSurf, *origSurf;
 	int height, width;
 	ScalerProc *scalerProc;
 	int scale1;
 
-
+#ifdef USE_OSD
+	const uint32 updateStartTime = getMicroseconds();
+	uint32 scalerTime = 0;
+#endif
 
 	// If the shake position changed, fill the dirty area with blackness
 	if (_currentShakePos != _newShakePos ||
@@ -1494,6 +1581,10 @@ void SurfaceSdlGraphicsManager::internUpdateScreen() {
 		srcPitch = srcSurf->pitch;
 		dstPitch = _hwScreen->pitch;
 
+#ifdef USE_OSD
+		const uint32 scalerStartTime = getMicroseconds();
+#endif
+
 		for (r = _dirtyRectList; r != lastRect; ++r) {
 			int dst_y = r->y + _currentShakePos;
 			int dst_h = 0;
@@ -1516,7 +1607,7 @@ void SurfaceSdlGraphicsManager::internUpdateScreen() {
 					dst_y = real2Aspect(dst_y);
 
 				assert(scalerProc != NULL);
-				scalerProc((byte *)srcSurf->pixels + (r->x * 2 + 2 * MAX_SCALER_REACH) + (r->y + MAX_SCALER_REACH) * srcPitch, srcPitch,
+				scaleRect(scalerProc, scale1, (byte *)srcSurf->pixels + (r->x * 2 + 2 * MAX_SCALER_REACH) + (r->y + MAX_SCALER_REACH) * srcPitch, srcPitch,
 					(byte *)_hwScreen->pixels + rx1 * 2 + dst_y * dstPitch, dstPitch, r->w, dst_h);
 			}
 
@@ -1530,6 +1621,11 @@ void SurfaceSdlGraphicsManager::internUpdateScreen() {
 				r->h = stretch200To240((uint8 *) _hwScreen->pixels, dstPitch, r->w, r->h, r->x, r->y, orig_dst_y * scale1);
 #endif
 		}
+
+#ifdef USE_OSD
+		scalerTime = getMicroseconds() - scalerStartTime;
+#endif
+
 		SDL_UnlockSurface(srcSurf);
 		SDL_UnlockSurface(_hwScreen);
 
@@ -1544,6 +1640,23 @@ void SurfaceSdlGraphicsManager::internUpdateScreen() {
 
 #ifdef USE_OSD
 		drawOSD();
+
+		// The statistics are opaque, so they are drawn on every update
+		// instead of redrawing the screen below them
+		if (_osdStatsSurface) {
+			SDL_Rect dstRect = getOSDStatsRect();
+			SDL_BlitSurface(_osdStatsSurface, 0, _hwScreen, &dstRect);
+
+			if (_numDirtyRects < NUM_DIRTY_RECT) {
+				_dirtyRectList[_numDirtyRects++] = dstRect;
+			} else {
+				_dirtyRectList[0].x = 0;
+				_dirtyRectList[0].y = 0;
+				_dirtyRectList[0].w = _hwScreen->w;
+				_dirtyRectList[0].h = _hwScreen->h;
+				_numDirtyRects = 1;
+			}
+		}
 #endif
 
 #ifdef USE_SDL_DEBUG_FOCUSRECT
@@ -1622,6 +1735,11 @@ void SurfaceSdlGraphicsManager::internUpdateScreen() {
 		if (!_displayDisabled) {
 			SDL_UpdateRects(_hwScreen, _numDirtyRects, _dirtyRectList);
 		}
+
+#ifdef USE_OSD
+		if (_osdStatsEnabled)
+			updateOSDStats(scalerTime, getMicroseconds() - updateStartTime);
+#endif
 	}
 
 	_numDirtyRects = 0;
@@ -2739,6 +2857,110 @@ void SurfaceSdlGraphicsManager::drawOSD() {
 	}
 }
 
+SDL_Rect SurfaceSdlGraphicsManager::getOSDStatsRect() const {
+	SDL_Rect dstRect;
+	dstRect.x = 10;
+	dstRect.y = 10;
+	dstRect.w = _osdStatsSurface->w;
+	dstRect.h = _osdStatsSurface->h;
+	return dstRect;
+}
+
+void SurfaceSdlGraphicsManager::toggleOSDStats() {
+	_osdStatsEnabled = !_osdStatsEnabled;
+
+	if (_osdStatsSurface) {
+		SDL_FreeSurface(_osdStatsSurface);
+		_osdStatsSurface = nullptr;
+	}
+
+	_osdStatsStartTime = SDL_GetTicks();
+	_osdStatsFrames = 0;
+	_osdStatsScalerTime = _osdStatsMaxScalerTime = 0;
+	_osdStatsUpdateTime = _osdStatsMaxUpdateTime = 0;
+
+	// Redraw the screen to show the statistics right away, or to remove them
+	_forceRedraw = true;
+}
+
+void SurfaceSdlGraphicsManager::updateOSDStats(uint32 scalerTime, uint32 updateTime) {
+	_osdStatsFrames++;
+	_osdStatsScalerTime += scalerTime;
+	_osdStatsMaxScalerTime = MAX(_osdStatsMaxScalerTime, scalerTime);
+	_osdStatsUpdateTime += updateTime;
+	_osdStatsMaxUpdateTime = MAX(_osdStatsMaxUpdateTime, updateTime);
+
+	const uint32 now = SDL_GetTicks();
+	if (_osdStatsSurface && now - _osdStatsStartTime < kOSDStatsInterval)
+		return;
+
+	renderOSDStats();
+
+	_osdStatsStartTime = now;
+	_osdStatsFrames = 0;
+	_osdStatsScalerTime = _osdStatsMaxScalerTime = 0;
+	_osdStatsUpdateTime = _osdStatsMaxUpdateTime = 0;
+}
+
+void SurfaceSdlGraphicsManager::renderOSDStats() {
+	const Graphics::Font *font = FontMan.getFontByUsage(Graphics::FontManager::kConsoleFont);
+
+	const uint32 elapsed = MAX<uint32>(SDL_GetTicks() - _osdStatsStartTime, 1);
+	const uint32 frames = MAX<uint32>(_osdStatsFrames, 1);
+
+	Common::String lines[3];
+	lines[0] = Common::String::format("%.1f fps, %u worker threads",
+		_osdStatsFrames * 1000.0 / elapsed, g_system->getJobManager()->getWorkerCount());
+	lines[1] = Common::String::format("Scaler: %.2f ms, max %.2f ms",
+		_osdStatsScalerTime / 1000.0 / frames, _osdStatsMaxScalerTime / 1000.0);
+	lines[2] = Common::String::format("Update: %.2f ms, max %.2f ms",
+		_osdStatsUpdateTime / 1000.0 / frames, _osdStatsMaxUpdateTime / 1000.0);
+
+	// Use a fixed size, so that the box does not flicker when the numbers change
+	const int padding = 4;
+	const int lineHeight = font->getFontHeight() + 2;
+	int width = font->getStringWidth("Update: 000.00 ms, max 000.00 ms") + 2 * padding;
+	int height = lineHeight * ARRAYSIZE(lines) + 2 * padding;
+
+	// Clip the rect
+	if (width > _hwScreen->w - 10)
+		width = _hwScreen->w - 10;
+	if (height > _hwScreen->h - 10)
+		height = _hwScreen->h - 10;
+
+	if (_osdStatsSurface && (_osdStatsSurface->w != width || _osdStatsSurface->h != height)) {
+		SDL_FreeSurface(_osdStatsSurface);
+		_osdStatsSurface = nullptr;
+	}
+
+	if (!_osdStatsSurface) {
+		_osdStatsSurface = SDL_CreateRGBSurface(
+			SDL_SWSURFACE, width, height, 16,
+			_hwScreen->format->Rmask, _hwScreen->format->Gmask, _hwScreen->format->Bmask, _hwScreen->format->Amask
+		);
+	}
+
+	if (SDL_LockSurface(_osdStatsSurface))
+		error("renderOSDStats: SDL_LockSurface failed: %s", SDL_GetError());
+
+	SDL_FillRect(_osdStatsSurface, nullptr, SDL_MapRGB(_osdStatsSurface->format, 0, 0, 0));
+
+	Graphics::Surface dst;
+	dst.init(_osdStatsSurface->w, _osdStatsSurface->h, _osdStatsSurface->pitch, _osdStatsSurface->pixels,
+		Graphics::PixelFormat(_osdStatsSurface->format->BytesPerPixel,
+			8 - _osdStatsSurface->format->Rloss, 8 - _osdStatsSurface->format->Gloss,
+			8 - _osdStatsSurface->format->Bloss, 8 - _osdStatsSurface->format->Aloss,
+			_osdStatsSurface->format->Rshift, _osdStatsSurface->format->Gshift,
+			_osdStatsSurface->format->Bshift, _osdStatsSurface->format->Ashift));
+
+	for (int i = 0; i < ARRAYSIZE(lines); i++) {
+		font->drawString(&dst, lines[i], padding, padding + i * lineHeight, width - 2 * padding,
+			SDL_MapRGB(_osdStatsSurface->format, 255, 255, 0));
+	}
+
+	SDL_UnlockSurface(_osdStatsSurface);
+}
+
 #endif
 
 void SurfaceSdlGraphicsManager::handleResizeImpl(const int width, const int height) {
@@ -2747,6 +2969,15 @@ void SurfaceSdlGraphicsManager::handleResizeImpl(const int width, const int heig
 }
 bool SurfaceSdlGraphicsManager::handleScalerHotkeys(Common::KeyCode key) {
 
+#ifdef USE_OSD
+	// Ctrl-Alt-i toggles the scaler statistics
+	if (key == 'i') {
+		toggleOSDStats();
+		internUpdateScreen();
+		return true;
+	}
+#endif
+
 	// Ctrl-Alt-a toggles aspect ratio correction
 	if (key == 'a') {
 		beginGFXTransaction();
@@ -2882,6 +3113,10 @@ bool SurfaceSdlGraphicsManager::isScalerHotkey(const Common::Event &event) {
 #if SDL_VERSION_ATLEAST(2, 0, 0)
 		if (event.kbd.keycode == 'f')
 			return true;
+#endif
+#ifdef USE_OSD
+		if (event.kbd.keycode == 'i')
+			return true;
 #endif
 		return (isScaleKey || event.kbd.keycode == 'a');
 	}
@@ -210,6 +210,28 @@ protected:
 
 	void updateOSD();
 	void drawOSD();
+
+	/** Whether to show the scaler statistics, toggled with Ctrl-Alt-i */
+	bool _osdStatsEnabled;
+	/** Surface containing the scaler statistics */
+	SDL_Surface *_osdStatsSurface;
+	/** When the statistics were last rendered (in milliseconds) */
+	uint32 _osdStatsStartTime;
+	/** The frames drawn since the statistics were last rendered */
+	uint32 _osdStatsFrames;
+	/** Total and maximal time spent scaling resp. updating these frames (in microseconds) */
+	uint32 _osdStatsScalerTime, _osdStatsMaxScalerTime;
+	uint32 _osdStatsUpdateTime, _osdStatsMaxUpdateTime;
+	enum {
+		kOSDStatsInterval = 500		/** < Delay between updates of the statistics (in milliseconds) */
+	};
+	/** Screen rectangle where the scaler statistics are drawn */
+	SDL_Rect getOSDStatsRect() const;
+	/** Show or hide the scaler statistics */
+	void toggleOSDStats();
+	/** Account a drawn frame in the scaler statistics, and render them if due */
+	void updateOSDStats(uint32 scalerTime, uint32 updateTime);
+	void renderOSDStats();
 #endif
 
 	virtual bool gameNeedsAspectRatioCorrection() const override {
@@ -412,6 +434,12 @@ protected:
 	virtual void blitCursor();
 
 	virtual void internUpdateScreen();
+
+	/**
+	 * Run the scaler on a rect. Large rects are split into slices of lines,
+	 * which are scaled in parallel by the job manager.
+	 */
+	void scaleRect(ScalerProc *scalerProc, int scale, const byte *src, uint32 srcPitch, byte *dst, uint32 dstPitch, int width, int height);
 	virtual void updateShader();
 
 	virtual bool loadGFXMode();
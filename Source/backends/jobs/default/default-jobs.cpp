@@ -0,0 +1,117 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "backends/jobs/default/default-jobs.h"
+
+#include "common/debug.h"
+#include "common/system.h"
+#include "common/util.h"
+
+DefaultJobManager::DefaultJobManager() : _nextHandle(kInvalidJob) {
+}
+
+DefaultJobManager::~DefaultJobManager() {
+	if (debugLevelSet(2))
+		dumpStats();
+}
+
+Common::JobManager::JobHandle DefaultJobManager::addJob(JobProc proc, void *refCon, const char *name, JobProc completion) {
+	const uint32 start = getMicros();
+	proc(refCon);
+	recordJob(name, getMicros() - start);
+
+	if (completion)
+		queueCompletion(completion, refCon);
+
+	return allocateHandle();
+}
+
+void DefaultJobManager::parallelFor(uint begin, uint end, uint grainSize, RangeProc proc, void *refCon, const char *name) {
+	assert(grainSize > 0);
+
+	const uint32 start = getMicros();
+	while (begin < end) {
+		const uint pieceEnd = begin + MIN(grainSize, end - begin);
+		proc(refCon, begin, pieceEnd);
+		begin = pieceEnd;
+	}
+	recordJob(name, getMicros() - start);
+}
+
+void DefaultJobManager::processCompletions() {
+	Common::Array<Completion> completions;
+
+	{
+		Common::StackLock lock(_mutex);
+		if (_completions.empty())
+			return;
+
+		// The callbacks may add new jobs, so they are called without the
+		// lock being held
+		completions = _completions;
+		_completions.resize(0);
+	}
+
+	for (uint i = 0; i < completions.size(); ++i)
+		completions[i].proc(completions[i].refCon);
+}
+
+void DefaultJobManager::dumpStats() {
+	Common::StackLock lock(_mutex);
+
+	debug("Job statistics (%u worker threads, times in us):", getWorkerCount());
+	for (JobStatsMap::const_iterator i = _stats.begin(); i != _stats.end(); ++i) {
+		const JobStats &stats = i->_value;
+		debug("  %s: %u jobs, total %u, avg %u, max %u", i->_key.c_str(), stats.count,
+		      stats.totalTime, stats.totalTime / stats.count, stats.maxTime);
+	}
+}
+
+uint32 DefaultJobManager::getMicros() {
+	return g_system->getMillis(true) * 1000;
+}
+
+Common::JobManager::JobHandle DefaultJobManager::allocateHandle() {
+	Common::StackLock lock(_mutex);
+
+	if (++_nextHandle == kInvalidJob)
+		++_nextHandle;
+	return _nextHandle;
+}
+
+void DefaultJobManager::recordJob(const char *name, uint32 time) {
+	Common::StackLock lock(_mutex);
+
+	JobStats &stats = _stats[name];
+	++stats.count;
+	stats.totalTime += time;
+	stats.maxTime = MAX(stats.maxTime, time);
+}
+
+void DefaultJobManager::queueCompletion(JobProc completion, void *refCon) {
+	Completion entry;
+	entry.proc = completion;
+	entry.refCon = refCon;
+
+	Common::StackLock lock(_mutex);
+	_completions.push_back(entry);
+}
@@ -0,0 +1,90 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef BACKENDS_JOBS_DEFAULT_H
+#define BACKENDS_JOBS_DEFAULT_H
+
+#include "common/array.h"
+#include "common/hashmap.h"
+#include "common/hash-str.h"
+#include "common/jobs.h"
+#include "common/mutex.h"
+#include "common/str.h"
+
+/**
+ * Job manager executing all jobs synchronously on the calling thread.
+ *
+ * It also implements the bookkeeping shared by all job managers, i.e. the
+ * statistics and the delivery of completion callbacks.
+ */
+class DefaultJobManager : public Common::JobManager {
+public:
+	DefaultJobManager();
+	virtual ~DefaultJobManager();
+
+	virtual uint getWorkerCount() const { return 0; }
+	virtual JobHandle addJob(JobProc proc, void *refCon, const char *name, JobProc completion = nullptr);
+	virtual bool isJobFinished(JobHandle job) { return true; }
+	virtual void waitForJob(JobHandle job) {}
+	virtual void parallelFor(uint begin, uint end, uint grainSize, RangeProc proc, void *refCon, const char *name);
+	virtual void processCompletions();
+	virtual void dumpStats();
+
+protected:
+	/**
+	 * Return a time stamp in microseconds used to measure the run time of
+	 * jobs. The default implementation only has millisecond precision.
+	 */
+	virtual uint32 getMicros();
+
+	/** Create a new, unique job handle. */
+	JobHandle allocateHandle();
+
+	/** Account a job executed in the given time to the statistics. */
+	void recordJob(const char *name, uint32 time);
+
+	/** Schedule a completion callback for processCompletions. */
+	void queueCompletion(JobProc completion, void *refCon);
+
+private:
+	struct Completion {
+		JobProc proc;
+		void *refCon;
+	};
+
+	struct JobStats {
+		JobStats() : count(0), totalTime(0), maxTime(0) {}
+
+		uint32 count;      ///< Number of executed jobs
+		uint32 totalTime;  ///< Total run time in microseconds
+		uint32 maxTime;    ///< Longest run time in microseconds
+	};
+
+	typedef Common::HashMap<Common::String, JobStats> JobStatsMap;
+
+	Common::Mutex _mutex;
+	JobHandle _nextHandle;
+	JobStatsMap _stats;
+	Common::Array<Completion> _completions;
+};
+
+#endif
@@ -0,0 +1,236 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "common/scummsys.h"
+
+#if defined(SDL_BACKEND)
+
+#include "backends/jobs/sdl/sdl-jobs.h"
+
+#include "common/textconsole.h"
+#include "common/util.h"
+
+SdlJobManager::SdlJobManager() : _quit(false) {
+	_queueMutex = SDL_CreateMutex();
+	_jobAdded = SDL_CreateCond();
+	_jobFinished = SDL_CreateCond();
+
+	// The main thread executes jobs too while waiting for them, so one
+	// worker less than there are cores suffices
+#if SDL_VERSION_ATLEAST(2, 0, 0)
+	const int numWorkers = MIN<int>(SDL_GetCPUCount() - 1, kMaxWorkers);
+#else
+	const int numWorkers = 0;
+#endif
+
+	for (int i = 0; i < numWorkers; ++i) {
+#if SDL_VERSION_ATLEAST(2, 0, 0)
+		SDL_Thread *thread = SDL_CreateThread(workerProc, "ScummVM worker", this);
+#else
+		SDL_Thread *thread = SDL_CreateThread(workerProc, this);
+#endif
+		if (!thread) {
+			warning("Could not create worker thread: %s", SDL_GetError());
+			break;
+		}
+		_workers.push_back(thread);
+	}
+}
+
+SdlJobManager::~SdlJobManager() {
+	SDL_LockMutex(_queueMutex);
+	_quit = true;
+	if (!_queue.empty())
+		warning("SdlJobManager: Dropping %u unfinished jobs", _queue.size());
+	SDL_CondBroadcast(_jobAdded);
+	SDL_UnlockMutex(_queueMutex);
+
+	for (uint i = 0; i < _workers.size(); ++i)
+		SDL_WaitThread(_workers[i], nullptr);
+
+	SDL_DestroyCond(_jobFinished);
+	SDL_DestroyCond(_jobAdded);
+	SDL_DestroyMutex(_queueMutex);
+}
+
+Common::JobManager::JobHandle SdlJobManager::addJob(JobProc proc, void *refCon, const char *name, JobProc completion) {
+	if (_workers.empty())
+		return DefaultJobManager::addJob(proc, refCon, name, completion);
+
+	Job job;
+	job.handle = allocateHandle();
+	job.proc = proc;
+	job.refCon = refCon;
+	job.name = name;
+	job.completion = completion;
+	job.loop = nullptr;
+
+	SDL_LockMutex(_queueMutex);
+	_queue.push_back(job);
+	_pendingJobs[job.handle] = true;
+	SDL_CondSignal(_jobAdded);
+	SDL_UnlockMutex(_queueMutex);
+
+	return job.handle;
+}
+
+bool SdlJobManager::isJobFinished(JobHandle job) {
+	SDL_LockMutex(_queueMutex);
+	const bool finished = !_pendingJobs.contains(job);
+	SDL_UnlockMutex(_queueMutex);
+	return finished;
+}
+
+void SdlJobManager::waitForJob(JobHandle job) {
+	SDL_LockMutex(_queueMutex);
+	while (_pendingJobs.contains(job)) {
+		// Rather than sitting idle help with the queued jobs, the awaited
+		// job might be among them
+		if (!_queue.empty()) {
+			const Job next = _queue.front();
+			_queue.pop_front();
+			executeJob(next);
+		} else {
+			SDL_CondWait(_jobFinished, _queueMutex);
+		}
+	}
+	SDL_UnlockMutex(_queueMutex);
+}
+
+void SdlJobManager::parallelFor(uint begin, uint end, uint grainSize, RangeProc proc, void *refCon, const char *name) {
+	assert(grainSize > 0);
+
+	const uint pieces = (end - begin + grainSize - 1) / grainSize;
+	if (_workers.empty() || pieces < 2) {
+		DefaultJobManager::parallelFor(begin, end, grainSize, proc, refCon, name);
+		return;
+	}
+
+	const uint32 start = getMicros();
+
+	Loop loop;
+	loop.proc = proc;
+	loop.refCon = refCon;
+	loop.next = begin;
+	loop.end = end;
+	loop.grainSize = grainSize;
+	loop.running = 0;
+
+	Job helper;
+	helper.handle = kInvalidJob;
+	helper.proc = nullptr;
+	helper.refCon = nullptr;
+	helper.name = name;
+	helper.completion = nullptr;
+	helper.loop = &loop;
+
+	SDL_LockMutex(_queueMutex);
+
+	// Helpers go to the front of the queue, the caller is blocked until the
+	// loop is done
+	const uint numHelpers = MIN<uint>(pieces - 1, _workers.size());
+	for (uint i = 0; i < numHelpers; ++i)
+		_queue.push_front(helper);
+	SDL_CondBroadcast(_jobAdded);
+
+	processLoop(loop);
+
+	// Helpers which did not start yet are not needed anymore. Once they
+	// are gone and no piece is running, nobody accesses loop anymore.
+	for (Common::List<Job>::iterator i = _queue.begin(); i != _queue.end(); ) {
+		if (i->loop == &loop)
+			i = _queue.erase(i);
+		else
+			++i;
+	}
+	while (loop.running)
+		SDL_CondWait(_jobFinished, _queueMutex);
+
+	SDL_UnlockMutex(_queueMutex);
+
+	recordJob(name, getMicros() - start);
+}
+
+uint32 SdlJobManager::getMicros() {
+#if SDL_VERSION_ATLEAST(2, 0, 0)
+	return (uint32)(uint64)((double)SDL_GetPerformanceCounter() * 1000000.0 / SDL_GetPerformanceFrequency());
+#else
+	return DefaultJobManager::getMicros();
+#endif
+}
+
+int SdlJobManager::workerProc(void *refCon) {
+	SdlJobManager *manager = (SdlJobManager *)refCon;
+
+	SDL_LockMutex(manager->_queueMutex);
+	while (true) {
+		while (manager->_queue.empty() && !manager->_quit)
+			SDL_CondWait(manager->_jobAdded, manager->_queueMutex);
+		if (manager->_quit)
+			break;
+
+		const Job job = manager->_queue.front();
+		manager->_queue.pop_front();
+		manager->executeJob(job);
+	}
+	SDL_UnlockMutex(manager->_queueMutex);
+
+	return 0;
+}
+
+void SdlJobManager::executeJob(const Job &job) {
+	if (job.loop) {
+		processLoop(*job.loop);
+		return;
+	}
+
+	SDL_UnlockMutex(_queueMutex);
+
+	const uint32 start = getMicros();
+	job.proc(job.refCon);
+	recordJob(job.name, getMicros() - start);
+
+	if (job.completion)
+		queueCompletion(job.completion, job.refCon);
+
+	SDL_LockMutex(_queueMutex);
+	_pendingJobs.erase(job.handle);
+	SDL_CondBroadcast(_jobFinished);
+}
+
+void SdlJobManager::processLoop(Loop &loop) {
+	while (loop.next < loop.end) {
+		const uint begin = loop.next;
+		const uint end = begin + MIN(loop.grainSize, loop.end - begin);
+		loop.next = end;
+		++loop.running;
+
+		SDL_UnlockMutex(_queueMutex);
+		loop.proc(loop.refCon, begin, end);
+		SDL_LockMutex(_queueMutex);
+
+		if (--loop.running == 0)
+			SDL_CondBroadcast(_jobFinished);
+	}
+}
+
+#endif
@@ -0,0 +1,90 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef BACKENDS_JOBS_SDL_H
+#define BACKENDS_JOBS_SDL_H
+
+#include "backends/jobs/default/default-jobs.h"
+
+#include "backends/platform/sdl/sdl-sys.h"
+
+#include "common/list.h"
+
+/**
+ * SDL job manager. Executes jobs on a pool of SDL threads, one less than
+ * the number of CPU cores. On single core systems, and with SDL 1.2, which
+ * cannot tell the number of cores, jobs are executed synchronously.
+ */
+class SdlJobManager : public DefaultJobManager {
+public:
+	SdlJobManager();
+	virtual ~SdlJobManager();
+
+	virtual uint getWorkerCount() const { return _workers.size(); }
+	virtual JobHandle addJob(JobProc proc, void *refCon, const char *name, JobProc completion = nullptr);
+	virtual bool isJobFinished(JobHandle job);
+	virtual void waitForJob(JobHandle job);
+	virtual void parallelFor(uint begin, uint end, uint grainSize, RangeProc proc, void *refCon, const char *name);
+
+protected:
+	virtual uint32 getMicros();
+
+private:
+	enum {
+		kMaxWorkers = 8
+	};
+
+	/** State of a parallelFor call, shared by all threads working on it. */
+	struct Loop {
+		RangeProc proc;
+		void *refCon;
+		uint next;        ///< Start of the next piece to process
+		uint end;
+		uint grainSize;
+		uint running;     ///< Number of pieces currently being processed
+	};
+
+	struct Job {
+		JobHandle handle;
+		JobProc proc;
+		void *refCon;
+		const char *name;
+		JobProc completion;
+		Loop *loop;       ///< Set for jobs helping with a parallelFor call
+	};
+
+	Common::Array<SDL_Thread *> _workers;
+	SDL_mutex *_queueMutex;           ///< Protects all members below and all Loops
+	SDL_cond *_jobAdded;
+	SDL_cond *_jobFinished;
+	Common::List<Job> _queue;
+	Common::HashMap<JobHandle, bool> _pendingJobs;
+	bool _quit;
+
+	static int workerProc(void *refCon);
+
+	// The following must be called with _queueMutex held
+	void executeJob(const Job &job);
+	void processLoop(Loop &loop);
+};
+
+#endif
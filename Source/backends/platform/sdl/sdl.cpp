@@ -46,6 +46,7 @@
 
 #include "backends/events/default/default-events.h"
 #include "backends/events/sdl/sdl-events.h"
+#include "backends/jobs/sdl/sdl-jobs.h"
 #include "backends/mutex/sdl/sdl-mutex.h"
 #include "backends/timer/sdl/sdl-timer.h"
 #include "backends/graphics/surfacesdl/surfacesdl-graphics.h"
@@ -129,6 +130,8 @@ OSystem_SDL::~OSystem_SDL() {
 #endif
 
 	_timerManager = 0;
+	delete _jobManager;
+	_jobManager = 0;
 	delete _mutexManager;
 	_mutexManager = 0;
 
@@ -285,6 +288,9 @@ void OSystem_SDL::initBackend() {
 		_timerManager = new SdlTimerManager();
 #endif
 
+	if (_jobManager == 0)
+		_jobManager = new SdlJobManager();
+
 	_audiocdManager = createAudioCDManager();
 
 	// Setup a custom program icon.
@@ -32,6 +32,7 @@
 #include "backends/saves/default/default-saves.h"
 #include "backends/events/default/default-events.h"
 #include "backends/audiocd/default/default-audiocd.h"
+#include "backends/jobs/default/default-jobs.h"
 #include "backends/mutex/mutex.h"
 #include "backends/fs/fs-factory.h"
 #include "backends/timer/tizen/timer.h"
@@ -266,6 +267,11 @@ result TizenSystem::initModules() {
 		return E_OUT_OF_MEMORY;
 	}
 
+	_jobManager = new DefaultJobManager();
+	if (!_jobManager) {
+		return E_OUT_OF_MEMORY;
+	}
+
 	_savefileManager = new TizenSaveFileManager();
 	if (!_savefileManager) {
 		return E_OUT_OF_MEMORY;
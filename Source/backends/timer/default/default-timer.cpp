@@ -24,6 +24,8 @@
 #include "backends/timer/default/default-timer.h"
 #include "common/util.h"
 #include "common/system.h"
+#include "common/debug.h"
+#include "common/textconsole.h"
 
 struct TimerSlot {
 	Common::TimerManager::TimerProc callback;
@@ -34,78 +36,91 @@ struct TimerSlot {
 	uint32 nextFireTime;	// in milliseconds
 	uint32 nextFireTimeMicro;	// microseconds part of nextFire
 
-	TimerSlot *next;
+	// Statistics, all times in milliseconds
+	uint32 numCalls;
+	uint32 totalRuntime;
+	uint32 maxRuntime;
+	uint32 totalLateness;	// time between the scheduled and the actual invocation
+	uint32 maxLateness;
 };
 
-void insertPrioQueue(TimerSlot *head, TimerSlot *newSlot) {
-	// The head points to a fake anchor TimerSlot; this common
-	// trick allows us to get rid of many special cases.
-
-	const uint32 nextFireTime = newSlot->nextFireTime;
-	TimerSlot *slot = head;
-	newSlot->next = 0;
-
-	// Insert the new slot into the sorted list of already scheduled
-	// timers in such a way that the list stays sorted...
-	while (true) {
-		assert(slot);
-		if (slot->next == 0 || nextFireTime < slot->next->nextFireTime) {
-			newSlot->next = slot->next;
-			slot->next = newSlot;
-			return;
-		}
-		slot = slot->next;
-	}
+static bool firesBefore(const TimerSlot *a, const TimerSlot *b) {
+	if (a->nextFireTime != b->nextFireTime)
+		return a->nextFireTime < b->nextFireTime;
+	return a->nextFireTimeMicro < b->nextFireTimeMicro;
 }
 
 
 DefaultTimerManager::DefaultTimerManager() :
-	_head(0) {
-
-	_head = new TimerSlot();
-	memset(_head, 0, sizeof(TimerSlot));
+	_runningSlot(0) {
 }
 
 DefaultTimerManager::~DefaultTimerManager() {
+	if (debugLevelSet(2))
+		dumpStats();
+
 	Common::StackLock lock(_mutex);
 
-	TimerSlot *slot = _head;
-	while (slot) {
-		TimerSlot *next = slot->next;
-		delete slot;
-		slot = next;
-	}
-	_head = 0;
+	for (uint i = 0; i < _queue.size(); ++i)
+		delete _queue[i];
+	_queue.clear();
 }
 
 void DefaultTimerManager::handler() {
-	Common::StackLock lock(_mutex);
+	const uint32 curTime = g_system->getMillis(true);
+
+	// Repeat as long as there is a TimerSlot that is scheduled to fire. The
+	// callbacks are invoked without holding _mutex, so that other threads can
+	// install and remove timers meanwhile. removeTimerProc waits on
+	// _dispatchMutex if it removes the callback currently running.
+	while (true) {
+		Common::StackLock dispatchLock(_dispatchMutex);
+
+		TimerProc callback;
+		void *refCon;
+		{
+			Common::StackLock lock(_mutex);
+
+			if (_queue.empty() || _queue[0]->nextFireTime >= curTime)
+				return;
+
+			TimerSlot *slot = _queue[0];
+			const uint32 lateness = curTime - slot->nextFireTime;
+			slot->totalLateness += lateness;
+			slot->maxLateness = MAX(slot->maxLateness, lateness);
+
+			// Update the fire time and restore the heap order. The fire time
+			// is advanced by the exact interval, rather than computed from the
+			// current time, so that the rounding to milliseconds does not add
+			// up over time.
+			assert(slot->interval > 0);
+			slot->nextFireTime += (slot->interval / 1000);
+			slot->nextFireTimeMicro += (slot->interval % 1000);
+			if (slot->nextFireTimeMicro >= 1000) {
+				slot->nextFireTime += slot->nextFireTimeMicro / 1000;
+				slot->nextFireTimeMicro %= 1000;
+			}
+			siftDown(0);
 
-	uint32 curTime = g_system->getMillis(true);
-
-	// Repeat as long as there is a TimerSlot that is scheduled to fire.
-	TimerSlot *slot = _head->next;
-	while (slot && slot->nextFireTime < curTime) {
-		// Remove the slot from the priority queue
-		_head->next = slot->next;
-
-		// Update the fire time and reinsert the TimerSlot into the priority
-		// queue.
-		assert(slot->interval > 0);
-		slot->nextFireTime += (slot->interval / 1000);
-		slot->nextFireTimeMicro += (slot->interval % 1000);
-		if (slot->nextFireTimeMicro > 1000) {
-			slot->nextFireTime += slot->nextFireTimeMicro / 1000;
-			slot->nextFireTimeMicro %= 1000;
+			assert(slot->callback);
+			callback = slot->callback;
+			refCon = slot->refCon;
+			_runningSlot = slot;
 		}
-		insertPrioQueue(_head, slot);
 
 		// Invoke the timer callback
-		assert(slot->callback);
-		slot->callback(slot->refCon);
+		const uint32 startTime = g_system->getMillis(true);
+		callback(refCon);
+		const uint32 runtime = g_system->getMillis(true) - startTime;
 
-		// Look at the next scheduled timer
-		slot = _head->next;
+		Common::StackLock lock(_mutex);
+		// The slot is gone in case the callback removed itself
+		if (_runningSlot) {
+			++_runningSlot->numCalls;
+			_runningSlot->totalRuntime += runtime;
+			_runningSlot->maxRuntime = MAX(_runningSlot->maxRuntime, runtime);
+			_runningSlot = 0;
+		}
 	}
 }
 
@@ -134,42 +149,127 @@ bool DefaultTimerManager::installTimerProc(TimerProc callback, int32 interval, v
 	slot->interval = interval;
 	slot->nextFireTime = g_system->getMillis() + interval / 1000;
 	slot->nextFireTimeMicro = interval % 1000;
-	slot->next = 0;
+	slot->numCalls = 0;
+	slot->totalRuntime = 0;
+	slot->maxRuntime = 0;
+	slot->totalLateness = 0;
+	slot->maxLateness = 0;
 
-	insertPrioQueue(_head, slot);
+	_queue.push_back(slot);
+	siftUp(_queue.size() - 1);
 
 	return true;
 }
 
 void DefaultTimerManager::removeTimerProc(TimerProc callback) {
-	Common::StackLock lock(_mutex);
+	bool running = false;
+
+	{
+		Common::StackLock lock(_mutex);
+
+		for (uint i = 0; i < _queue.size(); ) {
+			TimerSlot *slot = _queue[i];
+			if (slot->callback == callback) {
+				if (debugLevelSet(2))
+					logStats(slot);
+
+				if (slot == _runningSlot) {
+					_runningSlot = 0;
+					running = true;
+				}
 
-	TimerSlot *slot = _head;
+				removeSlot(i);
+				delete slot;
+			} else {
+				++i;
+			}
+		}
 
-	while (slot->next) {
-		if (slot->next->callback == callback) {
-			TimerSlot *next = slot->next->next;
-			delete slot->next;
-			slot->next = next;
-		} else {
-			slot = slot->next;
+		// We need to remove all names referencing the timer proc here.
+		//
+		// Else we run into troubles, when the client code removes and readds timer
+		// callbacks.
+		//
+		// Another issues occurs when one plays a game with ALSA as music driver,
+		// does RTL and starts a different engine game with ALSA as music driver.
+		// In this case the MPU401 code will add different timer procs with the
+		// same name, resulting in two different callbacks added with the same
+		// name and causing installTimerProc to error out.
+		// A good test case is running a SCUMM with ALSA output and then a KYRA
+		// game for example.
+		for (TimerSlotMap::iterator i = _callbacks.begin(), end = _callbacks.end(); i != end; ++i) {
+			if (i->_value == callback)
+				_callbacks.erase(i);
 		}
 	}
 
-	// We need to remove all names referencing the timer proc here.
-	//
-	// Else we run into troubles, when the client code removes and readds timer
-	// callbacks.
-	//
-	// Another issues occurs when one plays a game with ALSA as music driver,
-	// does RTL and starts a different engine game with ALSA as music driver.
-	// In this case the MPU401 code will add different timer procs with the
-	// same name, resulting in two different callbacks added with the same
-	// name and causing installTimerProc to error out.
-	// A good test case is running a SCUMM with ALSA output and then a KYRA
-	// game for example.
-	for (TimerSlotMap::iterator i = _callbacks.begin(), end = _callbacks.end(); i != end; ++i) {
-		if (i->_value == callback)
-			_callbacks.erase(i);
+	// Wait for the callback to return, in case it is currently being invoked.
+	// This does not block when the callback removes itself, as mutexes are
+	// recursive.
+	if (running) {
+		Common::StackLock dispatchLock(_dispatchMutex);
+	}
+}
+
+void DefaultTimerManager::dumpStats() {
+	Common::StackLock lock(_mutex);
+
+	debug("Timer statistics (times in ms):");
+	for (uint i = 0; i < _queue.size(); ++i)
+		logStats(_queue[i]);
+}
+
+void DefaultTimerManager::logStats(const TimerSlot *slot) {
+	if (!slot->numCalls) {
+		debug("  %s: interval %u us, never invoked", slot->id.c_str(), slot->interval);
+		return;
+	}
+
+	debug("  %s: interval %u us, %u calls, runtime avg %.2f max %u, lateness avg %.2f max %u",
+	      slot->id.c_str(), slot->interval, slot->numCalls,
+	      (double)slot->totalRuntime / slot->numCalls, slot->maxRuntime,
+	      (double)slot->totalLateness / slot->numCalls, slot->maxLateness);
+}
+
+void DefaultTimerManager::removeSlot(uint index) {
+	const uint last = _queue.size() - 1;
+	if (index != last) {
+		_queue[index] = _queue[last];
+		_queue.pop_back();
+
+		// The moved slot may belong either above or below its new position
+		siftUp(index);
+		siftDown(index);
+	} else {
+		_queue.pop_back();
+	}
+}
+
+void DefaultTimerManager::siftUp(uint index) {
+	TimerSlot *slot = _queue[index];
+	while (index > 0) {
+		const uint parent = (index - 1) / 2;
+		if (!firesBefore(slot, _queue[parent]))
+			break;
+		_queue[index] = _queue[parent];
+		index = parent;
+	}
+	_queue[index] = slot;
+}
+
+void DefaultTimerManager::siftDown(uint index) {
+	const uint size = _queue.size();
+	TimerSlot *slot = _queue[index];
+	while (true) {
+		uint child = 2 * index + 1;
+		if (child >= size)
+			break;
+		if (child + 1 < size && firesBefore(_queue[child + 1], _queue[child]))
+			++child;
+		if (!firesBefore(_queue[child], slot))
+			break;
+		_queue[index] = _queue[child];
+		index = child;
 	}
+	_queue[index] = slot;
 }
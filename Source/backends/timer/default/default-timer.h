@@ -23,6 +23,7 @@
 #ifndef BACKENDS_TIMER_DEFAULT_H
 #define BACKENDS_TIMER_DEFAULT_H
 
+#include "common/array.h"
 #include "common/str.h"
 #include "common/hash-str.h"
 #include "common/timer.h"
@@ -34,9 +35,17 @@ class DefaultTimerManager : public Common::TimerManager {
 private:
 	typedef Common::HashMap<Common::String, TimerProc, Common::IgnoreCase_Hash, Common::IgnoreCase_EqualTo> TimerSlotMap;
 
-	Common::Mutex _mutex;
-	TimerSlot *_head;
+	Common::Mutex _mutex;              ///< Protects the queue and the callback map
+	Common::Mutex _dispatchMutex;      ///< Held while a callback is running
+	Common::Array<TimerSlot *> _queue; ///< Binary min-heap ordered by next fire time
 	TimerSlotMap _callbacks;
+	TimerSlot *_runningSlot;           ///< The slot whose callback is being invoked, if any
+
+	void removeSlot(uint index);
+	void siftUp(uint index);
+	void siftDown(uint index);
+
+	static void logStats(const TimerSlot *slot);
 
 public:
 	DefaultTimerManager();
@@ -48,6 +57,12 @@ public:
 	 * Timer callback, to be invoked at regular time intervals by the backend.
 	 */
 	void handler();
+
+	/**
+	 * Print the runtime and latency statistics of all installed timers to
+	 * the debug log.
+	 */
+	void dumpStats();
 };
 
 #endif
@@ -249,6 +249,9 @@ void registerDefaults() {
 	ConfMan.registerDefault("mt32_device", "null");
 	ConfMan.registerDefault("gm_device", "null");
 	ConfMan.registerDefault("opl2lpt_parport", "null");	
+	ConfMan.registerDefault("resampler", "linear");
+	ConfMan.registerDefault("opl_render_ahead", 0);
+	ConfMan.registerDefault("mt32_render_ahead", 0);
 
 	ConfMan.registerDefault("cdrom", 0);
 
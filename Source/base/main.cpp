@@ -58,6 +58,7 @@
 
 #include "audio/mididrv.h"
 #include "audio/musicplugin.h"  /* for music manager */
+#include "audio/soundcache.h"
 
 #include "graphics/cursorman.h"
 #include "graphics/fontman.h"
@@ -272,6 +273,9 @@ static Common::Error runGame(const Plugin *plugin, OSystem &system, const Common
 	// Free up memory
 	delete engine;
 
+	// Drop the sounds of this game, the next one will not play them
+	g_soundCache.clear();
+
 	// We clear all debug levels again even though the engine should do it
 	DebugMan.clearAllDebugChannels();
 
@@ -25,6 +25,7 @@
 
 #include "common/scummsys.h"
 #include "common/func.h"
+#include "common/memory.h"
 #include "common/util.h"
 
 namespace Common {
@@ -55,6 +56,42 @@ Out copy_backward(In first, In last, Out dst) {
 	return dst;
 }
 
+/**
+ * Moves data from the range [first, last) to [dst, dst + (last - first)).
+ * It requires the range [dst, dst + (last - first)) to be valid.
+ * It also requires dst not to be in the range [first, last).
+ *
+ * Without compiler support for move semantics, this copies the data.
+ */
+template<class In, class Out>
+Out move(In first, In last, Out dst) {
+#ifdef SCUMMVM_HAS_MOVE_SEMANTICS
+	while (first != last)
+		*dst++ = Common::move(*first++);
+	return dst;
+#else
+	return copy(first, last, dst);
+#endif
+}
+
+/**
+ * Moves data from the range [first, last) to [dst - (last - first), dst).
+ * It requires the range [dst - (last - first), dst) to be valid.
+ * It also requires dst not to be in the range [first, last).
+ *
+ * Like copy_backward it processes the data from the end to the beginning.
+ */
+template<class In, class Out>
+Out move_backward(In first, In last, Out dst) {
+#ifdef SCUMMVM_HAS_MOVE_SEMANTICS
+	while (first != last)
+		*--dst = Common::move(*--last);
+	return dst;
+#else
+	return copy_backward(first, last, dst);
+#endif
+}
+
 /**
  * Copies data from the range [first, last) to [dst, dst + (last - first)).
  * It requires the range [dst, dst + (last - first)) to be valid.
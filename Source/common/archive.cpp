@@ -21,6 +21,7 @@
  */
 
 #include "common/archive.h"
+#include "common/atomic.h"
 #include "common/fs.h"
 #include "common/system.h"
 #include "common/textconsole.h"
@@ -62,6 +63,68 @@ int Archive::listMatchingMembers(ArchiveMemberList &list, const String &pattern)
 
 
 
+volatile uint32 SearchSet::_generation = 0;
+
+static uint32 loadGeneration(const volatile uint32 *generation) {
+#ifdef SCUMMVM_HAS_ATOMICS
+	return loadAcquire(generation);
+#else
+	return *generation;
+#endif
+}
+
+SearchSet::SearchSet() : _cacheGeneration(loadGeneration(&_generation)) {
+}
+
+void SearchSet::invalidateCache() {
+#ifdef SCUMMVM_HAS_ATOMICS
+	atomicIncrement(&_generation);
+#else
+	++_generation;
+#endif
+}
+
+void SearchSet::validateCache() const {
+	if (_cacheGeneration == loadGeneration(&_generation))
+		return;
+
+	dropCache();
+}
+
+void SearchSet::dropCache() const {
+	// Read the generation first, so that a modification made meanwhile by
+	// another thread drops the cache again
+	_cacheGeneration = loadGeneration(&_generation);
+	_lookupCache.clear();
+	_missCache.clear();
+	_patternCache.clear();
+}
+
+Archive *SearchSet::lookupArchive(const String &name) const {
+	validateCache();
+
+	LookupCache::const_iterator cached = _lookupCache.find(name);
+	if (cached != _lookupCache.end())
+		return cached->_value;
+	if (_missCache.contains(name))
+		return nullptr;
+
+	ArchiveNodeList::const_iterator it = _list.begin();
+	for (; it != _list.end(); ++it) {
+		if (it->_arc->hasFile(name)) {
+			_lookupCache[name] = it->_arc;
+			return it->_arc;
+		}
+	}
+
+	// Engines probe for lots of names which do not exist, so only the
+	// most recent ones are kept
+	if (_missCache.size() >= kMaxCachedMisses)
+		_missCache.clear();
+	_missCache[name] = true;
+	return nullptr;
+}
+
 SearchSet::ArchiveNodeList::iterator SearchSet::find(const String &name) {
 	ArchiveNodeList::iterator it = _list.begin();
 	for (; it != _list.end(); ++it) {
@@ -92,6 +155,8 @@ void SearchSet::insert(const Node &node) {
 			break;
 	}
 	_list.insert(it, node);
+	invalidateCache();
+	dropCache();
 }
 
 void SearchSet::add(const String &name, Archive *archive, int priority, bool autoFree) {
@@ -173,6 +238,8 @@ void SearchSet::remove(const String &name) {
 		if (it->_autoFree)
 			delete it->_arc;
 		_list.erase(it);
+		invalidateCache();
+		dropCache();
 	}
 }
 
@@ -187,6 +254,7 @@ void SearchSet::clear() {
 	}
 
 	_list.clear();
+	invalidateCache();
 }
 
 void SearchSet::setPriority(const String &name, int priority) {
@@ -209,23 +277,30 @@ bool SearchSet::hasFile(const String &name) const {
 	if (name.empty())
 		return false;
 
-	ArchiveNodeList::const_iterator it = _list.begin();
-	for (; it != _list.end(); ++it) {
-		if (it->_arc->hasFile(name))
-			return true;
-	}
-
-	return false;
+	return lookupArchive(name) != nullptr;
 }
 
 int SearchSet::listMatchingMembers(ArchiveMemberList &list, const String &pattern) const {
-	int matches = 0;
+	validateCache();
 
-	ArchiveNodeList::const_iterator it = _list.begin();
-	for (; it != _list.end(); ++it)
-		matches += it->_arc->listMatchingMembers(list, pattern);
+	PatternCache::const_iterator cached = _patternCache.find(pattern);
+	if (cached == _patternCache.end()) {
+		ArchiveMemberList matches;
 
-	return matches;
+		ArchiveNodeList::const_iterator it = _list.begin();
+		for (; it != _list.end(); ++it)
+			it->_arc->listMatchingMembers(matches, pattern);
+
+		if (_patternCache.size() >= kMaxCachedPatterns)
+			_patternCache.clear();
+		_patternCache[pattern] = matches;
+		cached = _patternCache.find(pattern);
+	}
+
+	const ArchiveMemberList &matches = cached->_value;
+	list.insert(list.end(), matches.begin(), matches.end());
+
+	return matches.size();
 }
 
 int SearchSet::listMembers(ArchiveMemberList &list) const {
@@ -242,11 +317,9 @@ const ArchiveMemberPtr SearchSet::getMember(const String &name) const {
 	if (name.empty())
 		return ArchiveMemberPtr();
 
-	ArchiveNodeList::const_iterator it = _list.begin();
-	for (; it != _list.end(); ++it) {
-		if (it->_arc->hasFile(name))
-			return it->_arc->getMember(name);
-	}
+	Archive *archive = lookupArchive(name);
+	if (archive)
+		return archive->getMember(name);
 
 	return ArchiveMemberPtr();
 }
@@ -255,11 +328,24 @@ SeekableReadStream *SearchSet::createReadStreamForMember(const String &name) con
 	if (name.empty())
 		return nullptr;
 
+	Archive *archive = lookupArchive(name);
+	if (!archive)
+		return nullptr;
+
+	SeekableReadStream *stream = archive->createReadStreamForMember(name);
+	if (stream)
+		return stream;
+
+	// The archive claims to have the member but failed to open it, so
+	// try all the others like an uncached search would.
 	ArchiveNodeList::const_iterator it = _list.begin();
 	for (; it != _list.end(); ++it) {
-		SeekableReadStream *stream = it->_arc->createReadStreamForMember(name);
-		if (stream)
-			return stream;
+		if (it->_arc == archive)
+			continue;
+
+		SeekableReadStream *otherStream = it->_arc->createReadStreamForMember(name);
+		if (otherStream)
+			return otherStream;
 	}
 
 	return nullptr;
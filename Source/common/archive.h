@@ -24,6 +24,8 @@
 #define COMMON_ARCHIVE_H
 
 #include "common/str.h"
+#include "common/hash-str.h"
+#include "common/hashmap.h"
 #include "common/list.h"
 #include "common/ptr.h"
 #include "common/singleton.h"
@@ -132,6 +134,15 @@ public:
  * contained Archives, hence the simplistic policy of always looking for the first
  * match. SearchSet *DOES* guarantee that searches are performed in *DESCENDING*
  * priority order. In case of conflicting priorities, insertion order prevails.
+ *
+ * The result of every lookup is cached (case-insensitively), so asking for the
+ * same name or pattern again does not query the archives anymore. Only a
+ * limited number of names which were not found and of patterns are kept. This assumes
+ * that the content of the archives does not change while they are part of the
+ * set. The caches of all SearchSets are dropped whenever any SearchSet is
+ * modified, which also covers SearchSets nested into other ones. Client code
+ * which changes the content of an archive it added has to call
+ * invalidateCache().
  */
 class SearchSet : public Archive {
 	struct Node {
@@ -152,7 +163,41 @@ class SearchSet : public Archive {
 	// Add an archive keeping the list sorted by descending priority.
 	void insert(const Node& node);
 
+	/** Maps member names to the archive which provides them. */
+	typedef HashMap<String, Archive *, IgnoreCase_Hash, IgnoreCase_EqualTo> LookupCache;
+	/** The names no archive provides. */
+	typedef HashMap<String, bool, IgnoreCase_Hash, IgnoreCase_EqualTo> MissCache;
+	/** Maps patterns to the members matching them. */
+	typedef HashMap<String, ArchiveMemberList, IgnoreCase_Hash, IgnoreCase_EqualTo> PatternCache;
+
+	mutable LookupCache _lookupCache;
+	mutable MissCache _missCache;
+	mutable PatternCache _patternCache;
+	mutable uint32 _cacheGeneration;
+
+	/**
+	 * Bumped on every modification of any SearchSet, from any thread. Without
+	 * SCUMMVM_HAS_ATOMICS the increment is not atomic, all SearchSets then
+	 * have to be modified on the same thread.
+	 */
+	static volatile uint32 _generation;
+
+	// Drop the cached lookups if any SearchSet was modified since they were made.
+	void validateCache() const;
+
+	// Drop the cached lookups of this set.
+	void dropCache() const;
+
+	// Find the archive providing the given member, using the lookup cache.
+	Archive *lookupArchive(const String &name) const;
+
 public:
+	enum {
+		kMaxCachedMisses = 1024,  ///< The names no archive provides are forgotten beyond this number
+		kMaxCachedPatterns = 64   ///< The pattern matches are forgotten beyond this number
+	};
+
+	SearchSet();
 	virtual ~SearchSet() { clear(); }
 
 	/**
@@ -236,6 +281,13 @@ public:
 	 */
 	void setPriority(const String& name, int priority);
 
+	/**
+	 * Drop all cached lookups. Only needed after changing the content of an
+	 * archive which is part of the set; adding or removing archives takes
+	 * care of this automatically.
+	 */
+	static void invalidateCache();
+
 	virtual bool hasFile(const String &name) const;
 	virtual int listMatchingMembers(ArchiveMemberList &list, const String &pattern) const;
 	virtual int listMembers(ArchiveMemberList &list) const;
@@ -84,6 +84,18 @@ public:
 		}
 	}
 
+#ifdef SCUMMVM_HAS_MOVE_SEMANTICS
+	/**
+	 * Constructs an array by taking over the storage of another array,
+	 * which is left empty. No elements are copied.
+	 */
+	Array(Array<T> &&old) : _capacity(old._capacity), _size(old._size), _storage(old._storage) {
+		old._capacity = 0;
+		old._size = 0;
+		old._storage = nullptr;
+	}
+#endif
+
 	/**
 	 * Construct an array by copying data from a regular array.
 	 */
@@ -108,6 +120,13 @@ public:
 			insert_aux(end(), &element, &element + 1);
 	}
 
+#ifdef SCUMMVM_HAS_MOVE_SEMANTICS
+	/** Appends element to the end of the array, moving it into place. */
+	void push_back(T &&element) {
+		emplace_back(Common::move(element));
+	}
+#endif
+
 	void push_back(const Array<T> &array) {
 		if (_size + array.size() <= _capacity) {
 			uninitialized_copy(array.begin(), array.end(), end());
@@ -159,6 +178,49 @@ public:
 	}
 
 
+#ifdef SCUMMVM_HAS_MOVE_SEMANTICS
+	/**
+	 * Constructs a new element at the end of the array, passing the given
+	 * arguments to its constructor.
+	 */
+	template<class... TArgs>
+	void emplace_back(TArgs &&...args) {
+		if (_size + 1 <= _capacity)
+			new ((void *)&_storage[_size++]) T(Common::forward<TArgs>(args)...);
+		else
+			emplace(end(), Common::forward<TArgs>(args)...);
+	}
+
+	/**
+	 * Constructs a new element before pos, passing the given arguments to
+	 * its constructor. The existing elements are moved, not copied, if the
+	 * storage has to be reallocated.
+	 */
+	template<class... TArgs>
+	void emplace(const_iterator pos, TArgs &&...args) {
+		assert(_storage <= pos && pos <= _storage + _size);
+		const size_type idx = pos - _storage;
+
+		if (_size + 1 <= _capacity && idx == _size) {
+			new ((void *)&_storage[idx]) T(Common::forward<TArgs>(args)...);
+		} else {
+			T *const oldStorage = _storage;
+			allocCapacity(roundUpCapacity(_size + 1));
+
+			// Construct the new element first, since the arguments may
+			// refer to an element of the old storage.
+			new ((void *)&_storage[idx]) T(Common::forward<TArgs>(args)...);
+
+			uninitialized_move(oldStorage, oldStorage + idx, _storage);
+			uninitialized_move(oldStorage + idx, oldStorage + _size, _storage + idx + 1);
+
+			freeStorage(oldStorage, _size);
+		}
+
+		_size++;
+	}
+#endif
+
 	void insert_at(size_type idx, const T &element) {
 		assert(idx <= _size);
 		insert_aux(_storage + idx, &element, &element + 1);
@@ -178,8 +240,12 @@ public:
 
 	T remove_at(size_type idx) {
 		assert(idx < _size);
+#ifdef SCUMMVM_HAS_MOVE_SEMANTICS
+		T tmp = Common::move(_storage[idx]);
+#else
 		T tmp = _storage[idx];
-		copy(_storage + idx + 1, _storage + _size, _storage + idx);
+#endif
+		Common::move(_storage + idx + 1, _storage + _size, _storage + idx);
 		_size--;
 		// We also need to destroy the last object properly here.
 		_storage[_size].~T();
@@ -210,6 +276,24 @@ public:
 		return *this;
 	}
 
+#ifdef SCUMMVM_HAS_MOVE_SEMANTICS
+	Array<T> &operator=(Array<T> &&old) {
+		if (this == &old)
+			return *this;
+
+		freeStorage(_storage, _size);
+		_capacity = old._capacity;
+		_size = old._size;
+		_storage = old._storage;
+
+		old._capacity = 0;
+		old._size = 0;
+		old._storage = nullptr;
+
+		return *this;
+	}
+#endif
+
 	size_type size() const {
 		return _size;
 	}
@@ -222,7 +306,7 @@ public:
 	}
 
 	iterator erase(iterator pos) {
-		copy(pos + 1, _storage + _size, pos);
+		Common::move(pos + 1, _storage + _size, pos);
 		_size--;
 		// We also need to destroy the last object properly here.
 		_storage[_size].~T();
@@ -273,8 +357,8 @@ public:
 		allocCapacity(newCapacity);
 
 		if (oldStorage) {
-			// Copy old data
-			uninitialized_copy(oldStorage, oldStorage + _size, _storage);
+			// Move old data
+			uninitialized_move(oldStorage, oldStorage + _size, _storage);
 			freeStorage(oldStorage, _size);
 		}
 	}
@@ -347,30 +431,31 @@ protected:
 				// storage to avoid conflicts.
 				allocCapacity(roundUpCapacity(_size + n));
 
-				// Copy the data from the old storage till the position where
-				// we insert new data
-				uninitialized_copy(oldStorage, oldStorage + idx, _storage);
-				// Copy the data we insert
+				// Copy the data we insert. This has to happen first, since
+				// for a self-insert the source range is moved away below.
 				uninitialized_copy(first, last, _storage + idx);
-				// Afterwards copy the old data from the position where we
+				// Move the data from the old storage till the position where
+				// we insert new data
+				uninitialized_move(oldStorage, oldStorage + idx, _storage);
+				// Afterwards move the old data from the position where we
 				// insert.
-				uninitialized_copy(oldStorage + idx, oldStorage + _size, _storage + idx + n);
+				uninitialized_move(oldStorage + idx, oldStorage + _size, _storage + idx + n);
 
 				freeStorage(oldStorage, _size);
 			} else if (idx + n <= _size) {
 				// Make room for the new elements by shifting back
 				// existing ones.
 				// 1. Move a part of the data to the uninitialized area
-				uninitialized_copy(_storage + _size - n, _storage + _size, _storage + _size);
+				uninitialized_move(_storage + _size - n, _storage + _size, _storage + _size);
 				// 2. Move a part of the data to the initialized area
-				copy_backward(pos, _storage + _size - n, _storage + _size);
+				move_backward(pos, _storage + _size - n, _storage + _size);
 
 				// Insert the new elements.
 				copy(first, last, pos);
 			} else {
-				// Copy the old data from the position till the end to the new
+				// Move the old data from the position till the end to the new
 				// place.
-				uninitialized_copy(pos, _storage + _size, _storage + idx + n);
+				uninitialized_move(pos, _storage + _size, _storage + idx + n);
 
 				// Copy a part of the new data to the position inside the
 				// initialized space.
@@ -432,6 +517,16 @@ private:
 
 	void push_back(const Array<T> &array);
 
+#ifdef SCUMMVM_HAS_MOVE_SEMANTICS
+	void push_back(T &&element);
+
+	template<class... TArgs>
+	void emplace_back(TArgs &&...args);
+
+	template<class... TArgs>
+	void emplace(typename Array<T>::const_iterator pos, TArgs &&...args);
+#endif
+
 	// Based on code Copyright (C) 2008-2009 Ksplice, Inc.
 	// Author: Tim Abbott <tabbott@ksplice.com>
 	// Licensed under GPLv2+
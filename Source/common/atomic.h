@@ -0,0 +1,86 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef COMMON_ATOMIC_H
+#define COMMON_ATOMIC_H
+
+#include "common/scummsys.h"
+
+/**
+ * @file
+ * Minimal support for lock-free structures shared between threads.
+ *
+ * Where the compiler offers atomic loads and stores SCUMMVM_HAS_ATOMICS is
+ * defined, and loadAcquire and storeRelease can be used to publish data
+ * from one thread to another, while atomicIncrement increments a counter
+ * shared by several threads and returns its new value. Code using them has
+ * to provide a fallback using a Common::Mutex for other compilers.
+ */
+
+#if defined(__clang__) || (defined(__GNUC__) && (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 7)))
+#define SCUMMVM_HAS_ATOMICS
+
+namespace Common {
+
+inline uint32 loadAcquire(const volatile uint32 *ptr) {
+	return __atomic_load_n(ptr, __ATOMIC_ACQUIRE);
+}
+
+inline void storeRelease(volatile uint32 *ptr, uint32 val) {
+	__atomic_store_n(ptr, val, __ATOMIC_RELEASE);
+}
+
+inline uint32 atomicIncrement(volatile uint32 *ptr) {
+	return __atomic_add_fetch(ptr, 1, __ATOMIC_ACQ_REL);
+}
+
+} // End of namespace Common
+
+#elif defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64))
+#define SCUMMVM_HAS_ATOMICS
+
+#include "common/math.h"	// for intrin.h on MSVC
+
+namespace Common {
+
+// x86 does not reorder loads with loads or stores with stores, so
+// preventing compiler reordering is sufficient here.
+inline uint32 loadAcquire(const volatile uint32 *ptr) {
+	uint32 val = *ptr;
+	_ReadWriteBarrier();
+	return val;
+}
+
+inline void storeRelease(volatile uint32 *ptr, uint32 val) {
+	_ReadWriteBarrier();
+	*ptr = val;
+}
+
+inline uint32 atomicIncrement(volatile uint32 *ptr) {
+	return (uint32)_InterlockedIncrement((volatile long *)ptr);
+}
+
+} // End of namespace Common
+
+#endif
+
+#endif
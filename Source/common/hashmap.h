@@ -44,6 +44,7 @@
 
 
 #include "common/func.h"
+#include "common/memory.h"
 
 #ifdef DEBUG_HASH_COLLISIONS
 #include "common/debug.h"
@@ -90,7 +91,12 @@ private:
 	struct Node {
 		const Key _key;
 		Val _value;
+#ifdef SCUMMVM_HAS_MOVE_SEMANTICS
+		template<class... TArgs>
+		explicit Node(const Key &key, TArgs &&...args) : _key(key), _value(Common::forward<TArgs>(args)...) {}
+#else
 		explicit Node(const Key &key) : _key(key), _value() {}
+#endif
 		Node() : _key(), _value() {}
 	};
 
@@ -131,6 +137,16 @@ private:
 	mutable int _collisions, _lookups, _dummyHits;
 #endif
 
+#ifdef SCUMMVM_HAS_MOVE_SEMANTICS
+	template<class... TArgs>
+	Node *allocNode(const Key &key, TArgs &&...args) {
+#ifdef USE_HASHMAP_MEMORY_POOL
+		return new (_nodePool) Node(key, Common::forward<TArgs>(args)...);
+#else
+		return new Node(key, Common::forward<TArgs>(args)...);
+#endif
+	}
+#else
 	Node *allocNode(const Key &key) {
 #ifdef USE_HASHMAP_MEMORY_POOL
 		return new (_nodePool) Node(key);
@@ -138,6 +154,7 @@ private:
 		return new Node(key);
 #endif
 	}
+#endif
 
 	void freeNode(Node *node) {
 		if (node && node != HASHMAP_DUMMY_NODE)
@@ -149,7 +166,12 @@ private:
 	}
 
 	void assign(const HM_t &map);
+#ifdef SCUMMVM_HAS_MOVE_SEMANTICS
+	void assignMove(HM_t &map);
+#endif
 	size_type lookup(const Key &key) const;
+	size_type lookupInsertPosition(const Key &key, bool &found);
+	size_type insertNode(size_type ctr, Node *node);
 	size_type lookupAndCreateIfMissing(const Key &key);
 	void expandStorage(size_type newCapacity);
 
@@ -221,6 +243,9 @@ public:
 
 	HashMap();
 	HashMap(const HM_t &map);
+#ifdef SCUMMVM_HAS_MOVE_SEMANTICS
+	HashMap(HM_t &&map);
+#endif
 	~HashMap();
 
 	HM_t &operator=(const HM_t &map) {
@@ -235,6 +260,18 @@ public:
 		return *this;
 	}
 
+#ifdef SCUMMVM_HAS_MOVE_SEMANTICS
+	HM_t &operator=(HM_t &&map) {
+		if (this == &map)
+			return *this;
+
+		clear();
+		delete[] _storage;
+		assignMove(map);
+		return *this;
+	}
+#endif
+
 	bool contains(const Key &key) const;
 
 	Val &operator[](const Key &key);
@@ -245,6 +282,30 @@ public:
 	const Val &getVal(const Key &key, const Val &defaultVal) const;
 	void setVal(const Key &key, const Val &val);
 
+#ifdef SCUMMVM_HAS_MOVE_SEMANTICS
+	void setVal(const Key &key, Val &&val);
+
+	/**
+	 * Constructs the value for the given key in place, passing the given
+	 * arguments to its constructor. An existing value for the key is
+	 * replaced.
+	 *
+	 * @return a reference to the new value
+	 */
+	template<class... TArgs>
+	Val &emplace(const Key &key, TArgs &&...args);
+
+	/**
+	 * Constructs the value for the given key in place, passing the given
+	 * arguments to its constructor, but only if the key is not yet present.
+	 * An existing value is left untouched and the arguments are not used.
+	 *
+	 * @return true if a new value was inserted, false if the key was present
+	 */
+	template<class... TArgs>
+	bool tryEmplace(const Key &key, TArgs &&...args);
+#endif
+
 	void clear(bool shrinkArray = 0);
 
 	void erase(iterator entry);
@@ -344,6 +405,25 @@ HashMap<Key, Val, HashFunc, EqualFunc>::HashMap(const HM_t &map) :
 	assign(map);
 }
 
+#ifdef SCUMMVM_HAS_MOVE_SEMANTICS
+/**
+ * Move constructor. The nodes of a HashMap live in its own memory pool,
+ * so they cannot simply be taken over; instead the values are moved into
+ * freshly allocated nodes. The keys keep their slots, so no rehash is
+ * needed. The given hashmap is left empty.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+HashMap<Key, Val, HashFunc, EqualFunc>::HashMap(HM_t &&map) :
+	_defaultVal() {
+#ifdef DEBUG_HASH_COLLISIONS
+	_collisions = 0;
+	_lookups = 0;
+	_dummyHits = 0;
+#endif
+	assignMove(map);
+}
+#endif
+
 /**
  * Destructor, frees all used memory.
  */
@@ -392,6 +472,39 @@ void HashMap<Key, Val, HashFunc, EqualFunc>::assign(const HM_t &map) {
 }
 
 
+#ifdef SCUMMVM_HAS_MOVE_SEMANTICS
+/**
+ * Internal method for moving the content of another HashMap to this one.
+ * The other HashMap is left empty.
+ *
+ * @note We do *not* deallocate the previous storage here -- the caller is
+ *       responsible for doing that!
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void HashMap<Key, Val, HashFunc, EqualFunc>::assignMove(HM_t &map) {
+	_mask = map._mask;
+	_storage = new Node *[_mask + 1];
+	assert(_storage != nullptr);
+	memset(_storage, 0, (_mask + 1) * sizeof(Node *));
+
+	_size = 0;
+	_deleted = 0;
+	for (size_type ctr = 0; ctr <= _mask; ++ctr) {
+		if (map._storage[ctr] == HASHMAP_DUMMY_NODE) {
+			_storage[ctr] = HASHMAP_DUMMY_NODE;
+			_deleted++;
+		} else if (map._storage[ctr] != nullptr) {
+			_storage[ctr] = allocNode(map._storage[ctr]->_key, Common::move(map._storage[ctr]->_value));
+			_size++;
+		}
+	}
+	assert(_size == map._size);
+	assert(_deleted == map._deleted);
+
+	map.clear(true);
+}
+#endif
+
 template<class Key, class Val, class HashFunc, class EqualFunc>
 void HashMap<Key, Val, HashFunc, EqualFunc>::clear(bool shrinkArray) {
 	for (size_type ctr = 0; ctr <= _mask; ++ctr) {
@@ -406,7 +519,7 @@ void HashMap<Key, Val, HashFunc, EqualFunc>::clear(bool shrinkArray) {
 	if (shrinkArray && _mask >= HASHMAP_MIN_CAPACITY) {
 		delete[] _storage;
 
-		_mask = HASHMAP_MIN_CAPACITY;
+		_mask = HASHMAP_MIN_CAPACITY - 1;
 		_storage = new Node *[HASHMAP_MIN_CAPACITY];
 		assert(_storage != nullptr);
 		memset(_storage, 0, HASHMAP_MIN_CAPACITY * sizeof(Node *));
@@ -494,12 +607,12 @@ typename HashMap<Key, Val, HashFunc, EqualFunc>::size_type HashMap<Key, Val, Has
 }
 
 template<class Key, class Val, class HashFunc, class EqualFunc>
-typename HashMap<Key, Val, HashFunc, EqualFunc>::size_type HashMap<Key, Val, HashFunc, EqualFunc>::lookupAndCreateIfMissing(const Key &key) {
+typename HashMap<Key, Val, HashFunc, EqualFunc>::size_type HashMap<Key, Val, HashFunc, EqualFunc>::lookupInsertPosition(const Key &key, bool &found) {
 	const size_type hash = _hash(key);
 	size_type ctr = hash & _mask;
 	const size_type NONE_FOUND = _mask + 1;
 	size_type first_free = NONE_FOUND;
-	bool found = false;
+	found = false;
 	for (size_type perturb = hash; ; perturb >>= HASHMAP_PERTURB_SHIFT) {
 		if (_storage[ctr] == nullptr)
 			break;
@@ -531,28 +644,48 @@ typename HashMap<Key, Val, HashFunc, EqualFunc>::size_type HashMap<Key, Val, Has
 	if (!found && first_free != _mask + 1)
 		ctr = first_free;
 
-	if (!found) {
-		if (_storage[ctr])
-			_deleted--;
-		_storage[ctr] = allocNode(key);
-		assert(_storage[ctr] != nullptr);
-		_size++;
+	return ctr;
+}
 
-		// Keep the load factor below a certain threshold.
-		// Deleted nodes are also counted
-		size_type capacity = _mask + 1;
-		if ((_size + _deleted) * HASHMAP_LOADFACTOR_DENOMINATOR >
-		        capacity * HASHMAP_LOADFACTOR_NUMERATOR) {
-			capacity = capacity < 500 ? (capacity * 4) : (capacity * 2);
-			expandStorage(capacity);
-			ctr = lookup(key);
-			assert(_storage[ctr] != nullptr);
-		}
+/**
+ * Internal method for storing a newly allocated node at the free position
+ * ctr returned by lookupInsertPosition. Grows the storage if needed.
+ *
+ * @return the position of the node after a possible rehash
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+typename HashMap<Key, Val, HashFunc, EqualFunc>::size_type HashMap<Key, Val, HashFunc, EqualFunc>::insertNode(size_type ctr, Node *node) {
+	if (_storage[ctr])
+		_deleted--;
+	_storage[ctr] = node;
+	assert(_storage[ctr] != nullptr);
+	_size++;
+
+	// Keep the load factor below a certain threshold.
+	// Deleted nodes are also counted
+	size_type capacity = _mask + 1;
+	if ((_size + _deleted) * HASHMAP_LOADFACTOR_DENOMINATOR >
+	        capacity * HASHMAP_LOADFACTOR_NUMERATOR) {
+		capacity = capacity < 500 ? (capacity * 4) : (capacity * 2);
+		expandStorage(capacity);
+		ctr = lookup(node->_key);
+		assert(_storage[ctr] != nullptr);
 	}
 
 	return ctr;
 }
 
+template<class Key, class Val, class HashFunc, class EqualFunc>
+typename HashMap<Key, Val, HashFunc, EqualFunc>::size_type HashMap<Key, Val, HashFunc, EqualFunc>::lookupAndCreateIfMissing(const Key &key) {
+	bool found;
+	size_type ctr = lookupInsertPosition(key, found);
+
+	if (!found)
+		ctr = insertNode(ctr, allocNode(key));
+
+	return ctr;
+}
+
 
 template<class Key, class Val, class HashFunc, class EqualFunc>
 bool HashMap<Key, Val, HashFunc, EqualFunc>::contains(const Key &key) const {
@@ -598,6 +731,45 @@ void HashMap<Key, Val, HashFunc, EqualFunc>::setVal(const Key &key, const Val &v
 	_storage[ctr]->_value = val;
 }
 
+#ifdef SCUMMVM_HAS_MOVE_SEMANTICS
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void HashMap<Key, Val, HashFunc, EqualFunc>::setVal(const Key &key, Val &&val) {
+	bool found;
+	size_type ctr = lookupInsertPosition(key, found);
+	if (found)
+		_storage[ctr]->_value = Common::move(val);
+	else
+		insertNode(ctr, allocNode(key, Common::move(val)));
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+template<class... TArgs>
+Val &HashMap<Key, Val, HashFunc, EqualFunc>::emplace(const Key &key, TArgs &&...args) {
+	bool found;
+	size_type ctr = lookupInsertPosition(key, found);
+	if (found) {
+		// The arguments may refer to the old value, so it must not be
+		// destroyed before the new one has been constructed.
+		_storage[ctr]->_value = Val(Common::forward<TArgs>(args)...);
+	} else {
+		ctr = insertNode(ctr, allocNode(key, Common::forward<TArgs>(args)...));
+	}
+	return _storage[ctr]->_value;
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+template<class... TArgs>
+bool HashMap<Key, Val, HashFunc, EqualFunc>::tryEmplace(const Key &key, TArgs &&...args) {
+	bool found;
+	size_type ctr = lookupInsertPosition(key, found);
+	if (found)
+		return false;
+
+	insertNode(ctr, allocNode(key, Common::forward<TArgs>(args)...));
+	return true;
+}
+#endif
+
 template<class Key, class Val, class HashFunc, class EqualFunc>
 void HashMap<Key, Val, HashFunc, EqualFunc>::erase(iterator entry) {
 	// Check whether we have a valid iterator
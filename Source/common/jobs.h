@@ -0,0 +1,123 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef COMMON_JOBS_H
+#define COMMON_JOBS_H
+
+#include "common/scummsys.h"
+#include "common/noncopyable.h"
+
+namespace Common {
+
+/**
+ * The job manager allows running CPU heavy work on a pool of worker threads.
+ *
+ * Not all backends support threads. Those execute every job synchronously,
+ * i.e. before addJob() returns. Code using the job manager hence has to work
+ * correctly, if more slowly, in that case. In particular jobs must not wait
+ * for other jobs which have not been added yet.
+ *
+ * Jobs may run in parallel with each other and with the main thread, so
+ * they should be written following the same safety guidelines as timer
+ * callbacks. Jobs must not call any OSystem methods apart from the mutex
+ * functions.
+ */
+class JobManager : NonCopyable {
+public:
+	typedef void (*JobProc)(void *refCon);
+	typedef void (*RangeProc)(void *refCon, uint begin, uint end);
+
+	/** Identifies an added job. */
+	typedef uint32 JobHandle;
+
+	enum {
+		/** A handle which never refers to a job. */
+		kInvalidJob = 0
+	};
+
+	virtual ~JobManager() {}
+
+	/**
+	 * Return the number of worker threads, or 0 if jobs are executed
+	 * synchronously.
+	 */
+	virtual uint getWorkerCount() const = 0;
+
+	/**
+	 * Add a job, which will be executed on one of the worker threads.
+	 *
+	 * @param proc        the function to execute
+	 * @param refCon      an arbitrary void pointer; will be passed to proc
+	 *                    and completion
+	 * @param name        name of the job, used for the statistics; must
+	 *                    stay valid as long as the job manager exists
+	 * @param completion  optional function, which is called on the main
+	 *                    thread from processCompletions() after proc
+	 *                    returned
+	 * @return a handle, which can be used to query the state of the job
+	 */
+	virtual JobHandle addJob(JobProc proc, void *refCon, const char *name, JobProc completion = nullptr) = 0;
+
+	/**
+	 * Check whether the given job has been executed. The completion
+	 * callback might not have been called yet.
+	 */
+	virtual bool isJobFinished(JobHandle job) = 0;
+
+	/**
+	 * Wait until the given job has been executed. The calling thread may
+	 * execute other jobs meanwhile.
+	 */
+	virtual void waitForJob(JobHandle job) = 0;
+
+	/**
+	 * Split the range [begin, end) into pieces of at most grainSize
+	 * elements and call proc for all of them, in parallel. This returns
+	 * once all pieces have been processed; the calling thread processes
+	 * pieces itself, too.
+	 *
+	 * @param begin      start of the range
+	 * @param end        end of the range, exclusive
+	 * @param grainSize  maximal number of elements passed to one call of proc
+	 * @param proc       the function processing a piece of the range
+	 * @param refCon     an arbitrary void pointer; will be passed to proc
+	 * @param name       name of the loop, used for the statistics
+	 */
+	virtual void parallelFor(uint begin, uint end, uint grainSize, RangeProc proc, void *refCon, const char *name) = 0;
+
+	/**
+	 * Call the completion callbacks of all finished jobs. This is done by
+	 * the event manager when polling events, so usually there is no need
+	 * to call this manually.
+	 */
+	virtual void processCompletions() = 0;
+
+	/**
+	 * Print the number of executed jobs and their run times, grouped by job
+	 * name, to the debug log.
+	 */
+	virtual void dumpStats() = 0;
+};
+
+} // End of namespace Common
+
+#endif
@@ -27,6 +27,40 @@
 
 namespace Common {
 
+#ifdef SCUMMVM_HAS_MOVE_SEMANTICS
+
+/**
+ * Strips a reference from a type, like std::remove_reference.
+ */
+template<class T> struct remove_reference { typedef T type; };
+template<class T> struct remove_reference<T &> { typedef T type; };
+template<class T> struct remove_reference<T &&> { typedef T type; };
+
+/**
+ * Casts its argument to an rvalue reference so that the move constructor
+ * or move assignment operator of the type is selected, like std::move.
+ */
+template<class T>
+inline typename remove_reference<T>::type &&move(T &&t) {
+	return static_cast<typename remove_reference<T>::type &&>(t);
+}
+
+/**
+ * Forwards an argument with its original value category, like std::forward.
+ * Used to pass constructor arguments through to in-place construction.
+ */
+template<class T>
+inline T &&forward(typename remove_reference<T>::type &t) {
+	return static_cast<T &&>(t);
+}
+
+template<class T>
+inline T &&forward(typename remove_reference<T>::type &&t) {
+	return static_cast<T &&>(t);
+}
+
+#endif
+
 /**
  * Copies data from the range [first, last) to [dst, dst + (last - first)).
  * It requires the range [dst, dst + (last - first)) to be valid and
@@ -39,6 +73,25 @@ Type *uninitialized_copy(In first, In last, Type *dst) {
 	return dst;
 }
 
+/**
+ * Moves data from the range [first, last) to [dst, dst + (last - first)).
+ * It requires the range [dst, dst + (last - first)) to be valid and
+ * uninitialized. The source objects are left in a valid but unspecified
+ * state and still have to be destroyed by the caller.
+ *
+ * Without compiler support for move semantics, this copies the data.
+ */
+template<class In, class Type>
+Type *uninitialized_move(In first, In last, Type *dst) {
+	while (first != last)
+#ifdef SCUMMVM_HAS_MOVE_SEMANTICS
+		new ((void *)dst++) Type(Common::move(*first++));
+#else
+		new ((void *)dst++) Type(*first++);
+#endif
+	return dst;
+}
+
 /**
  * Initializes the memory [first, first + (last - first)) with the value x.
  * It requires the range [first, first + (last - first)) to be valid and
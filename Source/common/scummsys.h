@@ -180,6 +180,17 @@
 #endif
 #endif
 
+#ifndef SCUMMVM_HAS_MOVE_SEMANTICS
+#if __cplusplus >= 201103L || (defined(_MSC_VER) && _MSC_VER >= 1800)
+	/**
+	 * Defined when the compiler supports rvalue references and variadic
+	 * templates, i.e. when the containers can offer move construction and
+	 * in-place (emplace) construction of their elements.
+	 */
+	#define SCUMMVM_HAS_MOVE_SEMANTICS
+#endif
+#endif
+
 // The following math constants are usually defined by the system math.h header, but
 // they are not part of the ANSI C++ standards and so can NOT be relied upon to be
 // present i.e. when -std=c++11 is passed to GCC, enabling strict ANSI compliance.
@@ -90,6 +90,25 @@ String::String(const String &str)
 	assert(_str != nullptr);
 }
 
+#ifdef SCUMMVM_HAS_MOVE_SEMANTICS
+String::String(String &&str)
+	: _size(str._size) {
+	if (str.isStorageIntern()) {
+		// String in internal storage: just copy it
+		memcpy(_storage, str._storage, _builtinCapacity);
+		_str = _storage;
+	} else {
+		// String in external storage: take over the reference
+		_extern._refCount = str._extern._refCount;
+		_extern._capacity = str._extern._capacity;
+		_str = str._str;
+	}
+	assert(_str != nullptr);
+
+	str.resetToEmpty();
+}
+#endif
+
 String::String(char c)
 	: _size(0), _str(_storage) {
 
@@ -237,6 +256,30 @@ String &String::operator=(const String &str) {
 	return *this;
 }
 
+#ifdef SCUMMVM_HAS_MOVE_SEMANTICS
+String &String::operator=(String &&str) {
+	if (&str == this)
+		return *this;
+
+	decRefCount(_extern._refCount);
+
+	if (str.isStorageIntern()) {
+		_size = str._size;
+		_str = _storage;
+		memcpy(_str, str._str, _size + 1);
+	} else {
+		_extern._refCount = str._extern._refCount;
+		_extern._capacity = str._extern._capacity;
+		_size = str._size;
+		_str = str._str;
+	}
+
+	str.resetToEmpty();
+
+	return *this;
+}
+#endif
+
 String &String::operator=(char c) {
 	decRefCount(_extern._refCount);
 	_str = _storage;
@@ -120,6 +120,14 @@ public:
 	/** Construct a copy of the given string. */
 	String(const String &str);
 
+#ifdef SCUMMVM_HAS_MOVE_SEMANTICS
+	/**
+	 * Construct a string by taking over the storage of the given string,
+	 * which is left empty. Avoids touching the reference count.
+	 */
+	String(String &&str);
+#endif
+
 	/** Construct a string consisting of the given character. */
 	explicit String(char c);
 
@@ -127,6 +135,9 @@ public:
 
 	String &operator=(const char *str);
 	String &operator=(const String &str);
+#ifdef SCUMMVM_HAS_MOVE_SEMANTICS
+	String &operator=(String &&str);
+#endif
 	String &operator=(char c);
 	String &operator+=(const char *str);
 	String &operator+=(const String &str);
@@ -328,6 +339,16 @@ protected:
 	void incRefCount() const;
 	void decRefCount(int *oldRefCount);
 	void initWithCStr(const char *str, uint32 len);
+
+	/**
+	 * Make this an empty string in internal storage without releasing the
+	 * previous storage. Used after the storage was handed over by a move.
+	 */
+	void resetToEmpty() {
+		_size = 0;
+		_str = _storage;
+		_storage[0] = 0;
+	}
 };
 
 // Append two strings to form a new (temp) string
@@ -25,6 +25,7 @@
 #include "common/system.h"
 #include "common/events.h"
 #include "common/fs.h"
+#include "common/jobs.h"
 #include "common/savefile.h"
 #include "common/str.h"
 #include "common/taskbar.h"
@@ -41,6 +42,7 @@ OSystem::OSystem() {
 	_audiocdManager = nullptr;
 	_eventManager = nullptr;
 	_timerManager = nullptr;
+	_jobManager = nullptr;
 	_savefileManager = nullptr;
 #if defined(USE_TASKBAR)
 	_taskbarManager = nullptr;
@@ -61,6 +63,9 @@ OSystem::~OSystem() {
 	delete _timerManager;
 	_timerManager = nullptr;
 
+	delete _jobManager;
+	_jobManager = nullptr;
+
 #if defined(USE_TASKBAR)
 	delete _taskbarManager;
 	_taskbarManager = nullptr;
@@ -86,6 +91,8 @@ void OSystem::initBackend() {
 		error("Backend failed to instantiate event manager");
 	if (!getTimerManager())
 		error("Backend failed to instantiate timer manager");
+	if (!_jobManager)
+		error("Backend failed to instantiate job manager");
 
 	// TODO: We currently don't check _savefileManager, because at least
 	// on the Nintendo DS, it is possible that none is set. That should
@@ -50,6 +50,7 @@ class TaskbarManager;
 class UpdateManager;
 #endif
 class TimerManager;
+class JobManager;
 class SeekableReadStream;
 class WriteStream;
 #ifdef ENABLE_KEYMAPPER
@@ -154,6 +155,15 @@ protected:
 	 */
 	Common::TimerManager *_timerManager;
 
+	/**
+	 * No default value is provided for _jobManager by OSystem.
+	 * However, BaseBackend::initBackend() does set a default value
+	 * if none has been set before.
+	 *
+	 * @note _jobManager is deleted by the OSystem destructor.
+	 */
+	Common::JobManager *_jobManager;
+
 	/**
 	 * No default value is provided for _savefileManager by OSystem.
 	 *
@@ -1010,6 +1020,14 @@ public:
 	 */
 	virtual Common::TimerManager *getTimerManager();
 
+	/**
+	 * Return the job manager singleton. For more information, refer
+	 * to the JobManager documentation.
+	 */
+	inline Common::JobManager *getJobManager() {
+		return _jobManager;
+	}
+
 	/**
 	 * Return the event manager singleton. For more information, refer
 	 * to the EventManager documentation.
@@ -1063,10 +1081,11 @@ public:
 	 * Historically, the OSystem API used to have a method which allowed
 	 * creating threads. Hence mutex support was needed for thread syncing.
 	 * To ease portability, though, we decided to remove the threading API.
-	 * Instead, we now use timers (see setTimerCallback() and Common::Timer).
+	 * Instead, we now use timers (see setTimerCallback() and Common::Timer)
+	 * and jobs (see Common::JobManager).
 	 * But since those may be implemented using threads (and in fact, that's
 	 * how our primary backend, the SDL one, does it on many systems), we
-	 * still have to do mutex syncing in our timer callbacks.
+	 * still have to do mutex syncing in our timer callbacks and jobs.
 	 * In addition, the sound mixer uses a mutex in case the backend runs it
 	 * from a dedicated thread (as e.g. the SDL backend does).
 	 *
@@ -106,7 +106,10 @@ typedef struct {
 #include "common/fs.h"
 #include "common/unzip.h"
 #include "common/memstream.h"
+#include "common/substream.h"
+#include "common/ptr.h"
 
+#include "common/array.h"
 #include "common/hashmap.h"
 #include "common/hash-str.h"
 
@@ -382,6 +385,7 @@ typedef Common::HashMap<Common::String, cached_file_in_zip, Common::IgnoreCase_H
 */
 typedef struct {
 	Common::SeekableReadStream *_stream;				/* io structore of the zipfile */
+	Common::SharedPtr<Common::SeekableReadStream> _sharedStream;	/* owner of _stream, shared with member streams */
 	unz_global_info gi;				/* public global information */
 	uLong byte_before_the_zipfile;	/* byte before the zipfile, (>0 for sfx)*/
 	uLong num_file;					/* number of the current file in the zipfile*/
@@ -544,6 +548,7 @@ unzFile unzOpen(Common::SeekableReadStream *stream) {
 	int err=UNZ_OK;
 
 	us->_stream = stream;
+	us->_sharedStream = Common::SharedPtr<Common::SeekableReadStream>(stream);
 
 	central_pos = unzlocal_SearchCentralDir(*us->_stream);
 	if (central_pos==0)
@@ -595,7 +600,6 @@ unzFile unzOpen(Common::SeekableReadStream *stream) {
 		err=UNZ_BADZIPFILE;
 
 	if (err != UNZ_OK) {
-		delete us->_stream;
 		delete us;
 		return nullptr;
 	}
@@ -644,7 +648,8 @@ int unzClose(unzFile file) {
 	if (s->pfile_in_zip_read != nullptr)
 		unzCloseCurrentFile(file);
 
-	delete s->_stream;
+	// The zipfile stream itself is released by _sharedStream once no
+	// member stream uses it anymore.
 	delete s;
 	return UNZ_OK;
 }
@@ -1125,6 +1130,33 @@ int unzOpenCurrentFile (unzFile file) {
 }
 
 
+/*
+  Get the position of the data of the current file in the zipfile stream,
+  i.e. the position right after its local header, without opening it.
+  return UNZ_OK if there is no problem.
+*/
+static int unzlocal_GetCurrentFileDataPos(unzFile file, uLong *pPos) {
+	unz_s* s;
+	uInt iSizeVar;
+	uLong offset_local_extrafield;
+	uInt  size_local_extrafield;
+
+	if (file==nullptr)
+		return UNZ_PARAMERROR;
+	s=(unz_s*)file;
+	if (!s->current_file_ok)
+		return UNZ_PARAMERROR;
+
+	if (unzlocal_CheckCurrentFileCoherencyHeader(s,&iSizeVar,
+				&offset_local_extrafield,&size_local_extrafield)!=UNZ_OK)
+		return UNZ_BADZIPFILE;
+
+	*pPos = s->cur_file_info_internal.offset_curfile + SIZEZIPLOCALHEADER +
+		iSizeVar + s->byte_before_the_zipfile;
+	return UNZ_OK;
+}
+
+
 /*
   Read bytes from the current file.
   buf contain buffer where data must be copied
@@ -1485,36 +1517,309 @@ const ArchiveMemberPtr ZipArchive::getMember(const String &name) const {
 	return ArchiveMemberPtr(new GenericArchiveMember(name, this));
 }
 
-SeekableReadStream *ZipArchive::createReadStreamForMember(const String &name) const {
-	if (unzLocateFile(_zipFile, name.c_str(), 2) != UNZ_OK)
-		return nullptr;
+enum {
+	/**
+	 * Compressed members up to this size are decompressed into memory right
+	 * away; for them the inflate state of a streaming reader would cost more
+	 * memory than the data itself.
+	 */
+	kZipMemoryMemberLimit = 64 * 1024,
 
-	unz_file_info fileInfo;
-	if (unzOpenCurrentFile(_zipFile) != UNZ_OK)
-		return nullptr;
+	/** Minimal distance between two inflate checkpoints. */
+	kZipMinCheckpointInterval = 256 * 1024,
 
-	if (unzGetCurrentFileInfo(_zipFile, &fileInfo, nullptr, 0, nullptr, 0, nullptr, 0) != UNZ_OK)
+	/** Maximal number of inflate checkpoints kept for one member. */
+	kZipMaxCheckpoints = 32
+};
+
+/**
+ * Read stream for a member which is stored without compression. It reads
+ * straight from the zipfile stream, so the data is never copied into memory.
+ * The zipfile stream is kept alive for as long as the member stream exists,
+ * even if the ZipArchive is deleted earlier.
+ */
+class ZipStoredReadStream : public SafeSeekableSubReadStream {
+	SharedPtr<SeekableReadStream> _zipStream;
+
+public:
+	ZipStoredReadStream(const SharedPtr<SeekableReadStream> &zipStream, uint32 begin, uint32 end)
+		: SafeSeekableSubReadStream(zipStream.get(), begin, end), _zipStream(zipStream) {
+	}
+};
+
+#ifdef USE_ZLIB
+
+/**
+ * Read stream for a deflated member which decompresses its data on demand.
+ *
+ * Every instance has its own inflate state and reads the compressed data
+ * through its own SafeSeekableSubReadStream, so several members of the same
+ * archive can be read independently. Seeking forward decompresses and drops
+ * the data in between. To keep seeking backward cheap, a copy of the inflate
+ * state is saved in regular intervals, so a backward seek only has to restart
+ * from the closest checkpoint instead of from the beginning of the member.
+ */
+class ZipInflateReadStream : public SeekableReadStream {
+	struct Checkpoint {
+		uint32 pos;				///< uncompressed position of the checkpoint
+		uint32 compressedPos;	///< position of the next unconsumed compressed byte
+		z_stream *state;		///< copy of the inflate state at that point
+	};
+
+	SharedPtr<SeekableReadStream> _zipStream;
+	SafeSeekableSubReadStream _compressed;
+	byte _inBuf[UNZ_BUFSIZE];
+	z_stream _stream;
+	int _zlibErr;
+
+	uint32 _pos;
+	uint32 _size;
+	bool _eos;
+
+	uint32 _crc;
+	uint32 _crcPos;
+	uint32 _expectedCrc;
+
+	Array<Checkpoint> _checkpoints;
+	uint32 _checkpointInterval;
+	uint32 _nextCheckpoint;
+
+	uint32 inflateData(byte *dst, uint32 len);
+	void saveCheckpoint();
+	bool restart(const Checkpoint *checkpoint);
+
+public:
+	ZipInflateReadStream(const SharedPtr<SeekableReadStream> &zipStream, uint32 begin, uint32 end,
+	                     uint32 uncompressedSize, uint32 crc);
+	~ZipInflateReadStream();
+
+	virtual bool err() const { return _zlibErr != Z_OK && _zlibErr != Z_STREAM_END; }
+	virtual void clearErr() {
+		// only reset _eos; inflate errors are not recoverable
+		_eos = false;
+	}
+	virtual bool eos() const { return _eos; }
+
+	virtual uint32 read(void *dataPtr, uint32 dataSize);
+
+	virtual int32 pos() const { return _pos; }
+	virtual int32 size() const { return _size; }
+	virtual bool seek(int32 offset, int whence = SEEK_SET);
+};
+
+ZipInflateReadStream::ZipInflateReadStream(const SharedPtr<SeekableReadStream> &zipStream, uint32 begin, uint32 end,
+                                           uint32 uncompressedSize, uint32 crc)
+	: _zipStream(zipStream), _compressed(zipStream.get(), begin, end), _stream(),
+	  _pos(0), _size(uncompressedSize), _eos(false),
+	  _crc(crc32(0, nullptr, 0)), _crcPos(0), _expectedCrc(crc) {
+
+	_checkpointInterval = MAX<uint32>(kZipMinCheckpointInterval, _size / kZipMaxCheckpoints + 1);
+	_nextCheckpoint = _checkpointInterval;
+
+	// windowBits is passed < 0 to tell that there is no zlib header
+	_zlibErr = inflateInit2(&_stream, -MAX_WBITS);
+	_stream.next_in = _inBuf;
+	_stream.avail_in = 0;
+}
+
+ZipInflateReadStream::~ZipInflateReadStream() {
+	for (uint i = 0; i < _checkpoints.size(); ++i) {
+		inflateEnd(_checkpoints[i].state);
+		delete _checkpoints[i].state;
+	}
+	inflateEnd(&_stream);
+}
+
+uint32 ZipInflateReadStream::inflateData(byte *dst, uint32 len) {
+	_stream.next_out = dst;
+	_stream.avail_out = len;
+
+	while (_zlibErr == Z_OK && _stream.avail_out) {
+		if (_stream.avail_in == 0) {
+			_stream.next_in = _inBuf;
+			_stream.avail_in = _compressed.read(_inBuf, UNZ_BUFSIZE);
+			if (_stream.avail_in == 0) {
+				// The compressed data ended before the expected size was reached
+				_zlibErr = Z_DATA_ERROR;
+				break;
+			}
+		}
+		_zlibErr = inflate(&_stream, Z_NO_FLUSH);
+	}
+
+	const uint32 decompressed = len - _stream.avail_out;
+
+	// Verify the checksum once the member has been decompressed in one go.
+	// After a backward seek the data is only decompressed again, so it
+	// needs no further checking.
+	if (_pos == _crcPos) {
+		_crc = crc32(_crc, dst, decompressed);
+		_crcPos += decompressed;
+		if (_crcPos == _size && _crc != _expectedCrc) {
+			warning("ZipInflateReadStream: CRC mismatch");
+			_zlibErr = Z_DATA_ERROR;
+		}
+	}
+
+	_pos += decompressed;
+	return decompressed;
+}
+
+void ZipInflateReadStream::saveCheckpoint() {
+	Checkpoint checkpoint;
+	checkpoint.pos = _pos;
+	checkpoint.compressedPos = _compressed.pos() - _stream.avail_in;
+	// zlib checks that a state belongs to its z_stream, so the copy has
+	// to stay at a fixed address.
+	checkpoint.state = new z_stream;
+	if (inflateCopy(checkpoint.state, &_stream) == Z_OK)
+		_checkpoints.push_back(checkpoint);
+	else
+		delete checkpoint.state;
+
+	_nextCheckpoint += _checkpointInterval;
+}
+
+bool ZipInflateReadStream::restart(const Checkpoint *checkpoint) {
+	if (checkpoint) {
+		inflateEnd(&_stream);
+		_zlibErr = inflateCopy(&_stream, checkpoint->state);
+		_pos = checkpoint->pos;
+		_compressed.seek(checkpoint->compressedPos, SEEK_SET);
+	} else {
+		_zlibErr = inflateReset(&_stream);
+		_pos = 0;
+		_compressed.seek(0, SEEK_SET);
+	}
+
+	_stream.next_in = _inBuf;
+	_stream.avail_in = 0;
+	return _zlibErr == Z_OK;
+}
+
+uint32 ZipInflateReadStream::read(void *dataPtr, uint32 dataSize) {
+	if (dataSize > _size - _pos) {
+		dataSize = _size - _pos;
+		_eos = true;
+	}
+
+	byte *dst = (byte *)dataPtr;
+	uint32 total = 0;
+	while (total < dataSize && !err()) {
+		// Stop at the next checkpoint, so the inflate state can be saved there
+		uint32 len = dataSize - total;
+		if (_nextCheckpoint < _size)
+			len = MIN(len, _nextCheckpoint - _pos);
+
+		const uint32 decompressed = inflateData(dst + total, len);
+		total += decompressed;
+
+		if (_pos == _nextCheckpoint && _pos < _size && !err())
+			saveCheckpoint();
+		if (decompressed < len)
+			break;
+	}
+
+	return total;
+}
+
+bool ZipInflateReadStream::seek(int32 offset, int whence) {
+	int32 newPos = 0;
+	switch (whence) {
+	case SEEK_SET:
+		newPos = offset;
+		break;
+	case SEEK_CUR:
+		newPos = _pos + offset;
+		break;
+	case SEEK_END:
+		newPos = _size + offset;
+		break;
+	default:
+		break;
+	}
+
+	if (newPos < 0 || (uint32)newPos > _size)
+		return false;
+
+	// Find the last checkpoint before the new position
+	const Checkpoint *checkpoint = nullptr;
+	for (uint i = 0; i < _checkpoints.size() && _checkpoints[i].pos <= (uint32)newPos; ++i)
+		checkpoint = &_checkpoints[i];
+
+	if ((uint32)newPos < _pos) {
+		if (!restart(checkpoint))
+			return false;
+	} else if (checkpoint && checkpoint->pos > _pos) {
+		// Jumping to a checkpoint is cheaper than decompressing up to it
+		if (!restart(checkpoint))
+			return false;
+	}
+
+	// Decompress and drop the data up to the new position
+	byte tmpBuf[1024];
+	while (_pos < (uint32)newPos && !err()) {
+		if (read(tmpBuf, MIN<uint32>(sizeof(tmpBuf), newPos - _pos)) == 0)
+			break;
+	}
+
+	_eos = false;
+	return !err();
+}
+
+#endif
+
+/**
+ * Decompress the current file of the given zipfile into memory.
+ */
+static SeekableReadStream *readCurrentFileIntoMemory(unzFile zipFile, uint32 size) {
+	if (unzOpenCurrentFile(zipFile) != UNZ_OK)
 		return nullptr;
 
-	byte *buffer = (byte *)malloc(fileInfo.uncompressed_size);
+	byte *buffer = (byte *)malloc(size);
 	assert(buffer);
 
-	if (unzReadCurrentFile(_zipFile, buffer, fileInfo.uncompressed_size) != (int)fileInfo.uncompressed_size) {
+	if (unzReadCurrentFile(zipFile, buffer, size) != (int)size) {
 		free(buffer);
+		unzCloseCurrentFile(zipFile);
 		return nullptr;
 	}
 
-	if (unzCloseCurrentFile(_zipFile) != UNZ_OK) {
+	if (unzCloseCurrentFile(zipFile) != UNZ_OK) {
 		free(buffer);
 		return nullptr;
 	}
 
-	return new MemoryReadStream(buffer, fileInfo.uncompressed_size, DisposeAfterUse::YES);
+	return new MemoryReadStream(buffer, size, DisposeAfterUse::YES);
+}
+
+SeekableReadStream *ZipArchive::createReadStreamForMember(const String &name) const {
+	if (unzLocateFile(_zipFile, name.c_str(), 2) != UNZ_OK)
+		return nullptr;
+
+	unz_file_info fileInfo;
+	if (unzGetCurrentFileInfo(_zipFile, &fileInfo, nullptr, 0, nullptr, 0, nullptr, 0) != UNZ_OK)
+		return nullptr;
+
+	uLong dataPos;
+	if (unzlocal_GetCurrentFileDataPos(_zipFile, &dataPos) != UNZ_OK)
+		return nullptr;
+
+	const unz_s *const archive = (const unz_s *)_zipFile;
+
+	if (fileInfo.compression_method == 0) {
+		if (fileInfo.compressed_size != fileInfo.uncompressed_size)
+			return nullptr;
+		return new ZipStoredReadStream(archive->_sharedStream, dataPos, dataPos + fileInfo.uncompressed_size);
+	}
+
+#ifdef USE_ZLIB
+	if (fileInfo.uncompressed_size > kZipMemoryMemberLimit)
+		return new ZipInflateReadStream(archive->_sharedStream, dataPos, dataPos + fileInfo.compressed_size,
+		                                fileInfo.uncompressed_size, fileInfo.crc);
+#endif
 
-	// FIXME: instead of reading all into a memory stream, we could
-	// instead create a new ZipStream class. But then we have to be
-	// careful to handle the case where the client code opens multiple
-	// files in the archive and tries to use them independently.
+	return readCurrentFileIntoMemory(_zipFile, fileInfo.uncompressed_size);
 }
 
 Archive *makeZipArchive(const String &name) {
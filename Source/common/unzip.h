@@ -35,6 +35,11 @@ class SeekableReadStream;
  * This factory method creates an Archive instance corresponding to the content
  * of the ZIP compressed file with the given name.
  *
+ * Member streams read their data from the ZIP file on demand: stored members
+ * are never copied into memory, and large deflated members are decompressed
+ * while they are read. A member stream keeps the ZIP file open on its own, so
+ * it may outlive the Archive it was created from.
+ *
  * May return 0 in case of a failure.
  */
 Archive *makeZipArchive(const String &name);
@@ -100,6 +100,7 @@ Console::Console(SciEngine *engine) : GUI::Debugger(),
 	registerCmd("selectors",			WRAP_METHOD(Console, cmdSelectors));
 	registerCmd("functions",			WRAP_METHOD(Console, cmdKernelFunctions));
 	registerCmd("class_table",		WRAP_METHOD(Console, cmdClassTable));
+	registerCmd("selector_cache",	WRAP_METHOD(Console, cmdSelectorCache));
 	// Parser
 	registerCmd("suffixes",			WRAP_METHOD(Console, cmdSuffixes));
 	registerCmd("parse_grammar",		WRAP_METHOD(Console, cmdParseGrammar));
@@ -117,6 +118,7 @@ Console::Console(SciEngine *engine) : GUI::Debugger(),
 	registerCmd("resource_types",		WRAP_METHOD(Console, cmdResourceTypes));
 	registerCmd("list",				WRAP_METHOD(Console, cmdList));
 	registerCmd("alloc_list",				WRAP_METHOD(Console, cmdAllocList));
+	registerCmd("resource_cache",		WRAP_METHOD(Console, cmdResourceCache));
 	registerCmd("hexgrep",			WRAP_METHOD(Console, cmdHexgrep));
 	registerCmd("verify_scripts",		WRAP_METHOD(Console, cmdVerifyScripts));
 	registerCmd("integrity_dump",	WRAP_METHOD(Console, cmdResourceIntegrityDump));
@@ -163,6 +165,7 @@ Console::Console(SciEngine *engine) : GUI::Debugger(),
 	registerCmd("gc_reachable",		WRAP_METHOD(Console, cmdGCShowReachable));
 	registerCmd("gc_freeable",		WRAP_METHOD(Console, cmdGCShowFreeable));
 	registerCmd("gc_normalize",		WRAP_METHOD(Console, cmdGCNormalize));
+	registerCmd("gc_stats",			WRAP_METHOD(Console, cmdGCStats));
 	// Music/SFX
 	registerCmd("songlib",			WRAP_METHOD(Console, cmdSongLib));
 	registerCmd("songinfo",			WRAP_METHOD(Console, cmdSongInfo));
@@ -225,6 +228,7 @@ Console::Console(SciEngine *engine) : GUI::Debugger(),
 	registerCmd("bpe",				WRAP_METHOD(Console, cmdBreakpointFunction));		// alias
 	// VM
 	registerCmd("script_steps",		WRAP_METHOD(Console, cmdScriptSteps));
+	registerCmd("opcode_profile",		WRAP_METHOD(Console, cmdOpcodeProfile));
 	registerCmd("script_objects",   WRAP_METHOD(Console, cmdScriptObjects));
 	registerCmd("scro",             WRAP_METHOD(Console, cmdScriptObjects));
 	registerCmd("script_strings",   WRAP_METHOD(Console, cmdScriptStrings));
@@ -256,6 +260,9 @@ Console::Console(SciEngine *engine) : GUI::Debugger(),
 	_debugState.breakpointWasHit = false;
 	_debugState._breakpoints.clear(); // No breakpoints defined
 	_debugState._activeBreakpointTypes = 0;
+	_debugState._profileOpcodes = false;
+	memset(_debugState._opcodeCounts, 0, sizeof(_debugState._opcodeCounts));
+	_debugState._undecodedOpcodeCount = 0;
 }
 
 Console::~Console() {
@@ -319,6 +326,7 @@ bool Console::cmdHelp(int argc, const char **argv) {
 	debugPrintf(" selector - Attempts to find the requested selector by name\n");
 	debugPrintf(" functions - Lists the kernel functions\n");
 	debugPrintf(" class_table - Shows the available classes\n");
+	debugPrintf(" selector_cache - Shows statistics of the selector lookup cache\n");
 	debugPrintf("\n");
 	debugPrintf("Parser:\n");
 	debugPrintf(" suffixes - Lists the vocabulary suffixes\n");
@@ -338,6 +346,7 @@ bool Console::cmdHelp(int argc, const char **argv) {
 	debugPrintf(" resource_types - Shows the valid resource types\n");
 	debugPrintf(" list - Lists all the resources of a given type\n");
 	debugPrintf(" alloc_list - Lists all allocated resources\n");
+	debugPrintf(" resource_cache - Shows statistics of the resource cache\n");
 	debugPrintf(" hexgrep - Searches some resources for a particular sequence of bytes, represented as hexadecimal numbers\n");
 	debugPrintf(" verify_scripts - Performs sanity checks on SCI1.1-SCI2.1 game scripts (e.g. if they're up to 64KB in total)\n");
 	debugPrintf(" integrity_dump - Dumps integrity data about resources in the current game to disk\n");
@@ -379,6 +388,7 @@ bool Console::cmdHelp(int argc, const char **argv) {
 	debugPrintf(" gc_reachable - Lists all addresses directly reachable from a given memory object\n");
 	debugPrintf(" gc_freeable - Lists all addresses freeable in a given segment\n");
 	debugPrintf(" gc_normalize - Prints the \"normal\" address of a given address\n");
+	debugPrintf(" gc_stats - Shows how long the garbage collections took\n");
 	debugPrintf("\n");
 	debugPrintf("Music/SFX:\n");
 	debugPrintf(" songlib - Shows the song library\n");
@@ -424,6 +434,7 @@ bool Console::cmdHelp(int argc, const char **argv) {
 	debugPrintf("\n");
 	debugPrintf("VM:\n");
 	debugPrintf(" script_steps - Shows the number of executed SCI operations\n");
+	debugPrintf(" opcode_profile - Counts how often each SCI operation is executed\n");
 	debugPrintf(" vm_varlist / vmvarlist / vl - Shows the addresses of variables in the VM\n");
 	debugPrintf(" vm_vars / vmvars / vv - Displays or changes variables in the VM\n");
 	debugPrintf(" stack - Lists the specified number of stack elements\n");
@@ -1025,6 +1036,22 @@ bool Console::cmdAllocList(int argc, const char **argv) {
 	return true;
 }
 
+bool Console::cmdResourceCache(int argc, const char **argv) {
+	const ResourceManager::CacheStats stats = _engine->getResMan()->getCacheStats();
+	const uint32 requests = stats.hits + stats.misses;
+
+	debugPrintf("Requests: %u, hits: %u (%u%%), misses: %u\n", requests, stats.hits,
+	            requests ? (uint32)((uint64)stats.hits * 100 / requests) : 0, stats.misses);
+	debugPrintf("Prefetched: %u resources\n", stats.prefetches);
+	debugPrintf("Freed to stay within the budget: %u resources\n", stats.evictions);
+	debugPrintf("Decompressed: %u KiB\n", (uint32)(stats.bytesDecompressed / 1024));
+	debugPrintf("Budget: %d KiB, used once: %d KiB, used again: %d KiB\n",
+	            stats.maxMemory / 1024, stats.memoryProbation / 1024, stats.memoryProtected / 1024);
+	debugPrintf("Locked: %d KiB\n", stats.memoryLocked / 1024);
+
+	return true;
+}
+
 bool Console::cmdDissectScript(int argc, const char **argv) {
 	if (argc != 2) {
 		debugPrintf("Examines a script\n");
@@ -1665,6 +1692,31 @@ bool Console::cmdClassTable(int argc, const char **argv) {
 	return true;
 }
 
+bool Console::cmdSelectorCache(int argc, const char **argv) {
+	SelectorLookupCache &cache = _engine->_gamestate->_segMan->getSelectorLookupCache();
+
+	if (argc == 2 && !scumm_stricmp(argv[1], "reset")) {
+		cache.resetStats();
+		debugPrintf("Statistics of the selector lookup cache reset\n");
+		return true;
+	} else if (argc != 1) {
+		debugPrintf("Shows statistics of the selector lookup cache\n");
+		debugPrintf("Usage: %s [reset]\n", argv[0]);
+		return true;
+	}
+
+	const SelectorLookupCache::Stats stats = cache.getStats();
+	const uint32 lookups = stats.hits + stats.misses;
+
+	debugPrintf("Lookups: %u, hits: %u (%u%%), misses: %u\n", lookups, stats.hits,
+	            lookups ? (uint32)((uint64)stats.hits * 100 / lookups) : 0, stats.misses);
+	debugPrintf("Cached results: %u, dropped: %u times\n", stats.entries, stats.invalidations);
+	debugPrintf("Selectors compared while dispatching: %u (%u per lookup)\n", (uint32)stats.probes,
+	            lookups ? (uint32)(stats.probes / lookups) : 0);
+
+	return true;
+}
+
 bool Console::cmdSentenceFragments(int argc, const char **argv) {
 	debugPrintf("Sentence fragments (used to build Parse trees)\n");
 
@@ -2713,6 +2765,42 @@ bool Console::cmdGCInvoke(int argc, const char **argv) {
 	return true;
 }
 
+bool Console::cmdGCStats(int argc, const char **argv) {
+	GCStats &stats = _engine->_gamestate->_gcStats;
+
+	if (argc == 2 && !scumm_stricmp(argv[1], "reset")) {
+		stats.reset();
+		debugPrintf("Garbage collection statistics reset\n");
+		return true;
+	} else if (argc != 1) {
+		debugPrintf("Shows how long the garbage collections took\n");
+		debugPrintf("Usage: %s [reset]\n", argv[0]);
+		return true;
+	}
+
+	debugPrintf("Collections: %u, objects freed: %u\n", stats.runs, stats.freed);
+	debugPrintf("Last collection: %u ms, %u reachable addresses\n", stats.lastPause, stats.lastReachable);
+	debugPrintf("Longest collection: %u ms\n", stats.maxPause);
+	debugPrintf("Next collection in %d kernel calls (interval %d x %d)\n",
+	            _engine->_gamestate->gcCountDown, _engine->_gamestate->scriptGCInterval, _engine->_gamestate->gcBackoff);
+
+	debugPrintf("Pauses:\n");
+	for (uint i = 0; i < GCStats::kPauseBuckets; i++) {
+		Common::String range;
+		if (i == 0)
+			range = "0 ms";
+		else if (i == 1)
+			range = "1 ms";
+		else if (i == GCStats::kPauseBuckets - 1)
+			range = Common::String::format("%d+ ms", 1 << (i - 1));
+		else
+			range = Common::String::format("%d-%d ms", 1 << (i - 1), (1 << i) - 1);
+		debugPrintf(" %-9s %u\n", range.c_str(), stats.pauses[i]);
+	}
+
+	return true;
+}
+
 bool Console::cmdGCObjects(int argc, const char **argv) {
 	AddrSet *use_map = findAllActiveReferences(_engine->_gamestate);
 
@@ -3248,6 +3336,55 @@ bool Console::cmdScriptSteps(int argc, const char **argv) {
 	return true;
 }
 
+bool Console::cmdOpcodeProfile(int argc, const char **argv) {
+	if (argc == 2 && !scumm_stricmp(argv[1], "on")) {
+		_debugState._profileOpcodes = true;
+		debugPrintf("Counting executed opcodes\n");
+		return true;
+	} else if (argc == 2 && !scumm_stricmp(argv[1], "off")) {
+		_debugState._profileOpcodes = false;
+		debugPrintf("No longer counting executed opcodes\n");
+		return true;
+	} else if (argc == 2 && !scumm_stricmp(argv[1], "reset")) {
+		memset(_debugState._opcodeCounts, 0, sizeof(_debugState._opcodeCounts));
+		_debugState._undecodedOpcodeCount = 0;
+		debugPrintf("Opcode profile reset\n");
+		return true;
+	} else if (argc != 1) {
+		debugPrintf("Counts how often each SCI operation is executed, and lists them most frequent first\n");
+		debugPrintf("Usage: %s [on|off|reset]\n", argv[0]);
+		return true;
+	}
+
+	Common::Array<uint> opcodes;
+	uint64 total = 0;
+	for (uint i = 0; i < ARRAYSIZE(_debugState._opcodeCounts); i++) {
+		if (_debugState._opcodeCounts[i]) {
+			opcodes.push_back(i);
+			total += _debugState._opcodeCounts[i];
+		}
+	}
+
+	// Sort by count, most frequent first
+	for (uint i = 1; i < opcodes.size(); i++) {
+		const uint opcode = opcodes[i];
+		uint j = i;
+		for (; j > 0 && _debugState._opcodeCounts[opcodes[j - 1]] < _debugState._opcodeCounts[opcode]; j--)
+			opcodes[j] = opcodes[j - 1];
+		opcodes[j] = opcode;
+	}
+
+	for (uint i = 0; i < opcodes.size(); i++) {
+		const uint64 count = _debugState._opcodeCounts[opcodes[i]];
+		debugPrintf("%-10s %20llu %3u%%\n", opcodeNames[opcodes[i]], (unsigned long long)count, (uint32)(count * 100 / total));
+	}
+
+	debugPrintf("Executed: %llu operations, %llu of them not pre-decoded, profiling is %s\n", (unsigned long long)total,
+	            (unsigned long long)_debugState._undecodedOpcodeCount, _debugState._profileOpcodes ? "on" : "off");
+
+	return true;
+}
+
 bool Console::cmdScriptObjects(int argc, const char **argv) {
 	int curScriptNr = -1;
 
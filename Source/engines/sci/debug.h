@@ -84,6 +84,9 @@ struct DebugState {
 	StackPtr old_sp;
 	Common::List<Breakpoint> _breakpoints;   //< List of breakpoints
 	int _activeBreakpointTypes;  //< Bit mask specifying which types of breakpoints are active
+	bool _profileOpcodes;        //< Whether executed opcodes are counted in _opcodeCounts
+	uint64 _opcodeCounts[128];   //< Number of times each opcode was executed while profiling
+	uint64 _undecodedOpcodeCount; //< Number of profiled opcodes which were read from the script buffer instead of the decoded code
 
 	void updateActiveBreakpointTypes();
 };
@@ -52,8 +52,9 @@ AddrSet *findAllActiveReferences(EngineState *s);
 /**
  * Runs garbage collection on the current system state
  * @param s The state in which we should gc
+ * @return The number of objects freed
  */
-void run_gc(EngineState *s);
+uint run_gc(EngineState *s);
 
 struct WorklistManager {
 	Common::Array<reg_t> _worklist;
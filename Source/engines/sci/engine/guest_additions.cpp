@@ -325,6 +325,7 @@ static void patchKSaveRestore(SegManager *segMan, reg_t methodAddress, byte id)
 	byte *patchPtr = const_cast<byte *>(script->getBuf(methodAddress.getOffset()));
 	memcpy(patchPtr, kSaveRestorePatch, sizeof(kSaveRestorePatch));
 	patchPtr[8] = id;
+	script->invalidateDecodedInstructions();
 }
 
 void GuestAdditions::patchGameSaveRestoreSCI16() const {
@@ -418,6 +419,7 @@ void GuestAdditions::patchGameSaveRestoreTorin(Script &script) const {
 	const uint32 address = script.validateExportFunc(2, true);
 	byte *patchPtr = const_cast<byte *>(script.getBuf(address));
 	memcpy(patchPtr, SRTorinPatch, sizeof(SRTorinPatch));
+	script.invalidateDecodedInstructions();
 
 	const Selector newSelector = SELECTOR(new_);
 	assert(newSelector != -1);
@@ -446,6 +448,7 @@ void GuestAdditions::patchGameSaveRestorePhant2(Script &script) const {
 
 		byte *scriptData = const_cast<byte *>(script.getBuf(obj.getFunction(methodIndex).getOffset()));
 		memcpy(scriptData, SRDialogPatch, sizeof(SRDialogPatch));
+		script.invalidateDecodedInstructions();
 		break;
 	}
 }
@@ -480,6 +483,7 @@ void GuestAdditions::patchSRDialogDoit(Script &script, const char *const objectN
 				const reg_t methodAddress = obj.getFunction(methodNr);
 				byte *patchPtr = const_cast<byte *>(script.getBuf(methodAddress.getOffset()));
 				memcpy(patchPtr, patchData, patchSize);
+				script.invalidateDecodedInstructions();
 
 				if (g_sci->isBE()) {
 					for (uint i = 0; i < numOffsets; ++i) {
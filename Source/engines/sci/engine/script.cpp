@@ -69,6 +69,10 @@ void Script::freeScript(const bool keepLocalsSegment) {
 	_markedAsDeleted = false;
 	_objects.clear();
 
+	_patched = false;
+	_instructionsDecoded = false;
+	_decodedInstructions.clear();
+
 	_offsetLookupArray.clear();
 	_offsetLookupObjectCount = 0;
 	_offsetLookupStringCount = 0;
@@ -148,7 +152,7 @@ void Script::load(int script_nr, ResourceManager *resMan, ScriptPatcher *scriptP
 	}
 
 	// Check scripts (+ possibly SCI 1.1 heap) for matching signatures and patch those, if found
-	scriptPatcher->processScript(_nr, outBuffer);
+	_patched = scriptPatcher->processScript(_nr, outBuffer);
 
 	if (getSciVersion() <= SCI_VERSION_1_LATE) {
 		// Some buggy game scripts contain two export tables (e.g. script 912
@@ -858,15 +862,26 @@ void Script::setLockers(int lockers) {
 }
 
 uint32 Script::validateExportFunc(int pubfunct, bool relocSci3) {
-	bool exportsAreWide = (g_sci->_features->detectLofsType() == SCI_VERSION_1_MIDDLE);
-
 	if (_numExports <= (uint)pubfunct) {
 		error("Script %d validateExportFunc(): pubfunct %d is invalid", _nr, pubfunct);
 	}
 
+	const int offset = getExportFuncOffset(pubfunct, relocSci3);
+	if (offset == -1)
+		error("Invalid export %d function pointer in script %d", pubfunct, _nr);
+
+	return offset;
+}
+
+int Script::getExportFuncOffset(int pubfunct, bool relocSci3) {
+	bool exportsAreWide = (g_sci->_features->detectLofsType() == SCI_VERSION_1_MIDDLE);
+
 	if (exportsAreWide)
 		pubfunct *= 2;
 
+	if ((uint)pubfunct >= _exports.size())
+		return -1;
+
 	int offset;
 
 #ifdef ENABLE_SCI32
@@ -890,8 +905,8 @@ uint32 Script::validateExportFunc(int pubfunct, bool relocSci3) {
 		offset = getCodeBlockOffset();
 	}
 
-	if (offset == -1 || offset >= (int)_buf->size())
-		error("Invalid export %d function pointer (%d) in script %d", pubfunct, offset, _nr);
+	if (offset >= (int)_buf->size())
+		return -1;
 
 	return offset;
 }
@@ -1286,4 +1301,100 @@ bool Script::offsetIsObject(uint32 offset) const {
 	return _buf->getUint16SEAt(offset + SCRIPT_OBJECT_MAGIC_OFFSET) == SCRIPT_OBJECT_MAGIC_NUMBER;
 }
 
+int Script::findDecodedInstruction(uint32 offset) {
+	if (!_instructionsDecoded)
+		decodeInstructions();
+
+	int low = 0;
+	int high = (int)_decodedInstructions.size() - 1;
+	while (low <= high) {
+		const int middle = (low + high) / 2;
+		const uint32 middleOffset = _decodedInstructions[middle].offset;
+		if (middleOffset == offset)
+			return middle;
+		else if (middleOffset < offset)
+			low = middle + 1;
+		else
+			high = middle - 1;
+	}
+
+	return -1;
+}
+
+void Script::invalidateDecodedInstructions() {
+	_patched = true;
+	_instructionsDecoded = true;
+	_decodedInstructions.clear();
+}
+
+void Script::decodeInstructions() {
+	_instructionsDecoded = true;
+	_decodedInstructions.clear();
+
+	// Patches replace instructions in place and may leave unreachable
+	// remains of the original code behind, so patched scripts are executed
+	// directly from the script buffer, as they always were
+	if (_patched)
+		return;
+
+	const uint32 codeSize = getScriptSize();
+	Common::Array<bool> isInstruction(codeSize, false);
+	Common::Array<uint32> pending;
+
+	// Code is entered through the methods of the objects and classes...
+	for (ObjMap::const_iterator it = _objects.begin(); it != _objects.end(); ++it) {
+		const Object &obj = it->_value;
+		for (uint16 i = 0; i < obj.getMethodCount(); i++)
+			pending.push_back(obj.getFunction(i).getOffset());
+	}
+
+	// ...and through the exported functions, unless they are objects
+	for (uint16 i = 0; i < _numExports; i++) {
+		const int offset = getExportFuncOffset(i, true);
+		if (offset == -1 || (uint32)offset >= codeSize)
+			continue;
+		const int magicOffset = offset + SCRIPT_OBJECT_MAGIC_OFFSET;
+		if (magicOffset >= 0 && magicOffset + 2 <= (int)getBufSize() && offsetIsObject(offset))
+			continue;
+		pending.push_back(offset);
+	}
+
+	while (!pending.empty()) {
+		uint32 offset = pending.back();
+		pending.pop_back();
+
+		// Follow the code until it returns or jumps away, or until it reaches
+		// code which has been decoded already. Anything which does not look
+		// like code is left to the interpreter to deal with.
+		while (offset < codeSize && !isInstruction[offset] && isValidPMachineInstruction(getBuf(offset), codeSize - offset)) {
+			byte extOpcode;
+			int16 opparams[4];
+			const uint32 next = offset + readPMachineInstruction(getBuf(offset), extOpcode, opparams);
+			isInstruction[offset] = true;
+
+			const byte opcode = extOpcode >> 1;
+			if (opcode == op_bt || opcode == op_bnt || opcode == op_jmp || opcode == op_call)
+				pending.push_back(next + opparams[0]);
+			if (opcode == op_ret || opcode == op_jmp)
+				break;
+
+			offset = next;
+		}
+	}
+
+	// The instructions are decoded in the order of their offsets, so that
+	// the VM can look them up with a binary search
+	for (uint32 offset = 0; offset < codeSize; offset++) {
+		if (!isInstruction[offset])
+			continue;
+
+		DecodedInstruction instruction;
+		instruction.offset = offset;
+		instruction.size = readPMachineInstruction(getBuf(offset), instruction.extOpcode, instruction.opparams);
+		_decodedInstructions.push_back(instruction);
+	}
+
+	debugC(kDebugLevelScripts, "Decoded %u instructions of script %d", _decodedInstructions.size(), _nr);
+}
+
 } // End of namespace Sci
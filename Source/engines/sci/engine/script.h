@@ -69,6 +69,17 @@ struct offsetLookupArrayEntry {
 
 typedef Common::Array<offsetLookupArrayEntry> offsetLookupArrayType;
 
+/**
+ * A PMachine instruction of a script, decoded ahead of its execution so that
+ * the VM does not have to parse its operands again every time it runs.
+ */
+struct DecodedInstruction {
+	uint32 offset;      // offset of the instruction within the script buffer
+	int16  opparams[4]; // operands, as returned by readPMachineInstruction()
+	uint16 size;        // size of the instruction in bytes
+	byte   extOpcode;   // "extended" opcode, including the low bit
+};
+
 class Script : public SegmentObj {
 private:
 	int _nr; /**< Script number */
@@ -94,6 +105,10 @@ private:
 
 	ObjMap _objects;	/**< Table for objects, contains property variables */
 
+	bool _patched; /**< Whether the script patcher changed the script */
+	bool _instructionsDecoded; /**< Whether decodeInstructions() ran since the script was loaded */
+	Common::Array<DecodedInstruction> _decodedInstructions; /**< Decoded code, sorted by offset */
+
 protected:
 	offsetLookupArrayType _offsetLookupArray; // Table of all elements of currently loaded script, that may get pointed to
 
@@ -128,6 +143,30 @@ public:
 	const ObjMap &getObjectMap() const { return _objects; }
 	bool offsetIsObject(uint32 offset) const;
 
+	/**
+	 * Finds the decoded instruction at the given offset. The code of the
+	 * script is decoded the first time this is called after loading it.
+	 * @param offset	the offset of the instruction within the script buffer
+	 * @return the index of the instruction, or -1 if no instruction was
+	 *         decoded at this offset and it has to be read from the buffer
+	 */
+	int findDecodedInstruction(uint32 offset);
+
+	/**
+	 * @return the decoded instruction at the given index, or NULL if the
+	 *         index is out of range
+	 */
+	const DecodedInstruction *getDecodedInstruction(int index) const {
+		return (uint)index < _decodedInstructions.size() ? &_decodedInstructions[index] : NULL;
+	}
+
+	/**
+	 * Drops the decoded code of the script. This must be called when the
+	 * code in the script buffer is changed after the script was loaded; the
+	 * script is then executed directly from its buffer.
+	 */
+	void invalidateDecodedInstructions();
+
 public:
 	Script();
 	~Script();
@@ -356,6 +395,20 @@ private:
 	 * Identifies certain offsets within script data and set up lookup-table
 	 */
 	void identifyOffsets();
+
+	/**
+	 * Decodes all code reachable from the methods of the script's objects
+	 * and from its exported functions into _decodedInstructions. Patched
+	 * scripts are left undecoded, and are executed by reading each
+	 * instruction from the script buffer instead.
+	 */
+	void decodeInstructions();
+
+	/**
+	 * Gets the offset of an exported function, like validateExportFunc(),
+	 * but returns -1 instead of erroring out when the export is invalid
+	 */
+	int getExportFuncOffset(int pubfunct, bool relocSci3);
 };
 
 } // End of namespace Sci
@@ -7589,11 +7589,12 @@ void ScriptPatcher::enablePatch(const SciScriptPatcherEntry *patchTable, const c
 		error("Script-Patcher: no patch found to enable");
 }
 
-void ScriptPatcher::processScript(uint16 scriptNr, SciSpan<byte> scriptData) {
+bool ScriptPatcher::processScript(uint16 scriptNr, SciSpan<byte> scriptData) {
 	const SciScriptPatcherEntry *signatureTable = NULL;
 	const SciScriptPatcherEntry *curEntry = NULL;
 	SciScriptPatcherRuntimeEntry *curRuntimeEntry = NULL;
 	const Sci::SciGameId gameId = g_sci->getGameId();
+	bool patched = false;
 
 	switch (gameId) {
 	case GID_CAMELOT:
@@ -7747,7 +7748,7 @@ void ScriptPatcher::processScript(uint16 scriptNr, SciSpan<byte> scriptData) {
 		if (!_runtimeTable) {
 			// Abort, in case selectors are not yet initialized (happens for games w/o selector-dictionary)
 			if (!g_sci->getKernel()->selectorNamesAvailable())
-				return;
+				return false;
 
 			// signature table needs to get initialized (Magic DWORD set, selector table set)
 			initSignature(signatureTable);
@@ -7790,6 +7791,7 @@ void ScriptPatcher::processScript(uint16 scriptNr, SciSpan<byte> scriptData) {
 						// found, so apply the patch
 						debugC(kDebugLevelScriptPatcher, "Script-Patcher: '%s' on script %d offset %d", curEntry->description, scriptNr, foundOffset);
 						applyPatch(curEntry, scriptData, foundOffset);
+						patched = true;
 					}
 					applyCount--;
 				} while ((foundOffset != -1) && (applyCount));
@@ -7797,6 +7799,8 @@ void ScriptPatcher::processScript(uint16 scriptNr, SciSpan<byte> scriptData) {
 			curEntry++; curRuntimeEntry++;
 		}
 	}
+
+	return patched;
 }
 
 } // End of namespace Sci
@@ -97,7 +97,8 @@ public:
 	void calculateMagicDWordAndVerify(const char *signatureDescription, const uint16 *signatureData, bool magicDWordIncluded, uint32 &calculatedMagicDWord, int &calculatedMagicDWordOffset);
 
 	// Called when a script is loaded to check for signature matches and apply patches in such cases
-	void processScript(uint16 scriptNr, SciSpan<byte> scriptData);
+	// Returns true if at least one patch was applied
+	bool processScript(uint16 scriptNr, SciSpan<byte> scriptData);
 
 	// Verifies, if a given signature matches the given script data (pointed to by additional byte offset)
 	bool verifySignature(uint32 byteOffset, const uint16 *signatureData, const char *signatureDescription, const SciSpan<const byte> &scriptData);
@@ -80,6 +80,8 @@ void SegManager::resetSegMan() {
 	// Reinitialize class table
 	_classTable.clear();
 	createClassTable();
+
+	_selectorLookupCache.invalidate();
 }
 
 void SegManager::initSysStrings() {
@@ -178,6 +180,8 @@ void SegManager::deallocate(SegmentId seg) {
 			if (_heap[scr->getLocalsSegment()])
 				deallocate(scr->getLocalsSegment());
 		}
+
+		_selectorLookupCache.invalidate();
 	}
 
 	delete mobj;
@@ -1046,6 +1050,7 @@ int SegManager::instantiateScript(int scriptNum) {
 	scr->initializeLocals(this);
 	scr->initializeClasses(this);
 	scr->initializeObjects(this, segmentId);
+	_selectorLookupCache.invalidate();
 #ifdef ENABLE_SCI32
 	g_sci->_guestAdditions->instantiateScriptHook(*scr);
 #endif
@@ -456,6 +456,12 @@ public:
 
 	const Common::Array<SegmentObj *> &getSegments() const { return _heap; }
 
+	/**
+	 * Return the cache of selector lookups, which is dropped whenever a
+	 * script is loaded or freed.
+	 */
+	SelectorLookupCache &getSelectorLookupCache() { return _selectorLookupCache; }
+
 private:
 	Common::Array<SegmentObj *> _heap;
 	Common::Array<Class> _classTable; /**< Table of all classes */
@@ -464,6 +470,7 @@ private:
 
 	ResourceManager *_resMan;
 	ScriptPatcher *_scriptPatcher;
+	SelectorLookupCache _selectorLookupCache;
 
 	SegmentId _clonesSegId; ///< ID of the (a) clones segment
 	SegmentId _listsSegId; ///< ID of the (a) list segment
@@ -310,6 +310,82 @@ void invokeSelector(EngineState *s, reg_t object, int selectorId,
 	run_vm(s); // Start a new vm
 }
 
+namespace {
+
+/**
+ * Search a selector in the methods of an object and its superclasses.
+ */
+SelectorType lookupMethod(SegManager *segMan, const Object *obj, Selector selectorId, reg_t *fptr) {
+	SelectorLookupCache &cache = segMan->getSelectorLookupCache();
+
+	while (obj) {
+		const int index = obj->funcSelectorPosition(selectorId);
+		if (index >= 0) {
+			cache.addProbes(index + 1);
+			if (fptr)
+				*fptr = obj->getFunction(index);
+
+			return kSelectorMethod;
+		}
+
+		cache.addProbes(obj->getMethodCount());
+		obj = segMan->getObject(obj->getSuperClassSelector());
+	}
+
+	return kSelectorNone;
+}
+
+} // End of anonymous namespace
+
+SelectorLookupCache::SelectorLookupCache() :
+		_hits(0), _misses(0), _invalidations(0), _probes(0) {
+}
+
+const SelectorLookupCache::Entry *SelectorLookupCache::find(reg_t classAddr, Selector selectorId) {
+	Key key;
+	key.classAddr = classAddr;
+	key.selectorId = selectorId;
+
+	EntryMap::const_iterator entry = _entries.find(key);
+	if (entry == _entries.end()) {
+		_misses++;
+		return NULL;
+	}
+
+	_hits++;
+	return &entry->_value;
+}
+
+void SelectorLookupCache::insert(reg_t classAddr, Selector selectorId, const Entry &entry) {
+	Key key;
+	key.classAddr = classAddr;
+	key.selectorId = selectorId;
+	_entries[key] = entry;
+}
+
+void SelectorLookupCache::invalidate() {
+	if (_entries.empty())
+		return;
+
+	_entries.clear();
+	_invalidations++;
+}
+
+SelectorLookupCache::Stats SelectorLookupCache::getStats() const {
+	Stats stats;
+	stats.hits = _hits;
+	stats.misses = _misses;
+	stats.invalidations = _invalidations;
+	stats.entries = _entries.size();
+	stats.probes = _probes;
+	return stats;
+}
+
+void SelectorLookupCache::resetStats() {
+	_hits = _misses = _invalidations = 0;
+	_probes = 0;
+}
+
 SelectorType lookupSelector(SegManager *segMan, reg_t obj_location, Selector selectorId, ObjVarRef *varp, reg_t *fptr) {
 	const Object *obj = segMan->getObject(obj_location);
 	int index;
@@ -325,34 +401,78 @@ SelectorType lookupSelector(SegManager *segMan, reg_t obj_location, Selector sel
 		error("lookupSelector: Attempt to send to non-object or invalid script. Address %04x:%04x, %s", PRINT_REG(obj_location), origin.toString().c_str());
 	}
 
-	index = obj->locateVarSelector(segMan, selectorId);
+	// SCI3 objects have their own list of properties, which does not
+	// come from the class
+	const bool classProperties = getSciVersion() != SCI_VERSION_3;
+
+	if (!classProperties) {
+		index = obj->locateVarSelector(segMan, selectorId);
+		segMan->getSelectorLookupCache().addProbes(obj->getVarCount());
+		if (index >= 0) {
+			if (varp) {
+				varp->obj = obj_location;
+				varp->varindex = index;
+			}
+			return kSelectorVariable;
+		}
+	}
+
+	const Object *objClass = obj->getClass(segMan);
+	if (!objClass) {
+		// Without a class there is nothing worth caching
+		return lookupMethod(segMan, obj, selectorId, fptr);
+	}
+
+	SelectorLookupCache &cache = segMan->getSelectorLookupCache();
+	const reg_t classAddr = objClass->getPos();
+	const SelectorLookupCache::Entry *cached = cache.find(classAddr, selectorId);
+	SelectorLookupCache::Entry entry;
+	if (cached) {
+		entry = *cached;
+	} else {
+		entry.type = kSelectorNone;
+		entry.varIndex = -1;
+		entry.funcp = NULL_REG;
+
+		if (classProperties) {
+			entry.varIndex = objClass->locateVarSelector(segMan, selectorId);
+			cache.addProbes(entry.varIndex >= 0 ? entry.varIndex + 1 : objClass->getVarCount());
+		}
+
+		if (entry.varIndex >= 0)
+			entry.type = kSelectorVariable;
+		else
+			entry.type = lookupMethod(segMan, objClass, selectorId, &entry.funcp);
 
-	if (index >= 0) {
+		cache.insert(classAddr, selectorId, entry);
+	}
+
+	if (entry.type == kSelectorVariable) {
 		// Found it as a variable
 		if (varp) {
 			varp->obj = obj_location;
-			varp->varindex = index;
+			varp->varindex = entry.varIndex;
 		}
 		return kSelectorVariable;
-	} else {
-		// Check if it's a method, with recursive lookup in superclasses
-		while (obj) {
-			index = obj->funcSelectorPosition(selectorId);
-			if (index >= 0) {
-				if (fptr)
-					*fptr = obj->getFunction(index);
-
-				return kSelectorMethod;
-			} else {
-				obj = segMan->getObject(obj->getSuperClassSelector());
-			}
-		}
+	}
 
-		return kSelectorNone;
+	// Methods defined by the object itself take precedence over the ones
+	// of its class
+	if (obj != objClass) {
+		index = obj->funcSelectorPosition(selectorId);
+		cache.addProbes(index >= 0 ? index + 1 : obj->getMethodCount());
+		if (index >= 0) {
+			if (fptr)
+				*fptr = obj->getFunction(index);
+
+			return kSelectorMethod;
+		}
 	}
 
+	if (entry.type == kSelectorMethod && fptr)
+		*fptr = entry.funcp;
 
-//	return _lookupSelector_function(segMan, obj, selectorId, fptr);
+	return entry.type;
 }
 
 } // End of namespace Sci
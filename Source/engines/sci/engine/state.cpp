@@ -31,6 +31,7 @@
 #include "sci/engine/vm.h"
 #include "sci/engine/script.h"
 #include "sci/engine/message.h"
+#include "sci/resource_prefetch.h"
 
 namespace Sci {
 
@@ -82,6 +83,7 @@ void EngineState::reset(bool isRestoring) {
 		_memorySegmentSize = 0;
 		_fileHandles.resize(5);
 		abortScriptProcessing = kAbortNone;
+		_gcStats.reset();
 	} else {
 		g_sci->_guestAdditions->reset();
 	}
@@ -100,6 +102,7 @@ void EngineState::reset(bool isRestoring) {
 	lastWaitTime = 0;
 
 	gcCountDown = 0;
+	gcBackoff = 1;
 
 #ifdef ENABLE_SCI32
 	_eventCounter = 0;
@@ -120,6 +123,11 @@ void EngineState::reset(bool isRestoring) {
 }
 
 void EngineState::speedThrottler(uint32 neededSleep) {
+	// The game sets the new room number before it loads the room, so a
+	// change can be noticed a little ahead of time
+	if (g_sci->getRoomPrefetcher())
+		g_sci->getRoomPrefetcher()->setRoom(currentRoomNumber());
+
 	if (_throttleTrigger) {
 		uint32 curTime = g_system->getMillis();
 		uint32 duration = curTime - _throttleLastTime;
@@ -140,6 +148,8 @@ int EngineState::wait(int16 ticks) {
 	lastWaitTime = time;
 
 	ticks *= g_debug_sleeptime_factor;
+	if (g_sci->getRoomPrefetcher())
+		g_sci->getRoomPrefetcher()->setRoom(currentRoomNumber());
 	g_sci->sleep(ticks * 1000 / 60);
 	return tickDelta;
 }
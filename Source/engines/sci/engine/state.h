@@ -98,6 +98,22 @@ struct SciCallOrigin {
 	}
 };
 
+/** Statistics of the garbage collector, shown by the gc_stats console command */
+struct GCStats {
+	enum {
+		kPauseBuckets = 8 ///< 0 ms, 1 ms, 2-3 ms, 4-7 ms, ..., 64 ms and longer
+	};
+
+	uint32 runs;          ///< Number of collections
+	uint32 freed;         ///< Number of objects freed by all collections
+	uint32 lastReachable; ///< Number of addresses found reachable by the last collection
+	uint32 lastPause;     ///< Duration of the last collection, in ms
+	uint32 maxPause;      ///< Duration of the longest collection, in ms
+	uint32 pauses[kPauseBuckets]; ///< Number of collections by duration
+
+	void reset() { memset(this, 0, sizeof(*this)); }
+};
+
 struct EngineState : public Common::Serializable {
 public:
 	EngineState(SegManager *segMan);
@@ -189,6 +205,8 @@ public:
 	void shrinkStackToBase();
 
 	int gcCountDown; /**< Number of kernel calls until next gc */
+	int gcBackoff; /**< Multiplier of scriptGCInterval, raised while collections find nothing to free */
+	GCStats _gcStats;
 
 	MessageState *_msgState;
 
@@ -535,6 +535,61 @@ int readPMachineInstruction(const byte *src, byte &extOpcode, int16 opparams[4])
 	return offset;
 }
 
+bool isValidPMachineInstruction(const byte *src, uint32 size) {
+	if (!size)
+		return false;
+
+	const byte extOpcode = src[0];
+	const byte opcode = extOpcode >> 1;
+	uint32 length = 1;
+
+	for (int i = 0; g_sci->_opcode_formats[opcode][i]; ++i) {
+		if (i >= 3)
+			return false;
+
+		switch (g_sci->_opcode_formats[opcode][i]) {
+		case Script_Byte:
+		case Script_SByte:
+			length++;
+			break;
+
+		case Script_Word:
+		case Script_SWord:
+			length += 2;
+			break;
+
+		case Script_Variable:
+		case Script_Property:
+		case Script_Local:
+		case Script_Temp:
+		case Script_Global:
+		case Script_Param:
+		case Script_Offset:
+		case Script_SVariable:
+		case Script_SRelative:
+			length += (extOpcode & 1) ? 1 : 2;
+			break;
+
+		case Script_None:
+		case Script_End:
+			break;
+
+		case Script_Invalid:
+		default:
+			return false;
+		}
+	}
+
+	if (opcode == op_pushSelf && (extOpcode & 1) && g_sci->getGameId() != GID_FANMADE) {
+		// Debug opcode op_file, followed by a null-terminated string
+		while (length < size && src[length])
+			length++;
+		length++;
+	}
+
+	return length <= size;
+}
+
 uint32 findOffset(const int16 relOffset, const Script *scr, const uint32 pcOffset) {
 	uint32 offset;
 
@@ -576,6 +631,7 @@ void run_vm(EngineState *s) {
 	ExecStack *xs_new = NULL;
 	Object *obj = s->_segMan->getObject(s->xs->objp);
 	Script *scr = 0;
+	int nextInstruction = -1; // Index of the decoded instruction expected at the pc of scr
 	Script *local_script = s->_segMan->getScriptIfLoaded(s->xs->local_segment);
 	int old_executionStackBase = s->executionStackBase;
 	// Used to detect the stack bottom, for "physical" returns
@@ -610,6 +666,7 @@ void run_vm(EngineState *s) {
 				error("No script in segment %d",  s->xs->addr.pc.getSegment());
 			s->xs = &(s->_executionStack.back());
 			s->_executionStackPosChanged = false;
+			nextInstruction = -1;
 
 			obj = s->_segMan->getObject(s->xs->objp);
 			local_script = s->_segMan->getScriptIfLoaded(s->xs->local_segment);
@@ -650,10 +707,35 @@ void run_vm(EngineState *s) {
 			error("run_vm(): program counter gone astray, addr: %d, code buffer size: %d",
 			s->xs->addr.pc.getOffset(), scr->getBufSize());
 
-		// Get opcode
+		// Get opcode. Instructions following each other are taken from the
+		// decoded code of the script one after the other, after a branch or
+		// call the instruction at the new pc is looked up. Code which was
+		// not decoded is read from the script buffer instead.
+		const uint32 pcOffset = s->xs->addr.pc.getOffset();
+		const DecodedInstruction *instruction = scr->getDecodedInstruction(nextInstruction);
+		if (!instruction || instruction->offset != pcOffset) {
+			nextInstruction = scr->findDecodedInstruction(pcOffset);
+			instruction = scr->getDecodedInstruction(nextInstruction);
+		}
+
 		byte extOpcode;
-		s->xs->addr.pc.incOffset(readPMachineInstruction(scr->getBuf(s->xs->addr.pc.getOffset()), extOpcode, opparams));
+		if (instruction) {
+			extOpcode = instruction->extOpcode;
+			opparams[0] = instruction->opparams[0];
+			opparams[1] = instruction->opparams[1];
+			opparams[2] = instruction->opparams[2];
+			opparams[3] = instruction->opparams[3];
+			s->xs->addr.pc.incOffset(instruction->size);
+			nextInstruction++;
+		} else {
+			s->xs->addr.pc.incOffset(readPMachineInstruction(scr->getBuf(pcOffset), extOpcode, opparams));
+		}
 		const byte opcode = extOpcode >> 1;
+		if (g_sci->_debugState._profileOpcodes) {
+			g_sci->_debugState._opcodeCounts[opcode]++;
+			if (!instruction)
+				g_sci->_debugState._undecodedOpcodeCount++;
+		}
 		//debug("%s: %d, %d, %d, %d, acc = %04x:%04x, script %d, local script %d", opcodeNames[opcode], opparams[0], opparams[1], opparams[2], opparams[3], PRINT_REG(s->r_acc), scr->getScriptNumber(), local_script->getScriptNumber());
 
 #ifdef ABORT_ON_INFINITE_LOOP
@@ -877,8 +959,13 @@ void run_vm(EngineState *s) {
 		case op_callk: { // 0x21 (33)
 			// Run the garbage collector, if needed
 			if (s->gcCountDown-- <= 0) {
-				s->gcCountDown = s->scriptGCInterval;
-				run_gc(s);
+				// While there is no garbage, collections only cost time,
+				// so the next ones are spaced out further
+				if (run_gc(s))
+					s->gcBackoff = 1;
+				else if (s->gcBackoff < GC_MAX_BACKOFF)
+					s->gcBackoff *= 2;
+				s->gcCountDown = s->scriptGCInterval * s->gcBackoff;
 			}
 
 			// Call kernel function
@@ -28,6 +28,7 @@
 #include "sci/engine/vm_types.h"	// for reg_t
 #include "sci/resource.h"	// for SciVersion
 
+#include "common/hashmap.h"
 #include "common/util.h"
 
 namespace Sci {
@@ -181,7 +182,8 @@ enum GlobalVar {
 
 /** Number of kernel calls in between gcs; should be < 50000 */
 enum {
-	GC_INTERVAL = 0x8000
+	GC_INTERVAL = 0x8000,
+	GC_MAX_BACKOFF = 4 ///< Maximum factor by which gcs finding no garbage stretch the interval
 };
 
 enum SciOpcodes {
@@ -395,6 +397,76 @@ void script_debug(EngineState *s);
 SelectorType lookupSelector(SegManager *segMan, reg_t obj, Selector selectorid,
 		ObjVarRef *varp, reg_t *fptr);
 
+/**
+ * Caches the results of lookupSelector() per class and selector.
+ *
+ * Resolving a selector means scanning the properties of the class of the
+ * object and then the methods of the object and each of its superclasses,
+ * which used to be repeated for every message sent by the scripts. Apart
+ * from the methods an object defines itself, the result only depends on
+ * the class, so it is kept per class.
+ *
+ * Classes only change when scripts are loaded or freed, and the SegManager
+ * drops the whole cache at these points.
+ */
+class SelectorLookupCache {
+public:
+	struct Entry {
+		SelectorType type;
+		int varIndex; ///< The index of the property, for kSelectorVariable
+		reg_t funcp;  ///< The address of the method, for kSelectorMethod
+	};
+
+	struct Stats {
+		uint32 hits;          ///< Lookups answered by the cache
+		uint32 misses;        ///< Lookups which had to search the class
+		uint32 invalidations; ///< Number of times the cache was dropped
+		uint32 entries;       ///< Number of cached results
+		uint64 probes;        ///< Selectors compared by the lookups done without the cache
+	};
+
+	SelectorLookupCache();
+
+	/**
+	 * Return the cached result for a selector of a class, or NULL if it
+	 * has not been looked up yet.
+	 */
+	const Entry *find(reg_t classAddr, Selector selectorId);
+
+	void insert(reg_t classAddr, Selector selectorId, const Entry &entry);
+
+	/** Drop all results, when the classes may have changed. */
+	void invalidate();
+
+	/** Count selectors compared by a lookup done without the cache. */
+	void addProbes(uint count) { _probes += count; }
+
+	Stats getStats() const;
+	void resetStats();
+
+private:
+	struct Key {
+		reg_t classAddr;
+		Selector selectorId;
+
+		bool operator==(const Key &other) const {
+			return classAddr == other.classAddr && selectorId == other.selectorId;
+		}
+	};
+
+	struct KeyHash {
+		uint operator()(const Key &key) const {
+			return ((uint)key.classAddr.getSegment() * 31 + key.classAddr.getOffset()) * 31 + (uint)key.selectorId;
+		}
+	};
+
+	typedef Common::HashMap<Key, Entry, KeyHash> EntryMap;
+
+	EntryMap _entries;
+	uint32 _hits, _misses, _invalidations;
+	uint64 _probes;
+};
+
 /**
  * Read a PMachine instruction from a memory buffer and return its length.
  *
@@ -413,6 +485,17 @@ SelectorType lookupSelector(SegManager *segMan, reg_t obj, Selector selectorid,
  */
 int readPMachineInstruction(const byte *src, byte &extOpcode, int16 opparams[4]);
 
+/**
+ * Checks whether a PMachine instruction can be read from a memory buffer.
+ * Unlike readPMachineInstruction(), this does not error out on invalid
+ * opcodes, so it can be used on data which is not known to be code.
+ *
+ * @param[in] src		address from which to start parsing
+ * @param[in] size		number of bytes available at src
+ * @return true if the opcode is valid and the instruction fits into size
+ */
+bool isValidPMachineInstruction(const byte *src, uint32 size);
+
 /**
  * Finds the script-absolute offset of a relative object offset.
  *
@@ -22,9 +22,11 @@
 
 // Resource library
 
+#include "common/config-manager.h"
 #include "common/file.h"
 #include "common/fs.h"
 #include "common/macresman.h"
+#include "common/system.h"
 #include "common/textconsole.h"
 #include "common/translation.h"
 #ifdef ENABLE_SCI32
@@ -34,6 +36,7 @@
 #include "sci/parser/vocabulary.h"
 #include "sci/resource.h"
 #include "sci/resource_intern.h"
+#include "sci/resource_prefetch.h"
 #include "sci/util.h"
 
 namespace Sci {
@@ -208,6 +211,11 @@ Resource::Resource(ResourceManager *resMan, ResourceId id) : SciSpan<const byte>
 	_source = nullptr;
 	_header = nullptr;
 	_headerSize = 0;
+	_compressed = false;
+	_reused = false;
+	_secondChance = false;
+	_lruPrev = nullptr;
+	_lruNext = nullptr;
 }
 
 Resource::~Resource() {
@@ -966,7 +974,14 @@ void ResourceManager::init() {
 	_maxMemoryLRU = 256 * 1024; // 256KiB
 	_memoryLocked = 0;
 	_memoryLRU = 0;
-	_LRU.clear();
+	_probationLRU.clear();
+	_protectedLRU.clear();
+	_cacheHits = 0;
+	_cacheMisses = 0;
+	_cachePrefetches = 0;
+	_cacheEvictions = 0;
+	_bytesDecompressed = 0;
+	_roomPrefetcher = nullptr;
 	_resMap.clear();
 	_audioMapSCI1 = NULL;
 #ifdef ENABLE_SCI32
@@ -1021,6 +1036,14 @@ void ResourceManager::init() {
 		_maxMemoryLRU = 4096 * 1024; // 4MiB
 	}
 
+	// Systems with plenty of memory can keep more resources around,
+	// which saves reading and decompressing them again
+	if (!_detectionMode && ConfMan.hasKey("resource_cache_size")) {
+		const int cacheSize = ConfMan.getInt("resource_cache_size");
+		if (cacheSize > 0)
+			_maxMemoryLRU = cacheSize * 1024;
+	}
+
 	switch (_viewType) {
 	case kViewEga:
 		debugC(1, kDebugLevelResMan, "resMan: Detected EGA graphic resources");
@@ -1062,12 +1085,39 @@ ResourceManager::~ResourceManager() {
 	}
 }
 
+void ResourceQueue::pushFront(Resource *res) {
+	res->_lruPrev = nullptr;
+	res->_lruNext = _head;
+	if (_head)
+		_head->_lruPrev = res;
+	else
+		_tail = res;
+	_head = res;
+	_memory += res->size();
+}
+
+void ResourceQueue::remove(Resource *res) {
+	if (res->_lruPrev)
+		res->_lruPrev->_lruNext = res->_lruNext;
+	else
+		_head = res->_lruNext;
+	if (res->_lruNext)
+		res->_lruNext->_lruPrev = res->_lruPrev;
+	else
+		_tail = res->_lruPrev;
+	res->_lruPrev = res->_lruNext = nullptr;
+	_memory -= res->size();
+}
+
 void ResourceManager::removeFromLRU(Resource *res) {
 	if (res->_status != kResStatusEnqueued) {
 		warning("resMan: trying to remove resource that isn't enqueued");
 		return;
 	}
-	_LRU.remove(res);
+	if (res->_reused)
+		_protectedLRU.remove(res);
+	else
+		_probationLRU.remove(res);
 	_memoryLRU -= res->size();
 	res->_status = kResStatusAllocated;
 }
@@ -1077,7 +1127,10 @@ void ResourceManager::addToLRU(Resource *res) {
 		warning("resMan: trying to enqueue resource with state %d", res->_status);
 		return;
 	}
-	_LRU.push_front(res);
+	if (res->_reused)
+		_protectedLRU.pushFront(res);
+	else
+		_probationLRU.pushFront(res);
 	_memoryLRU += res->size();
 #if SCI_VERBOSE_RESMAN
 	debug("Adding %s (%d bytes) to lru control: %d bytes total",
@@ -1090,15 +1143,14 @@ void ResourceManager::addToLRU(Resource *res) {
 void ResourceManager::printLRU() {
 	int mem = 0;
 	int entries = 0;
-	Common::List<Resource *>::iterator it = _LRU.begin();
-	Resource *res;
-
-	while (it != _LRU.end()) {
-		res = *it;
-		debug("\t%s: %u bytes", res->_id.toString().c_str(), res->size());
-		mem += res->size();
-		++entries;
-		++it;
+	const ResourceQueue *queues[] = { &_protectedLRU, &_probationLRU };
+
+	for (int i = 0; i < ARRAYSIZE(queues); ++i) {
+		for (Resource *res = queues[i]->front(); res; res = res->_lruNext) {
+			debug("\t%s: %u bytes", res->_id.toString().c_str(), res->size());
+			mem += res->size();
+			++entries;
+		}
 	}
 
 	debug("Total: %d entries, %d bytes (mgr says %d)", entries, mem, _memoryLRU);
@@ -1106,16 +1158,47 @@ void ResourceManager::printLRU() {
 
 void ResourceManager::freeOldResources() {
 	while (_maxMemoryLRU < _memoryLRU) {
-		assert(!_LRU.empty());
-		Resource *goner = _LRU.back();
+		// Resources which were not used again since being loaded go first,
+		// unless they take up only a small part of the budget. This way,
+		// going through many resources once, e.g. the views of a new room,
+		// does not push out the resources which are used all the time.
+		const bool fromProbation = _protectedLRU.empty() || _probationLRU.getMemory() > _maxMemoryLRU / 4;
+		ResourceQueue &queue = fromProbation ? _probationLRU : _protectedLRU;
+		assert(!queue.empty());
+		Resource *goner = queue.back();
+
+		// Decompressing takes longer than reading, so compressed resources
+		// are kept once more before freeing them
+		if (fromProbation && goner->_compressed && !goner->_secondChance) {
+			goner->_secondChance = true;
+			queue.remove(goner);
+			queue.pushFront(goner);
+			continue;
+		}
+
 		removeFromLRU(goner);
 		goner->unalloc();
+		_cacheEvictions++;
 #ifdef SCI_VERBOSE_RESMAN
 		debug("resMan-debug: LRU: Freeing %s (%d bytes)", goner->_id.toString().c_str(), goner->size);
 #endif
 	}
 }
 
+ResourceManager::CacheStats ResourceManager::getCacheStats() const {
+	CacheStats stats;
+	stats.hits = _cacheHits;
+	stats.misses = _cacheMisses;
+	stats.prefetches = _cachePrefetches;
+	stats.evictions = _cacheEvictions;
+	stats.bytesDecompressed = _bytesDecompressed;
+	stats.maxMemory = _maxMemoryLRU;
+	stats.memoryLocked = _memoryLocked;
+	stats.memoryProbation = _probationLRU.getMemory();
+	stats.memoryProtected = _protectedLRU.getMemory();
+	return stats;
+}
+
 Common::List<ResourceId> ResourceManager::listResources(ResourceType type, int mapNumber) {
 	Common::List<ResourceId> resources;
 
@@ -1135,15 +1218,34 @@ Resource *ResourceManager::findResource(ResourceId id, bool lock) {
 	if (!retval)
 		return NULL;
 
-	if (retval->_status == kResStatusNoMalloc)
+	if (retval->_status == kResStatusNoMalloc) {
+		_cacheMisses++;
+		retval->_compressed = false;
+		retval->_reused = false;
+		retval->_secondChance = false;
+
+		const uint32 startTime = g_system->getMillis();
 		loadResource(retval);
-	else if (retval->_status == kResStatusEnqueued)
-		// The resource is removed from its current position
-		// in the LRU list because it has been requested
-		// again. Below, it will either be locked, or it
-		// will be added back to the LRU list at the 'most
-		// recent' position.
-		removeFromLRU(retval);
+		if (retval->_compressed)
+			_bytesDecompressed += retval->size();
+
+		if (_roomPrefetcher)
+			_roomPrefetcher->resourceRequested(id, true, g_system->getMillis() - startTime);
+	} else {
+		if (_roomPrefetcher)
+			_roomPrefetcher->resourceRequested(id, false, 0);
+
+		_cacheHits++;
+		if (retval->_status == kResStatusEnqueued)
+			// The resource is removed from its current position
+			// in the LRU list because it has been requested
+			// again. Below, it will either be locked, or it
+			// will be added back to the LRU list at the 'most
+			// recent' position.
+			removeFromLRU(retval);
+		retval->_reused = true;
+		retval->_secondChance = false;
+	}
 
 	// Unless an error occurred, the resource is now either
 	// locked or allocated, but never queued or freed.
@@ -1170,6 +1272,32 @@ Resource *ResourceManager::findResource(ResourceId id, bool lock) {
 	}
 }
 
+Resource *ResourceManager::prefetchResource(ResourceId id) {
+	Resource *res = testResource(id);
+	if (!res || res->_status != kResStatusNoMalloc)
+		return nullptr;
+
+	_cachePrefetches++;
+	res->_compressed = false;
+	res->_reused = false;
+	res->_secondChance = false;
+
+	loadResource(res);
+	if (res->_compressed)
+		_bytesDecompressed += res->size();
+
+	if (!res->data()) {
+		warning("resMan: Failed to read %s", res->_id.toString().c_str());
+		return nullptr;
+	}
+
+	// Like any other resource loaded once, it stays in the probation queue
+	// until the game uses it
+	freeOldResources();
+	addToLRU(res);
+	return res;
+}
+
 void ResourceManager::unlockResource(Resource *res) {
 	assert(res);
 
@@ -2259,6 +2387,7 @@ int Resource::decompress(ResVersion volVersion, Common::SeekableReadStream *file
 	byte *ptr = new byte[_size];
 	_data = ptr;
 	_status = kResStatusAllocated;
+	_compressed = compression != kCompNone;
 	errorNum = ptr ? dec->unpack(file, ptr, szPacked, _size) : SCI_ERROR_RESOURCE_TOO_BIG;
 	if (errorNum) {
 		unalloc();
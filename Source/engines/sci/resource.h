@@ -240,6 +240,33 @@ struct ResourceIdHash : public Common::UnaryFunction<ResourceId, uint> {
 	uint operator()(ResourceId val) const { return val.hash(); }
 };
 
+class Resource;
+
+/**
+ * A queue of unlocked resources kept in memory, most recently used first.
+ * The links are stored in the resources themselves, so adding and removing
+ * resources takes constant time and needs no allocations.
+ */
+class ResourceQueue {
+public:
+	ResourceQueue() : _head(nullptr), _tail(nullptr), _memory(0) {}
+
+	void pushFront(Resource *res);
+	void remove(Resource *res);
+	void clear() { _head = _tail = nullptr; _memory = 0; }
+
+	Resource *front() const { return _head; }
+	Resource *back() const { return _tail; }
+	bool empty() const { return _head == nullptr; }
+
+	/** Returns the amount of resource bytes in the queue. */
+	int getMemory() const { return _memory; }
+
+private:
+	Resource *_head, *_tail;
+	int _memory;
+};
+
 /** Class for storing resources in memory */
 class Resource : public SciSpan<const byte> {
 	friend class ResourceManager;
@@ -254,6 +281,7 @@ class Resource : public SciSpan<const byte> {
 #ifdef ENABLE_SCI32
 	friend class ChunkResourceSource;
 #endif
+	friend class ResourceQueue;
 
 protected:
 	/**
@@ -271,6 +299,8 @@ public:
 
 	inline ResourceType getType() const { return _id.getType(); }
 	inline uint16 getNumber() const { return _id.getNumber(); }
+	inline const ResourceId &getId() const { return _id; }
+	inline int32 getFileOffset() const { return _fileOffset; }
 	bool isLocked() const { return _status == kResStatusLocked; }
 	/**
 	 * Write the resource to the specified stream.
@@ -299,6 +329,11 @@ protected:
 	ResourceSource *_source;
 	ResourceManager *_resMan;
 
+	bool _compressed; /**< Whether loading the data required decompressing it */
+	bool _reused; /**< Whether the data was used again since it was loaded */
+	bool _secondChance; /**< Whether the cache already kept the resource once instead of freeing it */
+	Resource *_lruPrev, *_lruNext; /**< Neighbours in the resource cache queue */
+
 	bool loadPatch(Common::SeekableReadStream *file);
 	bool loadFromPatchFile();
 	bool loadFromWaveFile(Common::SeekableReadStream *file);
@@ -311,6 +346,7 @@ protected:
 typedef Common::HashMap<ResourceId, Resource *, ResourceIdHash> ResourceMap;
 
 class IntMapResourceSource;
+class RoomPrefetcher;
 class ResourceManager {
 	// FIXME: These 'friend' declarations are meant to be a temporary hack to
 	// ease transition to the ResourceSource class system.
@@ -360,6 +396,15 @@ public:
 	 */
 	Resource *findResource(ResourceId id, bool lock);
 
+	/**
+	 * Loads a resource into the cache before the game asks for it. This is
+	 * counted as a prefetch rather than as a miss in the cache statistics.
+	 * @param id	The resource to load
+	 * @return The resource, or NULL if it doesn't exist, was in memory
+	 *         already or could not be loaded
+	 */
+	Resource *prefetchResource(ResourceId id);
+
 	/**
 	 * Unlocks a previously locked resource.
 	 * @param res	The resource to free
@@ -398,6 +443,28 @@ public:
 	const char *getVolVersionDesc() const { return versionDescription(_volVersion); }
 	ResVersion getVolVersion() const { return _volVersion; }
 
+	/**
+	 * Statistics of the cache of unlocked resources, for the debugger.
+	 */
+	struct CacheStats {
+		uint32 hits; ///< Requests for resources already in memory
+		uint32 misses; ///< Requests which had to load the resource
+		uint32 prefetches; ///< Resources loaded before the game asked for them
+		uint32 evictions; ///< Resources freed to stay within the memory budget
+		uint64 bytesDecompressed; ///< Amount of bytes decompressed when loading
+		int maxMemory; ///< The memory budget, in bytes
+		int memoryLocked; ///< Amount of resource bytes in locked memory
+		int memoryProbation; ///< Amount of resource bytes used once since being loaded
+		int memoryProtected; ///< Amount of resource bytes used again since being loaded
+	};
+
+	CacheStats getCacheStats() const;
+
+	/**
+	 * Sets the prefetcher to tell about the resources the game requests.
+	 */
+	void setRoomPrefetcher(RoomPrefetcher *prefetcher) { _roomPrefetcher = prefetcher; }
+
 	/**
 	 * Adds the appropriate GM patch from the Sierra MIDI utility as 4.pat, without
 	 * requiring the user to rename the file to 4.pat. Thus, the original Sierra
@@ -479,7 +546,17 @@ protected:
 	SourcesList _sources;
 	int _memoryLocked;	///< Amount of resource bytes in locked memory
 	int _memoryLRU;		///< Amount of resource bytes under LRU control
-	Common::List<Resource *> _LRU; ///< Last Resource Used list
+
+	// Unlocked resources are kept in two queues, so that a series of
+	// resources which are used only once cannot push out the resources
+	// which are used over and over again, see freeOldResources().
+	ResourceQueue _probationLRU; ///< Resources not used again since being loaded
+	ResourceQueue _protectedLRU; ///< Resources used again since being loaded
+
+	uint32 _cacheHits, _cacheMisses, _cachePrefetches, _cacheEvictions;
+	uint64 _bytesDecompressed;
+
+	RoomPrefetcher *_roomPrefetcher;
 	ResourceMap _resMap;
 	Common::List<Common::File *> _volumeFiles; ///< list of opened volume files
 	ResourceSource *_audioMapSCI1; ///< Currently loaded audio map for SCI1
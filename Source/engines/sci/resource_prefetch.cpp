@@ -0,0 +1,221 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+
+#include "common/savefile.h"
+#include "common/system.h"
+
+#include "sci/resource_prefetch.h"
+
+namespace Sci {
+
+namespace {
+
+enum {
+	kIndexTag = MKTAG('S', 'R', 'P', 'F'),
+	kIndexVersion = 1
+};
+
+/** The resource types which are worth loading ahead of time */
+bool isPrefetchable(ResourceType type) {
+	switch (type) {
+	case kResourceTypeView:
+	case kResourceTypePic:
+	case kResourceTypeScript:
+	case kResourceTypeHeap:
+	case kResourceTypeSound:
+	case kResourceTypePalette:
+		return true;
+	default:
+		return false;
+	}
+}
+
+} // End of anonymous namespace
+
+RoomPrefetcher::RoomPrefetcher(ResourceManager *resMan, const Common::String &indexName, bool enabled) :
+	_resMan(resMan),
+	_indexName(indexName),
+	_enabled(enabled),
+	_indexChanged(false),
+	_room(0),
+	_roomKnown(false),
+	_queuePos(0),
+	_prefetching(false),
+	_prefetchMemory(0),
+	_onDemandCount(0),
+	_onDemandTime(0),
+	_prefetchCount(0),
+	_prefetchTime(0) {
+	loadIndex();
+}
+
+RoomPrefetcher::~RoomPrefetcher() {
+	// Keep what was learned about the current room, too
+	if (_roomKnown && !_requested.empty()) {
+		_rooms[_room] = _requested;
+		_indexChanged = true;
+	}
+
+	if (_indexChanged)
+		saveIndex();
+}
+
+void RoomPrefetcher::resourceRequested(const ResourceId &id, bool loaded, uint32 loadTime) {
+	if (_prefetching)
+		return;
+
+	if (loaded) {
+		_onDemandCount++;
+		_onDemandTime += loadTime;
+	}
+
+	if (_roomKnown && isPrefetchable(id.getType()) && _requested.size() < kMaxResourcesPerRoom && !_requestedSet.contains(id)) {
+		_requestedSet[id] = true;
+		_requested.push_back(id);
+	}
+}
+
+void RoomPrefetcher::setRoom(uint16 room) {
+	if (_roomKnown && room == _room)
+		return;
+
+	if (_roomKnown) {
+		debugC(1, kDebugLevelResMan, "Room %d: loaded %d resources on demand in %d ms, prefetched %d in %d ms",
+		       _room, _onDemandCount, _onDemandTime, _prefetchCount, _prefetchTime);
+
+		if (!_requested.empty()) {
+			_rooms[_room] = _requested;
+			_indexChanged = true;
+		}
+	}
+
+	_room = room;
+	_roomKnown = true;
+	_requested.clear();
+	_requestedSet.clear();
+	_onDemandCount = _onDemandTime = 0;
+	_prefetchCount = _prefetchTime = 0;
+
+	_queue.clear();
+	_queuePos = 0;
+	_prefetchMemory = 0;
+
+	if (_enabled) {
+		RoomMap::const_iterator known = _rooms.find(room);
+		if (known != _rooms.end())
+			_queue = known->_value;
+	}
+}
+
+void RoomPrefetcher::prefetch(uint32 deadline) {
+	if (_queuePos >= _queue.size())
+		return;
+
+	// Prefetched resources are not used until the room needs them, so they
+	// are kept in the probation queue of the cache. When the cache is full,
+	// that queue is trimmed to a quarter of the budget, starting with the
+	// resources used longest ago. Prefetching more than that would push
+	// out the resources prefetched first. Only the resources loaded here
+	// count, as those left in the queue from earlier rooms go first.
+	const int maxMemory = _resMan->getCacheStats().maxMemory / 4;
+
+	uint32 time = g_system->getMillis();
+	_prefetching = true;
+	while (_queuePos < _queue.size() && time < deadline && _prefetchMemory < maxMemory) {
+		const Resource *res = _resMan->prefetchResource(_queue[_queuePos++]);
+		if (!res)
+			continue;
+
+		const uint32 now = g_system->getMillis();
+		_prefetchTime += now - time;
+		time = now;
+
+		_prefetchCount++;
+		_prefetchMemory += res->size();
+	}
+	_prefetching = false;
+}
+
+void RoomPrefetcher::loadIndex() {
+	Common::InSaveFile *in = g_system->getSavefileManager()->openForLoading(_indexName);
+	if (!in)
+		return;
+
+	if (in->readUint32BE() != kIndexTag || in->readUint16LE() != kIndexVersion) {
+		warning("Ignoring room prefetch index '%s' of an unknown version", _indexName.c_str());
+		delete in;
+		return;
+	}
+
+	const uint16 roomCount = in->readUint16LE();
+	for (uint16 i = 0; i < roomCount && !in->eos() && !in->err(); ++i) {
+		const uint16 room = in->readUint16LE();
+		const uint16 count = in->readUint16LE();
+
+		ResourceList &resources = _rooms[room];
+		resources.clear();
+		for (uint16 j = 0; j < count; ++j) {
+			const ResourceType type = (ResourceType)in->readByte();
+			const uint16 number = in->readUint16LE();
+			const uint32 tuple = in->readUint32LE();
+			resources.push_back(ResourceId(type, number, tuple));
+		}
+	}
+
+	if (in->err() || in->eos()) {
+		warning("Room prefetch index '%s' is damaged", _indexName.c_str());
+		_rooms.clear();
+	}
+
+	delete in;
+}
+
+void RoomPrefetcher::saveIndex() {
+	Common::OutSaveFile *out = g_system->getSavefileManager()->openForSaving(_indexName, false);
+	if (!out) {
+		warning("Could not save room prefetch index '%s'", _indexName.c_str());
+		return;
+	}
+
+	out->writeUint32BE(kIndexTag);
+	out->writeUint16LE(kIndexVersion);
+	out->writeUint16LE(_rooms.size());
+	for (RoomMap::const_iterator room = _rooms.begin(); room != _rooms.end(); ++room) {
+		out->writeUint16LE(room->_key);
+		out->writeUint16LE(room->_value.size());
+		for (ResourceList::const_iterator id = room->_value.begin(); id != room->_value.end(); ++id) {
+			out->writeByte(id->getType());
+			out->writeUint16LE(id->getNumber());
+			out->writeUint32LE(id->getTuple());
+		}
+	}
+
+	out->finalize();
+	if (out->err())
+		warning("Could not save room prefetch index '%s'", _indexName.c_str());
+	delete out;
+
+	_indexChanged = false;
+}
+
+} // End of namespace Sci
@@ -0,0 +1,112 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+
+#ifndef SCI_RESOURCE_PREFETCH_H
+#define SCI_RESOURCE_PREFETCH_H
+
+#include "common/array.h"
+#include "common/hashmap.h"
+#include "common/str.h"
+
+#include "sci/resource.h"
+
+namespace Sci {
+
+/**
+ * Loads the resources of a room before the game asks for them.
+ *
+ * While the game is in a room, the prefetcher records which resources it
+ * requests. When the game enters a room again later, the recorded
+ * resources are queued and loaded into the resource cache whenever the
+ * engine is idle, i.e. while it waits for the next frame. The records are
+ * kept in a small index file next to the saved games, so they survive
+ * across sessions.
+ *
+ * On each room change, the time spent loading resources on demand in the
+ * room just left is logged on the ResMan debug channel, along with the
+ * time spent prefetching. Prefetching can be turned off with the
+ * prefetch_rooms config key to compare the two.
+ */
+class RoomPrefetcher {
+public:
+	RoomPrefetcher(ResourceManager *resMan, const Common::String &indexName, bool enabled);
+	~RoomPrefetcher();
+
+	/**
+	 * Notes a resource requested by the game.
+	 *
+	 * @param id		the resource
+	 * @param loaded	whether it had to be loaded first
+	 * @param loadTime	the time loading it took, in milliseconds
+	 */
+	void resourceRequested(const ResourceId &id, bool loaded, uint32 loadTime);
+
+	/**
+	 * Tells the prefetcher the room the game is in or about to enter. On a
+	 * change, the resources of the new room are queued for prefetching.
+	 */
+	void setRoom(uint16 room);
+
+	/**
+	 * Loads queued resources until the given time, in milliseconds as
+	 * returned by OSystem::getMillis(), is reached.
+	 */
+	void prefetch(uint32 deadline);
+
+private:
+	enum {
+		kMaxResourcesPerRoom = 512
+	};
+
+	typedef Common::Array<ResourceId> ResourceList;
+	typedef Common::HashMap<ResourceId, bool, ResourceIdHash> ResourceSet;
+	typedef Common::HashMap<uint16, ResourceList> RoomMap;
+
+	void loadIndex();
+	void saveIndex();
+
+	ResourceManager *_resMan;
+	const Common::String _indexName;
+	const bool _enabled;
+
+	RoomMap _rooms; ///< The resources each room requested on the last visit
+	bool _indexChanged;
+
+	uint16 _room;
+	bool _roomKnown;
+	ResourceList _requested; ///< The resources requested in the current room
+	ResourceSet _requestedSet;
+
+	ResourceList _queue; ///< The resources still to prefetch
+	uint _queuePos;
+	bool _prefetching;
+	int _prefetchMemory; ///< Amount of resource bytes prefetched for the current room
+
+	// Statistics of the current room
+	uint32 _onDemandCount, _onDemandTime;
+	uint32 _prefetchCount, _prefetchTime;
+};
+
+} // End of namespace Sci
+
+#endif // SCI_RESOURCE_PREFETCH_H
@@ -32,6 +32,7 @@
 #include "sci/debug.h"
 #include "sci/console.h"
 #include "sci/event.h"
+#include "sci/resource_prefetch.h"
 
 #include "sci/engine/features.h"
 #include "sci/engine/guest_additions.h"
@@ -100,6 +101,7 @@ SciEngine::SciEngine(OSystem *syst, const ADGameDescription *desc, SciGameId gam
 	_guestAdditions = nullptr;
 	_features = 0;
 	_resMan = 0;
+	_roomPrefetcher = 0;
 	_gamestate = 0;
 	_kernel = 0;
 	_vocabulary = 0;
@@ -250,6 +252,9 @@ SciEngine::~SciEngine() {
 	delete[] _opcode_formats;
 
 	delete _scriptPatcher;
+	if (_resMan)
+		_resMan->setRoomPrefetcher(nullptr);
+	delete _roomPrefetcher;
 	delete _resMan;	// should be deleted last
 	g_sci = 0;
 }
@@ -274,6 +279,12 @@ Common::Error SciEngine::run() {
 	// Reset, so that error()s before SoundCommandParser is initialized wont cause a crash
 	_soundCmd = NULL;
 
+	// Learn which resources the rooms use, and load them ahead of time
+	// when entering a room again
+	const bool prefetchRooms = !ConfMan.hasKey("prefetch_rooms") || ConfMan.getBool("prefetch_rooms");
+	_roomPrefetcher = new RoomPrefetcher(_resMan, _targetName + ".rooms", prefetchRooms);
+	_resMan->setRoomPrefetcher(_roomPrefetcher);
+
 	// Add the after market GM patches for the specified game, if they exist
 	_resMan->addNewGMPatch(_gameId);
 	_gameObjectAddress = _resMan->findGameObject(true, isBE());
@@ -867,6 +878,10 @@ void SciEngine::sleep(uint32 msecs) {
 			g_sci->_gfxFrameout->updateScreen();
 		}
 #endif
+		// Use the time to load resources the game will need soon
+		if (_roomPrefetcher)
+			_roomPrefetcher->prefetch(wakeUpTime);
+
 		time = g_system->getMillis();
 		if (time + 10 < wakeUpTime) {
 			g_system->delayMillis(10);
@@ -62,6 +62,7 @@ namespace Sci {
 struct EngineState;
 class Vocabulary;
 class ResourceManager;
+class RoomPrefetcher;
 class Kernel;
 class GameFeatures;
 class GuestAdditions;
@@ -282,6 +283,7 @@ public:
 	bool hasMacIconBar() const;
 
 	inline ResourceManager *getResMan() const { return _resMan; }
+	inline RoomPrefetcher *getRoomPrefetcher() const { return _roomPrefetcher; }
 	inline ScriptPatcher *getScriptPatcher() const { return _scriptPatcher; }
 	inline Kernel *getKernel() const { return _kernel; }
 	inline EngineState *getEngineState() const { return _gamestate; }
@@ -426,6 +428,7 @@ private:
 	const ADGameDescription *_gameDescription;
 	const SciGameId _gameId;
 	ResourceManager *_resMan; /**< The resource manager */
+	RoomPrefetcher *_roomPrefetcher; /**< Loads room resources while the engine is idle */
 	ScriptPatcher *_scriptPatcher; /**< The script patcher */
 	EngineState *_gamestate;
 	Kernel *_kernel;
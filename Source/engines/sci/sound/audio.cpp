@@ -33,6 +33,7 @@
 #include "common/system.h"
 
 #include "audio/audiostream.h"
+#include "audio/soundcache.h"
 #include "audio/decoders/aiff.h"
 #include "audio/decoders/flac.h"
 #include "audio/decoders/mac_snd.h"
@@ -354,6 +355,17 @@ Audio::RewindableAudioStream *AudioPlayer::getAudioStream(uint32 number, uint32
 		}
 	}
 
+	// Decoded audio resources are kept in the sound cache, so that sounds
+	// played repeatedly only have to be decoded once
+	const Common::String cacheKey = Audio::SoundCache::makeKey(ConfMan.getActiveDomainName() + "/" + audioRes->getResourceLocation(),
+	                                                           audioRes->getFileOffset(), audioRes->getId().toString());
+	audioSeekStream = g_soundCache.get(cacheKey);
+	if (audioSeekStream) {
+		_audioRate = audioSeekStream->getRate();
+		*sampleLen = (audioSeekStream->getLength().msecs() * 60) / 1000; // we translate msecs to ticks
+		return audioSeekStream;
+	}
+
 	byte audioFlags;
 	uint32 audioCompressionType = audioRes->getAudioCompressionType();
 
@@ -454,6 +466,7 @@ Audio::RewindableAudioStream *AudioPlayer::getAudioStream(uint32 number, uint32
 	}
 
 	if (audioSeekStream) {
+		audioSeekStream = g_soundCache.put(cacheKey, audioSeekStream);
 		*sampleLen = (audioSeekStream->getLength().msecs() * 60) / 1000; // we translate msecs to ticks
 		audioStream = audioSeekStream;
 	}
@@ -34,6 +34,7 @@
 #include "graphics/surface.h"
 #include "common/list.h"
 #include "graphics/transform_struct.h"
+#include "graphics/transformed_surface_cache.h"
 
 namespace Wintermute {
 class BaseSurfaceOSystem;
@@ -79,7 +80,16 @@ public:
 	BaseImage *takeScreenshot() override;
 
 	void invalidateTicket(RenderTicket *renderTicket);
+	/**
+	 * Invalidate the tickets and cached transformed copies of a surface,
+	 * after its pixels changed.
+	 * @param surf the surface which changed.
+	 */
 	void invalidateTicketsFromSurface(BaseSurfaceOSystem *surf);
+	/**
+	 * The scaled and rotated copies of surfaces, kept across frames.
+	 */
+	Graphics::TransformedSurfaceCache &getTransformCache() { return _transformCache; }
 	/**
 	 * Insert a new ticket into the queue, adding a dirty rect
 	 * @param renderTicket the ticket to be added.
@@ -128,6 +138,7 @@ private:
 	void drawFromSurface(RenderTicket *ticket, Common::Rect *dstRect, Common::Rect *clipRect);
 	Common::Rect *_dirtyRect;
 	Common::List<RenderTicket *> _renderQueue;
+	Graphics::TransformedSurfaceCache _transformCache;
 
 	bool _needsFlip;
 	RenderQueueIterator _lastFrameIter;
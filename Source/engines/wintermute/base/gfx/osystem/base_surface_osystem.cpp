@@ -186,6 +186,10 @@ bool BaseSurfaceOSystem::finishLoad() {
 
 	delete image;
 
+	// Transformed copies of a previous load are stale
+	BaseRenderOSystem *renderer = static_cast<BaseRenderOSystem *>(_gameRef->_renderer);
+	renderer->invalidateTicketsFromSurface(this);
+
 	_loaded = true;
 
 	return true;
@@ -29,6 +29,7 @@
 
 #include "engines/wintermute/base/base_game.h"
 #include "engines/wintermute/base/gfx/osystem/render_ticket.h"
+#include "engines/wintermute/base/gfx/osystem/base_render_osystem.h"
 #include "engines/wintermute/base/gfx/osystem/base_surface_osystem.h"
 #include "graphics/transform_tools.h"
 #include "common/textconsole.h"
@@ -43,14 +44,10 @@ RenderTicket::RenderTicket(BaseSurfaceOSystem *owner, const Graphics::Surface *s
 	_wantsDraw(true),
 	_transform(transform) {
 	if (surf) {
-		_surface = new Graphics::Surface();
-		_surface->create((uint16)srcRect->width(), (uint16)srcRect->height(), surf->format);
-		assert(_surface->format.bytesPerPixel == 4);
-		// Get a clipped copy of the surface
-		for (int i = 0; i < _surface->h; i++) {
-			memcpy(_surface->getBasePtr(0, i), surf->getBasePtr(srcRect->left, srcRect->top + i), srcRect->width() * _surface->format.bytesPerPixel);
-		}
-		// Then scale it if necessary
+		assert(surf->format.bytesPerPixel == 4);
+		// Scale or rotate the surface if necessary. The transformed copies
+		// are cached, as sprites tend to be drawn with the same transform
+		// in many frames.
 		//
 		// NB: The numTimesX/numTimesY properties don't yet mix well with
 		// scaling and rotation, but there is no need for that functionality at
@@ -58,40 +55,22 @@ RenderTicket::RenderTicket(BaseSurfaceOSystem *owner, const Graphics::Surface *s
 		// NB: Mirroring and rotation are probably done in the wrong order.
 		// (Mirroring should most likely be done before rotation. See also
 		// TransformTools.)
-		if (_transform._angle != Graphics::kDefaultAngle) {
-			Graphics::TransparentSurface src(*_surface, false);
-			Graphics::Surface *temp;
-			if (owner->_gameRef->getBilinearFiltering()) {
-				temp = src.rotoscaleT<Graphics::FILTER_BILINEAR>(transform);
-			} else {
-				temp = src.rotoscaleT<Graphics::FILTER_NEAREST>(transform);
-			}
-			_surface->free();
-			delete _surface;
-			_surface = temp;
-		} else if ((dstRect->width() != srcRect->width() ||
-					dstRect->height() != srcRect->height()) &&
-					_transform._numTimesX * _transform._numTimesY == 1) {
-			Graphics::TransparentSurface src(*_surface, false);
-			Graphics::Surface *temp;
-			if (owner->_gameRef->getBilinearFiltering()) {
-				temp = src.scaleT<Graphics::FILTER_BILINEAR>(dstRect->width(), dstRect->height());
-			} else {
-				temp = src.scaleT<Graphics::FILTER_NEAREST>(dstRect->width(), dstRect->height());
+		if (_transform._angle != Graphics::kDefaultAngle ||
+				((dstRect->width() != srcRect->width() ||
+				  dstRect->height() != srcRect->height()) &&
+				 _transform._numTimesX * _transform._numTimesY == 1)) {
+			BaseRenderOSystem *renderer = static_cast<BaseRenderOSystem *>(owner->_gameRef->_renderer);
+			Graphics::TFilteringMode filteringMode = owner->_gameRef->getBilinearFiltering() ? Graphics::FILTER_BILINEAR : Graphics::FILTER_NEAREST;
+			_surface = renderer->getTransformCache().get(owner, *surf, *srcRect, transform, dstRect->width(), dstRect->height(), filteringMode);
+		} else {
+			Graphics::Surface *copy = new Graphics::Surface();
+			copy->create((uint16)srcRect->width(), (uint16)srcRect->height(), surf->format);
+			// Get a clipped copy of the surface
+			for (int i = 0; i < copy->h; i++) {
+				memcpy(copy->getBasePtr(0, i), surf->getBasePtr(srcRect->left, srcRect->top + i), srcRect->width() * copy->format.bytesPerPixel);
 			}
-			_surface->free();
-			delete _surface;
-			_surface = temp;
+			_surface = Common::SharedPtr<Graphics::Surface>(copy, Graphics::SurfaceDeleter());
 		}
-	} else {
-		_surface = nullptr;
-	}
-}
-
-RenderTicket::~RenderTicket() {
-	if (_surface) {
-		_surface->free();
-		delete _surface;
 	}
 }
 
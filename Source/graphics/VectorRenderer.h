@@ -279,6 +279,33 @@ public:
 	 */
 	virtual void setGradientColors(uint8 r1, uint8 g1, uint8 b1, uint8 r2, uint8 g2, uint8 b2) = 0;
 
+	/**
+	 * The part of the drawing state which a DrawStep does not necessarily
+	 * set itself, and hence inherits from the steps drawn before it.
+	 * Colors are stored in the format of the active surface.
+	 */
+	struct InheritedState {
+		uint32 fgColor, bgColor, bevelColor;
+		uint32 gradientStart, gradientEnd;
+		int gradientFactor;
+		bool disableShadows;
+		ShadowFillMode shadowFillMode;
+
+		bool operator==(const InheritedState &other) const {
+			return fgColor == other.fgColor && bgColor == other.bgColor && bevelColor == other.bevelColor &&
+			       gradientStart == other.gradientStart && gradientEnd == other.gradientEnd &&
+			       gradientFactor == other.gradientFactor && disableShadows == other.disableShadows &&
+			       shadowFillMode == other.shadowFillMode;
+		}
+	};
+
+	/**
+	 * Returns the drawing state which the next DrawStep will inherit.
+	 * Drawing the same steps in the same area with the same inherited
+	 * state gives the same result.
+	 */
+	virtual InheritedState getInheritedState() const = 0;
+
 	/**
 	 * Sets the active drawing surface. All drawing from this
 	 * point on will be done on that surface.
@@ -458,6 +485,12 @@ public:
 	virtual void drawStep(const Common::Rect &area, const DrawStep &step, uint32 extra = 0);
 	virtual void drawStepClip(const Common::Rect &area, const Common::Rect &clip, const DrawStep &step, uint32 extra = 0);
 
+	/**
+	 * Sets up the drawing state of the specified draw step as drawStep()
+	 * does, without drawing anything.
+	 */
+	void setStepState(const DrawStep &step, uint32 extra = 0);
+
 	/**
 	 * Copies the part of the current frame to the system overlay.
 	 *
@@ -0,0 +1,156 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+
+#include "graphics/dirty_region.h"
+
+namespace Graphics {
+
+static inline uint rectArea(const Common::Rect &r) {
+	return r.width() * r.height();
+}
+
+DirtyRegion::DirtyRegion(uint rectCost) : _coalesced(true), _rectCost(rectCost), _addedArea(0) {
+}
+
+void DirtyRegion::addRect(const Common::Rect &r) {
+	if (r.isEmpty())
+		return;
+
+	_addedArea += rectArea(r);
+
+	// Drop the rect if it is already covered, which happens a lot when the
+	// same area is redrawn several times in a frame, and drop the rects
+	// which it covers
+	for (uint i = 0; i < _rects.size(); ) {
+		if (_rects[i].contains(r))
+			return;
+
+		if (r.contains(_rects[i]))
+			_rects.remove_at(i);
+		else
+			++i;
+	}
+
+	_rects.push_back(r);
+	_coalesced = false;
+}
+
+void DirtyRegion::clear() {
+	_rects.clear();
+	_coalesced = true;
+	_addedArea = 0;
+}
+
+const Common::Array<Common::Rect> &DirtyRegion::getRects() {
+	if (!_coalesced)
+		coalesce();
+
+	return _rects;
+}
+
+uint DirtyRegion::getArea() {
+	if (!_coalesced)
+		coalesce();
+
+	uint area = 0;
+	for (uint i = 0; i < _rects.size(); ++i)
+		area += rectArea(_rects[i]);
+	return area;
+}
+
+bool DirtyRegion::shouldMerge(const Common::Rect &r1, const Common::Rect &r2) const {
+	Common::Rect bounds = r1;
+	bounds.extend(r2);
+
+	uint unionArea = rectArea(r1) + rectArea(r2);
+	if (r1.intersects(r2))
+		unionArea -= rectArea(r1.findIntersectingRect(r2));
+
+	return rectArea(bounds) <= unionArea + _rectCost;
+}
+
+void DirtyRegion::addDifference(const Common::Rect &r, const Common::Rect &cut) {
+	// The parts above and below the cut span the whole width, the ones left
+	// and right of it only the remaining lines
+	const int16 top = MAX(r.top, cut.top);
+	const int16 bottom = MIN(r.bottom, cut.bottom);
+
+	if (r.top < cut.top)
+		_rects.push_back(Common::Rect(r.left, r.top, r.right, cut.top));
+	if (cut.bottom < r.bottom)
+		_rects.push_back(Common::Rect(r.left, cut.bottom, r.right, r.bottom));
+	if (r.left < cut.left)
+		_rects.push_back(Common::Rect(r.left, top, cut.left, bottom));
+	if (cut.right < r.right)
+		_rects.push_back(Common::Rect(cut.right, top, r.right, bottom));
+}
+
+void DirtyRegion::coalesce() {
+	// Merge pairs of rects as long as that makes the upload cheaper. A
+	// merged rect may now be worth merging with rects checked before, so
+	// those are checked again.
+	for (uint i = 0; i < _rects.size(); ++i) {
+		for (uint j = i + 1; j < _rects.size(); ) {
+			if (shouldMerge(_rects[i], _rects[j])) {
+				_rects[i].extend(_rects.remove_at(j));
+				j = i + 1;
+			} else {
+				++j;
+			}
+		}
+	}
+
+	// Cut the overlaps out of the remaining rects, so that no pixel is
+	// uploaded twice. The pieces are appended, and are checked against the
+	// following rects like the other ones.
+	for (uint i = 0; i < _rects.size(); ++i) {
+		for (uint j = i + 1; j < _rects.size(); ) {
+			if (_rects[i].intersects(_rects[j])) {
+				const Common::Rect cut = _rects[i];
+				const Common::Rect r = _rects.remove_at(j);
+				addDifference(r, cut);
+			} else {
+				++j;
+			}
+		}
+	}
+
+	// Upload a single rect if the rects cover most of their bounding rect
+	if (_rects.size() > 1) {
+		Common::Rect bounds = _rects[0];
+		uint cost = rectArea(_rects[0]) + _rectCost;
+		for (uint i = 1; i < _rects.size(); ++i) {
+			bounds.extend(_rects[i]);
+			cost += rectArea(_rects[i]) + _rectCost;
+		}
+
+		if (rectArea(bounds) + _rectCost <= cost) {
+			_rects.clear();
+			_rects.push_back(bounds);
+		}
+	}
+
+	_coalesced = true;
+}
+
+} // End of namespace Graphics
@@ -0,0 +1,110 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+
+#ifndef GRAPHICS_DIRTY_REGION_H
+#define GRAPHICS_DIRTY_REGION_H
+
+#include "common/array.h"
+#include "common/rect.h"
+
+namespace Graphics {
+
+/**
+ * The areas of a surface which need to be copied to the screen.
+ *
+ * The added rects are coalesced into a set of rects which do not overlap.
+ * Rects are merged into their bounding rect where uploading the extra
+ * pixels is estimated to be cheaper than uploading an additional rect.
+ */
+class DirtyRegion {
+public:
+	enum {
+		/**
+		 * The default estimated cost of uploading one rect, in pixels. This
+		 * covers the overhead of a copyRectToScreen call, and of the backend
+		 * processing one more dirty rect.
+		 */
+		kDefaultRectCost = 1024
+	};
+
+	DirtyRegion(uint rectCost = kDefaultRectCost);
+
+	/**
+	 * Add a rect to the region. Empty rects are ignored.
+	 */
+	void addRect(const Common::Rect &r);
+
+	/**
+	 * Remove all rects from the region.
+	 */
+	void clear();
+
+	/**
+	 * Returns true if the region contains no rects.
+	 */
+	bool isEmpty() const { return _rects.empty(); }
+
+	/**
+	 * Return the coalesced rects covering the region. No two of them
+	 * overlap.
+	 */
+	const Common::Array<Common::Rect> &getRects();
+
+	/**
+	 * Return the total area of the coalesced rects.
+	 */
+	uint getArea();
+
+	/**
+	 * Return the total area of the rects added since the region was last
+	 * cleared, counting overlapping areas multiple times.
+	 */
+	uint getAddedArea() const { return _addedArea; }
+
+private:
+	/**
+	 * Merge rects where that is cheaper, then cut the overlapping parts
+	 * out of the remaining rects.
+	 */
+	void coalesce();
+
+	/**
+	 * Returns true if uploading the bounding rect of the given rects is
+	 * estimated to be cheaper than uploading them separately.
+	 */
+	bool shouldMerge(const Common::Rect &r1, const Common::Rect &r2) const;
+
+	/**
+	 * Add the parts of r which are not covered by cut to _rects.
+	 */
+	void addDifference(const Common::Rect &r, const Common::Rect &cut);
+
+	Common::Array<Common::Rect> _rects;
+	bool _coalesced;
+	uint _rectCost;
+	uint _addedArea;
+};
+
+} // End of namespace Graphics
+
+#endif
@@ -36,6 +36,11 @@ Common::Rect Font::getBoundingBox(uint32 chr) const {
 	return Common::Rect(getCharWidth(chr), getFontHeight());
 }
 
+void Font::drawChars(Surface *dst, const uint32 *chrs, const int *xs, uint count, int y, uint32 color) const {
+	for (uint i = 0; i < count; ++i)
+		drawChar(dst, chrs[i], xs[i], y, color);
+}
+
 namespace {
 
 template<class StringType>
@@ -108,6 +113,12 @@ void drawStringImpl(const Font &font, Surface *dst, const StringType &str, int x
 		x = x + w - width;
 	x += deltax;
 
+	// The characters are handed to the font in runs, which allows it to
+	// draw them all at once.
+	uint32 chrs[64];
+	int xs[64];
+	uint count = 0;
+
 	typename StringType::unsigned_type last = 0;
 	for (typename StringType::const_iterator i = str.begin(), end = str.end(); i != end; ++i) {
 		const typename StringType::unsigned_type cur = *i;
@@ -116,10 +127,19 @@ void drawStringImpl(const Font &font, Surface *dst, const StringType &str, int x
 		w = font.getCharWidth(cur);
 		if (x+w > rightX)
 			break;
-		if (x+w >= leftX)
-			font.drawChar(dst, cur, x, y, color);
+		if (x+w >= leftX) {
+			chrs[count] = cur;
+			xs[count] = x;
+			if (++count == ARRAYSIZE(chrs)) {
+				font.drawChars(dst, chrs, xs, count, y, color);
+				count = 0;
+			}
+		}
 		x += w;
 	}
+
+	if (count)
+		font.drawChars(dst, chrs, xs, count, y, color);
 }
 
 template<class StringType>
@@ -144,6 +144,22 @@ public:
 	virtual void drawChar(Surface *dst, uint32 chr, int x, int y, uint32 color) const = 0;
 	void drawChar(ManagedSurface *dst, uint32 chr, int x, int y, uint32 color) const;
 
+	/**
+	 * Draw a run of characters on the same line of a surface.
+	 *
+	 * drawString passes the characters of a string to this in runs, so fonts
+	 * which can draw many characters faster than one at a time can override
+	 * it. The default implementation calls drawChar for every character.
+	 *
+	 * @param dst   The surface to drawn on.
+	 * @param chrs  The characters to draw.
+	 * @param xs    The x coordinate where to draw each character.
+	 * @param count The number of characters to draw.
+	 * @param y     The y coordinate where to draw the characters.
+	 * @param color The color of the characters.
+	 */
+	virtual void drawChars(Surface *dst, const uint32 *chrs, const int *xs, uint count, int y, uint32 color) const;
+
 	// TODO: Add doxygen comments to this
 	void drawString(Surface *dst, const Common::String &str, int x, int y, int w, uint32 color, TextAlign align = kTextAlignLeft, int deltax = 0, bool useEllipsis = true) const;
 	void drawString(Surface *dst, const Common::U32String &str, int x, int y, int w, uint32 color, TextAlign align = kTextAlignLeft) const;
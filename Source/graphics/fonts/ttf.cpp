@@ -36,6 +36,8 @@
 #include "common/memstream.h"
 #include "common/hashmap.h"
 #include "common/ptr.h"
+#include "common/algorithm.h"
+#include "common/array.h"
 
 #include <ft2build.h>
 #include FT_FREETYPE_H
@@ -43,6 +45,8 @@
 #include FT_TRUETYPE_TABLES_H
 #include FT_TRUETYPE_TAGS_H
 
+#include <math.h>
+
 namespace Graphics {
 
 namespace {
@@ -55,6 +59,23 @@ inline int divRoundToNearest(int dividend, int divisor) {
 	return (dividend + (divisor / 2)) / divisor;
 }
 
+/** Orders characters by the height of their glyph image, tallest first. */
+struct TallerImage {
+	const Surface *_images;
+
+	TallerImage(const Surface *images) : _images(images) {}
+
+	bool operator()(uint a, uint b) const {
+		return _images[a].h > _images[b].h;
+	}
+};
+
+/** The kerning row of characters which are not kerned against any other. */
+const int8 kNoKerning[256] = { 0 };
+
+/** Marks the kerning row of characters with offsets which do not fit a row. */
+const int8 kLargeKerning[1] = { 0 };
+
 } // End of anonymous namespace
 
 class TTFLibrary : public Common::Singleton<TTFLibrary> {
@@ -122,6 +143,8 @@ public:
 	virtual Common::Rect getBoundingBox(uint32 chr) const;
 
 	virtual void drawChar(Surface *dst, uint32 chr, int x, int y, uint32 color) const;
+
+	virtual void drawChars(Surface *dst, const uint32 *chrs, const int *xs, uint count, int y, uint32 color) const;
 private:
 	bool _initialized;
 	FT_Face _face;
@@ -133,17 +156,48 @@ private:
 	int _ascent, _descent;
 
 	struct Glyph {
-		Surface image;
+		Common::Rect image; ///< The image of the glyph in the atlas
 		int xOffset, yOffset;
 		int advance;
 		FT_UInt slot;
+
+		Glyph() : xOffset(0), yOffset(0), advance(0), slot(0) {}
 	};
 
-	bool cacheGlyph(Glyph &glyph, uint32 chr) const;
+	bool cacheGlyph(Glyph &glyph, Surface &image, uint32 chr) const;
+	void addToAtlas(Glyph &glyph, const Surface &image) const;
+	const Glyph *getGlyph(uint32 chr) const;
+	void drawGlyph(Surface *dst, const Glyph &glyph, int x, int y, uint32 color, uint8 r, uint8 g, uint8 b) const;
+
+	/**
+	 * The glyphs of the characters 0-255. These are all loaded up front and
+	 * looked up directly; a slot of 0 means the font has no such glyph.
+	 */
+	Glyph _charsetGlyphs[256];
+
 	typedef Common::HashMap<uint32, Glyph> GlyphCache;
-	mutable GlyphCache _glyphs;
+	mutable GlyphCache _glyphs; ///< The glyphs of all other characters
 	bool _allowLateCaching;
-	void assureCached(uint32 chr) const;
+
+	/**
+	 * All glyph images, packed into rows ("shelves") of a single surface
+	 * instead of one surface per glyph. The current shelf starts at
+	 * _atlasShelfY and is _atlasShelfHeight pixels high, its free space
+	 * starts at _atlasX.
+	 */
+	mutable Surface _atlas;
+	mutable int _atlasX, _atlasShelfY, _atlasShelfHeight;
+
+	Common::Rect allocateAtlasRect(int w, int h) const;
+	void resizeAtlas(int w, int h) const;
+
+	/**
+	 * The kerning offsets between the characters 0-255, computed a row of
+	 * right characters at a time when a left character is first used.
+	 */
+	mutable const int8 *_kerningRows[256];
+
+	const int8 *computeKerningRow(uint32 left) const;
 
 	Common::SeekableReadStream *readTTFTable(FT_ULong tag) const;
 
@@ -158,8 +212,9 @@ private:
 
 TTFFont::TTFFont()
     : _initialized(false), _face(), _ttfFile(0), _size(0), _width(0), _height(0), _ascent(0),
-      _descent(0), _glyphs(), _loadFlags(FT_LOAD_TARGET_NORMAL), _renderMode(FT_RENDER_MODE_NORMAL),
-      _hasKerning(false), _allowLateCaching(false) {
+      _descent(0), _glyphs(), _allowLateCaching(false), _atlasX(0), _atlasShelfY(0), _atlasShelfHeight(0),
+      _loadFlags(FT_LOAD_TARGET_NORMAL), _renderMode(FT_RENDER_MODE_NORMAL), _hasKerning(false) {
+	memset(_kerningRows, 0, sizeof(_kerningRows));
 }
 
 TTFFont::~TTFFont() {
@@ -169,8 +224,12 @@ TTFFont::~TTFFont() {
 		delete[] _ttfFile;
 		_ttfFile = 0;
 
-		for (GlyphCache::iterator i = _glyphs.begin(), end = _glyphs.end(); i != end; ++i)
-			i->_value.image.free();
+		_atlas.free();
+
+		for (uint i = 0; i < ARRAYSIZE(_kerningRows); ++i) {
+			if (_kerningRows[i] != kNoKerning && _kerningRows[i] != kLargeKerning)
+				delete[] _kerningRows[i];
+		}
 
 		_initialized = false;
 	}
@@ -245,14 +304,16 @@ bool TTFFont::load(Common::SeekableReadStream &stream, int size, TTFSizeMode siz
 	_width = ftCeil26_6(FT_MulFix(_face->max_advance_width, _face->size->metrics.x_scale));
 	_height = _ascent - _descent + 1;
 
+	Surface images[ARRAYSIZE(_charsetGlyphs)];
+
 	if (!mapping) {
 		// Allow loading of all unicode characters.
 		_allowLateCaching = true;
 
 		// Load all ISO-8859-1 characters.
 		for (uint i = 0; i < 256; ++i) {
-			if (!cacheGlyph(_glyphs[i], i)) {
-				_glyphs.erase(i);
+			if (!cacheGlyph(_charsetGlyphs[i], images[i], i)) {
+				_charsetGlyphs[i] = Glyph();
 			}
 		}
 	} else {
@@ -264,15 +325,45 @@ bool TTFFont::load(Common::SeekableReadStream &stream, int size, TTFSizeMode siz
 			const bool isRequired = (mapping[i] & 0x80000000) != 0;
 			// Check whether loading an important glyph fails and error out if
 			// that is the case.
-			if (!cacheGlyph(_glyphs[i], unicode)) {
-				_glyphs.erase(i);
-				if (isRequired)
+			if (!cacheGlyph(_charsetGlyphs[i], images[i], unicode)) {
+				_charsetGlyphs[i] = Glyph();
+				if (isRequired) {
+					for (uint j = 0; j < i; ++j)
+						images[j].free();
 					return false;
+				}
 			}
 		}
 	}
 
-	_initialized = (_glyphs.size() != 0);
+	// Pack the glyphs into the atlas from the tallest to the shortest, which
+	// wastes the least space on the shelves
+	Common::Array<uint> order;
+	for (uint i = 0; i < ARRAYSIZE(_charsetGlyphs); ++i) {
+		if (_charsetGlyphs[i].slot)
+			order.push_back(i);
+	}
+	Common::sort(order.begin(), order.end(), TallerImage(images));
+
+	// A roughly square atlas keeps the shelves short
+	int area = 0, widest = 0;
+	for (uint i = 0; i < order.size(); ++i) {
+		area += images[order[i]].w * images[order[i]].h;
+		widest = MAX<int>(widest, images[order[i]].w);
+	}
+	if (!order.empty())
+		resizeAtlas(MAX<int>(widest, sqrt((double)area)), _height);
+
+	for (uint i = 0; i < order.size(); ++i) {
+		addToAtlas(_charsetGlyphs[order[i]], images[order[i]]);
+		images[order[i]].free();
+	}
+
+	// Drop the space the atlas has grown into but not used yet
+	if (_atlas.h > _atlasShelfY + _atlasShelfHeight)
+		resizeAtlas(_atlas.w, _atlasShelfY + _atlasShelfHeight);
+
+	_initialized = !order.empty();
 	return _initialized;
 }
 
@@ -405,66 +496,87 @@ int TTFFont::getMaxCharWidth() const {
 }
 
 int TTFFont::getCharWidth(uint32 chr) const {
-	assureCached(chr);
-	GlyphCache::const_iterator glyphEntry = _glyphs.find(chr);
-	if (glyphEntry == _glyphs.end())
+	const Glyph *glyph = getGlyph(chr);
+	if (!glyph)
 		return 0;
 	else
-		return glyphEntry->_value.advance;
+		return glyph->advance;
 }
 
 int TTFFont::getKerningOffset(uint32 left, uint32 right) const {
 	if (!_hasKerning)
 		return 0;
 
-	assureCached(left);
-	assureCached(right);
-
-	FT_UInt leftGlyph, rightGlyph;
-	GlyphCache::const_iterator glyphEntry;
-
-	glyphEntry = _glyphs.find(left);
-	if (glyphEntry != _glyphs.end()) {
-		leftGlyph = glyphEntry->_value.slot;
-	} else {
-		return 0;
-	}
-
-	glyphEntry = _glyphs.find(right);
-	if (glyphEntry != _glyphs.end()) {
-		rightGlyph = glyphEntry->_value.slot;
-	} else {
-		return 0;
+	if (left < ARRAYSIZE(_kerningRows) && right < ARRAYSIZE(_kerningRows)) {
+		const int8 *row = _kerningRows[left];
+		if (!row)
+			row = computeKerningRow(left);
+		if (row != kLargeKerning)
+			return row[right];
 	}
 
+	const Glyph *leftGlyph = getGlyph(left);
+	const Glyph *rightGlyph = getGlyph(right);
 	if (!leftGlyph || !rightGlyph)
 		return 0;
 
 	FT_Vector kerningVector;
-	FT_Get_Kerning(_face, leftGlyph, rightGlyph, FT_KERNING_DEFAULT, &kerningVector);
+	FT_Get_Kerning(_face, leftGlyph->slot, rightGlyph->slot, FT_KERNING_DEFAULT, &kerningVector);
 	return (kerningVector.x / 64);
 }
 
+const int8 *TTFFont::computeKerningRow(uint32 left) const {
+	const FT_UInt leftSlot = _charsetGlyphs[left].slot;
+
+	int8 *row = 0;
+	if (leftSlot) {
+		for (uint right = 0; right < ARRAYSIZE(_charsetGlyphs); ++right) {
+			const FT_UInt rightSlot = _charsetGlyphs[right].slot;
+			if (!rightSlot)
+				continue;
+
+			FT_Vector kerningVector;
+			FT_Get_Kerning(_face, leftSlot, rightSlot, FT_KERNING_DEFAULT, &kerningVector);
+			const int offset = kerningVector.x / 64;
+			if (!offset)
+				continue;
+
+			// Offsets this large only occur with huge sizes; those are
+			// queried from FreeType every time
+			if (offset < -128 || offset > 127) {
+				delete[] row;
+				_kerningRows[left] = kLargeKerning;
+				return kLargeKerning;
+			}
+
+			if (!row) {
+				row = new int8[ARRAYSIZE(_charsetGlyphs)];
+				memset(row, 0, ARRAYSIZE(_charsetGlyphs));
+			}
+			row[right] = offset;
+		}
+	}
+
+	// Most characters are not kerned against any other, those share a row
+	_kerningRows[left] = row ? row : kNoKerning;
+	return _kerningRows[left];
+}
+
 Common::Rect TTFFont::getBoundingBox(uint32 chr) const {
-	assureCached(chr);
-	GlyphCache::const_iterator glyphEntry = _glyphs.find(chr);
-	if (glyphEntry == _glyphs.end()) {
+	const Glyph *glyph = getGlyph(chr);
+	if (!glyph) {
 		return Common::Rect();
 	} else {
-		const int xOffset = glyphEntry->_value.xOffset;
-		const int yOffset = glyphEntry->_value.yOffset;
-		const Graphics::Surface &image = glyphEntry->_value.image;
-		return Common::Rect(xOffset, yOffset, xOffset + image.w, yOffset + image.h);
+		const int xOffset = glyph->xOffset;
+		const int yOffset = glyph->yOffset;
+		return Common::Rect(xOffset, yOffset, xOffset + glyph->image.width(), yOffset + glyph->image.height());
 	}
 }
 
 namespace {
 
 template<typename ColorType>
-void renderGlyph(uint8 *dstPos, const int dstPitch, const uint8 *srcPos, const int srcPitch, const int w, const int h, ColorType color, const PixelFormat &dstFormat) {
-	uint8 sR, sG, sB;
-	dstFormat.colorToRGB(color, sR, sG, sB);
-
+void renderGlyph(uint8 *dstPos, const int dstPitch, const uint8 *srcPos, const int srcPitch, const int w, const int h, ColorType color, uint8 sR, uint8 sG, uint8 sB, const PixelFormat &dstFormat) {
 	for (int y = 0; y < h; ++y) {
 		ColorType *rDst = (ColorType *)dstPos;
 		const uint8 *src = srcPos;
@@ -497,13 +609,23 @@ void renderGlyph(uint8 *dstPos, const int dstPitch, const uint8 *srcPos, const i
 } // End of anonymous namespace
 
 void TTFFont::drawChar(Surface *dst, uint32 chr, int x, int y, uint32 color) const {
-	assureCached(chr);
-	GlyphCache::const_iterator glyphEntry = _glyphs.find(chr);
-	if (glyphEntry == _glyphs.end())
-		return;
+	drawChars(dst, &chr, &x, 1, y, color);
+}
 
-	const Glyph &glyph = glyphEntry->_value;
+void TTFFont::drawChars(Surface *dst, const uint32 *chrs, const int *xs, uint count, int y, uint32 color) const {
+	// Split up the color only once for the whole run
+	uint8 r = 0, g = 0, b = 0;
+	if (dst->format.bytesPerPixel != 1)
+		dst->format.colorToRGB(color, r, g, b);
 
+	for (uint i = 0; i < count; ++i) {
+		const Glyph *glyph = getGlyph(chrs[i]);
+		if (glyph)
+			drawGlyph(dst, *glyph, xs[i], y, color, r, g, b);
+	}
+}
+
+void TTFFont::drawGlyph(Surface *dst, const Glyph &glyph, int x, int y, uint32 color, uint8 r, uint8 g, uint8 b) const {
 	x += glyph.xOffset;
 	y += glyph.yOffset;
 
@@ -512,10 +634,10 @@ void TTFFont::drawChar(Surface *dst, uint32 chr, int x, int y, uint32 color) con
 	if (y > dst->h)
 		return;
 
-	int w = glyph.image.w;
-	int h = glyph.image.h;
+	int w = glyph.image.width();
+	int h = glyph.image.height();
 
-	const uint8 *srcPos = (const uint8 *)glyph.image.getPixels();
+	const uint8 *srcPos = (const uint8 *)_atlas.getBasePtr(glyph.image.left, glyph.image.top);
 
 	// Make sure we are not drawing outside the screen bounds
 	if (x < 0) {
@@ -531,7 +653,7 @@ void TTFFont::drawChar(Surface *dst, uint32 chr, int x, int y, uint32 color) con
 		return;
 
 	if (y < 0) {
-		srcPos -= y * glyph.image.pitch;
+		srcPos -= y * _atlas.pitch;
 		h += y;
 		y = 0;
 	}
@@ -560,16 +682,16 @@ void TTFFont::drawChar(Surface *dst, uint32 chr, int x, int y, uint32 color) con
 			}
 
 			dstPos += dst->pitch;
-			srcPos += glyph.image.pitch;
+			srcPos += _atlas.pitch;
 		}
 	} else if (dst->format.bytesPerPixel == 2) {
-		renderGlyph<uint16>(dstPos, dst->pitch, srcPos, glyph.image.pitch, w, h, color, dst->format);
+		renderGlyph<uint16>(dstPos, dst->pitch, srcPos, _atlas.pitch, w, h, color, r, g, b, dst->format);
 	} else if (dst->format.bytesPerPixel == 4) {
-		renderGlyph<uint32>(dstPos, dst->pitch, srcPos, glyph.image.pitch, w, h, color, dst->format);
+		renderGlyph<uint32>(dstPos, dst->pitch, srcPos, _atlas.pitch, w, h, color, r, g, b, dst->format);
 	}
 }
 
-bool TTFFont::cacheGlyph(Glyph &glyph, uint32 chr) const {
+bool TTFFont::cacheGlyph(Glyph &glyph, Surface &image, uint32 chr) const {
 	FT_UInt slot = FT_Get_Char_Index(_face, chr);
 	if (!slot)
 		return false;
@@ -594,7 +716,7 @@ bool TTFFont::cacheGlyph(Glyph &glyph, uint32 chr) const {
 	glyph.advance = ftCeil26_6(_face->glyph->advance.x);
 
 	const FT_Bitmap &bitmap = _face->glyph->bitmap;
-	glyph.image.create(bitmap.width, bitmap.rows, PixelFormat::createFormatCLUT8());
+	image.create(bitmap.width, bitmap.rows, PixelFormat::createFormatCLUT8());
 
 	const uint8 *src = bitmap.buffer;
 	int srcPitch = bitmap.pitch;
@@ -603,8 +725,8 @@ bool TTFFont::cacheGlyph(Glyph &glyph, uint32 chr) const {
 		srcPitch = -srcPitch;
 	}
 
-	uint8 *dst = (uint8 *)glyph.image.getPixels();
-	memset(dst, 0, glyph.image.h * glyph.image.pitch);
+	uint8 *dst = (uint8 *)image.getPixels();
+	memset(dst, 0, image.h * image.pitch);
 
 	switch (bitmap.pixel_mode) {
 	case FT_PIXEL_MODE_MONO:
@@ -630,29 +752,91 @@ bool TTFFont::cacheGlyph(Glyph &glyph, uint32 chr) const {
 	case FT_PIXEL_MODE_GRAY:
 		for (int y = 0; y < (int)bitmap.rows; ++y) {
 			memcpy(dst, src, bitmap.width);
-			dst += glyph.image.pitch;
+			dst += image.pitch;
 			src += srcPitch;
 		}
 		break;
 
 	default:
 		warning("TTFFont::cacheGlyph: Unsupported pixel mode %d", bitmap.pixel_mode);
-		glyph.image.free();
+		image.free();
 		return false;
 	}
 
 	return true;
 }
 
-void TTFFont::assureCached(uint32 chr) const {
-	if (!chr || !_allowLateCaching || _glyphs.contains(chr)) {
-		return;
-	}
+void TTFFont::addToAtlas(Glyph &glyph, const Surface &image) const {
+	glyph.image = allocateAtlasRect(image.w, image.h);
+
+	for (int y = 0; y < image.h; ++y)
+		memcpy(_atlas.getBasePtr(glyph.image.left, glyph.image.top + y), image.getBasePtr(0, y), image.w);
+}
+
+const TTFFont::Glyph *TTFFont::getGlyph(uint32 chr) const {
+	if (chr < ARRAYSIZE(_charsetGlyphs))
+		return _charsetGlyphs[chr].slot ? &_charsetGlyphs[chr] : 0;
+
+	if (!_allowLateCaching)
+		return 0;
+
+	GlyphCache::iterator glyphEntry = _glyphs.find(chr);
+	if (glyphEntry != _glyphs.end())
+		return &glyphEntry->_value;
 
 	Glyph newGlyph;
-	if (cacheGlyph(newGlyph, chr)) {
-		_glyphs[chr] = newGlyph;
+	Surface image;
+	if (!cacheGlyph(newGlyph, image, chr))
+		return 0;
+
+	addToAtlas(newGlyph, image);
+	image.free();
+
+	Glyph &glyph = _glyphs[chr];
+	glyph = newGlyph;
+	return &glyph;
+}
+
+Common::Rect TTFFont::allocateAtlasRect(int w, int h) const {
+	if (!_atlas.w) {
+		// Make room for about 16 glyphs per shelf
+		resizeAtlas(MAX(w, _width * 16), MAX(h, _height));
+	} else if (w > _atlas.w) {
+		resizeAtlas(w, _atlas.h);
+	}
+
+	// Start a new shelf when the glyph does not fit on the current one
+	if (_atlasX + w > _atlas.w) {
+		_atlasShelfY += _atlasShelfHeight;
+		_atlasShelfHeight = 0;
+		_atlasX = 0;
 	}
+
+	// Double the height when out of space. Fonts with many characters, like
+	// CJK ones, cache most of their glyphs late; growing a shelf at a time
+	// would copy the atlas once per shelf.
+	_atlasShelfHeight = MAX(_atlasShelfHeight, h);
+	if (_atlasShelfY + _atlasShelfHeight > _atlas.h)
+		resizeAtlas(_atlas.w, MAX(_atlasShelfY + MAX(_atlasShelfHeight, _height), _atlas.h * 2));
+
+	Common::Rect rect(_atlasX, _atlasShelfY, _atlasX + w, _atlasShelfY + h);
+	_atlasX += w;
+	return rect;
+}
+
+void TTFFont::resizeAtlas(int w, int h) const {
+	Surface atlas;
+	atlas.create(w, h, PixelFormat::createFormatCLUT8());
+	memset(atlas.getPixels(), 0, atlas.h * atlas.pitch);
+
+	// The glyphs keep their position, so their rects stay valid
+	const int copyW = MIN<int>(w, _atlas.w);
+	const int copyH = MIN<int>(h, _atlas.h);
+	for (int y = 0; y < copyH; ++y)
+		memcpy(atlas.getBasePtr(0, y), _atlas.getBasePtr(0, y), copyW);
+
+	_atlas.free();
+	_atlas = atlas;
 }
 
 Font *loadTTFFont(Common::SeekableReadStream &stream, int size, TTFSizeMode sizeMode, uint dpi, TTFRenderMode renderMode, const uint32 *mapping) {
@@ -126,6 +126,11 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 	//	 | w7 | w8 | w9 |
 	//	 +----+----+----+
 
+#ifdef HQ_PATTERN_CHUNK
+	// The neighbors which differ from each pixel, computed in chunks
+	int patterns[HQ_PATTERN_CHUNK];
+#endif
+
 	while (height--) {
 		w1 = *(p - 1 - nextlineSrc);
 		w4 = *(p - 1);
@@ -136,6 +141,9 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 		w8 = *(p + nextlineSrc);
 
 		int tmpWidth = width;
+#ifdef HQ_PATTERN_CHUNK
+		int patternIndex = 0, patternCount = 0;
+#endif
 		while (tmpWidth--) {
 			p++;
 
@@ -143,6 +151,14 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 			w6 = *(p);
 			w9 = *(p + nextlineSrc);
 
+#ifdef HQ_PATTERN_CHUNK
+			if (patternIndex == patternCount) {
+				patternCount = (tmpWidth < HQ_PATTERN_CHUNK) ? tmpWidth + 1 : HQ_PATTERN_CHUNK;
+				computeHQPatterns(p - 1, nextlineSrc, RGBtoYUV, patternCount, patterns);
+				patternIndex = 0;
+			}
+			const int pattern = patterns[patternIndex++];
+#else
 			int pattern = 0;
 			const int yuv5 = YUV(5);
 			if (w5 != w1 && diffYUV(yuv5, YUV(1))) pattern |= 0x0001;
@@ -153,6 +169,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 			if (w5 != w7 && diffYUV(yuv5, YUV(7))) pattern |= 0x0020;
 			if (w5 != w8 && diffYUV(yuv5, YUV(8))) pattern |= 0x0040;
 			if (w5 != w9 && diffYUV(yuv5, YUV(9))) pattern |= 0x0080;
+#endif
 
 			switch (pattern) {
 			case 0:
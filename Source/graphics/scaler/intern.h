@@ -26,6 +26,14 @@
 #include "common/scummsys.h"
 #include "graphics/colormasks.h"
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SCALER_SSE2
+#include <emmintrin.h>
+#elif defined(__ARM_NEON__) || defined(__ARM_NEON)
+#define SCALER_NEON
+#include <arm_neon.h>
+#endif
+
 
 /**
  * Interpolate two 16 bit pixel *pairs* at once with equal weights 1.
@@ -218,4 +226,119 @@ static inline bool diffYUV(int yuv1, int yuv2) {
 */
 }
 
+#if defined(SCALER_SSE2) || defined(SCALER_NEON)
+
+/**
+ * The hq scalers compute the patterns of their input pixels in chunks of
+ * this many pixels with computeHQPatterns.
+ */
+#define HQ_PATTERN_CHUNK 64
+
+#ifdef SCALER_SSE2
+
+typedef __m128i YUVVec;
+
+static inline YUVVec loadYUV(const int *src) { return _mm_loadu_si128((const __m128i *)src); }
+
+/** Compare the channels of four YUV values at once, like diffYUV does. */
+static inline YUVVec diffYUV4(YUVVec yuv1, YUVVec yuv2) {
+	static const int masks[3] = { 0x00FF0000, 0x0000FF00, 0x000000FF };
+	static const int thresholds[3] = { 0x00300000, 0x00000700, 0x00000006 };
+
+	YUVVec result = _mm_setzero_si128();
+	for (int i = 0; i < 3; i++) {
+		const YUVVec mask = _mm_set1_epi32(masks[i]);
+		YUVVec diff = _mm_sub_epi32(_mm_and_si128(yuv1, mask), _mm_and_si128(yuv2, mask));
+		const YUVVec sign = _mm_srai_epi32(diff, 31);
+		diff = _mm_sub_epi32(_mm_xor_si128(diff, sign), sign);
+		result = _mm_or_si128(result, _mm_cmpgt_epi32(diff, _mm_set1_epi32(thresholds[i])));
+	}
+	return result;
+}
+
+static inline YUVVec emptyPattern() { return _mm_setzero_si128(); }
+
+static inline YUVVec addPatternBit(YUVVec pattern, YUVVec diff, int bit) {
+	return _mm_or_si128(pattern, _mm_and_si128(diff, _mm_set1_epi32(bit)));
+}
+
+static inline void storePatterns(int *dst, YUVVec pattern) { _mm_storeu_si128((__m128i *)dst, pattern); }
+
+#else
+
+typedef int32x4_t YUVVec;
+
+static inline YUVVec loadYUV(const int *src) { return vld1q_s32(src); }
+
+/** Compare the channels of four YUV values at once, like diffYUV does. */
+static inline YUVVec diffYUV4(YUVVec yuv1, YUVVec yuv2) {
+	static const int masks[3] = { 0x00FF0000, 0x0000FF00, 0x000000FF };
+	static const int thresholds[3] = { 0x00300000, 0x00000700, 0x00000006 };
+
+	uint32x4_t result = vdupq_n_u32(0);
+	for (int i = 0; i < 3; i++) {
+		const YUVVec mask = vdupq_n_s32(masks[i]);
+		const YUVVec diff = vabdq_s32(vandq_s32(yuv1, mask), vandq_s32(yuv2, mask));
+		result = vorrq_u32(result, vcgtq_s32(diff, vdupq_n_s32(thresholds[i])));
+	}
+	return vreinterpretq_s32_u32(result);
+}
+
+static inline YUVVec emptyPattern() { return vdupq_n_s32(0); }
+
+static inline YUVVec addPatternBit(YUVVec pattern, YUVVec diff, int bit) {
+	return vorrq_s32(pattern, vandq_s32(diff, vdupq_n_s32(bit)));
+}
+
+static inline void storePatterns(int *dst, YUVVec pattern) { vst1q_s32(dst, pattern); }
+
+#endif
+
+/**
+ * Compute the patterns of count (at most HQ_PATTERN_CHUNK) pixels in a row
+ * for the hq scaler family. Bit n - 1 of a pattern is set if the neighbor
+ * wn differs from the pixel, using the numbering of the hq scalers, i.e.
+ * bit 0 for the top left neighbor w1 and bit 7 for the bottom right one w9.
+ *
+ * @param p           the first pixel
+ * @param nextlineSrc the pitch of the source, in pixels
+ * @param rgbToYUV    the RGBtoYUV table
+ * @param count       the number of pixels
+ * @param patterns    receives the patterns
+ */
+static inline void computeHQPatterns(const uint16 *p, uint32 nextlineSrc, const uint32 *rgbToYUV, int count, int *patterns) {
+	// The YUV values of the three rows, including the pixels left and
+	// right of the chunk
+	int yuv[3][HQ_PATTERN_CHUNK + 2];
+	for (int row = 0; row < 3; row++) {
+		const uint16 *src = p - 1 + (row - 1) * (int)nextlineSrc;
+		for (int i = 0; i < count + 2; i++)
+			yuv[row][i] = rgbToYUV[src[i]];
+	}
+
+	// The row and column of the neighbors w1 to w9, leaving out w5
+	static const int neighborRows[8]    = { 0, 0, 0, 1, 1, 2, 2, 2 };
+	static const int neighborColumns[8] = { 0, 1, 2, 0, 2, 0, 1, 2 };
+
+	int i = 0;
+	for (; i + 4 <= count; i += 4) {
+		const YUVVec yuv5 = loadYUV(&yuv[1][i + 1]);
+
+		YUVVec pattern = emptyPattern();
+		for (int n = 0; n < 8; n++)
+			pattern = addPatternBit(pattern, diffYUV4(yuv5, loadYUV(&yuv[neighborRows[n]][i + neighborColumns[n]])), 1 << n);
+		storePatterns(&patterns[i], pattern);
+	}
+
+	for (; i < count; i++) {
+		patterns[i] = 0;
+		for (int n = 0; n < 8; n++) {
+			if (diffYUV(yuv[1][i + 1], yuv[neighborRows[n]][i + neighborColumns[n]]))
+				patterns[i] |= 1 << n;
+		}
+	}
+}
+
+#endif
+
 #endif
@@ -500,3 +500,172 @@ void scale2x_32_mmx(scale2x_uint32* dst0, scale2x_uint32* dst1, const scale2x_ui
 }
 
 #endif
+
+/***************************************************************************/
+/* Scale2x SSE2/NEON implementation */
+
+#if defined(SCALE2X_SSE2) || defined(SCALE2X_NEON)
+
+#ifdef SCALE2X_SSE2
+
+#include <emmintrin.h>
+
+/*
+ * The operations needed by scale2x_simd_single for each pixel size. All
+ * vectors are 128 bits wide.
+ */
+struct Scale2xVec16 {
+	typedef scale2x_uint16 Pixel;
+	typedef __m128i Vec;
+
+	static inline Vec load(const Pixel* src) { return _mm_loadu_si128((const __m128i*)src); }
+	static inline Vec equal(Vec a, Vec b) { return _mm_cmpeq_epi16(a, b); }
+	static inline void store2(Pixel* dst, Vec a, Vec b) {
+		_mm_storeu_si128((__m128i*)dst, _mm_unpacklo_epi16(a, b));
+		_mm_storeu_si128((__m128i*)(dst + 8), _mm_unpackhi_epi16(a, b));
+	}
+};
+
+struct Scale2xVec32 {
+	typedef scale2x_uint32 Pixel;
+	typedef __m128i Vec;
+
+	static inline Vec load(const Pixel* src) { return _mm_loadu_si128((const __m128i*)src); }
+	static inline Vec equal(Vec a, Vec b) { return _mm_cmpeq_epi32(a, b); }
+	static inline void store2(Pixel* dst, Vec a, Vec b) {
+		_mm_storeu_si128((__m128i*)dst, _mm_unpacklo_epi32(a, b));
+		_mm_storeu_si128((__m128i*)(dst + 4), _mm_unpackhi_epi32(a, b));
+	}
+};
+
+static inline __m128i scale2x_or(__m128i a, __m128i b) { return _mm_or_si128(a, b); }
+/* a & ~b */
+static inline __m128i scale2x_and_not(__m128i a, __m128i b) { return _mm_andnot_si128(b, a); }
+static inline __m128i scale2x_select(__m128i mask, __m128i a, __m128i b) { return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b)); }
+
+#else
+
+#include <arm_neon.h>
+
+/*
+ * The operations needed by scale2x_simd_single for each pixel size. All
+ * vectors are 128 bits wide.
+ */
+struct Scale2xVec16 {
+	typedef scale2x_uint16 Pixel;
+	typedef uint16x8_t Vec;
+
+	static inline Vec load(const Pixel* src) { return vld1q_u16(src); }
+	static inline Vec equal(Vec a, Vec b) { return vceqq_u16(a, b); }
+	static inline void store2(Pixel* dst, Vec a, Vec b) {
+		uint16x8x2_t pixels;
+		pixels.val[0] = a;
+		pixels.val[1] = b;
+		vst2q_u16(dst, pixels);
+	}
+};
+
+struct Scale2xVec32 {
+	typedef scale2x_uint32 Pixel;
+	typedef uint32x4_t Vec;
+
+	static inline Vec load(const Pixel* src) { return vld1q_u32(src); }
+	static inline Vec equal(Vec a, Vec b) { return vceqq_u32(a, b); }
+	static inline void store2(Pixel* dst, Vec a, Vec b) {
+		uint32x4x2_t pixels;
+		pixels.val[0] = a;
+		pixels.val[1] = b;
+		vst2q_u32(dst, pixels);
+	}
+};
+
+static inline uint16x8_t scale2x_or(uint16x8_t a, uint16x8_t b) { return vorrq_u16(a, b); }
+static inline uint32x4_t scale2x_or(uint32x4_t a, uint32x4_t b) { return vorrq_u32(a, b); }
+/* a & ~b */
+static inline uint16x8_t scale2x_and_not(uint16x8_t a, uint16x8_t b) { return vbicq_u16(a, b); }
+static inline uint32x4_t scale2x_and_not(uint32x4_t a, uint32x4_t b) { return vbicq_u32(a, b); }
+static inline uint16x8_t scale2x_select(uint16x8_t mask, uint16x8_t a, uint16x8_t b) { return vbslq_u16(mask, a, b); }
+static inline uint32x4_t scale2x_select(uint32x4_t mask, uint32x4_t a, uint32x4_t b) { return vbslq_u32(mask, a, b); }
+
+#endif
+
+/*
+ * Apply the Scale2x effect at a single row, like the C implementation but
+ * computing a whole vector of pixels at once. The remaining pixels are
+ * computed one by one.
+ */
+template<typename Ops>
+static inline void scale2x_simd_single(typename Ops::Pixel* dst, const typename Ops::Pixel* src0, const typename Ops::Pixel* src1, const typename Ops::Pixel* src2, unsigned count) {
+	typedef typename Ops::Vec Vec;
+	const unsigned pixelsPerVec = 16 / sizeof(typename Ops::Pixel);
+
+	while (count >= pixelsPerVec) {
+		const Vec b = Ops::load(src0);
+		const Vec d = Ops::load(src1 - 1);
+		const Vec e = Ops::load(src1);
+		const Vec f = Ops::load(src1 + 1);
+		const Vec h = Ops::load(src2);
+
+		/* the pixels where src0[0] == src2[0] or src1[-1] == src1[1] stay E */
+		const Vec keep = scale2x_or(Ops::equal(b, h), Ops::equal(d, f));
+		const Vec left = scale2x_and_not(Ops::equal(d, b), keep);
+		const Vec right = scale2x_and_not(Ops::equal(f, b), keep);
+
+		Ops::store2(dst, scale2x_select(left, b, e), scale2x_select(right, b, e));
+
+		src0 += pixelsPerVec;
+		src1 += pixelsPerVec;
+		src2 += pixelsPerVec;
+		dst += 2 * pixelsPerVec;
+		count -= pixelsPerVec;
+	}
+
+	while (count) {
+		if (src0[0] != src2[0] && src1[-1] != src1[1]) {
+			dst[0] = src1[-1] == src0[0] ? src0[0] : src1[0];
+			dst[1] = src1[1] == src0[0] ? src0[0] : src1[0];
+		} else {
+			dst[0] = src1[0];
+			dst[1] = src1[0];
+		}
+
+		++src0;
+		++src1;
+		++src2;
+		dst += 2;
+		--count;
+	}
+}
+
+/**
+ * Scale by a factor of 2 a row of pixels of 16 bits.
+ * This function operates like scale2x_16_def() but uses SSE2 or NEON
+ * instructions. There are no constraints on the row length.
+ * @param src0 Pointer at the first pixel of the previous row.
+ * @param src1 Pointer at the first pixel of the current row.
+ * @param src2 Pointer at the first pixel of the next row.
+ * @param count Length in pixels of the src0, src1 and src2 rows.
+ * @param dst0 First destination row, double length in pixels.
+ * @param dst1 Second destination row, double length in pixels.
+ */
+void scale2x_16_simd(scale2x_uint16* dst0, scale2x_uint16* dst1, const scale2x_uint16* src0, const scale2x_uint16* src1, const scale2x_uint16* src2, unsigned count) {
+	scale2x_simd_single<Scale2xVec16>(dst0, src0, src1, src2, count);
+	scale2x_simd_single<Scale2xVec16>(dst1, src2, src1, src0, count);
+}
+
+/**
+ * Scale by a factor of 2 a row of pixels of 32 bits.
+ * This function operates like scale2x_16_simd() but for 32 bits pixels.
+ * @param src0 Pointer at the first pixel of the previous row.
+ * @param src1 Pointer at the first pixel of the current row.
+ * @param src2 Pointer at the first pixel of the next row.
+ * @param count Length in pixels of the src0, src1 and src2 rows.
+ * @param dst0 First destination row, double length in pixels.
+ * @param dst1 Second destination row, double length in pixels.
+ */
+void scale2x_32_simd(scale2x_uint32* dst0, scale2x_uint32* dst1, const scale2x_uint32* src0, const scale2x_uint32* src1, const scale2x_uint32* src2, unsigned count) {
+	scale2x_simd_single<Scale2xVec32>(dst0, src0, src1, src2, count);
+	scale2x_simd_single<Scale2xVec32>(dst1, src2, src1, src0, count);
+}
+
+#endif
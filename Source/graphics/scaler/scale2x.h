@@ -57,6 +57,19 @@ static inline void scale2x_mmx_emms(void)
 
 #endif
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SCALE2X_SSE2
+#elif defined(__ARM_NEON__) || defined(__ARM_NEON)
+#define SCALE2X_NEON
+#endif
+
+#if defined(SCALE2X_SSE2) || defined(SCALE2X_NEON)
+
+void scale2x_16_simd(scale2x_uint16* dst0, scale2x_uint16* dst1, const scale2x_uint16* src0, const scale2x_uint16* src1, const scale2x_uint16* src2, unsigned count);
+void scale2x_32_simd(scale2x_uint32* dst0, scale2x_uint32* dst1, const scale2x_uint32* src0, const scale2x_uint32* src1, const scale2x_uint32* src2, unsigned count);
+
+#endif
+
 #if defined(USE_ARM_SCALER_ASM)
 
 extern "C" void scale2x_8_arm(scale2x_uint8* dst0, scale2x_uint8* dst1, const scale2x_uint8* src0, const scale2x_uint8* src1, const scale2x_uint8* src2, unsigned count);
@@ -22,39 +22,46 @@
 
 #include "common/system.h"
 #include "common/algorithm.h"
+#include "common/debug.h"
 #include "graphics/screen.h"
 #include "graphics/palette.h"
 
 namespace Graphics {
 
-Screen::Screen(): ManagedSurface() {
+Screen::Screen(): ManagedSurface(),
+		_updatedRects(0), _updatedPixels(0), _updatedDirtyPixels(0) {
 	create(g_system->getWidth(), g_system->getHeight(), g_system->getScreenFormat());
 }
 
-Screen::Screen(int width, int height): ManagedSurface() {
+Screen::Screen(int width, int height): ManagedSurface(),
+		_updatedRects(0), _updatedPixels(0), _updatedDirtyPixels(0) {
 	create(width, height);
 }
 
-Screen::Screen(int width, int height, PixelFormat pixelFormat): ManagedSurface() {
+Screen::Screen(int width, int height, PixelFormat pixelFormat): ManagedSurface(),
+		_updatedRects(0), _updatedPixels(0), _updatedDirtyPixels(0) {
 	create(width, height, pixelFormat);
 }
 
 void Screen::update() {
-	// Merge the dirty rects
-	mergeDirtyRects();
-
 	// Loop through copying dirty areas to the physical screen
-	Common::List<Common::Rect>::iterator i;
-	for (i = _dirtyRects.begin(); i != _dirtyRects.end(); ++i) {
-		const Common::Rect &r = *i;
+	const Common::Array<Common::Rect> &dirtyRects = _dirtyRegion.getRects();
+	for (uint i = 0; i < dirtyRects.size(); ++i) {
+		const Common::Rect &r = dirtyRects[i];
 		const byte *srcP = (const byte *)getBasePtr(r.left, r.top);
 		g_system->copyRectToScreen(srcP, pitch, r.left, r.top,
 			r.width(), r.height());
 	}
 
+	_updatedRects = dirtyRects.size();
+	_updatedPixels = _dirtyRegion.getArea();
+	_updatedDirtyPixels = _dirtyRegion.getAddedArea();
+	if (_updatedRects)
+		debug(9, "Screen::update: %d rects, %d pixels copied for %d dirty pixels", _updatedRects, _updatedPixels, _updatedDirtyPixels);
+
 	// Signal the physical screen to update
 	g_system->updateScreen();
-	_dirtyRects.clear();
+	_dirtyRegion.clear();
 }
 
 
@@ -64,42 +71,13 @@ void Screen::addDirtyRect(const Common::Rect &r) {
 	bounds.translate(getOffsetFromOwner().x, getOffsetFromOwner().y);
 
 	if (bounds.width() > 0 && bounds.height() > 0)
-		_dirtyRects.push_back(bounds);
+		_dirtyRegion.addRect(bounds);
 }
 
 void Screen::makeAllDirty() {
 	addDirtyRect(Common::Rect(0, 0, this->w, this->h));
 }
 
-void Screen::mergeDirtyRects() {
-	Common::List<Common::Rect>::iterator rOuter, rInner;
-
-	// Process the dirty rect list to find any rects to merge
-	for (rOuter = _dirtyRects.begin(); rOuter != _dirtyRects.end(); ++rOuter) {
-		rInner = rOuter;
-		while (++rInner != _dirtyRects.end()) {
-
-			if ((*rOuter).intersects(*rInner)) {
-				// These two rectangles overlap, so merge them
-				unionRectangle(*rOuter, *rOuter, *rInner);
-
-				// remove the inner rect from the list
-				_dirtyRects.erase(rInner);
-
-				// move back to beginning of list
-				rInner = rOuter;
-			}
-		}
-	}
-}
-
-bool Screen::unionRectangle(Common::Rect &destRect, const Common::Rect &src1, const Common::Rect &src2) {
-	destRect = src1;
-	destRect.extend(src2);
-
-	return !destRect.isEmpty();
-}
-
 void Screen::getPalette(byte palette[PALETTE_SIZE]) {
 	assert(format.bytesPerPixel == 1);
 	g_system->getPaletteManager()->grabPalette(palette, 0, PALETTE_COUNT);
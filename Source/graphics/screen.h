@@ -23,6 +23,7 @@
 #ifndef GRAPHICS_SCREEN_H
 #define GRAPHICS_SCREEN_H
 
+#include "graphics/dirty_region.h"
 #include "graphics/managed_surface.h"
 #include "graphics/pixelformat.h"
 #include "common/list.h"
@@ -42,19 +43,14 @@ namespace Graphics {
 class Screen : public ManagedSurface {
 private:
 	/**
-	 * List of affected areas of the screen
+	 * Affected areas of the screen
 	 */
-	Common::List<Common::Rect> _dirtyRects;
-private:
-	/**
-	* Merges together overlapping dirty areas of the screen
-	*/
-	void mergeDirtyRects();
+	DirtyRegion _dirtyRegion;
 
 	/**
-	* Returns the union of two dirty area rectangles
-	*/
-	bool unionRectangle(Common::Rect &destRect, const Common::Rect &src1, const Common::Rect &src2);
+	 * Statistics of the last update
+	 */
+	uint _updatedRects, _updatedPixels, _updatedDirtyPixels;
 protected:
 	/**
 	 * Adds a rectangle to the list of modified areas of the screen during the
@@ -69,7 +65,7 @@ public:
 	/**
 	 * Returns true if there are any pending screen updates (dirty areas)
 	 */
-	bool isDirty() const { return !_dirtyRects.empty(); }
+	bool isDirty() const { return !_dirtyRegion.isEmpty(); }
 
 	/**
 	 * Marks the whole screen as dirty. This forces the next call to update
@@ -80,13 +76,30 @@ public:
 	/**
 	 * Clear the current dirty rects list
 	 */
-	virtual void clearDirtyRects() { _dirtyRects.clear(); }
+	virtual void clearDirtyRects() { _dirtyRegion.clear(); }
 
 	/**
 	 * Updates the screen by copying any affected areas to the system
 	 */
 	virtual void update();
 
+	/**
+	 * Return the number of rects copied to the system by the last update
+	 */
+	uint getUpdatedRects() const { return _updatedRects; }
+
+	/**
+	 * Return the number of pixels copied to the system by the last update
+	 */
+	uint getUpdatedPixels() const { return _updatedPixels; }
+
+	/**
+	 * Return the total area of the rects marked dirty for the last update,
+	 * i.e. the number of pixels which would have been copied without
+	 * coalescing the rects
+	 */
+	uint getUpdatedDirtyPixels() const { return _updatedDirtyPixels; }
+
 	/**
 	 * Return the currently active palette
 	 */
@@ -0,0 +1,156 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "graphics/transformed_surface_cache.h"
+
+namespace Graphics {
+
+namespace {
+
+struct TransparentSurfaceDeleter {
+	void operator()(TransparentSurface *ptr) {
+		ptr->free();
+		delete ptr;
+	}
+};
+
+} // End of anonymous namespace
+
+bool TransformedSurfaceCache::Key::operator==(const Key &other) const {
+	return owner == other.owner &&
+	       srcRect == other.srcRect &&
+	       angle == other.angle &&
+	       zoom == other.zoom &&
+	       hotspot == other.hotspot &&
+	       width == other.width &&
+	       height == other.height &&
+	       filteringMode == other.filteringMode;
+}
+
+uint TransformedSurfaceCache::KeyHash::operator()(const Key &key) const {
+	uint hash = (uint)(size_t)key.owner;
+	hash = hash * 31 + (uint16)key.srcRect.left + ((uint)(uint16)key.srcRect.top << 16);
+	hash = hash * 31 + (uint16)key.srcRect.right + ((uint)(uint16)key.srcRect.bottom << 16);
+	hash = hash * 31 + (uint)key.angle;
+	hash = hash * 31 + (uint16)key.zoom.x + ((uint)(uint16)key.zoom.y << 16);
+	hash = hash * 31 + (uint16)key.hotspot.x + ((uint)(uint16)key.hotspot.y << 16);
+	hash = hash * 31 + (uint)key.width + ((uint)key.height << 16);
+	return hash * 31 + (uint)key.filteringMode;
+}
+
+TransformedSurfaceCache::TransformedSurfaceCache(uint32 maxSize) :
+		_maxSize(maxSize), _size(0), _hits(0), _misses(0) {
+}
+
+TransformedSurfaceCache::~TransformedSurfaceCache() {
+	clear();
+}
+
+TransformedSurfaceCache::SurfacePtr TransformedSurfaceCache::get(const void *owner, const Surface &source, const Common::Rect &srcRect,
+		const TransformStruct &transform, int width, int height, TFilteringMode filteringMode) {
+	const bool rotate = transform._angle != kDefaultAngle;
+
+	Key key;
+	key.owner = owner;
+	key.srcRect = srcRect;
+	key.angle = transform._angle;
+	// Only the size matters when scaling; rotating computes the size
+	key.zoom = rotate ? transform._zoom : Common::Point();
+	key.hotspot = rotate ? transform._hotspot : Common::Point();
+	key.width = rotate ? 0 : width;
+	key.height = rotate ? 0 : height;
+	key.filteringMode = filteringMode;
+
+	EntryMap::iterator cached = _map.find(key);
+	if (cached != _map.end()) {
+		_hits++;
+
+		// Move the entry to the front of the list
+		EntryList::iterator entry = cached->_value;
+		if (entry != _entries.begin()) {
+			_entries.push_front(*entry);
+			_entries.erase(entry);
+			cached->_value = _entries.begin();
+		}
+		return _entries.front().surface;
+	}
+
+	_misses++;
+
+	// Wrap the part of the source instead of copying it
+	const TransparentSurface part(source.getSubArea(srcRect), false);
+
+	TransparentSurface *transformed;
+	if (rotate) {
+		if (filteringMode == FILTER_BILINEAR)
+			transformed = part.rotoscaleT<FILTER_BILINEAR>(transform);
+		else
+			transformed = part.rotoscaleT<FILTER_NEAREST>(transform);
+	} else {
+		if (filteringMode == FILTER_BILINEAR)
+			transformed = part.scaleT<FILTER_BILINEAR>(width, height);
+		else
+			transformed = part.scaleT<FILTER_NEAREST>(width, height);
+	}
+
+	Entry entry;
+	entry.key = key;
+	entry.surface = SurfacePtr(transformed, TransparentSurfaceDeleter());
+	entry.size = transformed->h * transformed->pitch;
+
+	// Copies larger than the whole budget are not kept
+	if (entry.size > _maxSize)
+		return entry.surface;
+
+	while (_size + entry.size > _maxSize)
+		remove(--_entries.end());
+
+	_entries.push_front(entry);
+	_map[key] = _entries.begin();
+	_size += entry.size;
+	return entry.surface;
+}
+
+void TransformedSurfaceCache::invalidate(const void *owner) {
+	EntryList::iterator entry = _entries.begin();
+	while (entry != _entries.end()) {
+		EntryList::iterator next = entry;
+		++next;
+		if (entry->key.owner == owner)
+			remove(entry);
+		entry = next;
+	}
+}
+
+void TransformedSurfaceCache::clear() {
+	_entries.clear();
+	_map.clear();
+	_size = 0;
+}
+
+void TransformedSurfaceCache::remove(EntryList::iterator entry) {
+	_size -= entry->size;
+	_map.erase(entry->key);
+	_entries.erase(entry);
+}
+
+} // End of namespace Graphics
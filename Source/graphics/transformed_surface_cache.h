@@ -0,0 +1,137 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef GRAPHICS_TRANSFORMED_SURFACE_CACHE_H
+#define GRAPHICS_TRANSFORMED_SURFACE_CACHE_H
+
+#include "common/hashmap.h"
+#include "common/list.h"
+#include "common/ptr.h"
+#include "common/rect.h"
+#include "graphics/transform_struct.h"
+#include "graphics/transparent_surface.h"
+
+namespace Graphics {
+
+/**
+ * A cache of scaled and rotated copies of surfaces.
+ *
+ * Engines which draw the same sprite with the same zoom or rotation every
+ * frame can get the transformed copy from here instead of computing it
+ * again. A copy is identified by an owner, usually the object holding the
+ * source surface, the part of the source which is transformed and the
+ * transform. When the copies exceed the memory budget, the least recently
+ * used ones are dropped.
+ *
+ * The cache cannot notice changes to the source pixels, so owners have to
+ * call invalidate() whenever they modify or free their surface.
+ */
+class TransformedSurfaceCache {
+public:
+	typedef Common::SharedPtr<TransparentSurface> SurfacePtr;
+
+	enum {
+		kDefaultMaxSize = 16 * 1024 * 1024 ///< The default memory budget, in bytes
+	};
+
+	TransformedSurfaceCache(uint32 maxSize = kDefaultMaxSize);
+	~TransformedSurfaceCache();
+
+	/**
+	 * Return a transformed copy of part of a surface, computing it if it
+	 * is not cached yet.
+	 *
+	 * If the angle of the transform is set, the part is rotated and zoomed
+	 * as with TransparentSurface::rotoscaleT. Otherwise it is scaled to the
+	 * given size as with TransparentSurface::scaleT.
+	 *
+	 * The copy stays valid as long as the returned pointer is held, even
+	 * if it is dropped from the cache in the meantime.
+	 *
+	 * @param owner         identifies the source surface for invalidate()
+	 * @param source        the source surface, in the format of TransparentSurface
+	 * @param srcRect       the part of the source surface to transform
+	 * @param transform     the rotation and zoom to apply
+	 * @param width         the width to scale to, if not rotating
+	 * @param height        the height to scale to, if not rotating
+	 * @param filteringMode the filtering to use
+	 */
+	SurfacePtr get(const void *owner, const Surface &source, const Common::Rect &srcRect,
+	               const TransformStruct &transform, int width, int height, TFilteringMode filteringMode);
+
+	/**
+	 * Drop all copies of the surface of an owner.
+	 */
+	void invalidate(const void *owner);
+
+	/**
+	 * Drop all copies.
+	 */
+	void clear();
+
+	/** Return the memory used by the cached copies, in bytes. */
+	uint32 getSize() const { return _size; }
+
+	/** Return the number of get() calls answered from the cache. */
+	uint32 getHits() const { return _hits; }
+
+	/** Return the number of get() calls which had to compute the copy. */
+	uint32 getMisses() const { return _misses; }
+
+private:
+	struct Key {
+		const void *owner;
+		Common::Rect srcRect;
+		int32 angle;
+		Common::Point zoom;
+		Common::Point hotspot;
+		int width, height;
+		TFilteringMode filteringMode;
+
+		bool operator==(const Key &other) const;
+	};
+
+	struct KeyHash {
+		uint operator()(const Key &key) const;
+	};
+
+	struct Entry {
+		Key key;
+		SurfacePtr surface;
+		uint32 size;
+	};
+
+	typedef Common::List<Entry> EntryList;
+	typedef Common::HashMap<Key, EntryList::iterator, KeyHash> EntryMap;
+
+	void remove(EntryList::iterator entry);
+
+	EntryList _entries; ///< All cached copies, most recently used first
+	EntryMap _map;
+	uint32 _maxSize;
+	uint32 _size;
+	uint32 _hits, _misses;
+};
+
+} // End of namespace Graphics
+
+#endif
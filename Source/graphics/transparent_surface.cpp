@@ -37,6 +37,18 @@
 #include "graphics/transparent_surface.h"
 #include "graphics/transform_tools.h"
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define TRANSPARENT_SURFACE_SSE2
+#include <emmintrin.h>
+#elif defined(__ARM_NEON__) || defined(__ARM_NEON)
+#define TRANSPARENT_SURFACE_NEON
+#include <arm_neon.h>
+#endif
+
+#if defined(TRANSPARENT_SURFACE_SSE2) || defined(TRANSPARENT_SURFACE_NEON)
+#define TRANSPARENT_SURFACE_SIMD
+#endif
+
 namespace Graphics {
 
 static const int kBModShift = 0;//img->format.bShift;
@@ -57,6 +69,9 @@ static const int kGIndex = 1;
 static const int kRIndex = 0;
 #endif
 
+// The alpha channel of a pixel read as a native uint32, on either endianness
+static const uint32 kAlphaMask = 0x000000FF;
+
 void doBlitOpaqueFast(byte *ino, byte *outo, uint32 width, uint32 height, uint32 pitch, int32 inStep, int32 inoStep);
 void doBlitBinaryFast(byte *ino, byte *outo, uint32 width, uint32 height, uint32 pitch, int32 inStep, int32 inoStep);
 void doBlitAlphaBlend(byte *ino, byte *outo, uint32 width, uint32 height, uint32 pitch, int32 inStep, int32 inoStep, uint32 color);
@@ -81,54 +96,392 @@ TransparentSurface::TransparentSurface(const Surface &surf, bool copyData) : Sur
 	}
 }
 
-/**
- * Optimized version of doBlit to be used w/opaque blitting (no alpha).
+bool TransparentSurface::hasSIMD() {
+#ifdef TRANSPARENT_SURFACE_SIMD
+	return true;
+#else
+	return false;
+#endif
+}
+
+namespace {
+
+#ifdef TRANSPARENT_SURFACE_SSE2
+
+typedef __m128i Pixels;   // Four pixels
+typedef __m128i Channels; // The channels of two pixels, in 16-bit lanes
+
+static inline Pixels loadPixels(const byte *src, int32 inStep) {
+	if (inStep > 0)
+		return _mm_loadu_si128((const __m128i *)src);
+	// Flipped horizontally: src points to the last of the four pixels
+	return _mm_shuffle_epi32(_mm_loadu_si128((const __m128i *)(src - 12)), _MM_SHUFFLE(0, 1, 2, 3));
+}
+static inline void storePixels(byte *dst, Pixels p) { _mm_storeu_si128((__m128i *)dst, p); }
+static inline Pixels splatPixel(uint32 p) { return _mm_set1_epi32(p); }
+static inline Pixels bitOr(Pixels a, Pixels b) { return _mm_or_si128(a, b); }
+static inline Pixels select(Pixels mask, Pixels a, Pixels b) { return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b)); }
+static inline Pixels isTransparent(Pixels p) { return _mm_cmpeq_epi32(_mm_and_si128(p, splatPixel(kAlphaMask)), _mm_setzero_si128()); }
+static inline Pixels addSaturate(Pixels a, Pixels b) { return _mm_adds_epu8(a, b); }
+static inline Pixels broadcastAlpha(Pixels p) {
+	Pixels a = _mm_and_si128(p, splatPixel(kAlphaMask));
+	a = _mm_or_si128(a, _mm_slli_epi32(a, 8));
+	return _mm_or_si128(a, _mm_slli_epi32(a, 16));
+}
+static inline Channels unpackLow(Pixels p) { return _mm_unpacklo_epi8(p, _mm_setzero_si128()); }
+static inline Channels unpackHigh(Pixels p) { return _mm_unpackhi_epi8(p, _mm_setzero_si128()); }
+// Keeps the low 8 bits of each channel, like storing to a byte does
+static inline Pixels pack(Channels low, Channels high) {
+	const __m128i mask = _mm_set1_epi16(0xFF);
+	return _mm_packus_epi16(_mm_and_si128(low, mask), _mm_and_si128(high, mask));
+}
+static inline Channels splatChannel(uint16 c) { return _mm_set1_epi16(c); }
+static inline Channels add(Channels a, Channels b) { return _mm_add_epi16(a, b); }
+static inline Channels sub(Channels a, Channels b) { return _mm_sub_epi16(a, b); }
+static inline Channels mul(Channels a, Channels b) { return _mm_mullo_epi16(a, b); }
+static inline Channels mulHigh(Channels a, Channels b) { return _mm_mulhi_epu16(a, b); }
+static inline Channels shiftRight8(Channels a) { return _mm_srli_epi16(a, 8); }
+static inline Channels loadChannels(const uint16 *src) { return _mm_loadu_si128((const __m128i *)src); }
+// c0 + ((c1 - c0) * e >> 16), with e from 0 to 0xFFFF. _mm_mulhi_epi16 takes
+// e >= 0x8000 as e - 0x10000, which is corrected by adding c1 - c0 again.
+static inline Channels lerp(Channels c0, Channels c1, Channels e) {
+	const __m128i d = _mm_sub_epi16(c1, c0);
+	return _mm_add_epi16(_mm_add_epi16(_mm_mulhi_epi16(d, e), _mm_and_si128(d, _mm_srai_epi16(e, 15))), c0);
+}
+
+#elif defined(TRANSPARENT_SURFACE_NEON)
+
+typedef uint32x4_t Pixels;   // Four pixels
+typedef uint16x8_t Channels; // The channels of two pixels, in 16-bit lanes
+
+static inline Pixels loadPixels(const byte *src, int32 inStep) {
+	if (inStep > 0)
+		return vreinterpretq_u32_u8(vld1q_u8(src));
+	// Flipped horizontally: src points to the last of the four pixels
+	const Pixels p = vrev64q_u32(vreinterpretq_u32_u8(vld1q_u8(src - 12)));
+	return vcombine_u32(vget_high_u32(p), vget_low_u32(p));
+}
+static inline void storePixels(byte *dst, Pixels p) { vst1q_u8(dst, vreinterpretq_u8_u32(p)); }
+static inline Pixels splatPixel(uint32 p) { return vdupq_n_u32(p); }
+static inline Pixels bitOr(Pixels a, Pixels b) { return vorrq_u32(a, b); }
+static inline Pixels select(Pixels mask, Pixels a, Pixels b) { return vbslq_u32(mask, a, b); }
+static inline Pixels isTransparent(Pixels p) { return vceqq_u32(vandq_u32(p, splatPixel(kAlphaMask)), vdupq_n_u32(0)); }
+static inline Pixels addSaturate(Pixels a, Pixels b) { return vreinterpretq_u32_u8(vqaddq_u8(vreinterpretq_u8_u32(a), vreinterpretq_u8_u32(b))); }
+static inline Pixels broadcastAlpha(Pixels p) {
+	Pixels a = vandq_u32(p, splatPixel(kAlphaMask));
+	a = vorrq_u32(a, vshlq_n_u32(a, 8));
+	return vorrq_u32(a, vshlq_n_u32(a, 16));
+}
+static inline Channels unpackLow(Pixels p) { return vmovl_u8(vget_low_u8(vreinterpretq_u8_u32(p))); }
+static inline Channels unpackHigh(Pixels p) { return vmovl_u8(vget_high_u8(vreinterpretq_u8_u32(p))); }
+// Keeps the low 8 bits of each channel, like storing to a byte does
+static inline Pixels pack(Channels low, Channels high) { return vreinterpretq_u32_u8(vcombine_u8(vmovn_u16(low), vmovn_u16(high))); }
+static inline Channels splatChannel(uint16 c) { return vdupq_n_u16(c); }
+static inline Channels add(Channels a, Channels b) { return vaddq_u16(a, b); }
+static inline Channels sub(Channels a, Channels b) { return vsubq_u16(a, b); }
+static inline Channels mul(Channels a, Channels b) { return vmulq_u16(a, b); }
+static inline Channels mulHigh(Channels a, Channels b) {
+	const uint32x4_t low = vmull_u16(vget_low_u16(a), vget_low_u16(b));
+	const uint32x4_t high = vmull_u16(vget_high_u16(a), vget_high_u16(b));
+	return vcombine_u16(vshrn_n_u32(low, 16), vshrn_n_u32(high, 16));
+}
+static inline Channels shiftRight8(Channels a) { return vshrq_n_u16(a, 8); }
+static inline Channels loadChannels(const uint16 *src) { return vld1q_u16(src); }
+// c0 + ((c1 - c0) * e >> 16), with e from 0 to 0xFFFF. The signed multiply
+// takes e >= 0x8000 as e - 0x10000, which is corrected by adding c1 - c0 again.
+static inline Channels lerp(Channels c0, Channels c1, Channels e) {
+	const int16x8_t d = vreinterpretq_s16_u16(vsubq_u16(c1, c0));
+	const int16x8_t se = vreinterpretq_s16_u16(e);
+	const int32x4_t low = vmull_s16(vget_low_s16(d), vget_low_s16(se));
+	const int32x4_t high = vmull_s16(vget_high_s16(d), vget_high_s16(se));
+	const int16x8_t product = vaddq_s16(vcombine_s16(vshrn_n_s32(low, 16), vshrn_n_s32(high, 16)), vandq_s16(d, vshrq_n_s16(se, 15)));
+	return vaddq_u16(vreinterpretq_u16_s16(product), c0);
+}
+
+#endif
+
+/*
+ * The blenders combine a source pixel with a target pixel for one
+ * combination of alpha mode, blend mode and color modulation. blendPixel
+ * handles a single pixel; where SIMD is available, blendPixels handles four
+ * pixels at once and gives exactly the same results.
+ *
+ * All intermediate results of the SIMD versions fit into 16 bits: the
+ * products of two channels are at most 255 * 255, and products of three
+ * channels use the high half of a 16x16 bit multiplication.
  */
-void doBlitOpaqueFast(byte *ino, byte *outo, uint32 width, uint32 height, uint32 pitch, int32 inStep, int32 inoStep) {
 
-	byte *in;
-	byte *out;
+struct OpaqueBlender {
+	void blendPixel(const byte *in, byte *out) const {
+		*(uint32 *)out = *(const uint32 *)in;
+		out[kAIndex] = 0xFF;
+	}
 
-	for (uint32 i = 0; i < height; i++) {
-		out = outo;
-		in = ino;
-		memcpy(out, in, width * 4);
-		for (uint32 j = 0; j < width; j++) {
+#ifdef TRANSPARENT_SURFACE_SIMD
+	Pixels blendPixels(Pixels in, Pixels out) const {
+		return bitOr(in, splatPixel(kAlphaMask));
+	}
+#endif
+};
+
+struct BinaryBlender {
+	void blendPixel(const byte *in, byte *out) const {
+		if (in[kAIndex] != 0) {   // Full opacity (Any value not exactly 0 is Opaque here)
+			*(uint32 *)out = *(const uint32 *)in;
 			out[kAIndex] = 0xFF;
-			out += 4;
 		}
-		outo += pitch;
-		ino += inoStep;
 	}
-}
 
-/**
- * Optimized version of doBlit to be used w/binary blitting (blit or no-blit, no blending).
- */
-void doBlitBinaryFast(byte *ino, byte *outo, uint32 width, uint32 height, uint32 pitch, int32 inStep, int32 inoStep) {
+#ifdef TRANSPARENT_SURFACE_SIMD
+	Pixels blendPixels(Pixels in, Pixels out) const {
+		return select(isTransparent(in), out, bitOr(in, splatPixel(kAlphaMask)));
+	}
+#endif
+};
+
+struct AlphaBlender {
+	void blendPixel(const byte *in, byte *out) const {
+		if (in[kAIndex] != 0) {
+			out[kAIndex] = 255;
+			out[kRIndex] = ((in[kRIndex] * in[kAIndex]) + out[kRIndex] * (255 - in[kAIndex])) >> 8;
+			out[kGIndex] = ((in[kGIndex] * in[kAIndex]) + out[kGIndex] * (255 - in[kAIndex])) >> 8;
+			out[kBIndex] = ((in[kBIndex] * in[kAIndex]) + out[kBIndex] * (255 - in[kAIndex])) >> 8;
+		}
+	}
 
-	byte *in;
-	byte *out;
+#ifdef TRANSPARENT_SURFACE_SIMD
+	static inline Channels blend(Channels in, Channels out, Channels a) {
+		return shiftRight8(add(mul(in, a), mul(out, sub(splatChannel(255), a))));
+	}
+
+	Pixels blendPixels(Pixels in, Pixels out) const {
+		const Pixels a = broadcastAlpha(in);
+		const Pixels result = pack(blend(unpackLow(in), unpackLow(out), unpackLow(a)),
+		                           blend(unpackHigh(in), unpackHigh(out), unpackHigh(a)));
+		return select(isTransparent(in), out, bitOr(result, splatPixel(kAlphaMask)));
+	}
+#endif
+};
+
+struct ModulatedAlphaBlender {
+	ModulatedAlphaBlender(uint32 color) {
+		ca = (color >> kAModShift) & 0xFF;
+		cr = (color >> kRModShift) & 0xFF;
+		cg = (color >> kGModShift) & 0xFF;
+		cb = (color >> kBModShift) & 0xFF;
+
+#ifdef TRANSPARENT_SURFACE_SIMD
+		_alpha = splatChannel(ca);
+		_color = unpackLow(splatPixel(TS_ARGB(0, cr, cg, cb)));
+#endif
+	}
+
+	void blendPixel(const byte *in, byte *out) const {
+		uint32 ina = in[kAIndex] * ca >> 8;
+		out[kAIndex] = 255;
+		out[kBIndex] = (out[kBIndex] * (255 - ina) >> 8);
+		out[kGIndex] = (out[kGIndex] * (255 - ina) >> 8);
+		out[kRIndex] = (out[kRIndex] * (255 - ina) >> 8);
 
+		out[kBIndex] = out[kBIndex] + (in[kBIndex] * ina * cb >> 16);
+		out[kGIndex] = out[kGIndex] + (in[kGIndex] * ina * cg >> 16);
+		out[kRIndex] = out[kRIndex] + (in[kRIndex] * ina * cr >> 16);
+	}
+
+	byte ca, cr, cg, cb;
+
+#ifdef TRANSPARENT_SURFACE_SIMD
+	inline Channels blend(Channels in, Channels out, Channels a) const {
+		const Channels ina = shiftRight8(mul(a, _alpha));
+		return add(shiftRight8(mul(out, sub(splatChannel(255), ina))), mulHigh(mul(in, ina), _color));
+	}
+
+	Pixels blendPixels(Pixels in, Pixels out) const {
+		const Pixels a = broadcastAlpha(in);
+		const Pixels result = pack(blend(unpackLow(in), unpackLow(out), unpackLow(a)),
+		                           blend(unpackHigh(in), unpackHigh(out), unpackHigh(a)));
+		return bitOr(result, splatPixel(kAlphaMask));
+	}
+
+	Channels _alpha, _color;
+#endif
+};
+
+struct AdditiveBlender {
+	void blendPixel(const byte *in, byte *out) const {
+		if (in[kAIndex] != 0) {
+			out[kRIndex] = MIN((in[kRIndex] * in[kAIndex] >> 8) + out[kRIndex], 255);
+			out[kGIndex] = MIN((in[kGIndex] * in[kAIndex] >> 8) + out[kGIndex], 255);
+			out[kBIndex] = MIN((in[kBIndex] * in[kAIndex] >> 8) + out[kBIndex], 255);
+		}
+	}
+
+#ifdef TRANSPARENT_SURFACE_SIMD
+	Pixels blendPixels(Pixels in, Pixels out) const {
+		const Pixels a = broadcastAlpha(in);
+		const Pixels addend = pack(shiftRight8(mul(unpackLow(in), unpackLow(a))),
+		                           shiftRight8(mul(unpackHigh(in), unpackHigh(a))));
+		return select(splatPixel(kAlphaMask), out, addSaturate(out, addend));
+	}
+#endif
+};
+
+struct SubtractiveBlender {
+	void blendPixel(const byte *in, byte *out) const {
+		if (in[kAIndex] != 0) {
+			out[kRIndex] = MAX(out[kRIndex] - ((in[kRIndex] * out[kRIndex]) * in[kAIndex] >> 16), 0);
+			out[kGIndex] = MAX(out[kGIndex] - ((in[kGIndex] * out[kGIndex]) * in[kAIndex] >> 16), 0);
+			out[kBIndex] = MAX(out[kBIndex] - ((in[kBIndex] * out[kBIndex]) * in[kAIndex] >> 16), 0);
+		}
+	}
+
+#ifdef TRANSPARENT_SURFACE_SIMD
+	// The subtracted value is always smaller than out, so there is no need
+	// to clamp the result
+	static inline Channels blend(Channels in, Channels out, Channels a) {
+		return sub(out, mulHigh(mul(in, out), a));
+	}
+
+	Pixels blendPixels(Pixels in, Pixels out) const {
+		const Pixels a = broadcastAlpha(in);
+		const Pixels result = pack(blend(unpackLow(in), unpackLow(out), unpackLow(a)),
+		                           blend(unpackHigh(in), unpackHigh(out), unpackHigh(a)));
+		return select(splatPixel(kAlphaMask), out, result);
+	}
+#endif
+};
+
+struct MultiplyBlender {
+	void blendPixel(const byte *in, byte *out) const {
+		if (in[kAIndex] != 0) {
+			out[kRIndex] = MIN((in[kRIndex] * in[kAIndex] >> 8) * out[kRIndex] >> 8, 255);
+			out[kGIndex] = MIN((in[kGIndex] * in[kAIndex] >> 8) * out[kGIndex] >> 8, 255);
+			out[kBIndex] = MIN((in[kBIndex] * in[kAIndex] >> 8) * out[kBIndex] >> 8, 255);
+		}
+	}
+
+#ifdef TRANSPARENT_SURFACE_SIMD
+	static inline Channels blend(Channels in, Channels out, Channels a) {
+		return shiftRight8(mul(shiftRight8(mul(in, a)), out));
+	}
+
+	Pixels blendPixels(Pixels in, Pixels out) const {
+		const Pixels a = broadcastAlpha(in);
+		const Pixels result = pack(blend(unpackLow(in), unpackLow(out), unpackLow(a)),
+		                           blend(unpackHigh(in), unpackHigh(out), unpackHigh(a)));
+		return select(isTransparent(in), out, select(splatPixel(kAlphaMask), out, result));
+	}
+#endif
+};
+
+/**
+ * Blit a rectangle of pixels with the given blender.
+ * @see doBlitAlphaBlend for the parameters
+ */
+template<class Blender>
+void blitPixels(byte *ino, byte *outo, uint32 width, uint32 height, uint32 pitch, int32 inStep, int32 inoStep, const Blender &blender) {
 	for (uint32 i = 0; i < height; i++) {
-		out = outo;
-		in = ino;
-		for (uint32 j = 0; j < width; j++) {
-			uint32 pix = *(uint32 *)in;
-			int a = in[kAIndex];
-
-			if (a != 0) {   // Full opacity (Any value not exactly 0 is Opaque here)
-				*(uint32 *)out = pix;
-				out[kAIndex] = 0xFF;
+		byte *out = outo;
+		byte *in = ino;
+		uint32 j = 0;
+#ifdef TRANSPARENT_SURFACE_SIMD
+		if (inStep == 4 || inStep == -4) {
+			for (; j + 4 <= width; j += 4) {
+				storePixels(out, blender.blendPixels(loadPixels(in, inStep), loadPixels(out, 4)));
+				in += inStep * 4;
+				out += 16;
 			}
-			out += 4;
+		}
+#endif
+		for (; j < width; j++) {
+			blender.blendPixel(in, out);
 			in += inStep;
+			out += 4;
 		}
 		outo += pitch;
 		ino += inoStep;
 	}
 }
 
+/**
+ * Scale one row horizontally for bilinear scaling.
+ * @param src     the source row
+ * @param dst     the destination row
+ * @param sax     the source position of each destination pixel, in 16.16 fixed point
+ * @param dstW    the width of the destination row
+ * @param spixelw the index of the last source pixel
+ */
+void scaleRowBilinear(const byte *src, byte *dst, const int *sax, int dstW, int spixelw) {
+	int x = 0;
+#ifdef TRANSPARENT_SURFACE_SIMD
+	for (; x + 4 <= dstW; x += 4) {
+		uint32 c0[4], c1[4];
+		uint16 e[16]; // The weight of each pixel, for all four channels
+		for (int i = 0; i < 4; i++) {
+			const int cx = sax[x + i] >> 16;
+			c0[i] = READ_UINT32(src + cx * 4);
+			c1[i] = (cx < spixelw) ? READ_UINT32(src + cx * 4 + 4) : c0[i];
+			e[i * 4] = e[i * 4 + 1] = e[i * 4 + 2] = e[i * 4 + 3] = sax[x + i] & 0xffff;
+		}
+
+		const Pixels p0 = loadPixels((const byte *)c0, 4), p1 = loadPixels((const byte *)c1, 4);
+		storePixels(dst + x * 4, pack(lerp(unpackLow(p0), unpackLow(p1), loadChannels(e)),
+		                              lerp(unpackHigh(p0), unpackHigh(p1), loadChannels(e + 8))));
+	}
+#endif
+	for (; x < dstW; x++) {
+		const int cx = sax[x] >> 16;
+		const int ex = sax[x] & 0xffff;
+		const byte *c00 = src + cx * 4;
+		const byte *c01 = (cx < spixelw) ? c00 + 4 : c00;
+		byte *dp = dst + x * 4;
+		for (int i = 0; i < 4; i++)
+			dp[i] = ((((c01[i] - c00[i]) * ex) >> 16) + c00[i]) & 0xff;
+	}
+}
+
+/**
+ * Interpolate two horizontally scaled rows vertically for bilinear scaling.
+ * @param row0  the upper row
+ * @param row1  the lower row
+ * @param dst   the destination row
+ * @param width the width of the rows
+ * @param ey    the weight of the lower row, in 16.16 fixed point
+ */
+void blendRowsBilinear(const byte *row0, const byte *row1, byte *dst, int width, int ey) {
+	if (ey == 0) {
+		memcpy(dst, row0, width * 4);
+		return;
+	}
+
+	int x = 0;
+#ifdef TRANSPARENT_SURFACE_SIMD
+	const Channels e = splatChannel(ey);
+	for (; x + 4 <= width; x += 4) {
+		const Pixels p0 = loadPixels(row0 + x * 4, 4), p1 = loadPixels(row1 + x * 4, 4);
+		storePixels(dst + x * 4, pack(lerp(unpackLow(p0), unpackLow(p1), e), lerp(unpackHigh(p0), unpackHigh(p1), e)));
+	}
+#endif
+	for (x *= 4; x < width * 4; x++)
+		dst[x] = (((row1[x] - row0[x]) * ey) >> 16) + row0[x];
+}
+
+} // End of anonymous namespace
+
+/**
+ * Optimized version of doBlit to be used w/opaque blitting (no alpha).
+ */
+void doBlitOpaqueFast(byte *ino, byte *outo, uint32 width, uint32 height, uint32 pitch, int32 inStep, int32 inoStep) {
+	blitPixels(ino, outo, width, height, pitch, inStep, inoStep, OpaqueBlender());
+}
+
+/**
+ * Optimized version of doBlit to be used w/binary blitting (blit or no-blit, no blending).
+ */
+void doBlitBinaryFast(byte *ino, byte *outo, uint32 width, uint32 height, uint32 pitch, int32 inStep, int32 inoStep) {
+	blitPixels(ino, outo, width, height, pitch, inStep, inoStep, BinaryBlender());
+}
+
 /**
  * Optimized version of doBlit to be used with alpha blended blitting
  * @param ino a pointer to the input surface
@@ -141,57 +494,10 @@ void doBlitBinaryFast(byte *ino, byte *outo, uint32 width, uint32 height, uint32
  * @color colormod in 0xAARRGGBB format - 0xFFFFFFFF for no colormod
  */
 void doBlitAlphaBlend(byte *ino, byte *outo, uint32 width, uint32 height, uint32 pitch, int32 inStep, int32 inoStep, uint32 color) {
-	byte *in;
-	byte *out;
-
 	if (color == 0xffffffff) {
-
-		for (uint32 i = 0; i < height; i++) {
-			out = outo;
-			in = ino;
-			for (uint32 j = 0; j < width; j++) {
-
-				if (in[kAIndex] != 0) {
-					out[kAIndex] = 255;
-					out[kRIndex] = ((in[kRIndex] * in[kAIndex]) + out[kRIndex] * (255 - in[kAIndex])) >> 8;
-					out[kGIndex] = ((in[kGIndex] * in[kAIndex]) + out[kGIndex] * (255 - in[kAIndex])) >> 8;
-					out[kBIndex] = ((in[kBIndex] * in[kAIndex]) + out[kBIndex] * (255 - in[kAIndex])) >> 8;
-				}
-
-				in += inStep;
-				out += 4;
-			}
-			outo += pitch;
-			ino += inoStep;
-		}
+		blitPixels(ino, outo, width, height, pitch, inStep, inoStep, AlphaBlender());
 	} else {
-
-		byte ca = (color >> kAModShift) & 0xFF;
-		byte cr = (color >> kRModShift) & 0xFF;
-		byte cg = (color >> kGModShift) & 0xFF;
-		byte cb = (color >> kBModShift) & 0xFF;
-
-		for (uint32 i = 0; i < height; i++) {
-			out = outo;
-			in = ino;
-			for (uint32 j = 0; j < width; j++) {
-
-				uint32 ina = in[kAIndex] * ca >> 8;
-				out[kAIndex] = 255;
-				out[kBIndex] = (out[kBIndex] * (255 - ina) >> 8);
-				out[kGIndex] = (out[kGIndex] * (255 - ina) >> 8);
-				out[kRIndex] = (out[kRIndex] * (255 - ina) >> 8);
-
-				out[kBIndex] = out[kBIndex] + (in[kBIndex] * ina * cb >> 16);
-				out[kGIndex] = out[kGIndex] + (in[kGIndex] * ina * cg >> 16);
-				out[kRIndex] = out[kRIndex] + (in[kRIndex] * ina * cr >> 16);
-
-				in += inStep;
-				out += 4;
-			}
-			outo += pitch;
-			ino += inoStep;
-		}
+		blitPixels(ino, outo, width, height, pitch, inStep, inoStep, ModulatedAlphaBlender(color));
 	}
 }
 
@@ -203,24 +509,7 @@ void doBlitAdditiveBlend(byte *ino, byte *outo, uint32 width, uint32 height, uin
 	byte *out;
 
 	if (color == 0xffffffff) {
-
-		for (uint32 i = 0; i < height; i++) {
-			out = outo;
-			in = ino;
-			for (uint32 j = 0; j < width; j++) {
-
-				if (in[kAIndex] != 0) {
-					out[kRIndex] = MIN((in[kRIndex] * in[kAIndex] >> 8) + out[kRIndex], 255);
-					out[kGIndex] = MIN((in[kGIndex] * in[kAIndex] >> 8) + out[kGIndex], 255);
-					out[kBIndex] = MIN((in[kBIndex] * in[kAIndex] >> 8) + out[kBIndex], 255);
-				}
-
-				in += inStep;
-				out += 4;
-			}
-			outo += pitch;
-			ino += inoStep;
-		}
+		blitPixels(ino, outo, width, height, pitch, inStep, inoStep, AdditiveBlender());
 	} else {
 
 		byte ca = (color >> kAModShift) & 0xFF;
@@ -270,24 +559,7 @@ void doBlitSubtractiveBlend(byte *ino, byte *outo, uint32 width, uint32 height,
 	byte *out;
 
 	if (color == 0xffffffff) {
-
-		for (uint32 i = 0; i < height; i++) {
-			out = outo;
-			in = ino;
-			for (uint32 j = 0; j < width; j++) {
-
-				if (in[kAIndex] != 0) {
-					out[kRIndex] = MAX(out[kRIndex] - ((in[kRIndex] * out[kRIndex]) * in[kAIndex] >> 16), 0);
-					out[kGIndex] = MAX(out[kGIndex] - ((in[kGIndex] * out[kGIndex]) * in[kAIndex] >> 16), 0);
-					out[kBIndex] = MAX(out[kBIndex] - ((in[kBIndex] * out[kBIndex]) * in[kAIndex] >> 16), 0);
-				}
-
-				in += inStep;
-				out += 4;
-			}
-			outo += pitch;
-			ino += inoStep;
-		}
+		blitPixels(ino, outo, width, height, pitch, inStep, inoStep, SubtractiveBlender());
 	} else {
 
 		byte cr = (color >> kRModShift) & 0xFF;
@@ -335,23 +607,7 @@ void doBlitMultiplyBlend(byte *ino, byte *outo, uint32 width, uint32 height, uin
 	byte *out;
 
 	if (color == 0xffffffff) {
-		for (uint32 i = 0; i < height; i++) {
-			out = outo;
-			in = ino;
-			for (uint32 j = 0; j < width; j++) {
-
-				if (in[kAIndex] != 0) {
-					out[kRIndex] = MIN((in[kRIndex] * in[kAIndex] >> 8) * out[kRIndex] >> 8, 255);
-					out[kGIndex] = MIN((in[kGIndex] * in[kAIndex] >> 8) * out[kGIndex] >> 8, 255);
-					out[kBIndex] = MIN((in[kBIndex] * in[kAIndex] >> 8) * out[kBIndex] >> 8, 255);
-				}
-
-				in += inStep;
-				out += 4;
-			}
-			outo += pitch;
-			ino += inoStep;
-		}
+		blitPixels(ino, outo, width, height, pitch, inStep, inoStep, MultiplyBlender());
 	} else {
 		byte ca = (color >> kAModShift) & 0xFF;
 		byte cr = (color >> kRModShift) & 0xFF;
@@ -393,6 +649,29 @@ void doBlitMultiplyBlend(byte *ino, byte *outo, uint32 width, uint32 height, uin
 
 }
 
+/**
+ * Select the blitter for the given blend mode, color modulation and alpha
+ * mode, and blit with it.
+ */
+static void doBlit(byte *ino, byte *outo, uint32 width, uint32 height, uint32 pitch, int32 inStep, int32 inoStep, uint32 color, TSpriteBlendMode blendMode, AlphaType alphaMode) {
+	if (color == 0xFFFFFFFF && blendMode == BLEND_NORMAL && alphaMode == ALPHA_OPAQUE) {
+		doBlitOpaqueFast(ino, outo, width, height, pitch, inStep, inoStep);
+	} else if (color == 0xFFFFFFFF && blendMode == BLEND_NORMAL && alphaMode == ALPHA_BINARY) {
+		doBlitBinaryFast(ino, outo, width, height, pitch, inStep, inoStep);
+	} else {
+		if (blendMode == BLEND_ADDITIVE) {
+			doBlitAdditiveBlend(ino, outo, width, height, pitch, inStep, inoStep, color);
+		} else if (blendMode == BLEND_SUBTRACTIVE) {
+			doBlitSubtractiveBlend(ino, outo, width, height, pitch, inStep, inoStep, color);
+		} else if (blendMode == BLEND_MULTIPLY) {
+			doBlitMultiplyBlend(ino, outo, width, height, pitch, inStep, inoStep, color);
+		} else {
+			assert(blendMode == BLEND_NORMAL);
+			doBlitAlphaBlend(ino, outo, width, height, pitch, inStep, inoStep, color);
+		}
+	}
+}
+
 Common::Rect TransparentSurface::blit(Graphics::Surface &target, int posX, int posY, int flipping, Common::Rect *pPartRect, uint color, int width, int height, TSpriteBlendMode blendMode) {
 
 	Common::Rect retSize;
@@ -510,22 +789,7 @@ Common::Rect TransparentSurface::blit(Graphics::Surface &target, int posX, int p
 		byte *ino = (byte *)img->getBasePtr(xp, yp);
 		byte *outo = (byte *)target.getBasePtr(posX, posY);
 
-		if (color == 0xFFFFFFFF && blendMode == BLEND_NORMAL && _alphaMode == ALPHA_OPAQUE) {
-			doBlitOpaqueFast(ino, outo, img->w, img->h, target.pitch, inStep, inoStep);
-		} else if (color == 0xFFFFFFFF && blendMode == BLEND_NORMAL && _alphaMode == ALPHA_BINARY) {
-			doBlitBinaryFast(ino, outo, img->w, img->h, target.pitch, inStep, inoStep);
-		} else {
-			if (blendMode == BLEND_ADDITIVE) {
-				doBlitAdditiveBlend(ino, outo, img->w, img->h, target.pitch, inStep, inoStep, color);
-			} else if (blendMode == BLEND_SUBTRACTIVE) {
-				doBlitSubtractiveBlend(ino, outo, img->w, img->h, target.pitch, inStep, inoStep, color);
-			} else if (blendMode == BLEND_MULTIPLY) {
-				doBlitMultiplyBlend(ino, outo, img->w, img->h, target.pitch, inStep, inoStep, color);
-			} else {
-				assert(blendMode == BLEND_NORMAL);
-				doBlitAlphaBlend(ino, outo, img->w, img->h, target.pitch, inStep, inoStep, color);
-			}
-		}
+		doBlit(ino, outo, img->w, img->h, target.pitch, inStep, inoStep, color, blendMode, _alphaMode);
 
 	}
 
@@ -657,22 +921,7 @@ Common::Rect TransparentSurface::blitClip(Graphics::Surface &target, Common::Rec
 		byte *ino = (byte *)img->getBasePtr(xp, yp);
 		byte *outo = (byte *)target.getBasePtr(posX, posY);
 
-		if (color == 0xFFFFFFFF && blendMode == BLEND_NORMAL && _alphaMode == ALPHA_OPAQUE) {
-			doBlitOpaqueFast(ino, outo, img->w, img->h, target.pitch, inStep, inoStep);
-		} else if (color == 0xFFFFFFFF && blendMode == BLEND_NORMAL && _alphaMode == ALPHA_BINARY) {
-			doBlitBinaryFast(ino, outo, img->w, img->h, target.pitch, inStep, inoStep);
-		} else {
-			if (blendMode == BLEND_ADDITIVE) {
-				doBlitAdditiveBlend(ino, outo, img->w, img->h, target.pitch, inStep, inoStep, color);
-			} else if (blendMode == BLEND_SUBTRACTIVE) {
-				doBlitSubtractiveBlend(ino, outo, img->w, img->h, target.pitch, inStep, inoStep, color);
-			} else if (blendMode == BLEND_MULTIPLY) {
-				doBlitMultiplyBlend(ino, outo, img->w, img->h, target.pitch, inStep, inoStep, color);
-			} else {
-				assert(blendMode == BLEND_NORMAL);
-				doBlitAlphaBlend(ino, outo, img->w, img->h, target.pitch, inStep, inoStep, color);
-			}
-		}
+		doBlit(ino, outo, img->w, img->h, target.pitch, inStep, inoStep, color, blendMode, _alphaMode);
 
 	}
 
@@ -900,9 +1149,6 @@ TransparentSurface *TransparentSurface::scaleT(uint16 newWidth, uint16 newHeight
 	if (filteringMode == FILTER_BILINEAR) {
 		assert(format.bytesPerPixel == 4);
 
-		bool flipx = false, flipy = false; // TODO: See mirroring comment in RenderTicket ctor
-
-
 		int *sax = new int[dstW + 1];
 		int *say = new int[dstH + 1];
 		assert(sax && say);
@@ -947,100 +1193,39 @@ TransparentSurface *TransparentSurface::scaleT(uint16 newWidth, uint16 newHeight
 			}
 		}
 
-		const tColorRGBA *sp = (const tColorRGBA *) getBasePtr(0, 0);
-		tColorRGBA *dp = (tColorRGBA *) target->getBasePtr(0, 0);
-		int spixelgap = srcW;
+		// The interpolation is separable: every destination row is blended
+		// from two source rows, which are scaled horizontally first.
+		// Consecutive destination rows mostly use the same source rows, so
+		// the last two scaled rows are kept.
+		byte *rowBuffer = new byte[dstW * 4 * 2];
+		byte *rows[2] = { rowBuffer, rowBuffer + dstW * 4 };
+		int rowY[2] = { -1, -1 };
 
-		if (flipx) {
-			sp += spixelw;
-		}
-		if (flipy) {
-			sp += spixelgap * spixelh;
-		}
-
-		csay = say;
 		for (int y = 0; y < dstH; y++) {
-			const tColorRGBA *csp = sp;
-			csax = sax;
-			for (int x = 0; x < dstW; x++) {
-				/*
-				* Setup color source pointers
-				*/
-				int ex = (*csax & 0xffff);
-				int ey = (*csay & 0xffff);
-				int cx = (*csax >> 16);
-				int cy = (*csay >> 16);
-
-				const tColorRGBA *c00, *c01, *c10, *c11;
-				c00 = sp;
-				c01 = sp;
-				c10 = sp;
-				if (cy < spixelh) {
-					if (flipy) {
-						c10 -= spixelgap;
-					} else {
-						c10 += spixelgap;
-					}
-				}
-				c11 = c10;
-				if (cx < spixelw) {
-					if (flipx) {
-						c01--;
-						c11--;
-					} else {
-						c01++;
-						c11++;
-					}
-				}
-
-				/*
-				* Draw and interpolate colors
-				*/
-				int t1, t2;
-				t1 = ((((c01->r - c00->r) * ex) >> 16) + c00->r) & 0xff;
-				t2 = ((((c11->r - c10->r) * ex) >> 16) + c10->r) & 0xff;
-				dp->r = (((t2 - t1) * ey) >> 16) + t1;
-				t1 = ((((c01->g - c00->g) * ex) >> 16) + c00->g) & 0xff;
-				t2 = ((((c11->g - c10->g) * ex) >> 16) + c10->g) & 0xff;
-				dp->g = (((t2 - t1) * ey) >> 16) + t1;
-				t1 = ((((c01->b - c00->b) * ex) >> 16) + c00->b) & 0xff;
-				t2 = ((((c11->b - c10->b) * ex) >> 16) + c10->b) & 0xff;
-				dp->b = (((t2 - t1) * ey) >> 16) + t1;
-				t1 = ((((c01->a - c00->a) * ex) >> 16) + c00->a) & 0xff;
-				t2 = ((((c11->a - c10->a) * ex) >> 16) + c10->a) & 0xff;
-				dp->a = (((t2 - t1) * ey) >> 16) + t1;
-
-				/*
-				* Advance source pointer x
-				*/
-				int *salastx = csax;
-				csax++;
-				int sstepx = (*csax >> 16) - (*salastx >> 16);
-				if (flipx) {
-					sp -= sstepx;
+			int cy = say[y] >> 16;
+			int ey = say[y] & 0xffff;
+			int cy1 = (cy < spixelh) ? cy + 1 : cy;
+
+			if (rowY[0] != cy) {
+				if (rowY[1] == cy) {
+					SWAP(rows[0], rows[1]);
+					SWAP(rowY[0], rowY[1]);
 				} else {
-					sp += sstepx;
+					scaleRowBilinear((const byte *)getBasePtr(0, cy), rows[0], sax, dstW, spixelw);
+					rowY[0] = cy;
 				}
-
-				/*
-				* Advance destination pointer x
-				*/
-				dp++;
 			}
-			/*
-			* Advance source pointer y
-			*/
-			int *salasty = csay;
-			csay++;
-			int sstepy = (*csay >> 16) - (*salasty >> 16);
-			sstepy *= spixelgap;
-			if (flipy) {
-				sp = csp - sstepy;
-			} else {
-				sp = csp + sstepy;
+
+			// The lower row is not needed if it has no weight
+			if (ey != 0 && rowY[1] != cy1) {
+				scaleRowBilinear((const byte *)getBasePtr(0, cy1), rows[1], sax, dstW, spixelw);
+				rowY[1] = cy1;
 			}
+
+			blendRowsBilinear(rows[0], rows[1], (byte *)target->getBasePtr(0, y), dstW, ey);
 		}
 
+		delete[] rowBuffer;
 		delete[] sax;
 		delete[] say;
 
@@ -92,6 +92,12 @@ struct TransparentSurface : public Graphics::Surface {
 		return PixelFormat(4, 8, 8, 8, 8, 24, 16, 8, 0);
 	}
 
+	/**
+	 * Returns true if blitting uses SIMD code on this platform. The SIMD
+	 * code gives the same results as the plain C code.
+	 */
+	static bool hasSIMD();
+
 	void setColorKey(char r, char g, char b);
 	void disableColorKey();
 
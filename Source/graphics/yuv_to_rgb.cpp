@@ -86,29 +86,28 @@
 #include "graphics/surface.h"
 #include "graphics/yuv_to_rgb.h"
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define YUV_TO_RGB_SSE2
+#include <emmintrin.h>
+#elif defined(__ARM_NEON__) || defined(__ARM_NEON)
+#define YUV_TO_RGB_NEON
+#include <arm_neon.h>
+#endif
+
+#if defined(YUV_TO_RGB_SSE2) || defined(YUV_TO_RGB_NEON)
+#define YUV_TO_RGB_SIMD
+#endif
+
 namespace Common {
 DECLARE_SINGLETON(Graphics::YUVToRGBManager);
 }
 
 namespace Graphics {
 
-class YUVToRGBLookup {
-public:
-	YUVToRGBLookup(Graphics::PixelFormat format, YUVToRGBManager::LuminanceScale scale);
-
-	Graphics::PixelFormat getFormat() const { return _format; }
-	YUVToRGBManager::LuminanceScale getScale() const { return _scale; }
-	const uint32 *getRGBToPix() const { return _rgbToPix; }
-
-private:
-	Graphics::PixelFormat _format;
-	YUVToRGBManager::LuminanceScale _scale;
-	uint32 _rgbToPix[3 * 768]; // 9216 bytes
-};
-
-YUVToRGBLookup::YUVToRGBLookup(Graphics::PixelFormat format, YUVToRGBManager::LuminanceScale scale) {
+YUVToRGBLookup::YUVToRGBLookup(Graphics::PixelFormat format, YUVToRGBManager::LuminanceScale scale, bool useSIMD) {
 	_format = format;
 	_scale = scale;
+	_useSIMD = useSIMD && hasSIMD();
 
 	uint32 *r_2_pix_alloc = &_rgbToPix[0 * 768];
 	uint32 *g_2_pix_alloc = &_rgbToPix[1 * 768];
@@ -155,10 +154,6 @@ YUVToRGBLookup::YUVToRGBLookup(Graphics::PixelFormat format, YUVToRGBManager::Lu
 			b_2_pix_alloc[i] = b_2_pix_alloc[256 + 236 - 1];
 		}
 	}
-}
-
-YUVToRGBManager::YUVToRGBManager() {
-	_lookup = 0;
 
 	int16 *Cr_r_tab = &_colorTab[0 * 256];
 	int16 *Cr_g_tab = &_colorTab[1 * 256];
@@ -179,34 +174,319 @@ YUVToRGBManager::YUVToRGBManager() {
 	}
 }
 
+bool YUVToRGBLookup::hasSIMD() {
+#ifdef YUV_TO_RGB_SIMD
+	return true;
+#else
+	return false;
+#endif
+}
+
+YUVToRGBManager::YUVToRGBManager() {
+}
+
 YUVToRGBManager::~YUVToRGBManager() {
-	delete _lookup;
+	for (uint i = 0; i < _lookups.size(); ++i)
+		delete _lookups[i];
 }
 
 const YUVToRGBLookup *YUVToRGBManager::getLookup(Graphics::PixelFormat format, YUVToRGBManager::LuminanceScale scale) {
-	if (_lookup && _lookup->getFormat() == format && _lookup->getScale() == scale)
-		return _lookup;
+	Common::StackLock lock(_lookupMutex);
+
+	// Only a few formats are used during a session, so the tables are never
+	// replaced. A conversion still running with older tables is unaffected.
+	for (uint i = 0; i < _lookups.size(); ++i) {
+		if (_lookups[i]->getFormat() == format && _lookups[i]->getScale() == scale)
+			return _lookups[i];
+	}
+
+	YUVToRGBLookup *lookup = new YUVToRGBLookup(format, scale);
+	_lookups.push_back(lookup);
+	return lookup;
+}
+
+#ifdef YUV_TO_RGB_SIMD
+
+// The SIMD kernels compute the same values as the lookup tables, which is
+// possible because the tables just clip and pack the color components:
+// - The colorTab entries are products rounded toward zero. The fixed point
+//   factors below reproduce them exactly for all 256 chroma values.
+// - rgbToPix clamps the components to [0, 255], or for kScaleITU to
+//   [16, 235] followed by the (c - 16) * 255 / 219 expansion.
+// All values are processed as 8 lanes of 16 bit signed integers.
+
+#ifdef YUV_TO_RGB_SSE2
+
+typedef __m128i Vec16;
+
+static inline Vec16 splat(int16 x) { return _mm_set1_epi16(x); }
+static inline Vec16 load8(const byte *src) { return _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)src), _mm_setzero_si128()); }
+static inline Vec16 load16(const int16 *src) { return _mm_loadu_si128((const __m128i *)src); }
+static inline Vec16 add(Vec16 a, Vec16 b) { return _mm_add_epi16(a, b); }
+static inline Vec16 sub(Vec16 a, Vec16 b) { return _mm_sub_epi16(a, b); }
+static inline Vec16 mul(Vec16 a, Vec16 b) { return _mm_mullo_epi16(a, b); }
+static inline Vec16 mulHigh(Vec16 a, Vec16 b) { return _mm_mulhi_epi16(a, b); }
+static inline Vec16 shiftLeft(Vec16 a, int n) { return _mm_sll_epi16(a, _mm_cvtsi32_si128(n)); }
+static inline Vec16 shiftRight(Vec16 a, int n) { return _mm_srl_epi16(a, _mm_cvtsi32_si128(n)); }
+static inline Vec16 clamp(Vec16 a, int16 lo, int16 hi) { return _mm_min_epi16(_mm_max_epi16(a, splat(lo)), splat(hi)); }
+static inline Vec16 isNegative(Vec16 a) { return _mm_srli_epi16(a, 15); }
+static inline Vec16 duplicateLow(Vec16 a) { return _mm_unpacklo_epi16(a, a); }
+static inline Vec16 duplicateHigh(Vec16 a) { return _mm_unpackhi_epi16(a, a); }
+static inline Vec16 bitOr(Vec16 a, Vec16 b) { return _mm_or_si128(a, b); }
+static inline void store16(uint16 *dst, Vec16 a) { _mm_storeu_si128((__m128i *)dst, a); }
+static inline void store32(uint32 *dst, Vec16 low, Vec16 high) {
+	_mm_storeu_si128((__m128i *)dst, _mm_unpacklo_epi16(low, high));
+	_mm_storeu_si128((__m128i *)(dst + 4), _mm_unpackhi_epi16(low, high));
+}
+/** Store 8 pixels from 4 bytes each, saturating the values. */
+static inline void storeBytes32(uint32 *dst, const Vec16 *bytes) {
+	const __m128i bytes02 = _mm_packus_epi16(bytes[0], bytes[2]);
+	const __m128i bytes13 = _mm_packus_epi16(bytes[1], bytes[3]);
+	const __m128i bytes01 = _mm_unpacklo_epi8(bytes02, bytes13);
+	const __m128i bytes23 = _mm_unpackhi_epi8(bytes02, bytes13);
+	_mm_storeu_si128((__m128i *)dst, _mm_unpacklo_epi16(bytes01, bytes23));
+	_mm_storeu_si128((__m128i *)(dst + 4), _mm_unpackhi_epi16(bytes01, bytes23));
+}
+
+#elif defined(YUV_TO_RGB_NEON)
+
+typedef int16x8_t Vec16;
+
+static inline Vec16 splat(int16 x) { return vdupq_n_s16(x); }
+static inline Vec16 load8(const byte *src) { return vreinterpretq_s16_u16(vmovl_u8(vld1_u8(src))); }
+static inline Vec16 load16(const int16 *src) { return vld1q_s16(src); }
+static inline Vec16 add(Vec16 a, Vec16 b) { return vaddq_s16(a, b); }
+static inline Vec16 sub(Vec16 a, Vec16 b) { return vsubq_s16(a, b); }
+static inline Vec16 mul(Vec16 a, Vec16 b) { return vmulq_s16(a, b); }
+// vqdmulh returns (2 * a * b) >> 16, which cannot saturate for our factors
+static inline Vec16 mulHigh(Vec16 a, Vec16 b) { return vshrq_n_s16(vqdmulhq_s16(a, b), 1); }
+static inline Vec16 shiftLeft(Vec16 a, int n) { return vshlq_s16(a, vdupq_n_s16(n)); }
+static inline Vec16 shiftRight(Vec16 a, int n) { return vreinterpretq_s16_u16(vshlq_u16(vreinterpretq_u16_s16(a), vdupq_n_s16(-n))); }
+static inline Vec16 clamp(Vec16 a, int16 lo, int16 hi) { return vminq_s16(vmaxq_s16(a, splat(lo)), splat(hi)); }
+static inline Vec16 isNegative(Vec16 a) { return vreinterpretq_s16_u16(vshrq_n_u16(vreinterpretq_u16_s16(a), 15)); }
+static inline Vec16 duplicateLow(Vec16 a) { return vzipq_s16(a, a).val[0]; }
+static inline Vec16 duplicateHigh(Vec16 a) { return vzipq_s16(a, a).val[1]; }
+static inline Vec16 bitOr(Vec16 a, Vec16 b) { return vorrq_s16(a, b); }
+static inline void store16(uint16 *dst, Vec16 a) { vst1q_u16(dst, vreinterpretq_u16_s16(a)); }
+static inline void store32(uint32 *dst, Vec16 low, Vec16 high) {
+	const int16x8x2_t pixels = vzipq_s16(low, high);
+	vst1q_u32(dst, vreinterpretq_u32_s16(pixels.val[0]));
+	vst1q_u32(dst + 4, vreinterpretq_u32_s16(pixels.val[1]));
+}
+/** Store 8 pixels from 4 bytes each, saturating the values. */
+static inline void storeBytes32(uint32 *dst, const Vec16 *bytes) {
+	uint8x8x4_t pixels;
+	pixels.val[0] = vqmovun_s16(bytes[0]);
+	pixels.val[1] = vqmovun_s16(bytes[1]);
+	pixels.val[2] = vqmovun_s16(bytes[2]);
+	pixels.val[3] = vqmovun_s16(bytes[3]);
+	vst4_u8((uint8 *)dst, pixels);
+}
+
+#endif
+
+/**
+ * The pixel format, as needed by storePixels. 32 bit pixels are assembled
+ * from their low and high 16 bits. Shifting a 16 bit lane by 16 clears it,
+ * which drops a component from the half it is not part of.
+ */
+struct SIMDFormat {
+	SIMDFormat(const Graphics::PixelFormat &format, YUVToRGBManager::LuminanceScale scale) :
+		itu(scale == YUVToRGBManager::kScaleITU), usable(true), bytes(format.bytesPerPixel == 4) {
+		const int losses[3] = { format.rLoss, format.gLoss, format.bLoss };
+		const int shifts[3] = { format.rShift, format.gShift, format.bShift };
+		const uint32 alpha = format.RGBToColor(0, 0, 0);
+
+		for (int i = 0; i < 3; i++) {
+			loss[i] = losses[i];
+			if (format.bytesPerPixel == 2 || shifts[i] < 16) {
+				shiftLow[i] = shifts[i];
+				shiftHigh[i] = 16;
+			} else {
+				shiftLow[i] = 16;
+				shiftHigh[i] = shifts[i] - 16;
+			}
+
+			// A component which straddles both halves would need 32 bit
+			// lanes, but no pixel format in use has one
+			if (shifts[i] < 16 && shifts[i] + 8 - losses[i] > 16)
+				usable = false;
+		}
+
+		alphaLow = alpha & 0xFFFF;
+		alphaHigh = alpha >> 16;
+
+		// Check whether each byte of the pixels holds either a whole
+		// component or only alpha bits
+		for (int i = 0; i < 4; i++) {
+#ifdef SCUMM_BIG_ENDIAN
+			const int shift = (3 - i) * 8;
+#else
+			const int shift = i * 8;
+#endif
+			byteComponent[i] = 3;
+			byteAlpha[i] = (alpha >> shift) & 0xFF;
+			for (int j = 0; j < 3; j++) {
+				if (shifts[j] == shift && losses[j] == 0 && byteAlpha[i] == 0)
+					byteComponent[i] = j;
+				else if (shifts[j] < shift + 8 && shifts[j] + 8 - losses[j] > shift && losses[j] < 8)
+					bytes = false;
+			}
+		}
+	}
+
+	int loss[3];
+	int shiftLow[3];
+	int shiftHigh[3];
+	uint16 alphaLow, alphaHigh;
+	bool itu;
+	bool usable; ///< Can storePixels produce this format?
+	bool bytes;  ///< Are the components whole bytes of 32 bit pixels?
+	int byteComponent[4]; ///< The component in each byte, in memory order, or 3 for alpha
+	int16 byteAlpha[4];   ///< The alpha bits in each byte, in memory order
+};
+
+/** Put the components into the lanes at the given shifts. */
+static inline Vec16 packComponents(Vec16 r, Vec16 g, Vec16 b, const SIMDFormat &format, const int *shifts, uint16 alpha) {
+	Vec16 pixels = splat((int16)alpha);
+	pixels = bitOr(pixels, shiftLeft(shiftRight(r, format.loss[0]), shifts[0]));
+	pixels = bitOr(pixels, shiftLeft(shiftRight(g, format.loss[1]), shifts[1]));
+	pixels = bitOr(pixels, shiftLeft(shiftRight(b, format.loss[2]), shifts[2]));
+	return pixels;
+}
+
+static inline void storePixels(uint16 *dst, Vec16 r, Vec16 g, Vec16 b, const SIMDFormat &format) {
+	store16(dst, packComponents(r, g, b, format, format.shiftLow, format.alphaLow));
+}
+
+static inline void storePixels(uint32 *dst, Vec16 r, Vec16 g, Vec16 b, const SIMDFormat &format) {
+	if (format.bytes) {
+		const Vec16 components[3] = { r, g, b };
+		Vec16 bytes[4];
+		for (int i = 0; i < 4; i++)
+			bytes[i] = (format.byteComponent[i] < 3) ? components[format.byteComponent[i]] : splat(format.byteAlpha[i]);
+		storeBytes32(dst, bytes);
+		return;
+	}
+
+	const Vec16 low = packComponents(r, g, b, format, format.shiftLow, format.alphaLow);
+	const Vec16 high = packComponents(r, g, b, format, format.shiftHigh, format.alphaHigh);
+	store32(dst, low, high);
+}
+
+/**
+ * Compute the offsets added to the luminance for each component, like the
+ * Cr_r, Cr_g + Cb_g and Cb_b tables do (without their base offsets).
+ */
+static inline void chromaOffsets(Vec16 u, Vec16 v, Vec16 &rOff, Vec16 &gOff, Vec16 &bOff, const SIMDFormat &format) {
+	const Vec16 cr = sub(v, splat(128));
+	const Vec16 cb = sub(u, splat(128));
+
+	// The products are rounded down by mulHigh, adding one for negative
+	// inputs rounds them toward zero instead. None of them is an integer
+	// apart from zero.
+	const Vec16 crRound = isNegative(cr);
+	const Vec16 cbRound = isNegative(cb);
+
+	rOff = add(mulHigh(shiftLeft(cr, 2), splat(22957)), crRound);                 // 0.419 / 0.299
+	gOff = sub(sub(splat(0), add(mulHigh(shiftLeft(cr, 1), splat(23380)), crRound)), // 0.299 / 0.419
+	           add(mulHigh(cb, splat(22568)), cbRound));                         // 0.114 / 0.331
+	bOff = add(mulHigh(shiftLeft(cb, 2), splat(29055)), cbRound);                 // 0.587 / 0.331
+
+	if (format.itu) {
+		rOff = shiftLeft(rOff, 2);
+		gOff = shiftLeft(gOff, 2);
+		bOff = shiftLeft(bOff, 2);
+	}
+}
+
+/**
+ * Load the luminance of 8 pixels. For kScaleITU, the luminance and the
+ * chroma offsets are multiplied by 4 up front, as needed by clampComponent.
+ */
+static inline Vec16 loadLuma(const byte *src, const SIMDFormat &format) {
+	return format.itu ? shiftLeft(load8(src), 2) : load8(src);
+}
+
+/** Clamp and scale a color component like rgbToPix does. */
+static inline Vec16 clampComponent(Vec16 c, bool itu) {
+	if (!itu)
+		return clamp(c, 0, 255);
+
+	// (c - 16) * 255 / 219 for c in [16, 235], with c given multiplied by 4
+	return mulHigh(sub(clamp(c, 16 * 4, 235 * 4), splat(16 * 4)), splat(19078));
+}
+
+template<typename PixelInt>
+static inline void putPixels(byte *dst, Vec16 y, Vec16 rOff, Vec16 gOff, Vec16 bOff, const SIMDFormat &format) {
+	Vec16 r = add(y, rOff);
+	Vec16 g = add(y, gOff);
+	Vec16 b = add(y, bOff);
+
+	// Storing the components as bytes clamps them to [0, 255] anyway
+	if (format.itu || sizeof(PixelInt) == 2 || !format.bytes) {
+		r = clampComponent(r, format.itu);
+		g = clampComponent(g, format.itu);
+		b = clampComponent(b, format.itu);
+	}
 
-	delete _lookup;
-	_lookup = new YUVToRGBLookup(format, scale);
-	return _lookup;
+	storePixels((PixelInt *)dst, r, g, b, format);
 }
 
+/**
+ * Bilinearly interpolate the chroma of 8 pixels in a YUV410 image, the
+ * same way DO_INTERPOLATION does.
+ */
+static inline Vec16 interpolate410(const byte *src, int uvPitch, const Vec16 *weights) {
+	const int16 a[8] = { src[0], src[0], src[0], src[0], src[1], src[1], src[1], src[1] };
+	const int16 b[8] = { src[1], src[1], src[1], src[1], src[2], src[2], src[2], src[2] };
+	src += uvPitch;
+	const int16 c[8] = { src[0], src[0], src[0], src[0], src[1], src[1], src[1], src[1] };
+	const int16 d[8] = { src[1], src[1], src[1], src[1], src[2], src[2], src[2], src[2] };
+
+	Vec16 sum = add(mul(load16(a), weights[0]), mul(load16(b), weights[1]));
+	sum = add(sum, add(mul(load16(c), weights[2]), mul(load16(d), weights[3])));
+	return shiftRight(sum, 4);
+}
+
+#endif // YUV_TO_RGB_SIMD
+
 #define PUT_PIXEL(s, d) \
 	L = &rgbToPix[(s)]; \
 	*((PixelInt *)(d)) = (L[cr_r] | L[crb_g] | L[cb_b])
 
 template<typename PixelInt>
-void convertYUV444ToRGB(byte *dstPtr, int dstPitch, const YUVToRGBLookup *lookup, int16 *colorTab, const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth, int yHeight, int yPitch, int uvPitch) {
+void convertYUV444ToRGB(byte *dstPtr, int dstPitch, const YUVToRGBLookup *lookup, const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth, int yHeight, int yPitch, int uvPitch) {
 	// Keep the tables in pointers here to avoid a dereference on each pixel
-	const int16 *Cr_r_tab = colorTab;
+	const int16 *Cr_r_tab = lookup->getColorTab();
 	const int16 *Cr_g_tab = Cr_r_tab + 256;
 	const int16 *Cb_g_tab = Cr_g_tab + 256;
 	const int16 *Cb_b_tab = Cb_g_tab + 256;
 	const uint32 *rgbToPix = lookup->getRGBToPix();
 
+#ifdef YUV_TO_RGB_SIMD
+	const SIMDFormat format(lookup->getFormat(), lookup->getScale());
+#endif
+
 	for (int h = 0; h < yHeight; h++) {
-		for (int w = 0; w < yWidth; w++) {
+		int w = 0;
+
+#ifdef YUV_TO_RGB_SIMD
+		if (lookup->useSIMD() && format.usable) {
+			for (; w + 8 <= yWidth; w += 8) {
+				Vec16 rOff, gOff, bOff;
+				chromaOffsets(load8(uSrc), load8(vSrc), rOff, gOff, bOff, format);
+				putPixels<PixelInt>(dstPtr, loadLuma(ySrc, format), rOff, gOff, bOff, format);
+
+				ySrc += 8;
+				uSrc += 8;
+				vSrc += 8;
+				dstPtr += 8 * sizeof(PixelInt);
+			}
+		}
+#endif
+
+		for (; w < yWidth; w++) {
 			const uint32 *L;
 
 			int16 cr_r  = Cr_r_tab[*vSrc];
@@ -227,35 +507,70 @@ void convertYUV444ToRGB(byte *dstPtr, int dstPitch, const YUVToRGBLookup *lookup
 	}
 }
 
-void YUVToRGBManager::convert444(Graphics::Surface *dst, YUVToRGBManager::LuminanceScale scale, const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth, int yHeight, int yPitch, int uvPitch) {
+void YUVToRGBLookup::convert444(Graphics::Surface *dst, const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth, int yHeight, int yPitch, int uvPitch) const {
 	// Sanity checks
 	assert(dst && dst->getPixels());
+	assert(dst->format == _format);
 	assert(dst->format.bytesPerPixel == 2 || dst->format.bytesPerPixel == 4);
 	assert(ySrc && uSrc && vSrc);
 
-	const YUVToRGBLookup *lookup = getLookup(dst->format, scale);
-
 	// Use a templated function to avoid an if check on every pixel
 	if (dst->format.bytesPerPixel == 2)
-		convertYUV444ToRGB<uint16>((byte *)dst->getPixels(), dst->pitch, lookup, _colorTab, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
+		convertYUV444ToRGB<uint16>((byte *)dst->getPixels(), dst->pitch, this, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
 	else
-		convertYUV444ToRGB<uint32>((byte *)dst->getPixels(), dst->pitch, lookup, _colorTab, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
+		convertYUV444ToRGB<uint32>((byte *)dst->getPixels(), dst->pitch, this, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
+}
+
+void YUVToRGBManager::convert444(Graphics::Surface *dst, YUVToRGBManager::LuminanceScale scale, const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth, int yHeight, int yPitch, int uvPitch) {
+	assert(dst);
+
+	getLookup(dst->format, scale)->convert444(dst, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
 }
 
 template<typename PixelInt>
-void convertYUV420ToRGB(byte *dstPtr, int dstPitch, const YUVToRGBLookup *lookup, int16 *colorTab, const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth, int yHeight, int yPitch, int uvPitch) {
+void convertYUV420ToRGB(byte *dstPtr, int dstPitch, const YUVToRGBLookup *lookup, const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth, int yHeight, int yPitch, int uvPitch) {
 	int halfHeight = yHeight >> 1;
 	int halfWidth = yWidth >> 1;
 
 	// Keep the tables in pointers here to avoid a dereference on each pixel
-	const int16 *Cr_r_tab = colorTab;
+	const int16 *Cr_r_tab = lookup->getColorTab();
 	const int16 *Cr_g_tab = Cr_r_tab + 256;
 	const int16 *Cb_g_tab = Cr_g_tab + 256;
 	const int16 *Cb_b_tab = Cb_g_tab + 256;
 	const uint32 *rgbToPix = lookup->getRGBToPix();
 
+#ifdef YUV_TO_RGB_SIMD
+	const SIMDFormat format(lookup->getFormat(), lookup->getScale());
+#endif
+
 	for (int h = 0; h < halfHeight; h++) {
-		for (int w = 0; w < halfWidth; w++) {
+		int w = 0;
+
+#ifdef YUV_TO_RGB_SIMD
+		// 8 chroma values cover 16 pixels on two lines
+		if (lookup->useSIMD() && format.usable) {
+			for (; w + 8 <= halfWidth; w += 8) {
+				Vec16 rOff, gOff, bOff;
+				chromaOffsets(load8(uSrc), load8(vSrc), rOff, gOff, bOff, format);
+
+				const Vec16 rOffLow = duplicateLow(rOff), rOffHigh = duplicateHigh(rOff);
+				const Vec16 gOffLow = duplicateLow(gOff), gOffHigh = duplicateHigh(gOff);
+				const Vec16 bOffLow = duplicateLow(bOff), bOffHigh = duplicateHigh(bOff);
+
+				putPixels<PixelInt>(dstPtr, loadLuma(ySrc, format), rOffLow, gOffLow, bOffLow, format);
+				putPixels<PixelInt>(dstPtr + 8 * sizeof(PixelInt), loadLuma(ySrc + 8, format), rOffHigh, gOffHigh, bOffHigh, format);
+				putPixels<PixelInt>(dstPtr + dstPitch, loadLuma(ySrc + yPitch, format), rOffLow, gOffLow, bOffLow, format);
+				putPixels<PixelInt>(dstPtr + dstPitch + 8 * sizeof(PixelInt), loadLuma(ySrc + yPitch + 8, format), rOffHigh, gOffHigh, bOffHigh, format);
+
+				ySrc += 16;
+				uSrc += 8;
+				vSrc += 8;
+				dstPtr += 16 * sizeof(PixelInt);
+			}
+		}
+#endif
+
+		for (; w < halfWidth; w++) {
 			const uint32 *L;
 
 			int16 cr_r  = Cr_r_tab[*vSrc];
@@ -274,28 +589,33 @@ void convertYUV420ToRGB(byte *dstPtr, int dstPitch, const YUVToRGBLookup *lookup
 			dstPtr += sizeof(PixelInt);
 		}
 
-		dstPtr += dstPitch;
+		dstPtr += (dstPitch << 1) - yWidth * sizeof(PixelInt);
 		ySrc += (yPitch << 1) - yWidth;
 		uSrc += uvPitch - halfWidth;
 		vSrc += uvPitch - halfWidth;
 	}
 }
 
-void YUVToRGBManager::convert420(Graphics::Surface *dst, YUVToRGBManager::LuminanceScale scale, const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth, int yHeight, int yPitch, int uvPitch) {
+void YUVToRGBLookup::convert420(Graphics::Surface *dst, const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth, int yHeight, int yPitch, int uvPitch) const {
 	// Sanity checks
 	assert(dst && dst->getPixels());
+	assert(dst->format == _format);
 	assert(dst->format.bytesPerPixel == 2 || dst->format.bytesPerPixel == 4);
 	assert(ySrc && uSrc && vSrc);
 	assert((yWidth & 1) == 0);
 	assert((yHeight & 1) == 0);
 
-	const YUVToRGBLookup *lookup = getLookup(dst->format, scale);
-
 	// Use a templated function to avoid an if check on every pixel
 	if (dst->format.bytesPerPixel == 2)
-		convertYUV420ToRGB<uint16>((byte *)dst->getPixels(), dst->pitch, lookup, _colorTab, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
+		convertYUV420ToRGB<uint16>((byte *)dst->getPixels(), dst->pitch, this, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
 	else
-		convertYUV420ToRGB<uint32>((byte *)dst->getPixels(), dst->pitch, lookup, _colorTab, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
+		convertYUV420ToRGB<uint32>((byte *)dst->getPixels(), dst->pitch, this, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
+}
+
+void YUVToRGBManager::convert420(Graphics::Surface *dst, YUVToRGBManager::LuminanceScale scale, const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth, int yHeight, int yPitch, int uvPitch) {
+	assert(dst);
+
+	getLookup(dst->format, scale)->convert420(dst, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
 }
 
 #define READ_QUAD(ptr, prefix) \
@@ -323,9 +643,9 @@ void YUVToRGBManager::convert420(Graphics::Surface *dst, YUVToRGBManager::Lumina
 	xDiff++
 
 template<typename PixelInt>
-void convertYUV410ToRGB(byte *dstPtr, int dstPitch, const YUVToRGBLookup *lookup, int16 *colorTab, const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth, int yHeight, int yPitch, int uvPitch) {
+void convertYUV410ToRGB(byte *dstPtr, int dstPitch, const YUVToRGBLookup *lookup, const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth, int yHeight, int yPitch, int uvPitch) {
 	// Keep the tables in pointers here to avoid a dereference on each pixel
-	const int16 *Cr_r_tab = colorTab;
+	const int16 *Cr_r_tab = lookup->getColorTab();
 	const int16 *Cr_g_tab = Cr_r_tab + 256;
 	const int16 *Cb_g_tab = Cr_g_tab + 256;
 	const int16 *Cb_b_tab = Cb_g_tab + 256;
@@ -333,8 +653,41 @@ void convertYUV410ToRGB(byte *dstPtr, int dstPitch, const YUVToRGBLookup *lookup
 
 	int quarterWidth = yWidth >> 2;
 
+#ifdef YUV_TO_RGB_SIMD
+	const SIMDFormat format(lookup->getFormat(), lookup->getScale());
+#endif
+
 	for (int y = 0; y < yHeight; y++) {
-		for (int x = 0; x < quarterWidth; x++) {
+		int x = 0;
+
+#ifdef YUV_TO_RGB_SIMD
+		// Two chroma samples cover 8 pixels
+		if (lookup->useSIMD() && format.usable) {
+			const int yDiff = y & 3;
+			const int16 xDiffs[8] = { 0, 1, 2, 3, 0, 1, 2, 3 };
+			int16 weights[4][8];
+			for (int i = 0; i < 8; i++) {
+				weights[0][i] = (4 - xDiffs[i]) * (4 - yDiff);
+				weights[1][i] = xDiffs[i] * (4 - yDiff);
+				weights[2][i] = (4 - xDiffs[i]) * yDiff;
+				weights[3][i] = xDiffs[i] * yDiff;
+			}
+			const Vec16 weightVecs[4] = { load16(weights[0]), load16(weights[1]), load16(weights[2]), load16(weights[3]) };
+
+			for (; x + 2 <= quarterWidth; x += 2) {
+				int index = (y >> 2) * uvPitch + x;
+
+				Vec16 rOff, gOff, bOff;
+				chromaOffsets(interpolate410(uSrc + index, uvPitch, weightVecs), interpolate410(vSrc + index, uvPitch, weightVecs), rOff, gOff, bOff, format);
+				putPixels<PixelInt>(dstPtr, loadLuma(ySrc, format), rOff, gOff, bOff, format);
+
+				ySrc += 8;
+				dstPtr += 8 * sizeof(PixelInt);
+			}
+		}
+#endif
+
+		for (; x < quarterWidth; x++) {
 			// Perform bilinear interpolation on the the chroma values
 			// Based on the algorithm found here: http://tech-algorithm.com/articles/bilinear-image-scaling/
 			// Feel free to optimize further
@@ -366,21 +719,26 @@ void convertYUV410ToRGB(byte *dstPtr, int dstPitch, const YUVToRGBLookup *lookup
 #undef DO_INTERPOLATION
 #undef DO_YUV410_PIXEL
 
-void YUVToRGBManager::convert410(Graphics::Surface *dst, YUVToRGBManager::LuminanceScale scale, const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth, int yHeight, int yPitch, int uvPitch) {
+void YUVToRGBLookup::convert410(Graphics::Surface *dst, const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth, int yHeight, int yPitch, int uvPitch) const {
 	// Sanity checks
 	assert(dst && dst->getPixels());
+	assert(dst->format == _format);
 	assert(dst->format.bytesPerPixel == 2 || dst->format.bytesPerPixel == 4);
 	assert(ySrc && uSrc && vSrc);
 	assert((yWidth & 3) == 0);
 	assert((yHeight & 3) == 0);
 
-	const YUVToRGBLookup *lookup = getLookup(dst->format, scale);
-
 	// Use a templated function to avoid an if check on every pixel
 	if (dst->format.bytesPerPixel == 2)
-		convertYUV410ToRGB<uint16>((byte *)dst->getPixels(), dst->pitch, lookup, _colorTab, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
+		convertYUV410ToRGB<uint16>((byte *)dst->getPixels(), dst->pitch, this, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
 	else
-		convertYUV410ToRGB<uint32>((byte *)dst->getPixels(), dst->pitch, lookup, _colorTab, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
+		convertYUV410ToRGB<uint32>((byte *)dst->getPixels(), dst->pitch, this, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
+}
+
+void YUVToRGBManager::convert410(Graphics::Surface *dst, YUVToRGBManager::LuminanceScale scale, const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth, int yHeight, int yPitch, int uvPitch) {
+	assert(dst);
+
+	getLookup(dst->format, scale)->convert410(dst, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
 }
 
 } // End of namespace Graphics
@@ -39,6 +39,8 @@
 #define GRAPHICS_YUV_TO_RGB_H
 
 #include "common/scummsys.h"
+#include "common/array.h"
+#include "common/mutex.h"
 #include "common/singleton.h"
 #include "graphics/surface.h"
 
@@ -110,9 +112,59 @@ private:
 	YUVToRGBManager();
 	~YUVToRGBManager();
 
+	/**
+	 * Get the tables for the given format and scale. They stay valid until
+	 * the manager is destroyed, so that conversions may use them without
+	 * holding the mutex while other conversions create new ones.
+	 */
 	const YUVToRGBLookup *getLookup(Graphics::PixelFormat format, LuminanceScale scale);
 
-	YUVToRGBLookup *_lookup;
+	Common::Array<YUVToRGBLookup *> _lookups;
+	Common::Mutex _lookupMutex; ///< Conversions may run in parallel jobs
+};
+
+/**
+ * The tables for converting YUV images to one pixel format and luminance
+ * scale. YUVToRGBManager keeps the tables it used last, but they can be
+ * used directly as well.
+ *
+ * Where SSE2 or NEON is available, the conversions use SIMD code, which
+ * gives the same results as the lookup tables.
+ */
+class YUVToRGBLookup {
+public:
+	/**
+	 * Create the tables.
+	 *
+	 * @param format  the pixel format to convert to
+	 * @param scale   the scale of the luminance values
+	 * @param useSIMD whether to use the SIMD code, if available
+	 */
+	YUVToRGBLookup(Graphics::PixelFormat format, YUVToRGBManager::LuminanceScale scale, bool useSIMD = true);
+
+	Graphics::PixelFormat getFormat() const { return _format; }
+	YUVToRGBManager::LuminanceScale getScale() const { return _scale; }
+	const uint32 *getRGBToPix() const { return _rgbToPix; }
+	const int16 *getColorTab() const { return _colorTab; }
+	bool useSIMD() const { return _useSIMD; }
+
+	/** Is SIMD code for the conversions available on this platform? */
+	static bool hasSIMD();
+
+	/** @see YUVToRGBManager::convert444 */
+	void convert444(Graphics::Surface *dst, const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth, int yHeight, int yPitch, int uvPitch) const;
+
+	/** @see YUVToRGBManager::convert420 */
+	void convert420(Graphics::Surface *dst, const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth, int yHeight, int yPitch, int uvPitch) const;
+
+	/** @see YUVToRGBManager::convert410 */
+	void convert410(Graphics::Surface *dst, const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth, int yHeight, int yPitch, int uvPitch) const;
+
+private:
+	Graphics::PixelFormat _format;
+	YUVToRGBManager::LuminanceScale _scale;
+	bool _useSIMD;
+	uint32 _rgbToPix[3 * 768]; // 9216 bytes
 	int16 _colorTab[4 * 256]; // 2048 bytes
 };
 
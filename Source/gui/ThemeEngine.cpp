@@ -166,18 +166,147 @@ static const DrawDataInfo kDrawDataDefaults[] = {
 	{kDDSeparator,                  "separator",    kDrawLayerBackground,   kDDNone},
 };
 
+/**********************************************************
+ * Widget cache
+ *********************************************************/
+
+/**
+ * Keeps copies of DrawData sets as they looked on the screen after being
+ * drawn, so that a widget which is drawn again in the same state, e.g. a
+ * button the mouse moved over and away from again, is copied instead of
+ * being rendered from scratch.
+ *
+ * A copy includes the background restored from the back buffer below the
+ * widget, hence the copies are only valid until the back buffer changes.
+ * When the copies exceed the memory budget, the least recently used ones
+ * are dropped.
+ */
+class ThemeEngine::WidgetCache {
+public:
+	struct Key {
+		DrawData type;
+		uint32 dynamic;
+		Common::Rect area;
+		Common::Rect clip;
+		Graphics::VectorRenderer::InheritedState state;
+
+		bool operator==(const Key &other) const {
+			return type == other.type && dynamic == other.dynamic &&
+			       area == other.area && clip == other.clip && state == other.state;
+		}
+	};
+
+	WidgetCache() : _maxSize(0), _size(0) {}
+	~WidgetCache() { clear(); }
+
+	/**
+	 * Returns the copy of a DrawData set, or 0 if it is not cached.
+	 */
+	const Graphics::Surface *find(const Key &key) {
+		EntryMap::iterator cached = _map.find(key);
+		if (cached == _map.end())
+			return 0;
+
+		// Move the entry to the front of the list
+		EntryList::iterator entry = cached->_value;
+		if (entry != _entries.begin()) {
+			_entries.push_front(*entry);
+			_entries.erase(entry);
+			cached->_value = _entries.begin();
+		}
+		return &_entries.front().surface;
+	}
+
+	/**
+	 * Stores a copy of an area of the screen for a DrawData set.
+	 */
+	void insert(const Key &key, const Graphics::Surface &screen, const Common::Rect &r) {
+		const uint32 size = r.width() * r.height() * screen.format.bytesPerPixel;
+		// Copies larger than the whole budget are not kept
+		if (size == 0 || size > _maxSize || _map.contains(key))
+			return;
+
+		while (_size + size > _maxSize)
+			remove(--_entries.end());
+
+		Entry entry;
+		entry.key = key;
+		entry.size = size;
+		_entries.push_front(entry);
+		_entries.front().surface.copyFrom(screen.getSubArea(r));
+		_map[key] = _entries.begin();
+		_size += size;
+	}
+
+	/**
+	 * Drops all copies and sets the memory budget, in bytes.
+	 */
+	void reset(uint32 maxSize) {
+		clear();
+		_maxSize = maxSize;
+	}
+
+	/**
+	 * Drops all copies.
+	 */
+	void clear() {
+		for (EntryList::iterator entry = _entries.begin(); entry != _entries.end(); ++entry)
+			entry->surface.free();
+		_entries.clear();
+		_map.clear();
+		_size = 0;
+	}
+
+private:
+	struct KeyHash {
+		uint operator()(const Key &key) const {
+			uint hash = (uint)key.type;
+			hash = hash * 31 + key.dynamic;
+			hash = hash * 31 + (uint16)key.area.left + ((uint)(uint16)key.area.top << 16);
+			hash = hash * 31 + (uint16)key.area.right + ((uint)(uint16)key.area.bottom << 16);
+			hash = hash * 31 + (uint16)key.clip.left + ((uint)(uint16)key.clip.top << 16);
+			hash = hash * 31 + (uint16)key.clip.right + ((uint)(uint16)key.clip.bottom << 16);
+			hash = hash * 31 + key.state.fgColor;
+			hash = hash * 31 + key.state.bgColor;
+			return hash * 31 + key.state.gradientStart;
+		}
+	};
+
+	struct Entry {
+		Key key;
+		Graphics::Surface surface;
+		uint32 size;
+	};
+
+	typedef Common::List<Entry> EntryList;
+	typedef Common::HashMap<Key, EntryList::iterator, KeyHash> EntryMap;
+
+	void remove(EntryList::iterator entry) {
+		_size -= entry->size;
+		entry->surface.free();
+		_map.erase(entry->key);
+		_entries.erase(entry);
+	}
+
+	EntryList _entries; ///< All cached copies, most recently used first
+	EntryMap _map;
+	uint32 _maxSize;
+	uint32 _size;
+};
+
 /**********************************************************
  * ThemeEngine class
  *********************************************************/
 ThemeEngine::ThemeEngine(Common::String id, GraphicsMode mode) :
 	_system(0), _vectorRenderer(0),
 	_layerToDraw(kDrawLayerBackground), _bytesPerPixel(0),  _graphicsMode(kGfxDisabled),
-	_font(0), _initOk(false), _themeOk(false), _enabled(false), _themeFiles(),
+	_font(0), _widgetCache(0), _initOk(false), _themeOk(false), _enabled(false), _themeFiles(),
 	_cursor(0) {
 
 	_system = g_system;
 	_parser = new ThemeParser(this);
 	_themeEval = new GUI::ThemeEval();
+	_widgetCache = new WidgetCache();
 
 	_useCursor = false;
 
@@ -216,6 +345,8 @@ ThemeEngine::ThemeEngine(Common::String id, GraphicsMode mode) :
 }
 
 ThemeEngine::~ThemeEngine() {
+	delete _widgetCache;
+	_widgetCache = 0;
 	delete _vectorRenderer;
 	_vectorRenderer = 0;
 	_screen.free();
@@ -351,6 +482,7 @@ void ThemeEngine::clearAll() {
 	if (_initOk) {
 		_system->clearOverlay();
 		_system->grabOverlay(_backBuffer.getPixels(), _backBuffer.pitch);
+		_widgetCache->clear();
 	}
 }
 
@@ -443,6 +575,9 @@ void ThemeEngine::setGraphicsMode(GraphicsMode mode) {
 	_vectorRenderer = Graphics::createRenderer(mode);
 	_vectorRenderer->setSurface(&_screen);
 
+	// Keep up to two screens worth of widgets
+	_widgetCache->reset(2 * _screen.pitch * _screen.h);
+
 	// Since we reinitialized our screen surfaces we know nothing has been
 	// drawn so far. Sometimes we still end up with dirty screen bits in the
 	// list. Clearing it avoids invalid overlay writes when the backend
@@ -713,6 +848,8 @@ void ThemeEngine::unloadTheme() {
 	if (!_themeOk)
 		return;
 
+	_widgetCache->clear();
+
 	for (int i = 0; i < kDrawDataMAX; ++i) {
 		delete _widgets[i];
 		_widgets[i] = 0;
@@ -855,7 +992,42 @@ void ThemeEngine::drawDD(DrawData type, const Common::Rect &r, uint32 dynamic, b
 		extendedRect.clip(_clip);
 	}
 
-	if (forceRestore || drawData->_layer == kDrawLayerBackground)
+	const bool restore = forceRestore || drawData->_layer == kDrawLayerBackground;
+
+	// When the background is restored first, the result only depends on the
+	// back buffer and on how the widget is drawn, so it can be reused until
+	// the back buffer changes.
+	if (restore && drawData->_layer == _layerToDraw && _vectorRenderer->getActiveSurface() == &_screen &&
+	        isDrawDataCacheable(drawData, area, extendedRect)) {
+		WidgetCache::Key key;
+		key.type = type;
+		key.dynamic = dynamic;
+		key.area = area;
+		key.clip = _clip;
+		key.state = _vectorRenderer->getInheritedState();
+
+		Common::List<Graphics::DrawStep>::const_iterator step;
+		const Graphics::Surface *cached = _widgetCache->find(key);
+		if (cached) {
+			_vectorRenderer->blitSubSurface(cached, extendedRect);
+
+			// Leave the renderer in the state drawing the steps would
+			for (step = drawData->_steps.begin(); step != drawData->_steps.end(); ++step)
+				_vectorRenderer->setStepState(*step, dynamic);
+		} else {
+			restoreBackground(extendedRect);
+
+			for (step = drawData->_steps.begin(); step != drawData->_steps.end(); ++step)
+				_vectorRenderer->drawStepClip(area, _clip, *step, dynamic);
+
+			_widgetCache->insert(key, _screen, extendedRect);
+		}
+
+		addDirtyRect(extendedRect);
+		return;
+	}
+
+	if (restore)
 		restoreBackground(extendedRect);
 
 	if (drawData->_layer == _layerToDraw) {
@@ -868,6 +1040,48 @@ void ThemeEngine::drawDD(DrawData type, const Common::Rect &r, uint32 dynamic, b
 	}
 }
 
+bool ThemeEngine::isDrawDataCacheable(const WidgetDrawData *drawData, const Common::Rect &area, const Common::Rect &extendedRect) {
+	// The restored background and the copy are clipped to the screen
+	if (extendedRect.isEmpty() || extendedRect.left < 0 || extendedRect.top < 0 ||
+	        extendedRect.right > _screen.w || extendedRect.bottom > _screen.h)
+		return false;
+
+	Common::List<Graphics::DrawStep>::const_iterator step;
+	for (step = drawData->_steps.begin(); step != drawData->_steps.end(); ++step) {
+		// These do not stay inside the area of the step
+		if (step->drawingCall == &Graphics::VectorRenderer::drawCallback_FILLSURFACE ||
+		        step->drawingCall == &Graphics::VectorRenderer::drawCallback_ALPHABITMAP)
+			return false;
+
+		if (step->drawingCall == &Graphics::VectorRenderer::drawCallback_VOID)
+			continue;
+
+		uint16 x, y, w, h;
+		_vectorRenderer->stepGetPositions(*step, area, x, y, w, h);
+
+		Common::Rect bounds(x, y, x + w, y + h);
+		if (step->drawingCall == &Graphics::VectorRenderer::drawCallback_CIRCLE) {
+			const int radius = _vectorRenderer->stepGetRadius(*step, area);
+			bounds = Common::Rect(x, y, x + 2 * radius + 1, y + 2 * radius + 1);
+		} else if (step->drawingCall == &Graphics::VectorRenderer::drawCallback_LINE) {
+			bounds = Common::Rect(x, y, x + w + 1, y + w + 1);
+		}
+
+		// Leave room for strokes, bevels and shadows
+		bounds.grow(MAX(step->stroke, step->bevel) + 1);
+		bounds.right += step->shadow;
+		bounds.bottom += step->shadow;
+
+		if (!_clip.isEmpty())
+			bounds.clip(_clip);
+
+		if (!bounds.isEmpty() && !extendedRect.contains(bounds))
+			return false;
+	}
+
+	return true;
+}
+
 void ThemeEngine::drawDDText(TextData type, TextColor color, const Common::Rect &r, const Common::String &text,
                              bool restoreBg, bool ellipsis, Graphics::TextAlign alignH, TextAlignVertical alignV,
                              int deltax, const Common::Rect &drawableTextArea) {
@@ -1636,11 +1850,9 @@ bool ThemeEngine::themeConfigUsable(const Common::FSNode &node, Common::String &
 			stream.open("THEMERC", *zipArchive);
 		}
 		// Delete the ZIP archive again. Note: This only works because
-		// stream.open() only uses ZipArchive::createReadStreamForMember,
-		// and that in turn happens to read all the data for a given
-		// archive member into a memory block. So there will be no dangling
-		// reference to zipArchive anywhere. This could change if we
-		// ever modify ZipArchive::createReadStreamForMember.
+		// the member streams created by ZipArchive::createReadStreamForMember
+		// keep the underlying ZIP file open on their own. So there will be
+		// no dangling reference to zipArchive anywhere.
 		delete zipArchive;
 	} else if (node.isDirectory()) {
 		Common::FSNode headerfile = node.getChild("THEMERC");
@@ -1871,6 +2083,8 @@ void ThemeEngine::hideCursor() {
 }
 
 void ThemeEngine::drawToBackbuffer() {
+	// The cached widgets include the old back buffer contents
+	_widgetCache->clear();
 	_vectorRenderer->setSurface(&_backBuffer);
 }
 
@@ -635,6 +635,12 @@ protected:
 	                const Common::Rect &drawableTextArea = Common::Rect(0, 0, 0, 0));
 	void drawBitmap(const Graphics::Surface *bitmap, const Common::Rect &clippingRect, bool alpha);
 
+	/**
+	 * Checks whether drawing a DrawData set only touches the given area,
+	 * so that the result can be kept in the widget cache.
+	 */
+	bool isDrawDataCacheable(const WidgetDrawData *drawData, const Common::Rect &area, const Common::Rect &extendedRect);
+
 	/**
 	 * DEBUG: Draws a white square and writes some text next to it.
 	 */
@@ -718,6 +724,10 @@ protected:
 	/** List of all the dirty screens that must be blitted to the overlay. */
 	Common::List<Common::Rect> _dirtyScreen;
 
+	/** Copies of DrawData sets already drawn to the screen, see drawDD(). */
+	class WidgetCache;
+	WidgetCache *_widgetCache;
+
 	bool _initOk;  ///< Class and renderer properly initialized
 	bool _themeOk; ///< Theme data successfully loaded.
 	bool _enabled; ///< Whether the Theme is currently shown on the overlay
@@ -34,6 +34,8 @@
 #include "common/stream.h"
 #endif
 
+#include "audio/soundcache.h"
+
 #include "engines/engine.h"
 
 #include "gui/debugger.h"
@@ -78,6 +80,8 @@ Debugger::Debugger() {
 	registerCmd("debugflag_list",		WRAP_METHOD(Debugger, cmdDebugFlagsList));
 	registerCmd("debugflag_enable",	WRAP_METHOD(Debugger, cmdDebugFlagEnable));
 	registerCmd("debugflag_disable",	WRAP_METHOD(Debugger, cmdDebugFlagDisable));
+
+	registerCmd("soundcache",		WRAP_METHOD(Debugger, cmdSoundCache));
 }
 
 Debugger::~Debugger() {
@@ -781,6 +785,29 @@ bool Debugger::cmdDebugFlagDisable(int argc, const char **argv) {
 	return true;
 }
 
+bool Debugger::cmdSoundCache(int argc, const char **argv) {
+	if (argc >= 2 && !scumm_stricmp(argv[1], "clear")) {
+		g_soundCache.clear();
+		debugPrintf("Cleared the sound cache\n");
+	} else if (argc >= 2 && !scumm_stricmp(argv[1], "reset")) {
+		g_soundCache.resetStats();
+		debugPrintf("Reset the sound cache statistics\n");
+	} else if (argc >= 3 && !scumm_stricmp(argv[1], "limit")) {
+		g_soundCache.setMemoryLimit(atoi(argv[2]) * 1024);
+		debugPrintf("Sound cache limit set to %d KB\n", atoi(argv[2]));
+	} else if (argc >= 2) {
+		debugPrintf("Usage: %s [clear | reset | limit <KB>]\n", argv[0]);
+		return true;
+	}
+
+	const Audio::SoundCache::Stats stats = g_soundCache.getStats();
+	const uint32 lookups = stats.hits + stats.misses;
+	debugPrintf("Sound cache: %u sounds, %u of %u KB used\n", stats.entries, stats.memoryUsed / 1024, stats.memoryLimit / 1024);
+	debugPrintf("Hits: %u, misses: %u (%u%% hit rate), evictions: %u\n", stats.hits, stats.misses,
+			lookups ? stats.hits * 100 / lookups : 0, stats.evictions);
+	return true;
+}
+
 // Console handler
 #ifndef USE_TEXT_CONSOLE_FOR_DEBUGGER
 bool Debugger::debuggerInputCallback(GUI::ConsoleDialog *console, const char *input, void *refCon) {
@@ -22,6 +22,7 @@
 
 #include "base/version.h"
 
+#include "common/algorithm.h"
 #include "common/config-manager.h"
 #include "common/events.h"
 #include "common/fs.h"
@@ -88,6 +89,26 @@ enum {
 	kCmdSavePathClear = 'PSAC'
 };
 
+namespace {
+
+struct ListEntry {
+	Common::String description;
+	Common::String domain;
+	uint order;
+};
+
+struct ListEntryLess {
+	bool operator()(const ListEntry &x, const ListEntry &y) const {
+		const int cmp = scumm_stricmp(x.description.c_str(), y.description.c_str());
+		if (cmp != 0)
+			return cmp < 0;
+		// Games with the same description are listed in reverse config order
+		return x.order > y.order;
+	}
+};
+
+} // End of anonymous namespace
+
 #pragma mark -
 
 LauncherDialog::LauncherDialog()
@@ -99,7 +120,9 @@ LauncherDialog::LauncherDialog()
 	_w = screenW;
 	_h = screenH;
 
+	const uint32 startTime = g_system->getMillis();
 	build();
+	debug(2, "LauncherDialog: built in %d ms", g_system->getMillis() - startTime);
 
 	GUI::GuiManager::instance()._launched = true;
 }
@@ -245,10 +268,10 @@ void LauncherDialog::close() {
 }
 
 void LauncherDialog::updateListing() {
-	StringArray l;
+	const uint32 startTime = g_system->getMillis();
+	Common::Array<ListEntry> entries;
 
 	// Retrieve a list of all games defined in the config file
-	_domains.clear();
 	const ConfigManager::DomainMap &domains = ConfMan.getGameDomains();
 	ConfigManager::DomainMap::const_iterator iter;
 	for (iter = domains.begin(); iter != domains.end(); ++iter) {
@@ -276,16 +299,27 @@ void LauncherDialog::updateListing() {
 		}
 
 		if (!gameid.empty() && !description.empty()) {
-			// Insert the game into the launcher list
-			int pos = 0, size = l.size();
-
-			while (pos < size && (scumm_stricmp(description.c_str(), l[pos].c_str()) > 0))
-				pos++;
-			l.insert_at(pos, description);
-			_domains.insert_at(pos, iter->_key);
+			ListEntry entry;
+			entry.description = description;
+			entry.domain = iter->_key;
+			entry.order = entries.size();
+			entries.push_back(entry);
 		}
 	}
 
+	// Sort the games once instead of inserting each one at its place,
+	// which takes quadratic time with large collections
+	Common::sort(entries.begin(), entries.end(), ListEntryLess());
+
+	StringArray l;
+	l.reserve(entries.size());
+	_domains.clear();
+	_domains.reserve(entries.size());
+	for (Common::Array<ListEntry>::const_iterator i = entries.begin(); i != entries.end(); ++i) {
+		l.push_back(i->description);
+		_domains.push_back(i->domain);
+	}
+
 	const int oldSel = _list->getSelected();
 	_list->setList(l);
 	if (oldSel < (int)l.size())
@@ -298,6 +332,8 @@ void LauncherDialog::updateListing() {
 	// Update the filter settings, those are lost when "setList"
 	// is called.
 	_list->setFilter(_searchWidget->getEditString());
+
+	debug(2, "LauncherDialog: listed %d games in %d ms", (int)l.size(), g_system->getMillis() - startTime);
 }
 
 void LauncherDialog::addGame() {
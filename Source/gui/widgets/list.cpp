@@ -161,6 +161,7 @@ void ListWidget::setList(const StringArray &list, const ColorList *colors) {
 	_dataList = list;
 	_list = list;
 	_filter.clear();
+	_lowercaseList.clear();
 	_listIndex.clear();
 	_listColors.clear();
 
@@ -675,6 +676,11 @@ void ListWidget::setFilter(const String &filter, bool redraw) {
 	if (_filter == filt) // Filter was not changed
 		return;
 
+	// When the filter is only extended, the items matching it are a subset
+	// of the current matches, so only those have to be checked again. This
+	// keeps typing into the search box fast for long lists.
+	const bool narrowed = !_filter.empty() && filt.hasPrefix(_filter) && _lowercaseList.size() == _dataList.size();
+
 	_filter = filt;
 
 	if (_filter.empty()) {
@@ -685,16 +691,30 @@ void ListWidget::setFilter(const String &filter, bool redraw) {
 		// Restrict the list to everything which contains all words in _filter
 		// as substrings, ignoring case.
 
+		// Convert the items to lower case once, not on every change of the
+		// filter. Items appended since the last filtering are added here.
+		_lowercaseList.reserve(_dataList.size());
+		while (_lowercaseList.size() < _dataList.size()) {
+			_lowercaseList.push_back(_dataList[_lowercaseList.size()]);
+			_lowercaseList.back().toLowercase();
+		}
+
 		Common::StringTokenizer tok(_filter);
-		String tmp;
-		int n = 0;
+		Common::Array<int> candidates;
+
+		if (narrowed) {
+			candidates = _listIndex;
+		} else {
+			candidates.resize(_dataList.size());
+			for (uint i = 0; i < candidates.size(); ++i)
+				candidates[i] = i;
+		}
 
 		_list.clear();
 		_listIndex.clear();
 
-		for (StringArray::iterator i = _dataList.begin(); i != _dataList.end(); ++i, ++n) {
-			tmp = *i;
-			tmp.toLowercase();
+		for (Common::Array<int>::const_iterator i = candidates.begin(); i != candidates.end(); ++i) {
+			const String &tmp = _lowercaseList[*i];
 			bool matches = true;
 			tok.reset();
 			while (!tok.empty()) {
@@ -705,8 +725,8 @@ void ListWidget::setFilter(const String &filter, bool redraw) {
 			}
 
 			if (matches) {
-				_list.push_back(*i);
-				_listIndex.push_back(n);
+				_list.push_back(_dataList[*i]);
+				_listIndex.push_back(*i);
 			}
 		}
 	}
@@ -78,6 +78,7 @@ protected:
 	int				_scrollBarWidth;
 
 	String			_filter;
+	StringArray		_lowercaseList;	///< _dataList in lower case, built when filtering
 	bool			_quickSelect;
 
 	uint32			_cmd;
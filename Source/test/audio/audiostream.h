@@ -35,6 +35,53 @@ public:
 	}
 
 private:
+	/**
+	 * Reads from a stream the way the rate converters do: samples are
+	 * used in place where the stream allows it, and read otherwise.
+	 */
+	static int readViaPeek(Audio::AudioStream *stream, int16 *buffer, const int numSamples) {
+		int total = 0;
+		while (total < numSamples) {
+			const int16 *ptr;
+			int len = stream->peekBuffer(ptr);
+			if (len > 0) {
+				len = MIN(len, numSamples - total);
+				memcpy(buffer + total, ptr, len * sizeof(int16));
+				stream->consumeBuffer(len);
+			} else {
+				len = stream->readBuffer(buffer + total, MIN(numSamples - total, 100));
+				if (len <= 0)
+					break;
+			}
+			total += len;
+		}
+		return total;
+	}
+
+	template<typename T>
+	void testPeekBuffer(const int sampleRate, const bool isStereo) {
+		const int secondLength = sampleRate * (isStereo ? 2 : 1);
+
+		int16 *sine = 0;
+		Audio::SeekableAudioStream *s = createSineStream<T>(sampleRate, 1, &sine, false, isStereo);
+		Audio::LoopingAudioStream *loop = new Audio::LoopingAudioStream(s, 3);
+
+		int16 *buffer = new int16[secondLength * 4];
+
+		// Mix direct access and regular reads
+		TS_ASSERT_EQUALS(readViaPeek(loop, buffer, 1000), 1000);
+		TS_ASSERT_EQUALS(loop->readBuffer(buffer + 1000, 10), 10);
+		TS_ASSERT_EQUALS(readViaPeek(loop, buffer + 1010, secondLength * 4), secondLength * 3 - 1010);
+		TS_ASSERT_EQUALS(loop->endOfStream(), true);
+
+		for (int i = 0; i < 3; ++i)
+			TS_ASSERT_EQUALS(memcmp(buffer + secondLength * i, sine, secondLength * sizeof(int16)), 0);
+
+		delete[] buffer;
+		delete loop;
+		delete[] sine;
+	}
+
 	void testLoopingAudioStreamFixedIter(const int sampleRate, const bool isStereo) {
 		const int secondLength = sampleRate * (isStereo ? 2 : 1);
 
@@ -101,6 +148,39 @@ private:
 	}
 
 public:
+	void test_peek_buffer_native() {
+		testPeekBuffer<int16>(11025, false);
+		testPeekBuffer<int16>(22050, true);
+	}
+
+	void test_peek_buffer_converted() {
+		testPeekBuffer<uint8>(11025, false);
+		testPeekBuffer<uint8>(22050, true);
+	}
+
+	void test_peek_buffer_sub_looping() {
+		const int sampleRate = 11025;
+		int16 *sine = 0;
+		Audio::SeekableAudioStream *s = createSineStream<int16>(sampleRate, 2, &sine, false, true);
+		const Audio::Timestamp loopStart(500, 1000), loopEnd(1500, 1000);
+		Audio::SubLoopingAudioStream *loop = new Audio::SubLoopingAudioStream(s, 2, loopStart, loopEnd);
+
+		const int startPos = Audio::convertTimeToStreamPos(loopStart, sampleRate, true).totalNumberOfFrames();
+		const int endPos = Audio::convertTimeToStreamPos(loopEnd, sampleRate, true).totalNumberOfFrames();
+		const int loopLength = endPos - startPos;
+
+		int16 *buffer = new int16[endPos + loopLength + 100];
+		TS_ASSERT_EQUALS(readViaPeek(loop, buffer, endPos + loopLength + 100), endPos + loopLength);
+		TS_ASSERT_EQUALS(loop->endOfStream(), true);
+
+		TS_ASSERT_EQUALS(memcmp(buffer, sine, endPos * sizeof(int16)), 0);
+		TS_ASSERT_EQUALS(memcmp(buffer + endPos, sine + startPos, loopLength * sizeof(int16)), 0);
+
+		delete[] buffer;
+		delete loop;
+		delete[] sine;
+	}
+
 	void test_looping_audio_stream_mono_11025_fixed_iter() {
 		testLoopingAudioStreamFixedIter(11025, false);
 	}
@@ -0,0 +1,96 @@
+#include <cxxtest/TestSuite.h>
+
+#include "audio/audiostream.h"
+#include "audio/mixer_intern.h"
+
+#include "helper.h"
+#include "test/system.h"
+
+#include <time.h>
+
+class MixerTestSuite : public CxxTest::TestSuite {
+	OSystem *_oldSystem;
+	TestSystem _system;
+
+	enum {
+		kChannels = 16,
+		kFrames = 1024
+	};
+
+public:
+	void setUp() {
+		_oldSystem = g_system;
+		g_system = &_system;
+	}
+
+	void tearDown() {
+		g_system = _oldSystem;
+	}
+
+	void test_finished_channel() {
+		Audio::MixerImpl mixer(&_system, 44100);
+		mixer.setReady(true);
+
+		Audio::SoundHandle handle;
+		mixer.playStream(Audio::Mixer::kSFXSoundType, &handle, createSineStream<int16>(44100, 1, 0, false, false),
+		                 -1, 100, 20, DisposeAfterUse::YES, false, false);
+		TS_ASSERT(mixer.isSoundHandleActive(handle));
+		TS_ASSERT_EQUALS(mixer.getChannelVolume(handle), 100);
+		TS_ASSERT_EQUALS(mixer.getChannelBalance(handle), 20);
+
+		// The audio thread frees the slot of the channel once it finished
+		int16 *buffer = new int16[2 * kFrames];
+		for (int i = 0; i < 44100 / kFrames + 2; ++i)
+			mixer.mixCallback((byte *)buffer, 4 * kFrames);
+		delete[] buffer;
+
+		TS_ASSERT(!mixer.isSoundHandleActive(handle));
+		TS_ASSERT_EQUALS(mixer.getChannelVolume(handle), 0);
+		TS_ASSERT_EQUALS(mixer.getChannelBalance(handle), 0);
+
+		// Changes to the stale handle must not affect the next channel
+		mixer.setChannelVolume(handle, 50);
+		Audio::SoundHandle next;
+		mixer.playStream(Audio::Mixer::kSFXSoundType, &next, createSineStream<int16>(44100, 1, 0, false, false),
+		                 -1, 200, 0, DisposeAfterUse::YES, false, false);
+		TS_ASSERT_EQUALS(mixer.getChannelVolume(next), 200);
+		TS_ASSERT_EQUALS(mixer.getChannelVolume(handle), 0);
+	}
+
+	/**
+	 * Reports the time mixCallback takes for a callback of 1024 frames with
+	 * 16 looping channels at 22050 Hz, while the volume of every channel is
+	 * changed between two callbacks like during a fade.
+	 */
+	void test_mix_callback_benchmark() {
+		Audio::MixerImpl mixer(&_system, 44100);
+		mixer.setReady(true);
+
+		Audio::SoundHandle handles[kChannels];
+		for (int i = 0; i < kChannels; ++i) {
+			Audio::AudioStream *stream = new Audio::LoopingAudioStream(createSineStream<int16>(22050, 1, 0, false, false), 0);
+			mixer.playStream(Audio::Mixer::kSFXSoundType, &handles[i], stream, -1, Audio::Mixer::kMaxChannelVolume, 0,
+			                 DisposeAfterUse::YES, false, false);
+		}
+
+		const int kIterations = 44100 * 10 / kFrames;
+		int16 *buffer = new int16[2 * kFrames];
+
+		const clock_t start = (clock)();
+		for (int n = 0; n < kIterations; ++n) {
+			for (int i = 0; i < kChannels; ++i)
+				mixer.setChannelVolume(handles[i], n & 0xFF);
+			mixer.mixCallback((byte *)buffer, 4 * kFrames);
+		}
+		const double seconds = (double)((clock)() - start) / CLOCKS_PER_SEC;
+
+		for (int i = 0; i < kChannels; ++i)
+			TS_ASSERT(mixer.isSoundHandleActive(handles[i]));
+
+		TS_TRACE(Common::String::format("mixCallback %d channels x %d frames: %.1f us per callback",
+			kChannels, kFrames, seconds * 1000000.0 / kIterations).c_str());
+
+		delete[] buffer;
+		mixer.stopAll();
+	}
+};
@@ -0,0 +1,97 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/scummsys.h"
+#include "common/str.h"
+
+#ifdef USE_MT32EMU
+
+// prevents load of unused FileStream API because it includes a standard library
+// include, see audio/softsynth/mt32.cpp
+#define MT32EMU_FILE_STREAM_H
+
+#include "audio/softsynth/mt32/c_interface/cpp_interface.h"
+
+#include <time.h>
+
+#endif
+
+class MT32TestSuite : public CxxTest::TestSuite
+{
+public:
+	/**
+	 * Renders a fixed sequence of chords on all melodic parts and reports
+	 * how many partials the emulator can render in real time. The ROMs are
+	 * not shipped, so the benchmark only runs when MT32_CONTROL.ROM and
+	 * MT32_PCM.ROM are found in the current directory.
+	 */
+	void test_render_benchmark() {
+#ifdef USE_MT32EMU
+		MT32Emu::Service service;
+		service.createContext();
+		if (service.addROMFile("MT32_CONTROL.ROM") != MT32EMU_RC_ADDED_CONTROL_ROM ||
+		    service.addROMFile("MT32_PCM.ROM") != MT32EMU_RC_ADDED_PCM_ROM) {
+			TS_TRACE("MT-32 ROMs not found, skipping the render benchmark");
+			service.freeContext();
+			return;
+		}
+		TS_ASSERT_EQUALS(service.openSynth(), MT32EMU_RC_OK);
+		service.setMIDIDelayMode(MT32Emu::MIDIDelayMode_IMMEDIATE);
+
+		const uint32 rate = service.getActualStereoOutputSamplerate();
+		const uint32 partialCount = service.getPartialCount();
+		const int kSeconds = 10;
+		const int kChunkFrames = 512;
+		const int kChordFrames = rate / 4;
+		const byte chord[] = { 48, 55, 60, 64 };
+
+		int16 *buffer = new int16[2 * kChunkFrames];
+		byte *partialStates = new byte[(partialCount + 3) / 4];
+
+		// Melodic parts 1-8 listen on MIDI channels 2-9
+		for (int channel = 1; channel <= 8; ++channel)
+			service.playMsg(0xC0 | channel | ((channel * 11) << 8));
+
+		double partialFrames = 0;
+		clock_t renderTime = 0;
+		int chordPos = 0, chordNum = 0;
+		for (int frame = 0; frame < kSeconds * (int)rate; frame += kChunkFrames) {
+			if (frame >= chordPos) {
+				// Release the previous chord and play the next one,
+				// transposed, on every part
+				for (int channel = 1; channel <= 8; ++channel) {
+					for (uint i = 0; i < ARRAYSIZE(chord); ++i) {
+						if (chordNum)
+							service.playMsg(0x80 | channel | ((chord[i] + (chordNum - 1) % 12) << 8));
+						service.playMsg(0x90 | channel | ((chord[i] + chordNum % 12) << 8) | (100 << 16));
+					}
+				}
+				++chordNum;
+				chordPos += kChordFrames;
+			}
+
+			const clock_t start = (clock)();
+			service.renderBit16s(buffer, kChunkFrames);
+			renderTime += (clock)() - start;
+
+			service.getPartialStates(partialStates);
+			uint activePartials = 0;
+			for (uint32 i = 0; i < partialCount; ++i) {
+				if ((partialStates[i >> 2] >> ((i & 3) * 2)) & 3)
+					++activePartials;
+			}
+			partialFrames += (double)activePartials * kChunkFrames;
+		}
+
+		const double renderSeconds = (double)renderTime / CLOCKS_PER_SEC;
+		const double audioSeconds = kSeconds;
+		TS_TRACE(Common::String::format("MT-32 render %d s at %u Hz: %.0f ms (%.1fx real time), %.1f active partials on average, %.0f partials/s",
+			kSeconds, rate, renderSeconds * 1000, audioSeconds / renderSeconds,
+			partialFrames / rate / audioSeconds, partialFrames / rate / renderSeconds).c_str());
+
+		delete[] buffer;
+		delete[] partialStates;
+		service.closeSynth();
+		service.freeContext();
+#endif
+	}
+};
@@ -0,0 +1,365 @@
+#include <cxxtest/TestSuite.h>
+
+#include "audio/audiostream.h"
+#include "audio/decoders/raw.h"
+#include "audio/mixer.h"
+#include "audio/rate.h"
+
+#include "common/memstream.h"
+
+#include "helper.h"
+
+#include <time.h>
+
+/**
+ * Hides the direct access interface of a stream, so that it is consumed
+ * through readBuffer only.
+ */
+class ReadBufferOnlyStream : public Audio::AudioStream {
+public:
+	ReadBufferOnlyStream(Audio::AudioStream *parent) : _parent(parent) {}
+	~ReadBufferOnlyStream() { delete _parent; }
+
+	int readBuffer(int16 *buffer, const int numSamples) { return _parent->readBuffer(buffer, numSamples); }
+	bool isStereo() const { return _parent->isStereo(); }
+	int getRate() const { return _parent->getRate(); }
+	bool endOfData() const { return _parent->endOfData(); }
+	bool endOfStream() const { return _parent->endOfStream(); }
+
+private:
+	Audio::AudioStream *_parent;
+};
+
+class RateConverterTestSuite : public CxxTest::TestSuite
+{
+private:
+	enum {
+		kChannels = 32,
+		kFrames = 1024,
+		kIterations = 20
+	};
+
+	static Audio::SeekableAudioStream *createToneStream(const int sampleRate, const double freq, const int amplitude, const int frames, const bool isStereo) {
+		const int channels = isStereo ? 2 : 1;
+		byte *data = (byte *)malloc(frames * channels * 2);
+
+		for (int i = 0; i < frames; ++i) {
+			const int16 val = (int16)(amplitude * sin(2 * M_PI * freq * i / sampleRate));
+			for (int c = 0; c < channels; ++c)
+				WRITE_LE_UINT16(data + (i * channels + c) * 2, val);
+		}
+
+		Common::SeekableReadStream *stream = new Common::MemoryReadStream(data, frames * channels * 2, DisposeAfterUse::YES);
+		return Audio::makeRawStream(stream, sampleRate, Audio::FLAG_16BITS | Audio::FLAG_LITTLE_ENDIAN | (isStereo ? Audio::FLAG_STEREO : 0));
+	}
+
+	/**
+	 * Resamples a tone with the sinc resampler, and returns the largest
+	 * deviation from the given expected amplitude and frequency, skipping
+	 * the filter warm-up at the start.
+	 */
+	static int sincToneError(const int inRate, const int outRate, const double freq, const double expectedAmplitude) {
+		Audio::SeekableAudioStream *s = createToneStream(inRate, freq, 16000, inRate / 4, false);
+		Audio::RateConverter *c = Audio::makeRateConverter(inRate, outRate, false, false, Audio::kResamplerSinc);
+
+		const int frames = outRate / 8;
+		int16 *out = new int16[2 * frames];
+		memset(out, 0, 2 * frames * sizeof(int16));
+		const int res = c->flow(*s, out, frames, Audio::Mixer::kMaxMixerVolume, Audio::Mixer::kMaxMixerVolume);
+
+		int maxError = (res == frames) ? 0 : 0x7FFF;
+		for (int i = 64; i < res; ++i) {
+			const int expected = (int)(expectedAmplitude * sin(2 * M_PI * freq * i / outRate));
+			maxError = MAX(maxError, ABS(out[2 * i] - expected));
+			maxError = MAX(maxError, ABS(out[2 * i] - out[2 * i + 1]));
+		}
+
+		delete[] out;
+		delete c;
+		delete s;
+		return maxError;
+	}
+
+	void flowTestTemplate(const int inRate, const int outRate, const bool isStereo) {
+		Audio::SeekableAudioStream *s1 = createSineStream<int16>(inRate, 1, 0, false, isStereo);
+		Audio::SeekableAudioStream *s2 = createSineStream<int16>(inRate, 1, 0, false, isStereo);
+		Audio::RateConverter *c1 = Audio::makeRateConverter(inRate, outRate, isStereo);
+		Audio::RateConverter *c2 = Audio::makeRateConverter(inRate, outRate, isStereo);
+
+		int16 out16[2 * 300];
+		int32 out32[2 * 300];
+		int16 clamped[2 * 300];
+
+		for (int i = 0; i < 10; ++i) {
+			memset(out16, 0, sizeof(out16));
+			memset(out32, 0, sizeof(out32));
+
+			const int res16 = c1->flow(*s1, out16, 300, 200, 100);
+			const int res32 = c2->flowAccumulate(*s2, out32, 300, 200, 100);
+			TS_ASSERT_EQUALS(res16, res32);
+
+			Audio::clampMixBuffer(out32, clamped, 2 * res32);
+			TS_ASSERT_EQUALS(memcmp(out16, clamped, 2 * res16 * sizeof(int16)), 0);
+		}
+
+		delete c1;
+		delete c2;
+		delete s1;
+		delete s2;
+	}
+
+public:
+	void test_flow_accumulate_copy() {
+		flowTestTemplate(22050, 22050, false);
+		flowTestTemplate(22050, 22050, true);
+	}
+
+	void test_flow_accumulate_simple() {
+		flowTestTemplate(44100, 22050, false);
+		flowTestTemplate(44100, 22050, true);
+	}
+
+	void test_flow_accumulate_linear() {
+		flowTestTemplate(11025, 22050, false);
+		flowTestTemplate(11025, 44100, true);
+	}
+
+	void test_sinc_dc() {
+		// A constant signal must pass through unchanged
+		static const int rates[][2] = { { 11025, 44100 }, { 22050, 48000 }, { 48000, 44100 }, { 44100, 22050 }, { 12345, 44100 } };
+
+		for (int r = 0; r < ARRAYSIZE(rates); ++r) {
+			const int frames = rates[r][0] / 10;
+			byte *data = (byte *)malloc(frames * 2);
+			for (int i = 0; i < frames; ++i)
+				WRITE_LE_UINT16(data + i * 2, 10000);
+			Audio::SeekableAudioStream *s = Audio::makeRawStream(new Common::MemoryReadStream(data, frames * 2, DisposeAfterUse::YES),
+			                                                     rates[r][0], Audio::FLAG_16BITS | Audio::FLAG_LITTLE_ENDIAN);
+			Audio::RateConverter *c = Audio::makeRateConverter(rates[r][0], rates[r][1], false, false, Audio::kResamplerSinc);
+
+			int16 out[2 * 1000];
+			memset(out, 0, sizeof(out));
+			TS_ASSERT_EQUALS(c->flow(*s, out, 1000, Audio::Mixer::kMaxMixerVolume, Audio::Mixer::kMaxMixerVolume), 1000);
+			for (int i = 64; i < 1000; ++i)
+				TS_ASSERT_EQUALS(out[2 * i], 10000);
+
+			delete c;
+			delete s;
+		}
+	}
+
+	void test_sinc_tail() {
+		// The output of a finite stream has to cover all of its input,
+		// including the last half of the filter window
+		static const int rates[][2] = { { 22050, 44100 }, { 11025, 48000 }, { 48000, 22050 } };
+
+		for (int r = 0; r < ARRAYSIZE(rates); ++r) {
+			const int frames = 1000;
+			byte *data = (byte *)malloc(frames * 2);
+			for (int i = 0; i < frames; ++i)
+				WRITE_LE_UINT16(data + i * 2, 10000);
+			Audio::SeekableAudioStream *s = Audio::makeRawStream(new Common::MemoryReadStream(data, frames * 2, DisposeAfterUse::YES),
+			                                                     rates[r][0], Audio::FLAG_16BITS | Audio::FLAG_LITTLE_ENDIAN);
+			Audio::RateConverter *c = Audio::makeRateConverter(rates[r][0], rates[r][1], false, false, Audio::kResamplerSinc);
+
+			// Flow in small chunks, like the mixer does
+			const int expected = frames * rates[r][1] / rates[r][0];
+			int16 *out = new int16[2 * (expected + 256)];
+			memset(out, 0, 2 * (expected + 256) * sizeof(int16));
+			int total = 0;
+			while (total < expected + 128) {
+				const int res = c->flow(*s, out + 2 * total, 64, Audio::Mixer::kMaxMixerVolume, Audio::Mixer::kMaxMixerVolume);
+				if (res <= 0)
+					break;
+				total += res;
+			}
+
+			TS_ASSERT(s->endOfStream());
+			TS_ASSERT(!c->hasPendingOutput());
+			TS_ASSERT_LESS_THAN_EQUALS(expected - 2, total);
+			TS_ASSERT_LESS_THAN_EQUALS(total, expected + 2);
+
+			// Shortly before the end the signal is still at full level
+			const int last = expected - 8 * rates[r][1] / rates[r][0] - 1;
+			TS_ASSERT_LESS_THAN(ABS(out[2 * last] - 10000), 500);
+
+			delete[] out;
+			delete c;
+			delete s;
+		}
+	}
+
+	void test_sinc_tone() {
+		// Tones well below the Nyquist frequency are reproduced accurately
+		TS_ASSERT_LESS_THAN(sincToneError(22050, 48000, 1000.0, 16000.0), 160);
+		TS_ASSERT_LESS_THAN(sincToneError(11025, 44100, 2000.0, 16000.0), 160);
+		TS_ASSERT_LESS_THAN(sincToneError(48000, 22050, 3000.0, 16000.0), 160);
+	}
+
+	void test_sinc_aliasing() {
+		// A tone above the output Nyquist frequency must be filtered out
+		// instead of being mirrored into the audible range
+		TS_ASSERT_LESS_THAN(sincToneError(48000, 22050, 15000.0, 0.0), 400);
+		TS_ASSERT_LESS_THAN(sincToneError(44100, 11025, 7000.0, 0.0), 400);
+	}
+
+	void test_clamp_mix_buffer() {
+		// Odd length, so both the vectorized and the scalar tail are used
+		const int32 in[19] = {
+			0, 1, -1, 32767, 32768, -32768, -32769, 100000,
+			-100000, 12345, -12345, 70000, -70000, 2, -2, 40000,
+			-40000, 32766, -32767
+		};
+		const int16 expected[19] = {
+			0, 1, -1, 32767, 32767, -32768, -32768, 32767,
+			-32768, 12345, -12345, 32767, -32768, 2, -2, 32767,
+			-32768, 32766, -32767
+		};
+		int16 out[19];
+
+		Audio::clampMixBuffer(in, out, ARRAYSIZE(in));
+		for (int i = 0; i < ARRAYSIZE(in); ++i) {
+#ifdef OUTPUT_UNSIGNED_AUDIO
+			TS_ASSERT_EQUALS(out[i], (int16)(expected[i] ^ 0x8000));
+#else
+			TS_ASSERT_EQUALS(out[i], expected[i]);
+#endif
+		}
+	}
+
+	/**
+	 * Compares the per sample clampedAdd mixing path with summing into a
+	 * 32-bit buffer followed by clampMixBuffer, which is what
+	 * MixerImpl::mixCallback does for each callback. Reports the time
+	 * spent per callback of 1024 frames with 32 active channels.
+	 */
+	void test_mix_benchmark() {
+		Audio::SeekableAudioStream *streams[2][kChannels];
+		Audio::RateConverter *converters[2][kChannels];
+		for (int p = 0; p < 2; ++p) {
+			for (int i = 0; i < kChannels; ++i) {
+				streams[p][i] = createSineStream<int16>(22050, 1, 0, false, false);
+				converters[p][i] = Audio::makeRateConverter(22050, 44100, false);
+			}
+		}
+
+		int16 *legacy = new int16[2 * kFrames];
+		int16 *output = new int16[2 * kFrames];
+		int32 *accum = new int32[2 * kFrames];
+
+		// Low volume, so that the sum of all channels does not clip and
+		// both paths have to produce identical output.
+		const Audio::st_volume_t vol = 8;
+
+		clock_t legacyTime = 0, accumTime = 0;
+		for (int n = 0; n < kIterations; ++n) {
+			clock_t start = (clock)();
+			memset(legacy, 0, 2 * kFrames * sizeof(int16));
+			for (int i = 0; i < kChannels; ++i)
+				converters[0][i]->flow(*streams[0][i], legacy, kFrames, vol, vol);
+			legacyTime += (clock)() - start;
+
+			start = (clock)();
+			memset(accum, 0, 2 * kFrames * sizeof(int32));
+			for (int i = 0; i < kChannels; ++i)
+				converters[1][i]->flowAccumulate(*streams[1][i], accum, kFrames, vol, vol);
+			Audio::clampMixBuffer(accum, output, 2 * kFrames);
+			accumTime += (clock)() - start;
+
+			TS_ASSERT_EQUALS(memcmp(legacy, output, 2 * kFrames * sizeof(int16)), 0);
+		}
+
+		TS_TRACE(Common::String::format("mix %d channels x %d frames: clampedAdd %.1f us, accumulate+clamp %.1f us",
+			kChannels, kFrames,
+			legacyTime * 1000000.0 / CLOCKS_PER_SEC / kIterations,
+			accumTime * 1000000.0 / CLOCKS_PER_SEC / kIterations).c_str());
+
+		delete[] legacy;
+		delete[] output;
+		delete[] accum;
+		for (int p = 0; p < 2; ++p) {
+			for (int i = 0; i < kChannels; ++i) {
+				delete converters[p][i];
+				delete streams[p][i];
+			}
+		}
+	}
+
+	/**
+	 * Reports the mixing cost per channel and callback of 1024 frames for
+	 * a looping raw stream, once using the samples in place and once
+	 * through readBuffer. Both have to produce the same output.
+	 */
+	void test_peek_benchmark() {
+		static const int rates[2] = { 44100, 22050 };
+
+		for (int r = 0; r < 2; ++r) {
+			Audio::AudioStream *streams[2];
+			Audio::RateConverter *converters[2];
+			int32 *out[2];
+			clock_t time[2];
+
+			for (int p = 0; p < 2; ++p) {
+				streams[p] = new Audio::LoopingAudioStream(createToneStream(rates[r], 440.0, 16000, rates[r] / 2, true), 0);
+				if (p == 1)
+					streams[p] = new ReadBufferOnlyStream(streams[p]);
+				converters[p] = Audio::makeRateConverter(rates[r], 44100, true);
+				out[p] = new int32[2 * kFrames];
+				time[p] = 0;
+			}
+
+			for (int n = 0; n < kIterations * kChannels; ++n) {
+				for (int p = 0; p < 2; ++p) {
+					memset(out[p], 0, 2 * kFrames * sizeof(int32));
+					const clock_t start = (clock)();
+					TS_ASSERT_EQUALS(converters[p]->flowAccumulate(*streams[p], out[p], kFrames, 128, 128), kFrames);
+					time[p] += (clock)() - start;
+				}
+				TS_ASSERT_EQUALS(memcmp(out[0], out[1], 2 * kFrames * sizeof(int32)), 0);
+			}
+
+			TS_TRACE(Common::String::format("looping raw stream %d -> 44100 Hz, per channel and %d frames: in place %.2f us, readBuffer %.2f us",
+				rates[r], kFrames,
+				time[0] * 1000000.0 / CLOCKS_PER_SEC / (kIterations * kChannels),
+				time[1] * 1000000.0 / CLOCKS_PER_SEC / (kIterations * kChannels)).c_str());
+
+			for (int p = 0; p < 2; ++p) {
+				delete[] out[p];
+				delete converters[p];
+				delete streams[p];
+			}
+		}
+	}
+
+	/**
+	 * Reports the CPU time needed to resample one second of stereo audio
+	 * from 22050 to 48000 Hz with the linear and the sinc resampler.
+	 */
+	void test_resampler_benchmark() {
+		const Audio::ResamplerQuality qualities[2] = { Audio::kResamplerLinear, Audio::kResamplerSinc };
+		double usecs[2];
+		int32 *out = new int32[2 * 48000];
+
+		for (int q = 0; q < 2; ++q) {
+			Audio::SeekableAudioStream *s = createToneStream(22050, 1000.0, 16000, 22050, true);
+			Audio::RateConverter *c = Audio::makeRateConverter(22050, 48000, true, false, qualities[q]);
+
+			memset(out, 0, 2 * 48000 * sizeof(int32));
+			const clock_t start = (clock)();
+			int res = 0;
+			for (int i = 0; i < 48000; i += kFrames)
+				res += c->flowAccumulate(*s, out + 2 * i, MIN<int>(kFrames, 48000 - i), Audio::Mixer::kMaxMixerVolume, Audio::Mixer::kMaxMixerVolume);
+			usecs[q] = ((clock)() - start) * 1000000.0 / CLOCKS_PER_SEC;
+
+			// Both stop a few samples short of the end of the input
+			TS_ASSERT_LESS_THAN(47900, res);
+
+			delete c;
+			delete s;
+		}
+
+		TS_TRACE(Common::String::format("resample 1s stereo 22050 -> 48000 Hz: linear %.0f us, sinc %.0f us", usecs[0], usecs[1]).c_str());
+
+		delete[] out;
+	}
+};
@@ -0,0 +1,85 @@
+#include <cxxtest/TestSuite.h>
+
+#include "audio/ringbuffer.h"
+#include "common/str.h"
+#include "common/util.h"
+
+class SampleRingBufferTestSuite : public CxxTest::TestSuite
+{
+public:
+	void test_allocate() {
+		Audio::SampleRingBuffer ring;
+		TS_ASSERT_EQUALS(ring.size(), 0u);
+
+		ring.allocate(1000);
+		TS_ASSERT_EQUALS(ring.size(), 1024u);
+		TS_ASSERT_EQUALS(ring.getBuffered(), 0u);
+
+		ring.allocate(2048);
+		TS_ASSERT_EQUALS(ring.size(), 2048u);
+
+		ring.free();
+		TS_ASSERT_EQUALS(ring.size(), 0u);
+	}
+
+	void test_read_empty() {
+		Audio::SampleRingBuffer ring;
+		ring.allocate(64);
+
+		int16 buffer[16];
+		TS_ASSERT_EQUALS(ring.read(buffer, 16), 0u);
+		TS_ASSERT_EQUALS(ring.getBuffered(), 0u);
+	}
+
+	/**
+	 * A producer writing chunks the way the MT-32 renderer does, and a
+	 * consumer reading odd amounts like a mixer callback. The consumer has
+	 * to get every sample exactly once and in order, across many wrap
+	 * arounds of the buffer, and never more than was produced.
+	 */
+	void test_producer_consumer() {
+		const uint32 kChunkSize = 32;
+		const uint32 kTarget = 96;
+		const uint32 kReadSizes[] = { 1, 7, 50, 13, 128, 31, 64, 3 };
+
+		Audio::SampleRingBuffer ring;
+		ring.allocate(kTarget * 2);
+		TS_ASSERT_EQUALS(ring.size(), 256u);
+
+		int16 produced = 0, consumed = 0;
+		int16 buffer[128];
+		for (int i = 0; i < 500; ++i) {
+			// Fill up to the target like the render ahead proc
+			while (ring.getBuffered() < kTarget) {
+				int16 *chunk = ring.beginWrite(kChunkSize);
+				for (uint32 j = 0; j < kChunkSize; ++j)
+					chunk[j] = produced++;
+				ring.endWrite(kChunkSize);
+			}
+			TS_ASSERT_LESS_THAN_EQUALS(ring.getBuffered(), ring.size());
+
+			const uint32 wanted = kReadSizes[i % ARRAYSIZE(kReadSizes)];
+			const uint32 available = ring.getBuffered();
+			const uint32 len = ring.read(buffer, wanted);
+			TS_ASSERT_EQUALS(len, MIN(wanted, available));
+			TS_ASSERT_EQUALS(ring.getBuffered(), available - len);
+
+			for (uint32 j = 0; j < len; ++j) {
+				if (buffer[j] != consumed) {
+					TS_FAIL(Common::String::format("Sample %d read as %d", consumed, buffer[j]).c_str());
+					return;
+				}
+				++consumed;
+			}
+		}
+
+		// Drain what is left
+		uint32 len;
+		while ((len = ring.read(buffer, ARRAYSIZE(buffer))) > 0) {
+			for (uint32 j = 0; j < len; ++j)
+				TS_ASSERT_EQUALS(buffer[j], consumed++);
+		}
+		TS_ASSERT_EQUALS(consumed, produced);
+		TS_ASSERT_EQUALS(ring.getBuffered(), 0u);
+	}
+};
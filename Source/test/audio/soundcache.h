@@ -0,0 +1,134 @@
+#include <cxxtest/TestSuite.h>
+
+#include "audio/soundcache.h"
+
+#include "helper.h"
+#include "test/system.h"
+
+/**
+ * A stream which does not know its length, like those of some compressed
+ * formats.
+ */
+class UnknownLengthStream : public Audio::SeekableAudioStream {
+public:
+	UnknownLengthStream(Audio::SeekableAudioStream *parent) : _parent(parent) {}
+	~UnknownLengthStream() { delete _parent; }
+
+	int readBuffer(int16 *buffer, const int numSamples) { return _parent->readBuffer(buffer, numSamples); }
+	bool isStereo() const { return _parent->isStereo(); }
+	int getRate() const { return _parent->getRate(); }
+	bool endOfData() const { return _parent->endOfData(); }
+	bool seek(const Audio::Timestamp &where) { return _parent->seek(where); }
+	Audio::Timestamp getLength() const { return Audio::Timestamp(0, getRate()); }
+
+private:
+	Audio::SeekableAudioStream *_parent;
+};
+
+class SoundCacheTestSuite : public CxxTest::TestSuite {
+	OSystem *_oldSystem;
+	TestSystem _system;
+
+public:
+	void setUp() {
+		_oldSystem = g_system;
+		g_system = &_system;
+	}
+
+	void tearDown() {
+		Audio::SoundCache::destroy();
+		g_system = _oldSystem;
+	}
+
+	// One second of 16 bit mono sound at the given rate
+	static Audio::SeekableAudioStream *createSound(int rate, int16 **comp = 0) {
+		return createSineStream<int16>(rate, 1, comp, false, false);
+	}
+
+	void test_hit_miss() {
+		Audio::SoundCache &cache = g_soundCache;
+		const Common::String key = Audio::SoundCache::makeKey("sound.dat", 42, "raw");
+
+		TS_ASSERT(!cache.get(key));
+
+		int16 *comp;
+		Audio::SeekableAudioStream *stream = cache.put(key, createSound(11025, &comp));
+		TS_ASSERT(stream);
+		delete stream;
+
+		stream = cache.get(key);
+		TS_ASSERT(stream);
+		TS_ASSERT_EQUALS(stream->getRate(), 11025);
+		TS_ASSERT(!stream->isStereo());
+		TS_ASSERT_EQUALS(stream->getLength().totalNumberOfFrames(), 11025);
+
+		int16 buffer[11025];
+		TS_ASSERT_EQUALS(stream->readBuffer(buffer, 11025), 11025);
+		TS_ASSERT(stream->endOfData());
+		TS_ASSERT(!memcmp(buffer, comp, sizeof(buffer)));
+		delete stream;
+		delete[] comp;
+
+		TS_ASSERT(!cache.get(Audio::SoundCache::makeKey("sound.dat", 43, "raw")));
+
+		const Audio::SoundCache::Stats stats = cache.getStats();
+		TS_ASSERT_EQUALS(stats.hits, 1u);
+		TS_ASSERT_EQUALS(stats.misses, 2u);
+		TS_ASSERT_EQUALS(stats.entries, 1u);
+		TS_ASSERT_EQUALS(stats.memoryUsed, 11025 * sizeof(int16));
+	}
+
+	void test_eviction_while_playing() {
+		Audio::SoundCache &cache = g_soundCache;
+		// Room for four sounds, each of them just fits into a quarter
+		cache.setMemoryLimit(4 * 11025 * sizeof(int16));
+
+		Audio::SeekableAudioStream *playing = cache.put("a", createSound(11025));
+		TS_ASSERT(playing);
+		for (int i = 0; i < 3; ++i)
+			delete cache.put(Common::String::format("%d", i), createSound(11025));
+
+		// The budget is used up, the sound still playing must survive while
+		// the least recently used idle one is evicted instead
+		delete cache.put("b", createSound(11025));
+		Audio::SoundCache::Stats stats = cache.getStats();
+		TS_ASSERT_EQUALS(stats.evictions, 1u);
+		TS_ASSERT_EQUALS(stats.entries, 4u);
+
+		Audio::SeekableAudioStream *stream = cache.get("0");
+		TS_ASSERT(!stream);
+		delete stream;
+
+		int16 buffer[1024];
+		TS_ASSERT_EQUALS(playing->readBuffer(buffer, 1024), 1024);
+
+		// Clearing the cache must not free a sound still playing
+		cache.clear();
+		TS_ASSERT_EQUALS(cache.getStats().entries, 0u);
+		TS_ASSERT_EQUALS(playing->readBuffer(buffer, 1024), 1024);
+		delete playing;
+
+		TS_ASSERT(!cache.get("a"));
+	}
+
+	void test_oversize_pass_through() {
+		Audio::SoundCache &cache = g_soundCache;
+		cache.setMemoryLimit(4 * 11025 * sizeof(int16));
+
+		// Larger than a quarter of the budget, passed through untouched
+		Audio::SeekableAudioStream *sound = createSound(22050);
+		TS_ASSERT_EQUALS(cache.put("large", sound), sound);
+		TS_ASSERT_EQUALS(sound->getLength().totalNumberOfFrames(), 22050);
+		delete sound;
+
+		// The size of sounds of unknown length cannot be checked up front
+		sound = new UnknownLengthStream(createSound(8000));
+		TS_ASSERT_EQUALS(cache.put("unknown", sound), sound);
+		TS_ASSERT(!sound->endOfData());
+		delete sound;
+
+		const Audio::SoundCache::Stats stats = cache.getStats();
+		TS_ASSERT_EQUALS(stats.entries, 0u);
+		TS_ASSERT_EQUALS(stats.memoryUsed, 0u);
+	}
+};
@@ -0,0 +1,169 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/archive.h"
+#include "common/memstream.h"
+#include "common/str-array.h"
+
+/**
+ * A minimal in-memory archive which counts how often it is asked for files.
+ * A broken archive claims to have its files but fails to open them.
+ */
+class CountingArchive : public Common::Archive {
+	Common::StringArray _names;
+
+public:
+	mutable int _lookups;
+	mutable int _opens;
+	bool _broken;
+
+	CountingArchive(const char *name1, const char *name2 = nullptr) : _lookups(0), _opens(0), _broken(false) {
+		_names.push_back(name1);
+		if (name2)
+			_names.push_back(name2);
+	}
+
+	virtual bool hasFile(const Common::String &name) const {
+		++_lookups;
+		for (uint i = 0; i < _names.size(); ++i) {
+			if (_names[i].equalsIgnoreCase(name))
+				return true;
+		}
+		return false;
+	}
+
+	virtual int listMembers(Common::ArchiveMemberList &list) const {
+		for (uint i = 0; i < _names.size(); ++i)
+			list.push_back(Common::ArchiveMemberPtr(new Common::GenericArchiveMember(_names[i], this)));
+		return _names.size();
+	}
+
+	virtual const Common::ArchiveMemberPtr getMember(const Common::String &name) const {
+		if (!hasFile(name))
+			return Common::ArchiveMemberPtr();
+		return Common::ArchiveMemberPtr(new Common::GenericArchiveMember(name, this));
+	}
+
+	virtual Common::SeekableReadStream *createReadStreamForMember(const Common::String &name) const {
+		++_opens;
+		if (_broken || !hasFile(name))
+			return nullptr;
+		// The stream contains the address of the archive, to tell where it came from
+		const CountingArchive *self = this;
+		byte *data = (byte *)malloc(sizeof(self));
+		memcpy(data, &self, sizeof(self));
+		return new Common::MemoryReadStream(data, sizeof(self), DisposeAfterUse::YES);
+	}
+};
+
+class ArchiveTestSuite : public CxxTest::TestSuite {
+	static const CountingArchive *openedFrom(Common::SeekableReadStream *stream) {
+		const CountingArchive *archive = nullptr;
+		if (stream)
+			stream->read(&archive, sizeof(archive));
+		delete stream;
+		return archive;
+	}
+
+public:
+	void test_searchset_priority() {
+		Common::SearchSet set;
+		CountingArchive *low = new CountingArchive("a.dat", "b.dat");
+		CountingArchive *high = new CountingArchive("b.dat", "c.dat");
+		set.add("low", low, 0);
+		set.add("high", high, 10);
+
+		TS_ASSERT_EQUALS(openedFrom(set.createReadStreamForMember("a.dat")), low);
+		TS_ASSERT_EQUALS(openedFrom(set.createReadStreamForMember("B.DAT")), high);
+		TS_ASSERT_EQUALS(openedFrom(set.createReadStreamForMember("c.dat")), high);
+		TS_ASSERT(!set.createReadStreamForMember("d.dat"));
+
+		set.setPriority("low", 20);
+		TS_ASSERT_EQUALS(openedFrom(set.createReadStreamForMember("b.dat")), low);
+
+		set.remove("low");
+		TS_ASSERT(!set.hasFile("a.dat"));
+		TS_ASSERT_EQUALS(openedFrom(set.createReadStreamForMember("b.dat")), high);
+	}
+
+	void test_searchset_lookup_cache() {
+		Common::SearchSet set;
+		CountingArchive *archive1 = new CountingArchive("a.dat");
+		CountingArchive *archive2 = new CountingArchive("b.dat");
+		set.add("archive1", archive1, 10);
+		set.add("archive2", archive2, 0);
+
+		for (int i = 0; i < 10; ++i) {
+			TS_ASSERT(set.hasFile("b.dat"));
+			TS_ASSERT(set.hasFile("B.dat"));
+			TS_ASSERT(!set.hasFile("missing.dat"));
+		}
+		TS_ASSERT(set.getMember("b.dat"));
+		TS_ASSERT(!set.getMember("missing.dat"));
+
+		// Only the first lookup of each name had to ask the archives
+		TS_ASSERT_EQUALS(archive1->_lookups, 2);
+		TS_ASSERT_EQUALS(archive2->_lookups, 3);
+
+		// Modifying a nested set invalidates the outer cache as well
+		Common::SearchSet *nested = new Common::SearchSet();
+		set.add("nested", nested, 20);
+		TS_ASSERT(!set.hasFile("c.dat"));
+		nested->add("archive3", new CountingArchive("c.dat"));
+		TS_ASSERT(set.hasFile("c.dat"));
+	}
+
+	void test_searchset_miss_cache() {
+		Common::SearchSet set;
+		CountingArchive *archive = new CountingArchive("a.dat");
+		set.add("archive", archive);
+
+		TS_ASSERT(!set.hasFile("missing0.dat"));
+		TS_ASSERT(!set.hasFile("missing0.dat"));
+		TS_ASSERT_EQUALS(archive->_lookups, 1);
+
+		// Only a limited number of missing names is remembered
+		for (int i = 1; i <= Common::SearchSet::kMaxCachedMisses; ++i)
+			TS_ASSERT(!set.hasFile(Common::String::format("missing%d.dat", i)));
+		const int lookups = archive->_lookups;
+		TS_ASSERT(!set.hasFile("missing0.dat"));
+		TS_ASSERT_EQUALS(archive->_lookups, lookups + 1);
+
+		// Adding an archive forgets the missing names
+		set.add("other", new CountingArchive("missing0.dat"));
+		TS_ASSERT(set.hasFile("missing0.dat"));
+		set.remove("other");
+		TS_ASSERT(!set.hasFile("missing0.dat"));
+	}
+
+	void test_searchset_open_fallback() {
+		Common::SearchSet set;
+		CountingArchive *broken = new CountingArchive("a.dat");
+		CountingArchive *working = new CountingArchive("a.dat");
+		broken->_broken = true;
+		set.add("broken", broken, 10);
+		set.add("working", working, 0);
+
+		// The archive which failed to open the member is not asked again
+		TS_ASSERT_EQUALS(openedFrom(set.createReadStreamForMember("a.dat")), working);
+		TS_ASSERT_EQUALS(broken->_opens, 1);
+		TS_ASSERT_EQUALS(working->_opens, 1);
+	}
+
+	void test_searchset_list_matching() {
+		Common::SearchSet set;
+		set.add("archive1", new CountingArchive("a.dat", "b.txt"), 10);
+		set.add("archive2", new CountingArchive("c.dat", "a.dat"), 0);
+
+		for (int i = 0; i < 2; ++i) {
+			Common::ArchiveMemberList list;
+			TS_ASSERT_EQUALS(set.listMatchingMembers(list, "*.DAT"), 3);
+			TS_ASSERT_EQUALS(list.size(), 3U);
+			TS_ASSERT_EQUALS(list.front()->getName(), "a.dat");
+			TS_ASSERT_EQUALS(list.back()->getName(), "a.dat");
+		}
+
+		Common::ArchiveMemberList list;
+		set.remove("archive2");
+		TS_ASSERT_EQUALS(set.listMatchingMembers(list, "*.dat"), 1);
+	}
+};
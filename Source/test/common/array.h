@@ -410,8 +410,103 @@ class ArrayTestSuite : public CxxTest::TestSuite
 		TS_ASSERT_EQUALS(array[1], 163);
 	}
 
+#ifdef SCUMMVM_HAS_MOVE_SEMANTICS
+	struct CopyCounter {
+		static int _copies;
+		static int _moves;
+		int _value;
+		explicit CopyCounter(int v = 0) : _value(v) {}
+		CopyCounter(const CopyCounter &other) : _value(other._value) { ++_copies; }
+		CopyCounter(CopyCounter &&other) : _value(other._value) { other._value = -1; ++_moves; }
+		CopyCounter &operator=(const CopyCounter &other) { _value = other._value; ++_copies; return *this; }
+		CopyCounter &operator=(CopyCounter &&other) { _value = other._value; other._value = -1; ++_moves; return *this; }
+		static void reset() { _copies = _moves = 0; }
+	};
+#endif
+
+	void test_growth_moves_elements() {
+#ifdef SCUMMVM_HAS_MOVE_SEMANTICS
+		Common::Array<CopyCounter> array;
+		CopyCounter::reset();
+
+		// Before move support every reallocation copied all elements,
+		// i.e. 8 + 16 + 32 + 64 = 120 extra copies for 100 elements.
+		for (int i = 0; i < 100; ++i)
+			array.push_back(CopyCounter(i));
+
+		TS_ASSERT_EQUALS(CopyCounter::_copies, 0);
+		TS_ASSERT_EQUALS(CopyCounter::_moves, 100 + 8 + 16 + 32 + 64);
+		for (int i = 0; i < 100; ++i)
+			TS_ASSERT_EQUALS(array[i]._value, i);
+
+		CopyCounter::reset();
+		array.reserve(1000);
+		array.insert_at(0, CopyCounter(-5));
+		array.remove_at(50);
+		TS_ASSERT_EQUALS(CopyCounter::_copies, 1);
+		TS_ASSERT_EQUALS(array[0]._value, -5);
+		TS_ASSERT_EQUALS(array[50]._value, 50);
+		TS_ASSERT_EQUALS(array.size(), 100U);
+#endif
+	}
+
+	void test_emplace_back() {
+#ifdef SCUMMVM_HAS_MOVE_SEMANTICS
+		Common::Array<CopyCounter> array;
+		CopyCounter::reset();
+
+		for (int i = 0; i < 20; ++i)
+			array.emplace_back(i);
+
+		TS_ASSERT_EQUALS(CopyCounter::_copies, 0);
+		TS_ASSERT_EQUALS(CopyCounter::_moves, 8 + 16);
+		TS_ASSERT_EQUALS(array.size(), 20U);
+		TS_ASSERT_EQUALS(array[19]._value, 19);
+
+		// Emplacing a copy of an element of the array itself must work,
+		// even if the storage gets reallocated in the process.
+		Common::Array<Common::String> strings;
+		strings.push_back("0123456789012345678901234567890123456789");
+		for (int i = 0; i < 7; ++i)
+			strings.push_back("x");
+		strings.emplace_back(strings[0]);
+		TS_ASSERT_EQUALS(strings.size(), 9U);
+		TS_ASSERT_EQUALS(strings[8], strings[0]);
+
+		strings.emplace(strings.begin() + 1, "y");
+		TS_ASSERT_EQUALS(strings[1], "y");
+		TS_ASSERT_EQUALS(strings[9], strings[0]);
+#endif
+	}
+
+	void test_move_constructor() {
+#ifdef SCUMMVM_HAS_MOVE_SEMANTICS
+		Common::Array<CopyCounter> array1;
+		array1.emplace_back(1);
+		array1.emplace_back(2);
+		CopyCounter::reset();
+
+		Common::Array<CopyCounter> array2(Common::move(array1));
+		TS_ASSERT(array1.empty());
+		TS_ASSERT_EQUALS(array2.size(), 2U);
+		TS_ASSERT_EQUALS(array2[1]._value, 2);
+
+		array1 = Common::move(array2);
+		TS_ASSERT(array2.empty());
+		TS_ASSERT_EQUALS(array1.size(), 2U);
+
+		TS_ASSERT_EQUALS(CopyCounter::_copies, 0);
+		TS_ASSERT_EQUALS(CopyCounter::_moves, 0);
+#endif
+	}
+
 };
 
+#ifdef SCUMMVM_HAS_MOVE_SEMANTICS
+int ArrayTestSuite::CopyCounter::_copies = 0;
+int ArrayTestSuite::CopyCounter::_moves = 0;
+#endif
+
 struct ListElement {
 	int value;
 
@@ -230,5 +230,74 @@ class HashMapTestSuite : public CxxTest::TestSuite
 		TS_ASSERT(found == 16+8+4);
 }
 
+	void test_move() {
+#ifdef SCUMMVM_HAS_MOVE_SEMANTICS
+		Common::HashMap<int, Common::String> map1;
+		for (int i = 0; i < 50; ++i)
+			map1[i] = Common::String::format("value %d is long enough for the heap", i);
+		map1.erase(7);
+		const char *heapStr = map1[3].c_str();
+
+		Common::HashMap<int, Common::String> map2(Common::move(map1));
+		TS_ASSERT(map1.empty());
+		TS_ASSERT_EQUALS(map2.size(), 49U);
+		TS_ASSERT(!map2.contains(7));
+		TS_ASSERT_EQUALS(map2[42], "value 42 is long enough for the heap");
+		// The value buffers were moved, not copied
+		TS_ASSERT_EQUALS(map2[3].c_str(), heapStr);
+
+		// The moved-from map is still usable
+		map1[100] = "one hundred";
+		TS_ASSERT_EQUALS(map1[100], "one hundred");
+
+		map1 = Common::move(map2);
+		TS_ASSERT(map2.empty());
+		TS_ASSERT_EQUALS(map1.size(), 49U);
+		TS_ASSERT(!map1.contains(100));
+		TS_ASSERT_EQUALS(map1[3].c_str(), heapStr);
+#endif
+	}
+
+	void test_emplace() {
+#ifdef SCUMMVM_HAS_MOVE_SEMANTICS
+		Common::HashMap<int, Common::String> container;
+		Common::String &value = container.emplace(1, "abcdef", 3);
+		TS_ASSERT_EQUALS(value, "abc");
+		TS_ASSERT_EQUALS(container[1], "abc");
+
+		container.emplace(1, 'x');
+		TS_ASSERT_EQUALS(container[1], "x");
+		TS_ASSERT_EQUALS(container.size(), 1U);
+
+		TS_ASSERT(!container.tryEmplace(1, "ignored"));
+		TS_ASSERT_EQUALS(container[1], "x");
+		TS_ASSERT(container.tryEmplace(2, "two"));
+		TS_ASSERT_EQUALS(container[2], "two");
+
+		// Force a few rehashes while emplacing
+		for (int i = 3; i < 200; ++i)
+			TS_ASSERT(container.tryEmplace(i, (char)('a' + i % 26)));
+		TS_ASSERT_EQUALS(container.size(), 199U);
+		TS_ASSERT_EQUALS(container[30], "e");
+
+		Common::String str("moved into the map, long enough for the heap");
+		const char *heapStr = str.c_str();
+		container.setVal(500, Common::move(str));
+		TS_ASSERT_EQUALS(container[500].c_str(), heapStr);
+#endif
+	}
+
+	void test_clear_shrink() {
+		Common::HashMap<int, int> container;
+		for (int i = 0; i < 100; ++i)
+			container[i] = i;
+		container.clear(true);
+		TS_ASSERT(container.empty());
+		for (int i = 0; i < 100; ++i)
+			container[i] = -i;
+		TS_ASSERT_EQUALS(container.size(), 100U);
+		TS_ASSERT_EQUALS(container[99], -99);
+	}
+
 	// TODO: Add test cases for iterators, find, ...
 };
@@ -1,6 +1,7 @@
 #include <cxxtest/TestSuite.h>
 
 #include "common/str.h"
+#include "common/memory.h"
 
 class StringTestSuite : public CxxTest::TestSuite
 {
@@ -260,6 +261,33 @@ class StringTestSuite : public CxxTest::TestSuite
 		TS_ASSERT_EQUALS(str2, "01234567890123456789012345678901");
 	}
 
+	void test_move() {
+#ifdef SCUMMVM_HAS_MOVE_SEMANTICS
+		Common::String str("01234567890123456789012345678901");
+		const char *heapStr = str.c_str();
+		Common::String str2(Common::move(str));
+		TS_ASSERT(str.empty());
+		TS_ASSERT_EQUALS(str2, "01234567890123456789012345678901");
+		TS_ASSERT_EQUALS(str2.c_str(), heapStr);
+
+		Common::String str3("short");
+		str3 = Common::move(str2);
+		TS_ASSERT(str2.empty());
+		TS_ASSERT_EQUALS(str3.c_str(), heapStr);
+
+		Common::String str4(str3);
+		str4 = Common::move(str3);
+		TS_ASSERT(str3.empty());
+		TS_ASSERT_EQUALS(str4, "01234567890123456789012345678901");
+
+		str3 = "short";
+		str4 = Common::move(str3);
+		TS_ASSERT_EQUALS(str4, "short");
+		str3 += "reusable";
+		TS_ASSERT_EQUALS(str3, "reusable");
+#endif
+	}
+
 	void test_lastPathComponent() {
 		TS_ASSERT_EQUALS(Common::lastPathComponent("/", '/'), "");
 		TS_ASSERT_EQUALS(Common::lastPathComponent("/foo/bar", '/'), "bar");
@@ -0,0 +1,128 @@
+#include <cxxtest/TestSuite.h>
+
+#include "graphics/dirty_region.h"
+
+class DirtyRegionTestSuite : public CxxTest::TestSuite
+{
+private:
+	static uint rectArea(const Common::Rect &r) {
+		return r.width() * r.height();
+	}
+
+	static bool isCovered(const Common::Array<Common::Rect> &rects, int x, int y) {
+		for (uint i = 0; i < rects.size(); ++i)
+			if (rects[i].contains(x, y))
+				return true;
+		return false;
+	}
+
+	static void checkDisjoint(const Common::Array<Common::Rect> &rects) {
+		for (uint i = 0; i < rects.size(); ++i)
+			for (uint j = i + 1; j < rects.size(); ++j)
+				TS_ASSERT(!rects[i].intersects(rects[j]));
+	}
+
+public:
+	void test_empty() {
+		Graphics::DirtyRegion region;
+		TS_ASSERT(region.isEmpty());
+
+		region.addRect(Common::Rect(10, 10, 10, 20));
+		TS_ASSERT(region.isEmpty());
+		TS_ASSERT_EQUALS(region.getArea(), 0U);
+		TS_ASSERT_EQUALS(region.getRects().size(), 0U);
+	}
+
+	void test_contained() {
+		Graphics::DirtyRegion region;
+		region.addRect(Common::Rect(0, 0, 100, 100));
+		region.addRect(Common::Rect(10, 10, 20, 20));
+		region.addRect(Common::Rect(0, 0, 100, 100));
+
+		TS_ASSERT_EQUALS(region.getRects().size(), 1U);
+		TS_ASSERT_EQUALS(region.getRects()[0], Common::Rect(0, 0, 100, 100));
+		TS_ASSERT_EQUALS(region.getArea(), 10000U);
+		TS_ASSERT_EQUALS(region.getAddedArea(), 20100U);
+
+		region.clear();
+		TS_ASSERT(region.isEmpty());
+		TS_ASSERT_EQUALS(region.getAddedArea(), 0U);
+	}
+
+	void test_merge_nearby() {
+		// The gap costs fewer pixels than uploading a second rect
+		Graphics::DirtyRegion region(1024);
+		region.addRect(Common::Rect(0, 0, 40, 10));
+		region.addRect(Common::Rect(50, 0, 90, 10));
+
+		TS_ASSERT_EQUALS(region.getRects().size(), 1U);
+		TS_ASSERT_EQUALS(region.getRects()[0], Common::Rect(0, 0, 90, 10));
+	}
+
+	void test_keep_distant() {
+		Graphics::DirtyRegion region(16);
+		region.addRect(Common::Rect(0, 0, 10, 10));
+		region.addRect(Common::Rect(300, 200, 310, 210));
+
+		TS_ASSERT_EQUALS(region.getRects().size(), 2U);
+		TS_ASSERT_EQUALS(region.getArea(), 200U);
+	}
+
+	void test_split_overlaps() {
+		// Two long thin rects crossing each other; their bounding rect is
+		// far too large, so the overlap has to be cut out instead
+		Graphics::DirtyRegion region(16);
+		Common::Rect horizontal(0, 100, 320, 110);
+		Common::Rect vertical(150, 0, 160, 200);
+		region.addRect(horizontal);
+		region.addRect(vertical);
+
+		const Common::Array<Common::Rect> &rects = region.getRects();
+		checkDisjoint(rects);
+		TS_ASSERT_EQUALS(region.getArea(), rectArea(horizontal) + rectArea(vertical) - 100);
+
+		for (int y = 0; y < 200; y += 5) {
+			for (int x = 0; x < 320; x += 5) {
+				bool expected = horizontal.contains(x, y) || vertical.contains(x, y);
+				TS_ASSERT_EQUALS(isCovered(rects, x, y), expected);
+			}
+		}
+	}
+
+	void test_random() {
+		uint32 seed = 1;
+		for (int pass = 0; pass < 20; ++pass) {
+			Graphics::DirtyRegion region(64);
+			Common::Array<Common::Rect> added;
+
+			for (int i = 0; i < 12; ++i) {
+				seed = seed * 1103515245 + 12345;
+				int x = (seed >> 16) % 300;
+				seed = seed * 1103515245 + 12345;
+				int y = (seed >> 16) % 180;
+				seed = seed * 1103515245 + 12345;
+				int w = (seed >> 16) % 40 + 1;
+				seed = seed * 1103515245 + 12345;
+				int h = (seed >> 16) % 40 + 1;
+
+				Common::Rect r(x, y, x + w, y + h);
+				region.addRect(r);
+				added.push_back(r);
+			}
+
+			const Common::Array<Common::Rect> &rects = region.getRects();
+			checkDisjoint(rects);
+
+			uint area = 0;
+			for (uint i = 0; i < rects.size(); ++i)
+				area += rectArea(rects[i]);
+			TS_ASSERT_EQUALS(region.getArea(), area);
+
+			// Every added pixel must be covered
+			for (uint i = 0; i < added.size(); ++i)
+				for (int y = added[i].top; y < added[i].bottom; ++y)
+					for (int x = added[i].left; x < added[i].right; ++x)
+						TS_ASSERT(isCovered(rects, x, y));
+		}
+	}
+};
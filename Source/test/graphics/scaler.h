@@ -0,0 +1,167 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/scummsys.h"
+#include "common/str.h"
+
+#include "graphics/scaler.h"
+#include "graphics/scaler/intern.h"
+#include "graphics/scaler/scale2x.h"
+
+#if defined(USE_HQ_SCALERS) && !defined(USE_NASM) && defined(HQ_PATTERN_CHUNK)
+#define TEST_HQ_PATTERNS
+extern "C" uint32 *RGBtoYUV;
+#endif
+
+#if defined(USE_SCALERS) && (defined(SCALE2X_SSE2) || defined(SCALE2X_NEON))
+#define TEST_SCALE2X_SIMD
+#endif
+
+/**
+ * Checks that the SIMD code paths of the scalers produce the same output as
+ * the plain C code they replace, on random input.
+ */
+class ScalerTestSuite : public CxxTest::TestSuite
+{
+private:
+	uint32 _seed;
+
+	uint32 nextRandom() {
+		_seed = _seed * 1103515245 + 12345;
+		return _seed >> 8;
+	}
+
+	/**
+	 * Fill a buffer with random 16 bit pixels. Most pixels are small
+	 * variations of a few base colors, so that the thresholds of the hq
+	 * scalers are crossed in both directions.
+	 */
+	void fillRandom(uint16 *buf, int count, const Graphics::PixelFormat &format) {
+		uint16 base = nextRandom();
+		for (int i = 0; i < count; ++i) {
+			switch (nextRandom() % 8) {
+			case 0:
+				base = nextRandom();
+				buf[i] = base;
+				break;
+			case 1:
+				buf[i] = nextRandom();
+				break;
+			default: {
+				uint8 r, g, b;
+				format.colorToRGB(base, r, g, b);
+				r = CLIP<int>(r + (int)(nextRandom() % 65) - 32, 0, 255);
+				g = CLIP<int>(g + (int)(nextRandom() % 65) - 32, 0, 255);
+				b = CLIP<int>(b + (int)(nextRandom() % 65) - 32, 0, 255);
+				buf[i] = format.RGBToColor(r, g, b);
+				break;
+			}
+			}
+		}
+	}
+
+#ifdef TEST_HQ_PATTERNS
+	void checkHQPatterns(uint32 bitFormat, const Graphics::PixelFormat &format) {
+		InitScalers(bitFormat);
+
+		// Three rows with a spare pixel on either side
+		const int kPitch = HQ_PATTERN_CHUNK + 2;
+		uint16 src[3 * kPitch];
+		int patterns[HQ_PATTERN_CHUNK];
+
+		for (int iteration = 0; iteration < 2000; ++iteration) {
+			fillRandom(src, ARRAYSIZE(src), format);
+			const int count = 1 + iteration % HQ_PATTERN_CHUNK;
+			const uint16 *p = src + kPitch + 1;
+			computeHQPatterns(p, kPitch, RGBtoYUV, count, patterns);
+
+			for (int i = 0; i < count; ++i) {
+				// The pattern computation of the C code of HQ2x and HQ3x
+				const uint16 w5 = p[i];
+				const uint16 w[8] = {
+					p[i - kPitch - 1], p[i - kPitch], p[i - kPitch + 1],
+					p[i - 1],                         p[i + 1],
+					p[i + kPitch - 1], p[i + kPitch], p[i + kPitch + 1]
+				};
+				int pattern = 0;
+				for (int n = 0; n < 8; ++n) {
+					if (w5 != w[n] && diffYUV(RGBtoYUV[w5], RGBtoYUV[w[n]]))
+						pattern |= 1 << n;
+				}
+
+				if (patterns[i] != pattern) {
+					TS_FAIL(Common::String::format("%u: pattern of pixel %d of %d is %02x instead of %02x",
+						bitFormat, i, count, patterns[i], pattern).c_str());
+					DestroyScalers();
+					return;
+				}
+			}
+		}
+
+		DestroyScalers();
+	}
+#endif
+
+#ifdef TEST_SCALE2X_SIMD
+	template<typename T>
+	void checkScale2x(void (*simd)(T *, T *, const T *, const T *, const T *, unsigned),
+	                  void (*def)(T *, T *, const T *, const T *, const T *, unsigned)) {
+		const Graphics::PixelFormat format = Graphics::createPixelFormat<565>();
+		const int kMaxWidth = 70;
+		uint16 rows[3][kMaxWidth];
+		T src[3][kMaxWidth];
+		T simdDst[2][2 * kMaxWidth], defDst[2][2 * kMaxWidth];
+
+		for (int iteration = 0; iteration < 1000; ++iteration) {
+			// All widths, so that the scalar tails of the SIMD code are used
+			const unsigned width = 2 + iteration % (kMaxWidth - 1);
+			for (int row = 0; row < 3; ++row) {
+				fillRandom(rows[row], width, format);
+				for (unsigned i = 0; i < width; ++i)
+					src[row][i] = (sizeof(T) == 2) ? rows[row][i] : (rows[row][i] | (nextRandom() & 0xFFFF0000));
+			}
+
+			memset(simdDst, 0, sizeof(simdDst));
+			memset(defDst, 0, sizeof(defDst));
+			simd(simdDst[0], simdDst[1], src[0], src[1], src[2], width);
+			def(defDst[0], defDst[1], src[0], src[1], src[2], width);
+
+			for (int row = 0; row < 2; ++row) {
+				if (memcmp(simdDst[row], defDst[row], 2 * width * sizeof(T))) {
+					TS_FAIL(Common::String::format("%d bit scale2x output differs for width %u",
+						(int)sizeof(T) * 8, width).c_str());
+					return;
+				}
+			}
+		}
+	}
+#endif
+
+public:
+	void setUp() {
+		_seed = 0x1234;
+	}
+
+	void test_hq_patterns_565() {
+#ifdef TEST_HQ_PATTERNS
+		checkHQPatterns(565, Graphics::createPixelFormat<565>());
+#endif
+	}
+
+	void test_hq_patterns_555() {
+#ifdef TEST_HQ_PATTERNS
+		checkHQPatterns(555, Graphics::createPixelFormat<555>());
+#endif
+	}
+
+	void test_scale2x_16() {
+#ifdef TEST_SCALE2X_SIMD
+		checkScale2x<scale2x_uint16>(scale2x_16_simd, scale2x_16_def);
+#endif
+	}
+
+	void test_scale2x_32() {
+#ifdef TEST_SCALE2X_SIMD
+		checkScale2x<scale2x_uint32>(scale2x_32_simd, scale2x_32_def);
+#endif
+	}
+};
@@ -0,0 +1,121 @@
+#include <cxxtest/TestSuite.h>
+
+#include "graphics/transformed_surface_cache.h"
+
+class TransformedSurfaceCacheTestSuite : public CxxTest::TestSuite
+{
+private:
+	static void createSource(Graphics::Surface &surf, int w, int h) {
+		surf.create(w, h, Graphics::TransparentSurface::getSupportedPixelFormat());
+		uint32 seed = 1;
+		byte *pixels = (byte *)surf.getPixels();
+		for (int i = 0; i < h * surf.pitch; ++i) {
+			seed = seed * 1103515245 + 12345;
+			pixels[i] = seed >> 16;
+		}
+	}
+
+public:
+	void test_hit_and_miss() {
+		Graphics::Surface source;
+		createSource(source, 40, 30);
+		const Common::Rect srcRect(5, 5, 25, 20);
+		const Graphics::TransformStruct transform;
+		int owner;
+
+		Graphics::TransformedSurfaceCache cache;
+		Graphics::TransformedSurfaceCache::SurfacePtr first = cache.get(&owner, source, srcRect, transform, 40, 30, Graphics::FILTER_BILINEAR);
+		Graphics::TransformedSurfaceCache::SurfacePtr second = cache.get(&owner, source, srcRect, transform, 40, 30, Graphics::FILTER_BILINEAR);
+		TS_ASSERT_EQUALS(first.get(), second.get());
+		TS_ASSERT_EQUALS(cache.getHits(), 1U);
+		TS_ASSERT_EQUALS(cache.getMisses(), 1U);
+		TS_ASSERT_EQUALS(cache.getSize(), 40U * 30U * 4U);
+
+		// The copy is the scaled part of the source
+		const Graphics::TransparentSurface part(source.getSubArea(srcRect), false);
+		Graphics::TransparentSurface *expected = part.scaleT<Graphics::FILTER_BILINEAR>(40, 30);
+		TS_ASSERT_EQUALS(first->w, 40);
+		TS_ASSERT_EQUALS(first->h, 30);
+		for (int y = 0; y < 30; ++y)
+			TS_ASSERT_EQUALS(memcmp(first->getBasePtr(0, y), expected->getBasePtr(0, y), 40 * 4), 0);
+		expected->free();
+		delete expected;
+
+		// Anything which changes the result is a different copy
+		cache.get(&owner, source, srcRect, transform, 41, 30, Graphics::FILTER_BILINEAR);
+		cache.get(&owner, source, srcRect, transform, 40, 30, Graphics::FILTER_NEAREST);
+		cache.get(&owner, source, Common::Rect(5, 6, 25, 21), transform, 40, 30, Graphics::FILTER_BILINEAR);
+		cache.get(&owner, source, srcRect, Graphics::TransformStruct(100, 100, 90), 40, 30, Graphics::FILTER_BILINEAR);
+		TS_ASSERT_EQUALS(cache.getHits(), 1U);
+		TS_ASSERT_EQUALS(cache.getMisses(), 5U);
+
+		// ... but the color and blend mode do not change it
+		Graphics::TransformStruct tinted(100, 100, Graphics::BLEND_ADDITIVE, 0x80808080);
+		cache.get(&owner, source, srcRect, tinted, 40, 30, Graphics::FILTER_BILINEAR);
+		TS_ASSERT_EQUALS(cache.getHits(), 2U);
+
+		source.free();
+	}
+
+	void test_invalidate() {
+		Graphics::Surface source;
+		createSource(source, 20, 20);
+		const Common::Rect srcRect(0, 0, 20, 20);
+		const Graphics::TransformStruct transform;
+		int owner1, owner2;
+
+		Graphics::TransformedSurfaceCache cache;
+		Graphics::TransformedSurfaceCache::SurfacePtr held = cache.get(&owner1, source, srcRect, transform, 10, 10, Graphics::FILTER_NEAREST);
+		cache.get(&owner2, source, srcRect, transform, 10, 10, Graphics::FILTER_NEAREST);
+		TS_ASSERT_EQUALS(cache.getMisses(), 2U);
+
+		cache.invalidate(&owner1);
+		TS_ASSERT_EQUALS(cache.getSize(), 10U * 10U * 4U);
+		// Copies which are still in use stay valid
+		TS_ASSERT_EQUALS(held->w, 10);
+
+		cache.get(&owner1, source, srcRect, transform, 10, 10, Graphics::FILTER_NEAREST);
+		cache.get(&owner2, source, srcRect, transform, 10, 10, Graphics::FILTER_NEAREST);
+		TS_ASSERT_EQUALS(cache.getMisses(), 3U);
+		TS_ASSERT_EQUALS(cache.getHits(), 1U);
+
+		cache.clear();
+		TS_ASSERT_EQUALS(cache.getSize(), 0U);
+
+		source.free();
+	}
+
+	void test_eviction() {
+		Graphics::Surface source;
+		createSource(source, 20, 20);
+		const Common::Rect rectA(0, 0, 20, 20), rectB(0, 0, 10, 20), rectC(0, 0, 20, 10);
+		const Graphics::TransformStruct transform;
+		int owner;
+
+		// Room for two 10x10 copies
+		Graphics::TransformedSurfaceCache cache(2 * 10 * 10 * 4);
+		cache.get(&owner, source, rectA, transform, 10, 10, Graphics::FILTER_NEAREST);
+		cache.get(&owner, source, rectB, transform, 10, 10, Graphics::FILTER_NEAREST);
+		// A is now used more recently than B
+		cache.get(&owner, source, rectA, transform, 10, 10, Graphics::FILTER_NEAREST);
+		TS_ASSERT_EQUALS(cache.getMisses(), 2U);
+		TS_ASSERT_EQUALS(cache.getHits(), 1U);
+
+		// C pushes out B
+		cache.get(&owner, source, rectC, transform, 10, 10, Graphics::FILTER_NEAREST);
+		TS_ASSERT_EQUALS(cache.getSize(), 2U * 10U * 10U * 4U);
+		cache.get(&owner, source, rectA, transform, 10, 10, Graphics::FILTER_NEAREST);
+		TS_ASSERT_EQUALS(cache.getHits(), 2U);
+		cache.get(&owner, source, rectB, transform, 10, 10, Graphics::FILTER_NEAREST);
+		TS_ASSERT_EQUALS(cache.getMisses(), 4U);
+
+		// Copies larger than the budget are not kept
+		Graphics::TransformedSurfaceCache::SurfacePtr large = cache.get(&owner, source, rectA, transform, 40, 40, Graphics::FILTER_NEAREST);
+		TS_ASSERT_EQUALS(large->w, 40);
+		TS_ASSERT_EQUALS(cache.getSize(), 2U * 10U * 10U * 4U);
+		cache.get(&owner, source, rectA, transform, 40, 40, Graphics::FILTER_NEAREST);
+		TS_ASSERT_EQUALS(cache.getMisses(), 6U);
+
+		source.free();
+	}
+};
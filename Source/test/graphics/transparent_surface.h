@@ -0,0 +1,309 @@
+#include <cxxtest/TestSuite.h>
+
+#include <time.h>
+
+#include "common/str.h"
+
+#include "graphics/transparent_surface.h"
+
+class TransparentSurfaceTestSuite : public CxxTest::TestSuite
+{
+private:
+	enum {
+		// Not a multiple of 4, so that the plain C code handles the end of
+		// each line
+		kWidth = 322,
+		kHeight = 200,
+		kIterations = 20
+	};
+
+#ifdef SCUMM_LITTLE_ENDIAN
+	enum { kA = 0, kB = 1, kG = 2, kR = 3 };
+#else
+	enum { kA = 3, kB = 2, kG = 1, kR = 0 };
+#endif
+
+	static void fillRandom(Graphics::Surface &surf, uint32 &seed) {
+		byte *pixels = (byte *)surf.getPixels();
+		for (int i = 0; i < surf.h * surf.pitch; ++i) {
+			seed = seed * 1103515245 + 12345;
+			pixels[i] = seed >> 16;
+		}
+
+		// Make fully transparent and fully opaque pixels common
+		for (int y = 0; y < surf.h; ++y) {
+			for (int x = 0; x < surf.w; ++x) {
+				byte *p = (byte *)surf.getBasePtr(x, y);
+				if (p[kB] < 64)
+					p[kA] = 0;
+				else if (p[kB] < 128)
+					p[kA] = 255;
+			}
+		}
+	}
+
+	/**
+	 * The blending of one pixel as done by the original per-pixel code
+	 */
+	static void referenceBlend(const byte *in, byte *out, uint32 color, Graphics::TSpriteBlendMode blendMode, Graphics::AlphaType alphaMode) {
+		const uint ca = (color >> 24) & 0xFF, cr = (color >> 16) & 0xFF, cg = (color >> 8) & 0xFF, cb = color & 0xFF;
+		if (color == 0xFFFFFFFF && blendMode == Graphics::BLEND_NORMAL && alphaMode != Graphics::ALPHA_FULL) {
+			if (alphaMode == Graphics::ALPHA_OPAQUE || in[kA] != 0) {
+				memcpy(out, in, 4);
+				out[kA] = 0xFF;
+			}
+			return;
+		}
+
+		const int channels[3] = { kR, kG, kB };
+		const uint mods[3] = { cr, cg, cb };
+
+		if (color == 0xFFFFFFFF) {
+			if (in[kA] == 0)
+				return;
+			const uint a = in[kA];
+			if (blendMode == Graphics::BLEND_NORMAL)
+				out[kA] = 255;
+			for (int i = 0; i < 3; ++i) {
+				const int c = channels[i];
+				switch (blendMode) {
+				case Graphics::BLEND_NORMAL:
+					out[c] = (in[c] * a + out[c] * (255 - a)) >> 8;
+					break;
+				case Graphics::BLEND_ADDITIVE:
+					out[c] = MIN<uint>((in[c] * a >> 8) + out[c], 255);
+					break;
+				case Graphics::BLEND_SUBTRACTIVE:
+					out[c] = MAX<int>(out[c] - (int)((in[c] * out[c]) * a >> 16), 0);
+					break;
+				case Graphics::BLEND_MULTIPLY:
+					out[c] = MIN<uint>((in[c] * a >> 8) * out[c] >> 8, 255);
+					break;
+				default:
+					break;
+				}
+			}
+			return;
+		}
+
+		const uint ina = in[kA] * ca >> 8;
+		if (blendMode == Graphics::BLEND_NORMAL || blendMode == Graphics::BLEND_SUBTRACTIVE)
+			out[kA] = 255;
+		for (int i = 0; i < 3; ++i) {
+			const int c = channels[i];
+			const uint m = mods[i];
+			switch (blendMode) {
+			case Graphics::BLEND_NORMAL:
+				out[c] = out[c] * (255 - ina) >> 8;
+				out[c] = out[c] + (in[c] * ina * m >> 16);
+				break;
+			case Graphics::BLEND_ADDITIVE:
+				if (m != 255)
+					out[c] = MIN<uint>(out[c] + ((in[c] * m * ina) >> 16), 255);
+				else
+					out[c] = MIN<uint>(out[c] + (in[c] * ina >> 8), 255);
+				break;
+			case Graphics::BLEND_SUBTRACTIVE:
+				if (m != 255)
+					out[c] = MAX<int>(out[c] - (int)((in[c] * m * out[c] * in[kA]) >> 24), 0);
+				else
+					out[c] = MAX<int>(out[c] - (int)(in[c] * out[c] * in[kA] >> 16), 0);
+				break;
+			case Graphics::BLEND_MULTIPLY:
+				if (m != 255)
+					out[c] = MIN<uint>(out[c] * ((in[c] * m * ina) >> 16) >> 8, 255);
+				else
+					out[c] = MIN<uint>(out[c] * (in[c] * ina >> 8) >> 8, 255);
+				break;
+			default:
+				break;
+			}
+		}
+	}
+
+	static void referenceBlit(const Graphics::Surface &src, Graphics::Surface &dst, int flipping, uint32 color, Graphics::TSpriteBlendMode blendMode, Graphics::AlphaType alphaMode) {
+		for (int y = 0; y < dst.h; ++y) {
+			for (int x = 0; x < dst.w; ++x) {
+				const int srcX = (flipping & Graphics::FLIP_H) ? src.w - 1 - x : x;
+				const int srcY = (flipping & Graphics::FLIP_V) ? src.h - 1 - y : y;
+				referenceBlend((const byte *)src.getBasePtr(srcX, srcY), (byte *)dst.getBasePtr(x, y), color, blendMode, alphaMode);
+			}
+		}
+	}
+
+	/**
+	 * Bilinear scaling as done by the original per-pixel code
+	 */
+	static Graphics::Surface *referenceScaleBilinear(const Graphics::Surface &src, int dstW, int dstH) {
+		Graphics::Surface *dst = new Graphics::Surface();
+		dst->create(dstW, dstH, src.format);
+
+		const int spixelw = src.w - 1, spixelh = src.h - 1;
+		const int sx = (int)(65536.0f * (float)spixelw / (float)(dstW - 1));
+		const int sy = (int)(65536.0f * (float)spixelh / (float)(dstH - 1));
+
+		for (int y = 0; y < dstH; ++y) {
+			const int csy = MIN(y * sy, (src.h << 16) - 1);
+			const int cy = csy >> 16, ey = csy & 0xffff;
+			for (int x = 0; x < dstW; ++x) {
+				const int csx = MIN(x * sx, (src.w << 16) - 1);
+				const int cx = csx >> 16, ex = csx & 0xffff;
+
+				const byte *c00 = (const byte *)src.getBasePtr(cx, cy);
+				const byte *c10 = (cy < spixelh) ? (const byte *)src.getBasePtr(cx, cy + 1) : c00;
+				const byte *c01 = (cx < spixelw) ? c00 + 4 : c00;
+				const byte *c11 = (cx < spixelw) ? c10 + 4 : c10;
+
+				byte *dp = (byte *)dst->getBasePtr(x, y);
+				for (int i = 0; i < 4; ++i) {
+					const int t1 = ((((c01[i] - c00[i]) * ex) >> 16) + c00[i]) & 0xff;
+					const int t2 = ((((c11[i] - c10[i]) * ex) >> 16) + c10[i]) & 0xff;
+					dp[i] = (((t2 - t1) * ey) >> 16) + t1;
+				}
+			}
+		}
+
+		return dst;
+	}
+
+public:
+	void test_scale_bilinear_matches_reference() {
+		const int sizes[][2] = {
+			{ 3, 2 }, { 13, 7 }, { 161, 100 }, { 322, 200 }, { 501, 333 }, { 700, 451 }
+		};
+
+		Graphics::TransparentSurface src;
+		src.create(kWidth, kHeight, Graphics::TransparentSurface::getSupportedPixelFormat());
+		uint32 seed = 7;
+		fillRandom(src, seed);
+
+		for (uint i = 0; i < ARRAYSIZE(sizes); ++i) {
+			Graphics::Surface *expected = referenceScaleBilinear(src, sizes[i][0], sizes[i][1]);
+			Graphics::TransparentSurface *result = src.scaleT<Graphics::FILTER_BILINEAR>(sizes[i][0], sizes[i][1]);
+
+			TS_ASSERT_EQUALS(result->w, expected->w);
+			TS_ASSERT_EQUALS(result->h, expected->h);
+			for (int y = 0; y < expected->h; ++y)
+				TS_ASSERT_EQUALS(memcmp(expected->getBasePtr(0, y), result->getBasePtr(0, y), expected->w * 4), 0);
+
+			expected->free();
+			delete expected;
+			result->free();
+			delete result;
+		}
+
+		src.free();
+	}
+
+	void test_blit_matches_reference() {
+		const Graphics::TSpriteBlendMode blendModes[] = {
+			Graphics::BLEND_NORMAL,
+			Graphics::BLEND_ADDITIVE,
+			Graphics::BLEND_SUBTRACTIVE,
+			Graphics::BLEND_MULTIPLY
+		};
+		const Graphics::AlphaType alphaModes[] = {
+			Graphics::ALPHA_OPAQUE,
+			Graphics::ALPHA_BINARY,
+			Graphics::ALPHA_FULL
+		};
+		const uint32 colors[] = {
+			0xFFFFFFFF,
+			0x80FFFFFF,
+			0xFF4060FF,
+			0xC0FF8020
+		};
+
+		const Graphics::PixelFormat format = Graphics::TransparentSurface::getSupportedPixelFormat();
+		Graphics::TransparentSurface src;
+		Graphics::Surface background, expected, result;
+		src.create(kWidth, kHeight, format);
+		background.create(kWidth, kHeight, format);
+		expected.create(kWidth, kHeight, format);
+		result.create(kWidth, kHeight, format);
+
+		uint32 seed = 42;
+		fillRandom(src, seed);
+		fillRandom(background, seed);
+
+		for (uint b = 0; b < ARRAYSIZE(blendModes); ++b) {
+			for (uint a = 0; a < ARRAYSIZE(alphaModes); ++a) {
+				for (uint c = 0; c < ARRAYSIZE(colors); ++c) {
+					for (int flipping = Graphics::FLIP_NONE; flipping <= Graphics::FLIP_HV; ++flipping) {
+						src.setAlphaMode(alphaModes[a]);
+
+						expected.copyFrom(background);
+						referenceBlit(src, expected, flipping, colors[c], blendModes[b], alphaModes[a]);
+
+						result.copyFrom(background);
+						src.blit(result, 0, 0, flipping, nullptr, colors[c], -1, -1, blendModes[b]);
+
+						TSM_ASSERT_EQUALS(Common::String::format("blend %d, alpha %d, color %08x, flipping %d", blendModes[b], alphaModes[a], colors[c], flipping).c_str(),
+							memcmp(expected.getPixels(), result.getPixels(), kHeight * expected.pitch), 0);
+					}
+				}
+			}
+		}
+
+		src.free();
+		background.free();
+		expected.free();
+		result.free();
+	}
+
+	void test_benchmark() {
+		const Graphics::PixelFormat format = Graphics::TransparentSurface::getSupportedPixelFormat();
+		Graphics::TransparentSurface src;
+		Graphics::Surface dst;
+		src.create(kWidth, kHeight, format);
+		dst.create(kWidth, kHeight, format);
+
+		uint32 seed = 42;
+		fillRandom(src, seed);
+		fillRandom(dst, seed);
+
+		const uint32 colors[] = { 0xFFFFFFFF, 0xC0FF8020 };
+		for (uint c = 0; c < ARRAYSIZE(colors); ++c) {
+			double mpixels[2];
+			for (int i = 0; i < 2; ++i) {
+				const clock_t start = (clock)();
+				for (int n = 0; n < kIterations; ++n) {
+					if (i == 0)
+						referenceBlit(src, dst, Graphics::FLIP_NONE, colors[c], Graphics::BLEND_NORMAL, Graphics::ALPHA_FULL);
+					else
+						src.blit(dst, 0, 0, Graphics::FLIP_NONE, nullptr, colors[c]);
+				}
+				const double seconds = (double)((clock)() - start) / CLOCKS_PER_SEC;
+				mpixels[i] = (double)kWidth * kHeight * kIterations / 1000000.0 / MAX(seconds, 0.000001);
+			}
+
+			TS_TRACE(Common::String::format("Alpha blend, color %08x, %dx%d: per pixel %.0f MPixel/s, blit (%s) %.0f MPixel/s",
+				colors[c], kWidth, kHeight, mpixels[0],
+				Graphics::TransparentSurface::hasSIMD() ? "SIMD" : "no SIMD", mpixels[1]).c_str());
+		}
+
+		// Bilinear scaling to twice the size
+		double mpixels[2];
+		for (int i = 0; i < 2; ++i) {
+			const clock_t start = (clock)();
+			for (int n = 0; n < kIterations; ++n) {
+				Graphics::Surface *scaled;
+				if (i == 0)
+					scaled = referenceScaleBilinear(src, kWidth * 2, kHeight * 2);
+				else
+					scaled = src.scaleT<Graphics::FILTER_BILINEAR>(kWidth * 2, kHeight * 2);
+				scaled->free();
+				delete scaled;
+			}
+			const double seconds = (double)((clock)() - start) / CLOCKS_PER_SEC;
+			mpixels[i] = (double)kWidth * kHeight * 4 * kIterations / 1000000.0 / MAX(seconds, 0.000001);
+		}
+
+		TS_TRACE(Common::String::format("Bilinear scaling to %dx%d: per pixel %.0f MPixel/s, scaleT (%s) %.0f MPixel/s",
+			kWidth * 2, kHeight * 2, mpixels[0],
+			Graphics::TransparentSurface::hasSIMD() ? "SIMD" : "no SIMD", mpixels[1]).c_str());
+
+		src.free();
+		dst.free();
+	}
+};
@@ -0,0 +1,87 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/scummsys.h"
+#include "common/str.h"
+
+#ifdef USE_FREETYPE2
+
+#include "backends/fs/stdiostream.h"
+#include "graphics/font.h"
+#include "graphics/surface.h"
+#include "graphics/fonts/ttf.h"
+
+#include <time.h>
+
+#endif
+
+class TTFFontTestSuite : public CxxTest::TestSuite
+{
+public:
+	/**
+	 * Draws strings with a TTF font and caches all of its glyphs outside of
+	 * the characters 0-255, which is what fonts with many characters (e.g.
+	 * CJK ones) do during play. Font files are not shipped, so the
+	 * benchmark only runs when TTF_BENCHMARK.ttf is found in the current
+	 * directory; FreeSans.ttf from the modern theme is a good choice.
+	 */
+	void test_render_benchmark() {
+#ifdef USE_FREETYPE2
+		Common::SeekableReadStream *file = StdioStream::makeFromPath("TTF_BENCHMARK.ttf", false);
+		if (!file) {
+			TS_TRACE("TTF_BENCHMARK.ttf not found, skipping the TTF benchmark");
+			return;
+		}
+
+		const Graphics::PixelFormat formats[] = {
+			Graphics::PixelFormat::createFormatCLUT8(),
+			Graphics::PixelFormat(2, 5, 6, 5, 0, 11, 5, 0, 0),
+			Graphics::PixelFormat(4, 8, 8, 8, 8, 24, 16, 8, 0)
+		};
+		const Common::String text("The quick brown fox jumps over the lazy dog. AV To Wa 0123456789");
+		const int kIterations = 20000;
+
+		for (uint i = 0; i < ARRAYSIZE(formats); ++i) {
+			file->seek(0);
+			Graphics::Font *font = Graphics::loadTTFFont(*file, 14);
+			TS_ASSERT(font);
+			if (!font)
+				break;
+
+			Graphics::Surface surface;
+			surface.create(640, 480, formats[i]);
+			const uint32 color = (formats[i].bytesPerPixel == 1) ? 15 : formats[i].RGBToColor(200, 30, 90);
+
+			const clock_t start = (clock)();
+			for (int n = 0; n < kIterations; ++n)
+				font->drawString(&surface, text, 0, (n % 30) * 15, 640, color, Graphics::kTextAlignLeft, 0, false);
+			const double seconds = (double)((clock)() - start) / CLOCKS_PER_SEC;
+
+			TS_TRACE(Common::String::format("TTF drawString at %dbpp: %.2f Mglyphs/s",
+				formats[i].bytesPerPixel * 8, text.size() * kIterations / seconds / 1e6).c_str());
+
+			surface.free();
+			delete font;
+		}
+
+		// Glyphs outside of the characters 0-255 are cached on first use
+		file->seek(0);
+		Graphics::Font *font = Graphics::loadTTFFont(*file, 14);
+		TS_ASSERT(font);
+		if (font) {
+			int lateGlyphs = 0;
+			const clock_t start = (clock)();
+			for (uint32 chr = 0x100; chr < 0x10000; ++chr) {
+				if (font->getCharWidth(chr))
+					++lateGlyphs;
+			}
+			const double seconds = (double)((clock)() - start) / CLOCKS_PER_SEC;
+
+			TS_TRACE(Common::String::format("TTF late caching: %d glyphs in %.1f ms (%.1f us per glyph)",
+				lateGlyphs, seconds * 1000, lateGlyphs ? seconds * 1e6 / lateGlyphs : 0.0).c_str());
+			delete font;
+		}
+
+		delete file;
+#endif
+	}
+};
@@ -0,0 +1,149 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/str.h"
+
+#include "graphics/pixelformat.h"
+#include "graphics/surface.h"
+#include "graphics/yuv_to_rgb.h"
+
+#include <time.h>
+
+class YUVToRGBTestSuite : public CxxTest::TestSuite
+{
+private:
+	enum Subsampling {
+		k444,
+		k420,
+		k410
+	};
+
+	enum {
+		// Not a multiple of 16, so that the scalar code handles the end
+		// of each line
+		kWidth = 644,
+		kHeight = 480,
+		kIterations = 10
+	};
+
+	struct Planes {
+		byte *y, *u, *v;
+		int yPitch, uvPitch;
+	};
+
+	static void fillRandom(byte *dst, int size, uint32 &seed) {
+		for (int i = 0; i < size; ++i) {
+			seed = seed * 1103515245 + 12345;
+			dst[i] = seed >> 16;
+		}
+	}
+
+	static Planes createPlanes(Subsampling subsampling) {
+		// 410 reads one extra row and column of chroma
+		const int div = (subsampling == k444) ? 1 : (subsampling == k420) ? 2 : 4;
+		const int uvWidth = kWidth / div + 1, uvHeight = kHeight / div + 1;
+
+		Planes planes;
+		planes.yPitch = kWidth;
+		planes.uvPitch = uvWidth;
+		planes.y = new byte[kWidth * kHeight];
+		planes.u = new byte[uvWidth * uvHeight];
+		planes.v = new byte[uvWidth * uvHeight];
+
+		uint32 seed = 42;
+		fillRandom(planes.y, kWidth * kHeight, seed);
+		fillRandom(planes.u, uvWidth * uvHeight, seed);
+		fillRandom(planes.v, uvWidth * uvHeight, seed);
+		return planes;
+	}
+
+	static void freePlanes(Planes &planes) {
+		delete[] planes.y;
+		delete[] planes.u;
+		delete[] planes.v;
+	}
+
+	static void convert(const Graphics::YUVToRGBLookup &lookup, Subsampling subsampling, Graphics::Surface *dst, const Planes &planes) {
+		switch (subsampling) {
+		case k444:
+			lookup.convert444(dst, planes.y, planes.u, planes.v, kWidth, kHeight, planes.yPitch, planes.uvPitch);
+			break;
+		case k420:
+			lookup.convert420(dst, planes.y, planes.u, planes.v, kWidth, kHeight, planes.yPitch, planes.uvPitch);
+			break;
+		case k410:
+			lookup.convert410(dst, planes.y, planes.u, planes.v, kWidth, kHeight, planes.yPitch, planes.uvPitch);
+			break;
+		}
+	}
+
+public:
+	void test_simd_matches_lookup() {
+		const Graphics::PixelFormat formats[] = {
+			Graphics::PixelFormat(2, 5, 6, 5, 0, 11, 5, 0, 0),
+			Graphics::PixelFormat(2, 5, 5, 5, 1, 10, 5, 0, 15),
+			Graphics::PixelFormat(4, 8, 8, 8, 8, 24, 16, 8, 0),
+			Graphics::PixelFormat(4, 8, 8, 8, 0, 16, 8, 0, 0)
+		};
+		const Graphics::YUVToRGBManager::LuminanceScale scales[] = {
+			Graphics::YUVToRGBManager::kScaleFull,
+			Graphics::YUVToRGBManager::kScaleITU
+		};
+
+		for (int subsampling = k444; subsampling <= k410; ++subsampling) {
+			Planes planes = createPlanes((Subsampling)subsampling);
+
+			for (uint f = 0; f < ARRAYSIZE(formats); ++f) {
+				for (uint s = 0; s < ARRAYSIZE(scales); ++s) {
+					const Graphics::YUVToRGBLookup scalar(formats[f], scales[s], false);
+					const Graphics::YUVToRGBLookup simd(formats[f], scales[s], true);
+
+					Graphics::Surface expected, result;
+					expected.create(kWidth, kHeight, formats[f]);
+					result.create(kWidth, kHeight, formats[f]);
+
+					convert(scalar, (Subsampling)subsampling, &expected, planes);
+					convert(simd, (Subsampling)subsampling, &result, planes);
+					TS_ASSERT_EQUALS(memcmp(expected.getPixels(), result.getPixels(), kHeight * expected.pitch), 0);
+
+					expected.free();
+					result.free();
+				}
+			}
+
+			freePlanes(planes);
+		}
+	}
+
+	void test_benchmark() {
+		static const char *const names[] = { "444", "420", "410" };
+		const Graphics::PixelFormat format(4, 8, 8, 8, 8, 24, 16, 8, 0);
+		const Graphics::YUVToRGBLookup lookups[2] = {
+			Graphics::YUVToRGBLookup(format, Graphics::YUVToRGBManager::kScaleITU, false),
+			Graphics::YUVToRGBLookup(format, Graphics::YUVToRGBManager::kScaleITU, true)
+		};
+
+		Graphics::Surface dst;
+		dst.create(kWidth, kHeight, format);
+
+		for (int subsampling = k444; subsampling <= k410; ++subsampling) {
+			Planes planes = createPlanes((Subsampling)subsampling);
+
+			double mpixels[2];
+			for (int i = 0; i < 2; ++i) {
+				const clock_t start = (clock)();
+				for (int n = 0; n < kIterations; ++n)
+					convert(lookups[i], (Subsampling)subsampling, &dst, planes);
+				const double seconds = (double)((clock)() - start) / CLOCKS_PER_SEC;
+				mpixels[i] = (double)kWidth * kHeight * kIterations / 1000000.0 / MAX(seconds, 0.000001);
+			}
+
+			TS_TRACE(Common::String::format("YUV%s to ARGB8888, %dx%d: lookup %.0f MPixel/s, %s %.0f MPixel/s",
+				names[subsampling], kWidth, kHeight, mpixels[0],
+				Graphics::YUVToRGBLookup::hasSIMD() ? "SIMD" : "no SIMD", mpixels[1]).c_str());
+
+			freePlanes(planes);
+		}
+
+		dst.free();
+	}
+};
@@ -5,8 +5,21 @@
 #
 ######################################################################
 
-TESTS        := $(srcdir)/test/common/*.h $(srcdir)/test/audio/*.h
-TEST_LIBS    := audio/libaudio.a common/libcommon.a
+TESTS        := $(srcdir)/test/common/*.h $(srcdir)/test/audio/*.h $(srcdir)/test/graphics/*.h
+TEST_LIBS    := audio/libaudio.a graphics/libgraphics.a common/libcommon.a
+
+# For benchmarks reading optional data files
+TEST_LIBS += backends/fs/stdiostream.o
+
+ifdef USE_MT32EMU
+	TEST_LIBS += audio/softsynth/mt32/libmt32.a
+endif
+
+# The video library has to precede the libraries it depends on
+ifdef USE_BINK
+	TESTS += $(srcdir)/test/video/*.h
+	TEST_LIBS := video/libvideo.a backends/jobs/default/default-jobs.o $(TEST_LIBS)
+endif
 
 ifeq ($(ENABLE_WINTERMUTE), STATIC_PLUGIN)
 	TESTS += $(srcdir)/test/engines/wintermute/*.h
@@ -0,0 +1,86 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/scummsys.h"
+#include "common/str.h"
+
+#ifdef USE_BINK
+
+#include "backends/fs/stdiostream.h"
+#include "backends/jobs/default/default-jobs.h"
+#include "graphics/surface.h"
+#include "video/bink_decoder.h"
+
+#include "test/system.h"
+
+#include <time.h>
+
+/**
+ * The Bink decoder runs its work through the job manager of the system.
+ * The default one executes the jobs on the calling thread, which matches
+ * the no-op mutexes of TestSystem.
+ */
+class BinkTestSystem : public TestSystem {
+public:
+	/** Must be called once the system is installed, to create mutexes. */
+	void initJobManager() { _jobManager = new DefaultJobManager(); }
+};
+
+#endif
+
+class BinkDecoderTestSuite : public CxxTest::TestSuite
+{
+public:
+	/**
+	 * Decodes all frames of a Bink video and reports the frames per second
+	 * decoded, for 16 and 32 bit output. Videos are not shipped, so the
+	 * benchmark only runs when BINK_BENCHMARK.bik is found in the current
+	 * directory. All jobs run on the calling thread, so this measures the
+	 * decoding and conversion work rather than the gain from the workers.
+	 */
+	void test_decode_benchmark() {
+#ifdef USE_BINK
+		Common::SeekableReadStream *file = StdioStream::makeFromPath("BINK_BENCHMARK.bik", false);
+		if (!file) {
+			TS_TRACE("BINK_BENCHMARK.bik not found, skipping the Bink benchmark");
+			return;
+		}
+		delete file;
+
+		OSystem *oldSystem = g_system;
+		BinkTestSystem system;
+		g_system = &system;
+		system.initJobManager();
+
+		const Graphics::PixelFormat formats[] = {
+			Graphics::PixelFormat(2, 5, 6, 5, 0, 11, 5, 0, 0),
+			Graphics::PixelFormat(4, 8, 8, 8, 8, 24, 16, 8, 0)
+		};
+
+		for (uint i = 0; i < ARRAYSIZE(formats); ++i) {
+			Video::BinkDecoder decoder;
+			decoder.setDefaultHighColorFormat(formats[i]);
+			TS_ASSERT(decoder.loadStream(StdioStream::makeFromPath("BINK_BENCHMARK.bik", false)));
+			if (!decoder.isVideoLoaded())
+				break;
+
+			const uint32 frameCount = decoder.getFrameCount();
+			uint32 decoded = 0;
+			const clock_t start = (clock)();
+			for (uint32 frame = 0; frame < frameCount; ++frame) {
+				if (decoder.decodeNextFrame())
+					++decoded;
+			}
+			const double seconds = (double)((clock)() - start) / CLOCKS_PER_SEC;
+			TS_ASSERT_EQUALS(decoded, frameCount);
+
+			TS_TRACE(Common::String::format("Bink %dx%d at %dbpp: %u frames, %.1f frames/s",
+				decoder.getWidth(), decoder.getHeight(), formats[i].bytesPerPixel * 8,
+				decoded, seconds > 0 ? decoded / seconds : 0.0).c_str());
+
+			decoder.close();
+		}
+
+		g_system = oldSystem;
+#endif
+	}
+};
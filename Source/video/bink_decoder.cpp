@@ -38,6 +38,8 @@
 #include "common/huffman.h"
 #include "common/rdft.h"
 #include "common/dct.h"
+#include "common/debug.h"
+#include "common/jobs.h"
 #include "common/system.h"
 
 #include "graphics/yuv_to_rgb.h"
@@ -59,10 +61,15 @@ static const uint16 kAudioFlagStereo = 0x2000;
 // Number of bits used to store first DC value in bundle
 static const uint32 kDCStartBits = 11;
 
+// Number of chroma lines converted to RGB in one parallel slice
+static const uint kConvertSliceLines = 16;
+
 namespace Video {
 
 BinkDecoder::BinkDecoder() {
 	_bink = 0;
+	_decodedFrames = 0;
+	_decodeTime = 0;
 }
 
 BinkDecoder::~BinkDecoder() {
@@ -145,6 +152,13 @@ bool BinkDecoder::loadStream(Common::SeekableReadStream *stream) {
 }
 
 void BinkDecoder::close() {
+	if (_decodedFrames) {
+		debug(1, "Bink: Decoded %u frames, %u ms on the main thread (%.1f frames/s)", _decodedFrames, _decodeTime,
+		      _decodedFrames * 1000.0 / MAX<uint32>(_decodeTime, 1));
+		_decodedFrames = 0;
+		_decodeTime = 0;
+	}
+
 	VideoDecoder::close();
 
 	delete _bink;
@@ -160,7 +174,8 @@ void BinkDecoder::readNextPacket() {
 	if (videoTrack->endOfTrack())
 		return;
 
-	VideoFrame &frame = _frames[videoTrack->getCurFrame() + 1];
+	const uint32 frameNum = videoTrack->getCurFrame() + 1;
+	VideoFrame &frame = _frames[frameNum];
 
 	if (!_bink->seek(frame.offset))
 		error("Bad bink seek");
@@ -200,16 +215,58 @@ void BinkDecoder::readNextPacket() {
 		}
 	}
 
-	uint32 videoPacketStart = _bink->pos();
-	uint32 videoPacketEnd   = _bink->pos() + frameSize;
+	const uint32 startTime = g_system->getMillis();
+
+	if (videoTrack->isDecodingAhead()) {
+		videoTrack->finishDecodeAhead();
+	} else {
+		uint32 videoPacketStart = _bink->pos();
+		uint32 videoPacketEnd   = _bink->pos() + frameSize;
+
+		frame.bits = new Common::BitStream32LELSB(new Common::SeekableSubReadStream(_bink,
+				videoPacketStart, videoPacketEnd), DisposeAfterUse::YES);
 
-	frame.bits = new Common::BitStream32LELSB(new Common::SeekableSubReadStream(_bink,
-			videoPacketStart, videoPacketEnd), DisposeAfterUse::YES);
+		videoTrack->decodePacket(frame);
+
+		delete frame.bits;
+		frame.bits = 0;
+	}
 
-	videoTrack->decodePacket(frame);
+	// Decode the next frame while this one is being shown. Its audio
+	// packets are still read and decoded here, on the next call.
+	if (videoTrack->canDecodeAhead() && frameNum + 1 < _frames.size()) {
+		VideoFrame &nextFrame = _frames[frameNum + 1];
 
-	delete frame.bits;
-	frame.bits = 0;
+		nextFrame.bits = new Common::BitStream32LELSB(readVideoPacket(nextFrame), DisposeAfterUse::YES);
+		videoTrack->startDecodeAhead(nextFrame);
+	}
+
+	_decodeTime += g_system->getMillis() - startTime;
+	_decodedFrames++;
+}
+
+Common::SeekableReadStream *BinkDecoder::readVideoPacket(const VideoFrame &frame) {
+	if (!_bink->seek(frame.offset))
+		error("Bad bink seek");
+
+	uint32 frameSize = frame.size;
+
+	// Skip the audio packets
+	for (uint32 i = 0; i < _audioTracks.size(); i++) {
+		uint32 audioPacketLength = _bink->readUint32LE();
+
+		frameSize -= 4;
+
+		if (frameSize < audioPacketLength)
+			error("Audio packet too big for the frame");
+
+		_bink->skip(audioPacketLength);
+		frameSize -= audioPacketLength;
+	}
+
+	// Read the video packet into memory, so that it can be decoded on a
+	// worker thread
+	return _bink->readStream(frameSize);
 }
 
 VideoDecoder::AudioTrack *BinkDecoder::getAudioTrack(int index) {
@@ -246,6 +303,14 @@ BinkDecoder::BinkVideoTrack::BinkVideoTrack(uint32 width, uint32 height, const G
 		_frameCount(frameCount), _frameRate(frameRate), _swapPlanes(swapPlanes), _hasAlpha(hasAlpha), _id(id) {
 	_curFrame = -1;
 
+	_jobManager = g_system->getJobManager();
+	_decodeAheadFrame = 0;
+	_decodeAheadJob = Common::JobManager::kInvalidJob;
+	_convertDst = 0;
+
+	// The conversion may run in jobs, so create the singleton beforehand
+	Graphics::YUVToRGBManager::instance();
+
 	for (int i = 0; i < 16; i++)
 		_huffman[i] = 0;
 
@@ -286,6 +351,14 @@ BinkDecoder::BinkVideoTrack::BinkVideoTrack(uint32 width, uint32 height, const G
 	_surface.h = height;
 	_surface.w = width;
 
+	// With worker threads available, the next frame is decoded into a
+	// second surface while the current one is shown
+	if (_jobManager->getWorkerCount() > 0) {
+		_nextSurface.create(_surfaceWidth, _surfaceHeight, format);
+		_nextSurface.h = height;
+		_nextSurface.w = width;
+	}
+
 	// Compute the video dimensions in blocks
 	_yBlockWidth   = (width  +  7) >> 3;
 	_yBlockHeight  = (height +  7) >> 3;
@@ -317,6 +390,13 @@ BinkDecoder::BinkVideoTrack::BinkVideoTrack(uint32 width, uint32 height, const G
 }
 
 BinkDecoder::BinkVideoTrack::~BinkVideoTrack() {
+	if (_decodeAheadFrame) {
+		_jobManager->waitForJob(_decodeAheadJob);
+
+		delete _decodeAheadFrame->bits;
+		_decodeAheadFrame->bits = 0;
+	}
+
 	for (int i = 0; i < 4; i++) {
 		delete[] _curPlanes[i]; _curPlanes[i] = 0;
 		delete[] _oldPlanes[i]; _oldPlanes[i] = 0;
@@ -330,9 +410,62 @@ BinkDecoder::BinkVideoTrack::~BinkVideoTrack() {
 	}
 
 	_surface.free();
+	_nextSurface.free();
 }
 
 void BinkDecoder::BinkVideoTrack::decodePacket(VideoFrame &frame) {
+	decodeFrame(frame, _surface);
+
+	_curFrame++;
+}
+
+void BinkDecoder::BinkVideoTrack::startDecodeAhead(VideoFrame &frame) {
+	assert(!_decodeAheadFrame && canDecodeAhead());
+
+	_decodeAheadFrame = &frame;
+	_decodeAheadJob = _jobManager->addJob(decodeAheadProc, this, "Bink frame");
+}
+
+void BinkDecoder::BinkVideoTrack::finishDecodeAhead() {
+	assert(_decodeAheadFrame);
+
+	_jobManager->waitForJob(_decodeAheadJob);
+
+	delete _decodeAheadFrame->bits;
+	_decodeAheadFrame->bits = 0;
+	_decodeAheadFrame = 0;
+	_decodeAheadJob = Common::JobManager::kInvalidJob;
+
+	SWAP(_surface, _nextSurface);
+	_curFrame++;
+}
+
+void BinkDecoder::BinkVideoTrack::decodeAheadProc(void *refCon) {
+	BinkVideoTrack *track = (BinkVideoTrack *)refCon;
+
+	track->decodeFrame(*track->_decodeAheadFrame, track->_nextSurface);
+}
+
+void BinkDecoder::BinkVideoTrack::convertSliceProc(void *refCon, uint begin, uint end) {
+	BinkVideoTrack *track = (BinkVideoTrack *)refCon;
+	Graphics::Surface *dst = track->_convertDst;
+
+	// Every chroma line covers two lines of luma and of the surface
+	const int yPitch  = track->_yBlockWidth  * 8;
+	const int uvPitch = track->_uvBlockWidth * 8;
+	const int height  = (end - begin) * 2;
+
+	Graphics::Surface slice;
+	slice.init(dst->w, height, dst->pitch, dst->getBasePtr(0, begin * 2), dst->format);
+
+	YUVToRGBMan.convert420(&slice, Graphics::YUVToRGBManager::kScaleITU,
+			track->_curPlanes[0] + begin * 2 * yPitch,
+			track->_curPlanes[1] + begin * uvPitch,
+			track->_curPlanes[2] + begin * uvPitch,
+			track->_surfaceWidth, height, yPitch, uvPitch);
+}
+
+void BinkDecoder::BinkVideoTrack::decodeFrame(VideoFrame &frame, Graphics::Surface &dst) {
 	assert(frame.bits);
 
 	if (_hasAlpha) {
@@ -358,15 +491,15 @@ void BinkDecoder::BinkVideoTrack::decodePacket(VideoFrame &frame) {
 	// We're ignoring alpha for now
 	// The width used here is the surface-width, and not the video-width
 	// to allow for odd-sized videos.
+	// The conversion is split into horizontal slices processed in parallel.
 	assert(_curPlanes[0] && _curPlanes[1] && _curPlanes[2]);
-	YUVToRGBMan.convert420(&_surface, Graphics::YUVToRGBManager::kScaleITU, _curPlanes[0], _curPlanes[1], _curPlanes[2],
-			_surfaceWidth, _surfaceHeight, _yBlockWidth * 8, _uvBlockWidth * 8);
+	_convertDst = &dst;
+	_jobManager->parallelFor(0, _surfaceHeight / 2, kConvertSliceLines, convertSliceProc, this, "Bink YUV conversion");
+	_convertDst = 0;
 
 	// And swap the planes with the reference planes
 	for (int i = 0; i < 4; i++)
 		SWAP(_curPlanes[i], _oldPlanes[i]);
-
-	_curFrame++;
 }
 
 void BinkDecoder::BinkVideoTrack::decodePlane(VideoFrame &video, int planeIdx, bool isChroma) {
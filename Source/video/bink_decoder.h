@@ -33,6 +33,7 @@
 
 #include "common/array.h"
 #include "common/bitstream.h"
+#include "common/jobs.h"
 #include "common/rational.h"
 
 #include "video/video_decoder.h"
@@ -154,6 +155,20 @@ private:
 		/** Decode a video packet. */
 		void decodePacket(VideoFrame &frame);
 
+		/** Can frames be decoded on a worker thread, ahead of time? */
+		bool canDecodeAhead() const { return _nextSurface.getPixels() != 0; }
+		/** Is a frame being decoded ahead of time? */
+		bool isDecodingAhead() const { return _decodeAheadFrame != 0; }
+
+		/**
+		 * Start decoding the next frame on a worker thread. The frame's
+		 * bits must not access the video file, so that the main thread can
+		 * keep reading the audio packets.
+		 */
+		void startDecodeAhead(VideoFrame &frame);
+		/** Wait for the frame decoded ahead of time and make it current. */
+		void finishDecodeAhead();
+
 	protected:
 		Common::Rational getFrameRate() const { return _frameRate; }
 
@@ -235,6 +250,7 @@ private:
 		int _frameCount;
 
 		Graphics::Surface _surface;
+		Graphics::Surface _nextSurface; ///< The frame being decoded ahead of time
 		int _surfaceWidth; ///< The actual surface width
 		int _surfaceHeight; ///< The actual surface height
 
@@ -262,6 +278,16 @@ private:
 		byte *_curPlanes[4]; ///< The 4 color planes, YUVA, current frame.
 		byte *_oldPlanes[4]; ///< The 4 color planes, YUVA, last frame.
 
+		Common::JobManager *_jobManager;
+		VideoFrame *_decodeAheadFrame;                 ///< The frame being decoded ahead of time
+		Common::JobManager::JobHandle _decodeAheadJob; ///< The job decoding it
+		Graphics::Surface *_convertDst;                ///< Destination of the running YUV conversion
+
+		void decodeFrame(VideoFrame &frame, Graphics::Surface &dst);
+
+		static void decodeAheadProc(void *refCon);
+		static void convertSliceProc(void *refCon, uint begin, uint end);
+
 		/** Initialize the bundles. */
 		void initBundles();
 		/** Deinitialize the bundles. */
@@ -357,6 +383,12 @@ private:
 	Common::Array<AudioInfo> _audioTracks; ///< All audio tracks.
 	Common::Array<VideoFrame> _frames;      ///< All video frames.
 
+	uint32 _decodedFrames; ///< Number of frames decoded since loading the stream
+	uint32 _decodeTime;    ///< Time spent decoding on the main thread, in ms
+
+	/** Read the video packet of a frame, skipping its audio packets. */
+	Common::SeekableReadStream *readVideoPacket(const VideoFrame &frame);
+
 	void initAudioTrack(AudioInfo &audio);
 };
 